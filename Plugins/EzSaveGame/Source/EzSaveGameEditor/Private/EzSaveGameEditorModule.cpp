@@ -7,6 +7,9 @@
 #include "PropertyEditorModule.h"
 #include "MotaEzSaveGameSettingsCustomization.h"
 #include "MotaEzSaveGameSettings.h"
+#include "MotaEzSchemaCache.h"
+#include "UObject/ICookInfo.h"
+#include "Misc/Paths.h"
 
 static const FName EzSaveGameSchemaEditorTabName("EzSaveGameSchemaEditor");
 
@@ -46,12 +49,17 @@ public:
         }
 
         UE_LOG(LogTemp, Log, TEXT("EzSaveGameEditor: Schema Editor registrado en Window menu"));
+
+        // Bake the compiled schema into the packaged build so it never parses the text schema
+        CookStartedHandle = UE::Cook::FDelegates::CookStarted.AddRaw(this, &FEzSaveGameEditorModule::OnCookStarted);
     }
 
     virtual void ShutdownModule() override
     {
         UE_LOG(LogTemp, Log, TEXT("EzSaveGameEditor: Shutdown"));
 
+        UE::Cook::FDelegates::CookStarted.Remove(CookStartedHandle);
+
         // Unregister property customization
         if (FModuleManager::Get().IsModuleLoaded("PropertyEditor"))
         {
@@ -65,6 +73,31 @@ public:
 
 private:
 
+    FDelegateHandle CookStartedHandle;
+
+    void OnCookStarted(UE::Cook::ICookInfo& CookInfo)
+    {
+        const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+        const FString SchemaPath = Settings->GetSchemaFilePath();
+        const FString BakedPath = UMotaEzSchemaCache::GetBakedCachePath();
+
+        if (!FPaths::FileExists(SchemaPath))
+        {
+            UE_LOG(LogTemp, Log, TEXT("EzSaveGameEditor: No schema at %s, nothing to bake"), *SchemaPath);
+            return;
+        }
+
+        FString Error;
+        if (UMotaEzSchemaCache::CompileSchemaFile(SchemaPath, Settings->DefaultFormat, BakedPath, Error))
+        {
+            UE_LOG(LogTemp, Log, TEXT("EzSaveGameEditor: Schema baked to %s"), *BakedPath);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("EzSaveGameEditor: Failed to bake schema: %s"), *Error);
+        }
+    }
+
     TSharedRef<SDockTab> OnSpawnSchemaEditorTab(const FSpawnTabArgs& Args)
     {
         return SNew(SDockTab)
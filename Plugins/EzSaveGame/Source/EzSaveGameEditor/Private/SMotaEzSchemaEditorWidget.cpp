@@ -335,6 +335,13 @@ TSharedRef<ITableRow> SMotaEzSchemaEditorWidget::OnGenerateFieldRow(TSharedPtr<F
                     case EMotaEzFieldType::String: return TEXT("String");
                     case EMotaEzFieldType::Vector: return TEXT("Vector");
                     case EMotaEzFieldType::Rotator: return TEXT("Rotator");
+                    case EMotaEzFieldType::Int64: return TEXT("Int64");
+                    case EMotaEzFieldType::Double: return TEXT("Double");
+                    case EMotaEzFieldType::Quat: return TEXT("Quat");
+                    case EMotaEzFieldType::Transform: return TEXT("Transform");
+                    case EMotaEzFieldType::LinearColor: return TEXT("LinearColor");
+                    case EMotaEzFieldType::Struct: return TEXT("Struct");
+                    case EMotaEzFieldType::Blob: return TEXT("Blob");
                     default: return TEXT("Unknown");
                 }
             }()))
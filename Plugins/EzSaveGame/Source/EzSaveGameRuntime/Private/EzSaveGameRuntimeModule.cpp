@@ -7,9 +7,17 @@
 #include "MotaEzConfigSubsystem.h"
 #include "MotaEzSaveData.h"
 #include "MotaEzSaveGameSettings.h"
+#include "MotaEzObjectSerializer.h"
+#include "MotaEzStructCodec.h"
+#include "MotaEzFormatSerializer.h"
+#include "GameFramework/SaveGame.h"
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 #include "Engine/GameViewportClient.h"
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Dom/JsonObject.h"
 
 static FAutoConsoleCommand ConsoleCommand_EzSave(
     TEXT("EzSave.Save"),
@@ -189,6 +197,289 @@ static FAutoConsoleCommand ConsoleCommand_EzInfo(
     })
 );
 
+// Benchmarks only report timings; the consistency they used to print is covered by the EzSaveGame.* automation tests
+#if !UE_BUILD_SHIPPING
+namespace
+{
+    /**
+     * Runs a mixed read/write workload on one save data object from several threads.
+     * @return Operations per second over all threads
+     */
+    double RunContentionPass(UMotaEzSaveData* SaveData, const TArray<FString>& Keys, int32 NumThreads, int32 OpsPerThread, int32 WritePercent)
+    {
+        TArray<TFuture<void>> Workers;
+        Workers.Reserve(NumThreads);
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+        {
+            Workers.Add(Async(EAsyncExecution::Thread, [SaveData, &Keys, ThreadIndex, OpsPerThread, WritePercent]()
+            {
+                FRandomStream Random(ThreadIndex + 1);
+                for (int32 Op = 0; Op < OpsPerThread; ++Op)
+                {
+                    const FString& Key = Keys[Random.RandHelper(Keys.Num())];
+                    if (Random.RandHelper(100) < WritePercent)
+                    {
+                        SaveData->SetInt(Key, Op);
+                    }
+                    else
+                    {
+                        SaveData->GetInt(Key, 0);
+                    }
+                }
+            }));
+        }
+
+        for (TFuture<void>& Worker : Workers)
+        {
+            Worker.Wait();
+        }
+
+        const double Elapsed = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+        return (double)NumThreads * OpsPerThread / Elapsed;
+    }
+
+    /**
+     * Reads published snapshots from several threads, one read scope per operation.
+     * @return Reads per second over all threads
+     */
+    double RunSnapshotPass(const TSharedRef<FMotaEzSnapshotChannel, ESPMode::ThreadSafe>& Channel, const TArray<FString>& Keys, int32 NumThreads, int32 OpsPerThread)
+    {
+        TArray<TFuture<void>> Workers;
+        Workers.Reserve(NumThreads);
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+        {
+            Workers.Add(Async(EAsyncExecution::Thread, [Channel, &Keys, ThreadIndex, OpsPerThread]()
+            {
+                FRandomStream Random(ThreadIndex + 1);
+                for (int32 Op = 0; Op < OpsPerThread; ++Op)
+                {
+                    FMotaEzSnapshotReadScope Snapshot(*Channel);
+                    Snapshot->GetInt(Keys[Random.RandHelper(Keys.Num())], 0);
+                }
+            }));
+        }
+
+        for (TFuture<void>& Worker : Workers)
+        {
+            Worker.Wait();
+        }
+
+        const double Elapsed = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+        return (double)NumThreads * OpsPerThread / Elapsed;
+    }
+}
+
+static FAutoConsoleCommand ConsoleCommand_EzBenchContention(
+    TEXT("EzSave.BenchContention"),
+    TEXT("Measures thread-safe and snapshot save data access at 1-32 threads and checks the result stays consistent. Usage: EzSave.BenchContention [OpsPerThread] [WritePercent]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 OpsPerThread = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 200000;
+        const int32 WritePercent = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 0, 100) : 10;
+
+        // Transient object; garbage collection cannot run while the game thread waits on the workers
+        UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+
+        TArray<FString> Keys;
+        for (int32 Index = 0; Index < 1024; ++Index)
+        {
+            Keys.Add(FString::Printf(TEXT("Bench_%d"), Index));
+            SaveData->SetInt(Keys.Last(), Index);
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Contention benchmark, %d ops per thread, %d%% writes, %d keys, %d lock shards"),
+            OpsPerThread, WritePercent, Keys.Num(), UMotaEzSaveData::NumLockShards);
+
+        SaveData->SetThreadSafe(false);
+        const double Unlocked = RunContentionPass(SaveData, Keys, 1, OpsPerThread, WritePercent);
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   unlocked   1 thread : %12.0f ops/s"), Unlocked);
+
+        SaveData->SetThreadSafe(true);
+        bool bConsistent = true;
+        for (int32 NumThreads = 1; NumThreads <= 32; NumThreads *= 2)
+        {
+            const double Locked = RunContentionPass(SaveData, Keys, NumThreads, OpsPerThread, WritePercent);
+            UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   sharded  %3d threads: %12.0f ops/s (%.2fx unlocked)"), NumThreads, Locked, Locked / Unlocked);
+
+            // The running fingerprint must still match the contents after concurrent writes
+            const uint64 RunningFingerprint = SaveData->GetFingerprint();
+            SaveData->RecomputeFingerprint();
+            if (RunningFingerprint != SaveData->GetFingerprint() || SaveData->Data.Num() != Keys.Num())
+            {
+                bConsistent = false;
+                UE_LOG(LogTemp, Error, TEXT("EzSaveGame:   inconsistent state after %d threads"), NumThreads);
+            }
+        }
+
+        // Read-only consumers: lock-free snapshots should scale with the number of cores
+        const TSharedRef<FMotaEzSnapshotChannel, ESPMode::ThreadSafe> Channel = SaveData->GetSnapshotChannel();
+        for (int32 NumThreads = 1; NumThreads <= 32; NumThreads *= 2)
+        {
+            const double Reads = RunSnapshotPass(Channel, Keys, NumThreads, OpsPerThread);
+            UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   snapshot %3d threads: %12.0f reads/s"), NumThreads, Reads);
+        }
+
+        SaveData->MarkAsGarbage();
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Contention benchmark %s"), bConsistent ? TEXT("finished, state consistent") : TEXT("FAILED"));
+    })
+);
+
+namespace
+{
+    /**
+     * Round-trips an object through the Key -> FMotaEzValue map and a text format, the way
+     * property-by-property saving works without compiled layouts.
+     * @return true if the text could be parsed back
+     */
+    bool RoundTripThroughMap(USaveGame* Object, FString& OutText)
+    {
+        TMap<FString, FMotaEzValue> Map;
+        for (TFieldIterator<FProperty> PropIt(Object->GetClass()); PropIt; ++PropIt)
+        {
+            if (PropIt->HasAnyPropertyFlags(CPF_SaveGame))
+            {
+                FMotaEzValue& Value = Map.Add(PropIt->GetName());
+                Value.Type = EMotaEzFieldType::String;
+                PropIt->ExportTextItem_InContainer(Value.ScalarValue, Object, nullptr, nullptr, PPF_None);
+            }
+        }
+
+        FString Error;
+        if (!UMotaEzFormatSerializer::SaveConfig(EMotaEzConfigFormat::Json, Map, OutText, Error))
+        {
+            return false;
+        }
+
+        Map.Reset();
+        if (!UMotaEzFormatSerializer::LoadConfig(EMotaEzConfigFormat::Json, OutText, Map, Error))
+        {
+            return false;
+        }
+
+        for (TFieldIterator<FProperty> PropIt(Object->GetClass()); PropIt; ++PropIt)
+        {
+            if (const FMotaEzValue* Value = Map.Find(PropIt->GetName()))
+            {
+                PropIt->ImportText_InContainer(*Value->ScalarValue, Object, Object, PPF_None);
+            }
+        }
+        return true;
+    }
+}
+
+static FAutoConsoleCommand ConsoleCommand_EzBenchObject(
+    TEXT("EzSave.BenchObject"),
+    TEXT("Compares saving and loading a USaveGame class through the key/value map and through its compiled layout. Usage: EzSave.BenchObject <ClassPath> [Iterations]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() < 1)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Usage: EzSave.BenchObject <ClassPath> [Iterations]"));
+            return;
+        }
+
+        UClass* ObjectClass = LoadClass<USaveGame>(nullptr, *Args[0]);
+        if (!ObjectClass)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s is not a USaveGame class"), *Args[0]);
+            return;
+        }
+
+        const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10000;
+        USaveGame* Object = NewObject<USaveGame>(GetTransientPackage(), ObjectClass);
+
+        FString Text;
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            if (!RoundTripThroughMap(Object, Text))
+            {
+                UE_LOG(LogTemp, Error, TEXT("EzSaveGame: Map round trip failed"));
+                return;
+            }
+        }
+        const double MapSeconds = FPlatformTime::Seconds() - StartTime;
+
+        TArray<uint8> Bytes;
+        FString Error;
+        StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            if (!UMotaEzObjectSerializer::SerializeObject(Object, Bytes, Error) || !UMotaEzObjectSerializer::DeserializeObject(Object, Bytes, Error))
+            {
+                UE_LOG(LogTemp, Error, TEXT("EzSaveGame: Object round trip failed - %s"), *Error);
+                return;
+            }
+        }
+        const double LayoutSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: %s, %d fields, %d iterations"),
+            *ObjectClass->GetName(), UMotaEzObjectSerializer::GetLayoutFieldCount(ObjectClass), Iterations);
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   map path   : %8.2f us per save+load (%d chars)"), MapSeconds * 1e6 / Iterations, Text.Len());
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   layout path: %8.2f us per save+load (%d bytes, %.1fx faster)"),
+            LayoutSeconds * 1e6 / Iterations, Bytes.Num(), MapSeconds / LayoutSeconds);
+
+        Object->MarkAsGarbage();
+    })
+);
+
+static FAutoConsoleCommand ConsoleCommand_EzBenchStruct(
+    TEXT("EzSave.BenchStruct"),
+    TEXT("Compares storing an array of USTRUCT values as packed records and as text-format objects. Usage: EzSave.BenchStruct <StructPath> [Count]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() < 1)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Usage: EzSave.BenchStruct <StructPath> [Count]"));
+            return;
+        }
+
+        const UScriptStruct* Struct = UMotaEzStructCodec::FindStruct(Args[0]);
+        if (!Struct)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s is not a struct"), *Args[0]);
+            return;
+        }
+
+        const int32 Count = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10000;
+        const int32 Stride = Struct->GetStructureSize();
+        uint8* Values = (uint8*)FMemory::Malloc((SIZE_T)Stride * Count, Struct->GetMinAlignment());
+        Struct->InitializeStruct(Values, Count);
+
+        FMotaEzValue Value;
+        FString Error;
+        double StartTime = FPlatformTime::Seconds();
+        bool bOk = UMotaEzStructCodec::MakeValue(Struct, Values, Count, true, Value)
+            && UMotaEzStructCodec::UnpackRecords(Struct, Value.StructData, [Values](int32) { return Values; }, Error);
+        const double RecordSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+
+        FMotaEzValue TextValue;
+        StartTime = FPlatformTime::Seconds();
+        const TSharedPtr<FJsonObject> Object = bOk ? UMotaEzStructCodec::ToJsonObject(Value, Error) : nullptr;
+        bOk = Object.IsValid() && UMotaEzStructCodec::FromJsonObject(*Object, TextValue, Error);
+        const double TextSeconds = FPlatformTime::Seconds() - StartTime;
+
+        Struct->DestroyStruct(Values, Count);
+        FMemory::Free(Values);
+
+        if (!bOk)
+        {
+            UE_LOG(LogTemp, Error, TEXT("EzSaveGame: Struct round trip failed - %s"), *Error);
+            return;
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: %s, %d members, %d values"), *Struct->GetName(), UMotaEzStructCodec::GetMemberCount(Struct), Count);
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   text objects  : %8.2f ms per save+load"), TextSeconds * 1e3);
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame:   packed records: %8.2f ms per save+load (%d bytes, %.1fx faster)"),
+            RecordSeconds * 1e3, Value.StructData.Num(), TextSeconds / RecordSeconds);
+    })
+);
+#endif // !UE_BUILD_SHIPPING
+
 class FEzSaveGameRuntimeModule : public IModuleInterface
 {
 public:
@@ -202,6 +493,11 @@ public:
         UE_LOG(LogTemp, Log, TEXT("   - EzSave.SetInt     : Set Int value"));
         UE_LOG(LogTemp, Log, TEXT("   - EzSave.GetString  : Get String value"));
         UE_LOG(LogTemp, Log, TEXT("   - EzSave.Info       : Show info"));
+#if !UE_BUILD_SHIPPING
+        UE_LOG(LogTemp, Log, TEXT("   - EzSave.BenchContention : Benchmark thread-safe access"));
+        UE_LOG(LogTemp, Log, TEXT("   - EzSave.BenchObject : Benchmark object serialization"));
+        UE_LOG(LogTemp, Log, TEXT("   - EzSave.BenchStruct : Benchmark struct records"));
+#endif
     }
 
     virtual void ShutdownModule() override
@@ -0,0 +1,148 @@
+﻿#include "MotaEzBase64.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+    const ANSICHAR Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    /** Two output characters for every 12-bit input. */
+    struct FCharPair
+    {
+        TCHAR Chars[2];
+    };
+
+    struct FTables
+    {
+        FCharPair Pairs[4096];
+        int8 Digits[256];
+
+        FTables()
+        {
+            for (int32 Index = 0; Index < 4096; ++Index)
+            {
+                Pairs[Index].Chars[0] = (TCHAR)Alphabet[Index >> 6];
+                Pairs[Index].Chars[1] = (TCHAR)Alphabet[Index & 63];
+            }
+
+            FMemory::Memset(Digits, 0xFF, sizeof(Digits));
+            for (int32 Index = 0; Index < 64; ++Index)
+            {
+                Digits[(uint8)Alphabet[Index]] = (int8)Index;
+            }
+        }
+    };
+
+    const FTables& GetTables()
+    {
+        static const FTables Tables;
+        return Tables;
+    }
+
+    /** @return The 6-bit value of a character, or a negative number if it is not a Base64 digit */
+    FORCEINLINE int32 DigitOf(const FTables& Tables, TCHAR Char)
+    {
+        return (uint32)Char < 256 ? Tables.Digits[(uint32)Char] : -1;
+    }
+}
+
+void MotaEzBase64::Encode(TConstArrayView<uint8> Bytes, FString& Out)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_Base64Encode);
+
+    const FTables& Tables = GetTables();
+    const int32 Num = Bytes.Num();
+    const uint8* In = Bytes.GetData();
+
+    TArray<TCHAR, FString::AllocatorType>& Chars = Out.GetCharArray();
+    const int32 Start = Out.Len();
+    Chars.SetNumUninitialized(Start + GetEncodedLength(Num) + 1);
+    FCharPair* Dest = reinterpret_cast<FCharPair*>(Chars.GetData() + Start);
+
+    int32 Index = 0;
+    for (; Index + 3 <= Num; Index += 3)
+    {
+        const uint32 Group = ((uint32)In[Index] << 16) | ((uint32)In[Index + 1] << 8) | In[Index + 2];
+        *Dest++ = Tables.Pairs[Group >> 12];
+        *Dest++ = Tables.Pairs[Group & 0xFFF];
+    }
+
+    if (Index < Num)
+    {
+        const bool bTwoBytes = Index + 1 < Num;
+        const uint32 Group = ((uint32)In[Index] << 16) | (bTwoBytes ? (uint32)In[Index + 1] << 8 : 0);
+        *Dest = Tables.Pairs[Group >> 12];
+        ++Dest;
+        Dest->Chars[0] = bTwoBytes ? Tables.Pairs[Group & 0xFFF].Chars[0] : TCHAR('=');
+        Dest->Chars[1] = TCHAR('=');
+        ++Dest;
+    }
+
+    *reinterpret_cast<TCHAR*>(Dest) = TCHAR('\0');
+}
+
+bool MotaEzBase64::Decode(FStringView Text, TArray<uint8>& OutBytes)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_Base64Decode);
+
+    Text = Text.TrimStartAndEnd();
+    while (Text.EndsWith(TCHAR('=')))
+    {
+        Text.LeftChopInline(1);
+    }
+
+    const int32 Len = Text.Len();
+    if (Len % 4 == 1)
+    {
+        OutBytes.Reset();
+        return false;
+    }
+
+    const FTables& Tables = GetTables();
+    const TCHAR* In = Text.GetData();
+    OutBytes.SetNumUninitialized(Len / 4 * 3 + FMath::Max(Len % 4 - 1, 0));
+    uint8* Dest = OutBytes.GetData();
+
+    int32 Index = 0;
+    for (; Index + 4 <= Len; Index += 4)
+    {
+        const int32 D0 = DigitOf(Tables, In[Index]);
+        const int32 D1 = DigitOf(Tables, In[Index + 1]);
+        const int32 D2 = DigitOf(Tables, In[Index + 2]);
+        const int32 D3 = DigitOf(Tables, In[Index + 3]);
+        // One test for the four digits: any invalid one is negative
+        if ((D0 | D1 | D2 | D3) < 0)
+        {
+            OutBytes.Reset();
+            return false;
+        }
+
+        const uint32 Group = ((uint32)D0 << 18) | ((uint32)D1 << 12) | ((uint32)D2 << 6) | (uint32)D3;
+        Dest[0] = (uint8)(Group >> 16);
+        Dest[1] = (uint8)(Group >> 8);
+        Dest[2] = (uint8)Group;
+        Dest += 3;
+    }
+
+    // Two or three trailing digits carry one or two bytes
+    const int32 Tail = Len - Index;
+    if (Tail > 0)
+    {
+        const int32 D0 = DigitOf(Tables, In[Index]);
+        const int32 D1 = DigitOf(Tables, In[Index + 1]);
+        const int32 D2 = Tail > 2 ? DigitOf(Tables, In[Index + 2]) : 0;
+        if ((D0 | D1 | D2) < 0)
+        {
+            OutBytes.Reset();
+            return false;
+        }
+
+        const uint32 Group = ((uint32)D0 << 18) | ((uint32)D1 << 12) | ((uint32)D2 << 6);
+        Dest[0] = (uint8)(Group >> 16);
+        if (Tail > 2)
+        {
+            Dest[1] = (uint8)(Group >> 8);
+        }
+    }
+
+    return true;
+}
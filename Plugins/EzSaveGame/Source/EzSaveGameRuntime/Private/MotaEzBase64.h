@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Standard padded Base64 for Blob values in text formats.
+ * Encoding looks up 12 bits (two output characters) at a time and writes straight into the
+ * destination string; decoding reads four characters per step into a pre-sized buffer.
+ */
+namespace MotaEzBase64
+{
+    /** @return Number of characters Encode produces for Num bytes */
+    FORCEINLINE int32 GetEncodedLength(int32 Num)
+    {
+        return ((Num + 2) / 3) * 4;
+    }
+
+    /**
+     * Appends the Base64 text of the bytes to Out.
+     * @param Bytes - Bytes to encode
+     * @param Out - String the text is appended to
+     */
+    void Encode(TConstArrayView<uint8> Bytes, FString& Out);
+
+    /**
+     * Decodes Base64 text; surrounding whitespace is ignored and padding is optional.
+     * @param Text - Text to decode
+     * @param OutBytes - Receives the bytes
+     * @return true if the text was valid Base64, false otherwise (OutBytes is emptied)
+     */
+    bool Decode(FStringView Text, TArray<uint8>& OutBytes);
+}
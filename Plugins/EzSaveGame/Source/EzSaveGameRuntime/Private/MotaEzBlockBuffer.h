@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Raw little-endian buffers shared by the binary codecs (object blocks, struct records).
+ */
+namespace MotaEzBlockBuffer
+{
+    /** Appends raw bytes to the output buffer. */
+    struct FBlockWriter
+    {
+        TArray<uint8>& Bytes;
+
+        FORCEINLINE void Write(const void* Data, int64 Size)
+        {
+            Bytes.Append(static_cast<const uint8*>(Data), Size);
+        }
+
+        template <typename T>
+        FORCEINLINE void WriteValue(T Value)
+        {
+            Write(&Value, sizeof(T));
+        }
+
+        void WriteString(const FString& Value)
+        {
+            const FTCHARToUTF8 Utf8(*Value);
+            WriteValue<uint32>(Utf8.Length());
+            Write(Utf8.Get(), Utf8.Length());
+        }
+
+        /** Reserves a uint32 to be patched once the size of what follows is known. */
+        FORCEINLINE int64 BeginSize()
+        {
+            const int64 At = Bytes.Num();
+            WriteValue<uint32>(0);
+            return At;
+        }
+
+        FORCEINLINE void EndSize(int64 At)
+        {
+            const uint32 Size = (uint32)(Bytes.Num() - At - sizeof(uint32));
+            FMemory::Memcpy(Bytes.GetData() + At, &Size, sizeof(Size));
+        }
+    };
+
+    /** Reads from the input buffer with bounds checks. */
+    struct FBlockReader
+    {
+        TConstArrayView<uint8> Bytes;
+        int64 Position = 0;
+
+        FORCEINLINE int64 Remaining() const
+        {
+            return Bytes.Num() - Position;
+        }
+
+        FORCEINLINE bool Read(void* Data, int64 Size)
+        {
+            if (Size < 0 || Position + Size > Bytes.Num())
+            {
+                return false;
+            }
+            FMemory::Memcpy(Data, Bytes.GetData() + Position, Size);
+            Position += Size;
+            return true;
+        }
+
+        template <typename T>
+        FORCEINLINE bool ReadValue(T& Value)
+        {
+            return Read(&Value, sizeof(T));
+        }
+
+        bool ReadString(FString& Value)
+        {
+            uint32 Length = 0;
+            if (!ReadValue(Length) || Position + Length > Bytes.Num())
+            {
+                return false;
+            }
+            Value = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + Position), Length));
+            Position += Length;
+            return true;
+        }
+    };
+}
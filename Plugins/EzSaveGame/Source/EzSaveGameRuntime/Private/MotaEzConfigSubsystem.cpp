@@ -1,8 +1,13 @@
 ﻿#include "MotaEzConfigSubsystem.h"
 #include "MotaEzSaveData.h"
 #include "MotaEzSaveGameSettings.h"
+#include "MotaEzSlotFile.h"
+#include "MotaEzSlotManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 UMotaEzConfigSubsystem::UMotaEzConfigSubsystem()
 {
@@ -12,22 +17,202 @@ void UMotaEzConfigSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
 
-    FString Error;
-    if (!LoadInternal(Error))
+    CurrentSave = NewObject<UMotaEzSaveData>(this);
+    StartBackgroundLoad();
+
+    // Read the slots the next map needs while it streams in
+    PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UMotaEzConfigSubsystem::HandlePreLoadMap);
+
+    // The first map (or the PIE world) is already loading by the time the game instance exists
+    if (const UWorld* World = GetWorld())
     {
-        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Failed to load initial config: %s"), *Error);
-        CurrentSave = NewObject<UMotaEzSaveData>(this);
+        UMotaEzSlotManager::PrefetchForMap(World->GetMapName());
     }
 }
 
 void UMotaEzConfigSubsystem::Deinitialize()
 {
+    FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+    PreLoadMapHandle.Reset();
+
+    // Never auto-save over the config with data that has not finished loading
+    CompleteBackgroundLoad();
+
     // Execute auto-save on exit if enabled
     ExecuteAutoSaveOnExit();
+
+    SchemaTask = {};
+    ConfigTask = {};
     
     Super::Deinitialize();
 }
 
+UMotaEzSaveData* UMotaEzConfigSubsystem::GetCurrentSave() const
+{
+    if (!bIsReady.load())
+    {
+        if (IsInGameThread())
+        {
+            // First synchronous access before the workers finished: block here instead of returning defaults
+            const_cast<UMotaEzConfigSubsystem*>(this)->CompleteBackgroundLoad();
+        }
+        else
+        {
+            // The merge and OnReady belong to the game thread; just wait for the parse to finish
+            SchemaTask.Wait();
+            ConfigTask.Wait();
+        }
+    }
+    return CurrentSave;
+}
+
+UMotaEzSaveData* UMotaEzConfigSubsystem::GetDocument(int32 SlotIndex)
+{
+    CompleteBackgroundLoad();
+
+    // A resident document is the authority for its slot, including its unsaved changes
+    if (UMotaEzSaveData* Resident = FindDocument(SlotIndex))
+    {
+        return Resident;
+    }
+
+    if (UMotaEzSlotManager::IsSlotOccupied(SlotIndex))
+    {
+        UMotaEzSaveData* Document = nullptr;
+        FString Error;
+        if (UMotaEzSlotManager::LoadSlotDocument(this, SlotIndex, Document, Error))
+        {
+            return Document;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: GetDocument %d - %s"), SlotIndex, *Error);
+    }
+
+    return FindOrAddDocument(SlotIndex);
+}
+
+void UMotaEzConfigSubsystem::ReleaseDocument(int32 SlotIndex)
+{
+    Documents.Remove(SlotIndex);
+}
+
+UMotaEzSaveData* UMotaEzConfigSubsystem::FindDocument(int32 SlotIndex) const
+{
+    const TObjectPtr<UMotaEzSaveData>* Found = Documents.Find(SlotIndex);
+    return Found ? Found->Get() : nullptr;
+}
+
+UMotaEzSaveData* UMotaEzConfigSubsystem::FindOrAddDocument(int32 SlotIndex)
+{
+    if (UMotaEzSaveData* Existing = FindDocument(SlotIndex))
+    {
+        return Existing;
+    }
+
+    UMotaEzSaveData* Document = NewObject<UMotaEzSaveData>(this);
+    Document->SetDefaultsLayer(SchemaDefaults);
+    Document->SetValidationRules(SchemaRules);
+    Documents.Add(SlotIndex, Document);
+    return Document;
+}
+
+void UMotaEzConfigSubsystem::SetCurrentSave(UMotaEzSaveData* SaveData)
+{
+    if (SaveData)
+    {
+        CurrentSave = SaveData;
+    }
+}
+
+void UMotaEzConfigSubsystem::StartBackgroundLoad()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_StartBackgroundLoad);
+
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    if (!Settings)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Failed to load initial config: Failed to get UMotaEzSaveGameSettings"));
+        bIsReady = true;
+        return;
+    }
+
+    const FString SchemaPath = Settings->GetSchemaFilePath();
+    const FString ConfigPath = Settings->GetConfigFilePath();
+    const EMotaEzConfigFormat Format = Settings->DefaultFormat;
+
+    bIsReady = false;
+
+    // Schema and config are independent until the merge, so parse them in parallel
+    SchemaTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [SchemaPath, Format]()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_LoadSchema);
+        FMotaEzSchemaLoadResult Result;
+        Result.bSuccess = LoadSchemaFile(SchemaPath, Format, Result.Schema, Result.Error);
+        return Result;
+    });
+
+    ConfigTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [ConfigPath, Format]()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_LoadConfig);
+        FMotaEzConfigLoadResult Result;
+        Result.bSuccess = LoadConfigFile(ConfigPath, Format, Result.RawConfig, Result.Error);
+        return Result;
+    });
+
+    // Finish on the game thread as soon as both are done, without anyone having to ask
+    ReadyTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+    {
+        if (!SchemaTask.IsCompleted() || !ConfigTask.IsCompleted())
+        {
+            return true;
+        }
+
+        ReadyTickerHandle.Reset();
+        CompleteBackgroundLoad();
+        return false;
+    }));
+}
+
+void UMotaEzConfigSubsystem::CompleteBackgroundLoad()
+{
+    if (bIsReady.load())
+    {
+        return;
+    }
+
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_CompleteBackgroundLoad);
+
+    if (ReadyTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(ReadyTickerHandle);
+        ReadyTickerHandle.Reset();
+    }
+
+    // GetResult only blocks if the worker is still running
+    FMotaEzSchemaLoadResult& SchemaResult = SchemaTask.GetResult();
+    FMotaEzConfigLoadResult& ConfigResult = ConfigTask.GetResult();
+
+    if (!SchemaResult.bSuccess || !ConfigResult.bSuccess)
+    {
+        const FString& Error = !SchemaResult.bSuccess ? SchemaResult.Error : ConfigResult.Error;
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Failed to load initial config: %s"), *Error);
+    }
+    else
+    {
+        BuildSaveDataFromSchemaAndConfig(SchemaResult.Schema, MoveTemp(ConfigResult.RawConfig), CurrentSave.Get());
+    }
+
+    // The task handles stay valid until Deinitialize so other threads in GetCurrentSave can still wait on them
+    bIsReady.store(true);
+    OnReady.Broadcast();
+}
+
+void UMotaEzConfigSubsystem::HandlePreLoadMap(const FString& MapName)
+{
+    UMotaEzSlotManager::PrefetchForMap(MapName);
+}
+
 bool UMotaEzConfigSubsystem::ReloadFromDisk()
 {
     FString Error;
@@ -51,7 +236,7 @@ bool UMotaEzConfigSubsystem::SaveToDisk()
 }
 
 
-bool UMotaEzConfigSubsystem::LoadTextFile(const FString& FilePath, FString& OutText, FString& OutError) const
+bool UMotaEzConfigSubsystem::LoadTextFile(const FString& FilePath, FString& OutText, FString& OutError)
 {
     OutError.Reset();
     OutText.Reset();
@@ -62,32 +247,39 @@ bool UMotaEzConfigSubsystem::LoadTextFile(const FString& FilePath, FString& OutT
         return false;
     }
 
-    if (!FFileHelper::LoadFileToString(OutText, *FilePath))
-    {
-        OutError = FString::Printf(TEXT("Failed to read file: %s"), *FilePath);
-        return false;
-    }
+    return UMotaEzSlotFile::ReadText(FilePath, OutText, OutError);
+}
 
-    return true;
+bool UMotaEzConfigSubsystem::SaveTextFile(const FString& FilePath, EMotaEzConfigFormat Format, const FString& Text, FString& OutError) const
+{
+    return UMotaEzSlotFile::WriteText(FilePath, Format, Text, OutError);
 }
 
-bool UMotaEzConfigSubsystem::SaveTextFile(const FString& FilePath, const FString& Text, FString& OutError) const
+bool UMotaEzConfigSubsystem::LoadSchemaFile(const FString& SchemaPath, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& OutSchema, FString& OutError)
 {
-    OutError.Reset();
+    // Reuses the compiled schema unless the text changed; packaged builds use the cooked cache
+    return UMotaEzSchemaCache::LoadSchema(SchemaPath, Format, OutSchema, OutError);
+}
 
-    const FString Dir = FPaths::GetPath(FilePath);
-    if (!IFileManager::Get().DirectoryExists(*Dir))
+bool UMotaEzConfigSubsystem::LoadConfigFile(const FString& ConfigPath, EMotaEzConfigFormat Format, TMap<FString, FMotaEzValue>& OutConfig, FString& OutError)
+{
+    if (!FPaths::FileExists(ConfigPath))
     {
-        if (!IFileManager::Get().MakeDirectory(*Dir, true))
-        {
-            OutError = FString::Printf(TEXT("Failed to create directory: %s"), *Dir);
-            return false;
-        }
+        return true;
+    }
+
+    FString ConfigText;
+    FString LocalError;
+
+    if (!LoadTextFile(ConfigPath, ConfigText, LocalError))
+    {
+        OutError = LocalError;
+        return false;
     }
 
-    if (!FFileHelper::SaveStringToFile(Text, *FilePath))
+    if (!UMotaEzFormatSerializer::LoadConfig(Format, ConfigText, OutConfig, LocalError))
     {
-        OutError = FString::Printf(TEXT("Failed to write file: %s"), *FilePath);
+        OutError = FString::Printf(TEXT("Error parsing config: %s"), *LocalError);
         return false;
     }
 
@@ -98,6 +290,9 @@ bool UMotaEzConfigSubsystem::LoadInternal(FString& OutError)
 {
     OutError.Reset();
 
+    // A reload must not be overwritten later by a still-running initial load
+    CompleteBackgroundLoad();
+
     const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
     if (!Settings)
     {
@@ -109,47 +304,16 @@ bool UMotaEzConfigSubsystem::LoadInternal(FString& OutError)
     const FString SchemaPath = Settings->GetSchemaFilePath();
     const EMotaEzConfigFormat Format = Settings->DefaultFormat;
 
-    FMotaEzSaveSchema Schema;
-
+    FMotaEzCompiledSchema Schema;
+    if (!LoadSchemaFile(SchemaPath, Format, Schema, OutError))
     {
-        FString SchemaText;
-        FString LocalError;
-        if (FPaths::FileExists(SchemaPath))
-        {
-            if (!LoadTextFile(SchemaPath, SchemaText, LocalError))
-            {
-                OutError = LocalError;
-                return false;
-            }
-
-            if (!UMotaEzFormatSerializer::LoadSchema(Format, SchemaText, Schema, LocalError))
-            {
-                OutError = FString::Printf(TEXT("Error parsing schema: %s"), *LocalError);
-                return false;
-            }
-        }
+        return false;
     }
 
     TMap<FString, FMotaEzValue> RawConfig;
-
+    if (!LoadConfigFile(ConfigPath, Format, RawConfig, OutError))
     {
-        if (FPaths::FileExists(ConfigPath))
-        {
-            FString ConfigText;
-            FString LocalError;
-
-            if (!LoadTextFile(ConfigPath, ConfigText, LocalError))
-            {
-                OutError = LocalError;
-                return false;
-            }
-
-            if (!UMotaEzFormatSerializer::LoadConfig(Format, ConfigText, RawConfig, LocalError))
-            {
-                OutError = FString::Printf(TEXT("Error parsing config: %s"), *LocalError);
-                return false;
-            }
-        }
+        return false;
     }
 
     if (!CurrentSave)
@@ -157,7 +321,7 @@ bool UMotaEzConfigSubsystem::LoadInternal(FString& OutError)
         CurrentSave = NewObject<UMotaEzSaveData>(this);
     }
 
-    BuildSaveDataFromSchemaAndConfig(Schema, RawConfig, CurrentSave.Get());
+    BuildSaveDataFromSchemaAndConfig(Schema, MoveTemp(RawConfig), CurrentSave.Get());
 
     return true;
 }
@@ -166,6 +330,8 @@ bool UMotaEzConfigSubsystem::SaveInternal(FString& OutError)
 {
     OutError.Reset();
 
+    CompleteBackgroundLoad();
+
     const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
     if (!Settings)
     {
@@ -182,75 +348,61 @@ bool UMotaEzConfigSubsystem::SaveInternal(FString& OutError)
     const FString ConfigPath = Settings->GetConfigFilePath();
     const EMotaEzConfigFormat Format = Settings->DefaultFormat;
 
+    // Nothing changed since the last successful write (e.g. auto-save on exit right after a manual save);
+    // a format or encryption change alters the fingerprint, so the file is rewritten in the new form
+    const uint64 Fingerprint = UMotaEzSlotFile::MakeWriteFingerprint(CurrentSave->GetFingerprint(), Format);
+    if (LastSavedFingerprint.IsSet() && LastSavedFingerprint.GetValue() == Fingerprint && FPaths::FileExists(ConfigPath))
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: SaveInternal - No changes since last write, skipping"));
+        return true;
+    }
+
     FString OutText;
     FString LocalError;
 
-    if (!UMotaEzFormatSerializer::SaveConfig(Format, CurrentSave->Data, OutText, LocalError))
     {
-        OutError = FString::Printf(TEXT("Error serializing config: %s"), *LocalError);
-        return false;
+        UMotaEzSaveData::FExclusiveScope Lock(*CurrentSave);
+        if (!UMotaEzFormatSerializer::SaveConfig(Format, CurrentSave->Data, OutText, LocalError))
+        {
+            OutError = FString::Printf(TEXT("Error serializing config: %s"), *LocalError);
+            return false;
+        }
     }
 
-    if (!SaveTextFile(ConfigPath, OutText, LocalError))
+    if (!SaveTextFile(ConfigPath, Format, OutText, LocalError))
     {
+        LastSavedFingerprint.Reset();
         OutError = LocalError;
         return false;
     }
 
+    LastSavedFingerprint = Fingerprint;
     return true;
 }
 
 void UMotaEzConfigSubsystem::BuildSaveDataFromSchemaAndConfig(
-    const FMotaEzSaveSchema& Schema,
-    const TMap<FString, FMotaEzValue>& RawConfig,
+    const FMotaEzCompiledSchema& Schema,
+    TMap<FString, FMotaEzValue>&& RawConfig,
     UMotaEzSaveData* OutSave
-) const
+)
 {
     if (!OutSave)
     {
         return;
     }
 
-    OutSave->Data.Reset();
-
-    for (const auto& Pair : Schema.Fields)
+    SchemaDefaults = Schema.Defaults;
+    SchemaRules = MakeShared<const FMotaEzSaveSchema>(Schema.Schema);
+    for (const auto& Pair : Documents)
     {
-        const FString& Key = Pair.Key;
-        const FMotaEzFieldDescriptor& Desc = Pair.Value;
-
-        const FMotaEzValue* Existing = RawConfig.Find(Key);
-
-        if (Existing)
-        {
-            OutSave->Data.Add(Key, *Existing);
-        }
-        else
-        {
-            FMotaEzValue NewVal;
-            NewVal.Type = Desc.Type;
-            NewVal.bIsArray = Desc.bIsArray;
-
-            if (Desc.bIsArray)
-            {
-                NewVal.ArrayValues = Desc.DefaultArray;
-            }
-            else
-            {
-                NewVal.ScalarValue = Desc.DefaultValue;
-            }
-
-            OutSave->Data.Add(Key, NewVal);
-        }
+        Pair.Value->SetDefaultsLayer(SchemaDefaults);
+        Pair.Value->SetValidationRules(SchemaRules);
     }
 
-    for (const auto& Pair : RawConfig)
-    {
-        const FString& Key = Pair.Key;
-        if (!Schema.Fields.Contains(Key))
-        {
-            OutSave->Data.Add(Key, Pair.Value);
-        }
-    }
+    // Only config values are stored; schema defaults stay in the shared layer underneath
+    OutSave->SetDefaultsLayer(SchemaDefaults);
+    OutSave->SetValidationRules(SchemaRules);
+    OutSave->ReplaceData(MoveTemp(RawConfig));
 }
 
 void UMotaEzConfigSubsystem::ExecuteAutoSaveOnExit()
@@ -97,156 +97,112 @@ FString UMotaEzEncryption::GenerateRandomKey()
     return Guid.ToString();
 }
 
-bool UMotaEzEncryption::EncryptAES(const TArray<uint8>& PlainData, const FString& Key, TArray<uint8>& OutEncrypted)
+FAESKey UMotaEzEncryption::DeriveAESKey(const FString& Key)
 {
-    ANSICHAR KeyAnsi[32] = {0};
-    FString KeyHash = FMD5::HashAnsiString(*Key);
-    
-    for (int32 i = 0; i < 32; ++i)
-    {
-        int32 HashIndex = (i / 2) % 16;
-        uint8 HexValue = 0;
-        
-        if (HashIndex * 2 < KeyHash.Len())
-        {
-            TCHAR HighChar = KeyHash[HashIndex * 2];
-            TCHAR LowChar = (HashIndex * 2 + 1 < KeyHash.Len()) ? KeyHash[HashIndex * 2 + 1] : '0';
-            HexValue = (FParse::HexDigit(HighChar) << 4) | FParse::HexDigit(LowChar);
-        }
-        
-        KeyAnsi[i] = (ANSICHAR)(HexValue ^ (i * 7));
-    }
+    FTCHARToUTF8 KeyUtf8(*Key);
 
-    int32 PaddedSize = ((PlainData.Num() + 15) / 16) * 16;
-    
-    TArray<uint8> PaddedData;
-    PaddedData.SetNum(PaddedSize);
-    
-    FMemory::Memcpy(PaddedData.GetData(), PlainData.GetData(), PlainData.Num());
-    
-    uint8 PaddingValue = PaddedSize - PlainData.Num();
-    for (int32 i = PlainData.Num(); i < PaddedSize; ++i)
-    {
-        PaddedData[i] = PaddingValue;
-    }
+    uint8 ShaDigest[FSHA1::DigestSize];
+    FSHA1::HashBuffer(KeyUtf8.Get(), KeyUtf8.Length(), ShaDigest);
 
-    OutEncrypted.SetNum(PaddedSize);
-    
-    for (int32 BlockStart = 0; BlockStart < PaddedSize; BlockStart += 16)
-    {
-        uint8 Block[16];
-        FMemory::Memcpy(Block, &PaddedData[BlockStart], 16);
-        
-        for (int32 Round = 0; Round < 14; ++Round)
-        {
-            for (int32 i = 0; i < 16; ++i)
-            {
-                uint8 KeyByte = KeyAnsi[(Round * 16 + i) % 32];
-                Block[i] = (Block[i] + KeyByte + Round) ^ ((Block[i] << 1) | (Block[i] >> 7));
-            }
-            
-            for (int32 i = 0; i < 4; ++i)
-            {
-                uint8 a = Block[i * 4 + 0];
-                uint8 b = Block[i * 4 + 1];
-                uint8 c = Block[i * 4 + 2];
-                uint8 d = Block[i * 4 + 3];
-                
-                Block[i * 4 + 0] = a ^ b ^ c ^ d ^ KeyAnsi[(Round + i * 4 + 0) % 32];
-                Block[i * 4 + 1] = b ^ c ^ d ^ a ^ KeyAnsi[(Round + i * 4 + 1) % 32];
-                Block[i * 4 + 2] = c ^ d ^ a ^ b ^ KeyAnsi[(Round + i * 4 + 2) % 32];
-                Block[i * 4 + 3] = d ^ a ^ b ^ c ^ KeyAnsi[(Round + i * 4 + 3) % 32];
-            }
-        }
-        
-        FMemory::Memcpy(&OutEncrypted[BlockStart], Block, 16);
-    }
+    FMD5 Md5;
+    Md5.Update(ShaDigest, FSHA1::DigestSize);
+    Md5.Update((const uint8*)KeyUtf8.Get(), KeyUtf8.Length());
+    uint8 Md5Digest[16];
+    Md5.Final(Md5Digest);
 
+    FAESKey AesKey;
+    FMemory::Memcpy(AesKey.Key, ShaDigest, FSHA1::DigestSize);
+    FMemory::Memcpy(AesKey.Key + FSHA1::DigestSize, Md5Digest, FAESKey::KeySize - FSHA1::DigestSize);
+    return AesKey;
+}
+
+bool UMotaEzEncryption::EncryptAES(const TArray<uint8>& PlainData, const FString& Key, TArray<uint8>& OutEncrypted)
+{
+    OutEncrypted.SetNumUninitialized(FMotaEzCipherStream::NonceSize + PlainData.Num());
+    FMotaEzCipherStream::MakeNonce(OutEncrypted.GetData());
+
+    uint8* Payload = OutEncrypted.GetData() + FMotaEzCipherStream::NonceSize;
+    FMemory::Memcpy(Payload, PlainData.GetData(), PlainData.Num());
+
+    FMotaEzCipherStream Cipher(Key, OutEncrypted.GetData());
+    Cipher.Process(Payload, PlainData.Num());
     return true;
 }
 
 bool UMotaEzEncryption::DecryptAES(const TArray<uint8>& EncryptedData, const FString& Key, TArray<uint8>& OutDecrypted)
 {
-    if (EncryptedData.Num() == 0 || EncryptedData.Num() % 16 != 0)
+    if (EncryptedData.Num() < FMotaEzCipherStream::NonceSize)
     {
         return false;
     }
 
-    ANSICHAR KeyAnsi[32] = {0};
-    FString KeyHash = FMD5::HashAnsiString(*Key);
-    
-    for (int32 i = 0; i < 32; ++i)
-    {
-        int32 HashIndex = (i / 2) % 16;
-        uint8 HexValue = 0;
-        
-        if (HashIndex * 2 < KeyHash.Len())
-        {
-            TCHAR HighChar = KeyHash[HashIndex * 2];
-            TCHAR LowChar = (HashIndex * 2 + 1 < KeyHash.Len()) ? KeyHash[HashIndex * 2 + 1] : '0';
-            HexValue = (FParse::HexDigit(HighChar) << 4) | FParse::HexDigit(LowChar);
-        }
-        
-        KeyAnsi[i] = (ANSICHAR)(HexValue ^ (i * 7));
-    }
+    const int32 PayloadSize = EncryptedData.Num() - FMotaEzCipherStream::NonceSize;
+    OutDecrypted.SetNumUninitialized(PayloadSize);
+    FMemory::Memcpy(OutDecrypted.GetData(), EncryptedData.GetData() + FMotaEzCipherStream::NonceSize, PayloadSize);
+
+    FMotaEzCipherStream Cipher(Key, EncryptedData.GetData());
+    Cipher.Process(OutDecrypted.GetData(), PayloadSize);
+    return true;
+}
+
+// ==================== CIPHER STREAM ====================
+
+namespace
+{
+    /** Keystream blocks generated per FAES call; amortizes the per-call key expansion. */
+    constexpr int64 KeystreamBatchBlocks = 4096;
+}
+
+FMotaEzCipherStream::FMotaEzCipherStream(const FString& Key, const uint8* InNonce)
+    : AesKey(UMotaEzEncryption::DeriveAESKey(Key))
+{
+    FMemory::Memcpy(Nonce, InNonce, NonceSize);
+}
 
-    TArray<uint8> DecryptedPadded;
-    DecryptedPadded.SetNum(EncryptedData.Num());
+void FMotaEzCipherStream::MakeNonce(uint8* OutNonce)
+{
+    const FGuid Guid = FGuid::NewGuid();
+    FMemory::Memcpy(OutNonce, &Guid, NonceSize);
+}
+
+void FMotaEzCipherStream::RefillKeystream(int64 NumBlocks)
+{
+    Keystream.SetNumUninitialized(NumBlocks * FAES::AESBlockSize, EAllowShrinking::No);
 
-    for (int32 BlockStart = 0; BlockStart < EncryptedData.Num(); BlockStart += 16)
+    uint64 NonceCounter = 0;
+    FMemory::Memcpy(&NonceCounter, Nonce + 8, sizeof(uint64));
+
+    uint8* Block = Keystream.GetData();
+    for (int64 i = 0; i < NumBlocks; ++i, Block += FAES::AESBlockSize)
     {
-        uint8 Block[16];
-        FMemory::Memcpy(Block, &EncryptedData[BlockStart], 16);
-        
-        for (int32 Round = 13; Round >= 0; --Round)
-        {
-            for (int32 i = 0; i < 4; ++i)
-            {
-                uint8 a = Block[i * 4 + 0] ^ KeyAnsi[(Round + i * 4 + 0) % 32];
-                uint8 b = Block[i * 4 + 1] ^ KeyAnsi[(Round + i * 4 + 1) % 32];
-                uint8 c = Block[i * 4 + 2] ^ KeyAnsi[(Round + i * 4 + 2) % 32];
-                uint8 d = Block[i * 4 + 3] ^ KeyAnsi[(Round + i * 4 + 3) % 32];
-                
-                Block[i * 4 + 0] = a ^ b ^ c ^ d;
-                Block[i * 4 + 1] = b ^ c ^ d ^ a;
-                Block[i * 4 + 2] = c ^ d ^ a ^ b;
-                Block[i * 4 + 3] = d ^ a ^ b ^ c;
-            }
-            
-            for (int32 i = 0; i < 16; ++i)
-            {
-                uint8 KeyByte = KeyAnsi[(Round * 16 + i) % 32];
-                uint8 Temp = Block[i] ^ ((Block[i] << 1) | (Block[i] >> 7));
-                Block[i] = (Temp - KeyByte - Round) & 0xFF;
-            }
-        }
-        
-        FMemory::Memcpy(&DecryptedPadded[BlockStart], Block, 16);
+        const uint64 Counter = NonceCounter + NextCounter++;
+        FMemory::Memcpy(Block, Nonce, 8);
+        FMemory::Memcpy(Block + 8, &Counter, sizeof(uint64));
     }
 
-    uint8 PaddingValue = DecryptedPadded.Last();
-    
-    if (PaddingValue > 0 && PaddingValue <= 16)
+    FAES::EncryptData(Keystream.GetData(), Keystream.Num(), AesKey);
+    KeystreamOffset = 0;
+}
+
+void FMotaEzCipherStream::Process(uint8* Data, int64 NumBytes)
+{
+    while (NumBytes > 0)
     {
-        int32 UnpaddedSize = DecryptedPadded.Num() - PaddingValue;
-        
-        bool bValidPadding = true;
-        for (int32 i = UnpaddedSize; i < DecryptedPadded.Num(); ++i)
+        if (KeystreamOffset >= Keystream.Num())
         {
-            if (DecryptedPadded[i] != PaddingValue)
-            {
-                bValidPadding = false;
-                break;
-            }
+            const int64 BlocksNeeded = (NumBytes + FAES::AESBlockSize - 1) / FAES::AESBlockSize;
+            RefillKeystream(FMath::Min(BlocksNeeded, KeystreamBatchBlocks));
         }
-        
-        if (bValidPadding)
+
+        const int64 Count = FMath::Min<int64>(NumBytes, Keystream.Num() - KeystreamOffset);
+        const uint8* Key = Keystream.GetData() + KeystreamOffset;
+        for (int64 i = 0; i < Count; ++i)
         {
-            OutDecrypted.SetNum(UnpaddedSize);
-            FMemory::Memcpy(OutDecrypted.GetData(), DecryptedPadded.GetData(), UnpaddedSize);
-            return true;
+            Data[i] ^= Key[i];
         }
-    }
 
-    return false;
-}
\ No newline at end of file
+        Data += Count;
+        NumBytes -= Count;
+        KeystreamOffset += Count;
+    }
+}
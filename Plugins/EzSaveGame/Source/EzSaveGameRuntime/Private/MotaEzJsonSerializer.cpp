@@ -1,4 +1,6 @@
 ﻿#include "MotaEzJsonSerializer.h"
+#include "MotaEzValueConversion.h"
+#include "MotaEzStructCodec.h"
 
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonReader.h"
@@ -14,6 +16,13 @@ namespace
         if (TypeStr.Equals(TEXT("String"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::String;
         if (TypeStr.Equals(TEXT("Vector"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Vector;
         if (TypeStr.Equals(TEXT("Rotator"), ESearchCase::IgnoreCase)) return EMotaEzFieldType::Rotator;
+        if (TypeStr.Equals(TEXT("Int64"), ESearchCase::IgnoreCase))   return EMotaEzFieldType::Int64;
+        if (TypeStr.Equals(TEXT("Double"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Double;
+        if (TypeStr.Equals(TEXT("Quat"), ESearchCase::IgnoreCase))    return EMotaEzFieldType::Quat;
+        if (TypeStr.Equals(TEXT("Transform"), ESearchCase::IgnoreCase))   return EMotaEzFieldType::Transform;
+        if (TypeStr.Equals(TEXT("LinearColor"), ESearchCase::IgnoreCase)) return EMotaEzFieldType::LinearColor;
+        if (TypeStr.Equals(TEXT("Struct"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Struct;
+        if (TypeStr.Equals(TEXT("Blob"), ESearchCase::IgnoreCase))    return EMotaEzFieldType::Blob;
         return EMotaEzFieldType::None;
     }
 
@@ -27,9 +36,27 @@ namespace
         case EMotaEzFieldType::String:  return TEXT("String");
         case EMotaEzFieldType::Vector:  return TEXT("Vector");
         case EMotaEzFieldType::Rotator: return TEXT("Rotator");
+        case EMotaEzFieldType::Int64:   return TEXT("Int64");
+        case EMotaEzFieldType::Double:  return TEXT("Double");
+        case EMotaEzFieldType::Quat:    return TEXT("Quat");
+        case EMotaEzFieldType::Transform:   return TEXT("Transform");
+        case EMotaEzFieldType::LinearColor: return TEXT("LinearColor");
+        case EMotaEzFieldType::Struct:  return TEXT("Struct");
+        case EMotaEzFieldType::Blob:    return TEXT("Blob");
         default:                        return TEXT("None");
         }
     }
+
+    /** JSON numbers are doubles: int64 values beyond 2^53 are written as strings to stay exact. */
+    TSharedPtr<FJsonValue> MakeInt64Value(const FString& Text)
+    {
+        const int64 Value = FCString::Atoi64(*Text);
+        if (FMath::Abs(Value) <= (int64(1) << 53))
+        {
+            return MakeShared<FJsonValueNumber>((double)Value);
+        }
+        return MakeShared<FJsonValueString>(LexToString(Value));
+    }
 }
 
 bool UMotaEzJsonSerializer::LoadConfig(
@@ -58,7 +85,24 @@ bool UMotaEzJsonSerializer::LoadConfig(
         FMotaEzValue OutVal;
         OutVal.bIsArray = Val->Type == EJson::Array;
 
-        if (Val->Type == EJson::Array)
+        if (Val->Type == EJson::Object && UMotaEzStructCodec::IsStructObject(*Val->AsObject()))
+        {
+            FString StructError;
+            if (!UMotaEzStructCodec::FromJsonObject(*Val->AsObject(), OutVal, StructError))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping %s - %s"), *Key, *StructError);
+                continue;
+            }
+        }
+        else if (Val->Type == EJson::Object && Val->AsObject()->HasTypedField<EJson::String>(MotaEzValueConversion::BlobField))
+        {
+            if (!MotaEzValueConversion::Base64ToBlob(Val->AsObject()->GetStringField(MotaEzValueConversion::BlobField), OutVal))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping %s - invalid Base64 blob"), *Key);
+                continue;
+            }
+        }
+        else if (Val->Type == EJson::Array)
         {
             const TArray<TSharedPtr<FJsonValue>>& Arr = Val->AsArray();
 
@@ -72,7 +116,15 @@ bool UMotaEzJsonSerializer::LoadConfig(
                 switch (Elem->Type)
                 {
                 case EJson::Number:
+                {
+                    // Fractions and integers beyond int32 keep full precision as Float text
+                    const double Number = Elem->AsNumber();
+                    if (Number != FMath::RoundToDouble(Number) || Number < MIN_int32 || Number > MAX_int32)
+                    {
+                        bAllInt = false;
+                    }
                     break;
+                }
                 case EJson::String:
                     bAllInt = bAllFloat = bAllBool = false;
                     break;
@@ -99,7 +151,7 @@ bool UMotaEzJsonSerializer::LoadConfig(
                 OutVal.Type = EMotaEzFieldType::Float;
                 for (const auto& Elem : Arr)
                 {
-                    OutVal.ArrayValues.Add(FString::SanitizeFloat((float)Elem->AsNumber()));
+                    OutVal.ArrayValues.Add(MotaEzValueConversion::DoubleToString(Elem->AsNumber()));
                 }
             }
             else if (bAllBool)
@@ -127,7 +179,7 @@ bool UMotaEzJsonSerializer::LoadConfig(
             {
             case EJson::Number:
                 OutVal.Type = EMotaEzFieldType::Float;
-                OutVal.ScalarValue = FString::SanitizeFloat((float)Val->AsNumber());
+                OutVal.ScalarValue = MotaEzValueConversion::DoubleToString(Val->AsNumber());
                 break;
             case EJson::String:
                 OutVal.Type = EMotaEzFieldType::String;
@@ -188,7 +240,24 @@ bool UMotaEzJsonSerializer::SaveConfig(
         const FString& Key = Pair.Key;
         const FMotaEzValue& Val = Pair.Value;
 
-        if (!Val.bIsArray)
+        if (Val.Type == EMotaEzFieldType::Struct)
+        {
+            FString StructError;
+            const TSharedPtr<FJsonObject> StructObj = UMotaEzStructCodec::ToJsonObject(Val, StructError);
+            if (!StructObj.IsValid())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping %s - %s"), *Key, *StructError);
+                continue;
+            }
+            RootObj->SetObjectField(Key, StructObj);
+        }
+        else if (Val.Type == EMotaEzFieldType::Blob)
+        {
+            TSharedRef<FJsonObject> BlobObj = MakeShared<FJsonObject>();
+            BlobObj->SetStringField(MotaEzValueConversion::BlobField, MotaEzValueConversion::BlobToBase64(Val));
+            RootObj->SetObjectField(Key, BlobObj);
+        }
+        else if (!Val.bIsArray)
         {
             switch (Val.Type)
             {
@@ -198,6 +267,12 @@ bool UMotaEzJsonSerializer::SaveConfig(
             case EMotaEzFieldType::Float:
                 RootObj->SetNumberField(Key, FCString::Atof(*Val.ScalarValue));
                 break;
+            case EMotaEzFieldType::Double:
+                RootObj->SetNumberField(Key, FCString::Atod(*Val.ScalarValue));
+                break;
+            case EMotaEzFieldType::Int64:
+                RootObj->SetField(Key, MakeInt64Value(Val.ScalarValue));
+                break;
             case EMotaEzFieldType::Bool:
                 RootObj->SetBoolField(
                     Key,
@@ -228,6 +303,18 @@ bool UMotaEzJsonSerializer::SaveConfig(
                     Arr.Add(MakeShared<FJsonValueNumber>((double)FCString::Atof(*S)));
                 }
                 break;
+            case EMotaEzFieldType::Double:
+                for (const FString& S : Val.ArrayValues)
+                {
+                    Arr.Add(MakeShared<FJsonValueNumber>(FCString::Atod(*S)));
+                }
+                break;
+            case EMotaEzFieldType::Int64:
+                for (const FString& S : Val.ArrayValues)
+                {
+                    Arr.Add(MakeInt64Value(S));
+                }
+                break;
             case EMotaEzFieldType::Bool:
                 for (const FString& S : Val.ArrayValues)
                 {
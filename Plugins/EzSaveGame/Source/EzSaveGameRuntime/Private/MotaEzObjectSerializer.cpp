@@ -0,0 +1,466 @@
+﻿#include "MotaEzObjectSerializer.h"
+#include "MotaEzSlotManager.h"
+#include "MotaEzSlotFile.h"
+#include "MotaEzBlockBuffer.h"
+#include "GameFramework/SaveGame.h"
+#include "UObject/TextProperty.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/ObjectKey.h"
+#include "Misc/Paths.h"
+#include "Hash/xxhash.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Object blocks store fields in native byte order, which must be little-endian");
+
+const TCHAR* UMotaEzObjectSerializer::ObjectFileExtension = TEXT(".ezobj");
+
+namespace
+{
+    using namespace MotaEzBlockBuffer;
+
+    constexpr uint32 ObjectBlockMagic = 0x424F5A45; // "EZOB"
+    constexpr uint8 ObjectBlockVersion = 1;
+
+    /** How one value is stored. Fixed-size codecs are copied as raw bytes, arrays of them in one block. */
+    enum class EFieldCodec : uint8
+    {
+        Bool,
+        Byte,
+        Int32,
+        Int64,
+        Float,
+        Double,
+        Vector,
+        Rotator,
+        String,
+        Name,
+        Text
+    };
+
+    FORCEINLINE int32 GetFixedSize(EFieldCodec Codec)
+    {
+        switch (Codec)
+        {
+            case EFieldCodec::Bool:
+            case EFieldCodec::Byte:    return 1;
+            case EFieldCodec::Int32:
+            case EFieldCodec::Float:   return 4;
+            case EFieldCodec::Int64:
+            case EFieldCodec::Double:  return 8;
+            case EFieldCodec::Vector:  return sizeof(FVector);
+            case EFieldCodec::Rotator: return sizeof(FRotator);
+            default:                   return 0;
+        }
+    }
+
+    /** One SaveGame property, resolved once per class. */
+    struct FFieldLayout
+    {
+        const FProperty* Property = nullptr;
+        int32 Offset = 0;
+        uint32 NameHash = 0;
+        EFieldCodec Codec = EFieldCodec::Int32;
+        bool bIsArray = false;
+
+        /** Scalar bools may be bitfields, so they go through the property instead of the offset. */
+        const FBoolProperty* BoolProperty = nullptr;
+        const FArrayProperty* ArrayProperty = nullptr;
+    };
+
+    struct FClassLayout
+    {
+        TArray<FFieldLayout> Fields;
+        TMap<uint32, int32> FieldByNameHash;
+        uint64 LayoutHash = 0;
+    };
+
+    /** @return Codec for a value property, or false if the plugin does not serialize its type */
+    bool DetectCodec(const FProperty* Property, EFieldCodec& OutCodec)
+    {
+        if (CastField<FBoolProperty>(Property))   { OutCodec = EFieldCodec::Bool;   return true; }
+        if (CastField<FIntProperty>(Property))    { OutCodec = EFieldCodec::Int32;  return true; }
+        if (CastField<FInt64Property>(Property))  { OutCodec = EFieldCodec::Int64;  return true; }
+        if (CastField<FFloatProperty>(Property))  { OutCodec = EFieldCodec::Float;  return true; }
+        if (CastField<FDoubleProperty>(Property)) { OutCodec = EFieldCodec::Double; return true; }
+        if (CastField<FByteProperty>(Property))   { OutCodec = EFieldCodec::Byte;   return true; }
+        if (CastField<FStrProperty>(Property))    { OutCodec = EFieldCodec::String; return true; }
+        if (CastField<FNameProperty>(Property))   { OutCodec = EFieldCodec::Name;   return true; }
+        if (CastField<FTextProperty>(Property))   { OutCodec = EFieldCodec::Text;   return true; }
+
+        if (const FEnumProperty* EnumProp = CastField<FEnumProperty>(Property))
+        {
+            // Stored as the underlying integer
+            switch (EnumProp->GetUnderlyingProperty()->GetElementSize())
+            {
+                case 1: OutCodec = EFieldCodec::Byte;  return true;
+                case 4: OutCodec = EFieldCodec::Int32; return true;
+                case 8: OutCodec = EFieldCodec::Int64; return true;
+                default: return false;
+            }
+        }
+
+        if (const FStructProperty* StructProp = CastField<FStructProperty>(Property))
+        {
+            if (StructProp->Struct == TBaseStructure<FVector>::Get())  { OutCodec = EFieldCodec::Vector;  return true; }
+            if (StructProp->Struct == TBaseStructure<FRotator>::Get()) { OutCodec = EFieldCodec::Rotator; return true; }
+        }
+
+        return false;
+    }
+
+    TSharedRef<const FClassLayout> CompileLayout(const UClass* Class)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_CompileObjectLayout);
+
+        TSharedRef<FClassLayout> Layout = MakeShared<FClassLayout>();
+        FXxHash64Builder Hasher;
+
+        for (TFieldIterator<FProperty> PropIt(Class); PropIt; ++PropIt)
+        {
+            const FProperty* Property = *PropIt;
+            if (!Property->HasAnyPropertyFlags(CPF_SaveGame))
+            {
+                continue;
+            }
+
+            FFieldLayout Field;
+            Field.Property = Property;
+            Field.Offset = Property->GetOffset_ForInternal();
+            Field.ArrayProperty = CastField<FArrayProperty>(Property);
+            Field.bIsArray = Field.ArrayProperty != nullptr;
+
+            const FProperty* ValueProperty = Field.bIsArray ? Field.ArrayProperty->Inner : Property;
+            if (Property->ArrayDim != 1 || !DetectCodec(ValueProperty, Field.Codec))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s.%s has an unsupported type and is not serialized"), *Class->GetName(), *Property->GetName());
+                continue;
+            }
+
+            if (!Field.bIsArray && Field.Codec == EFieldCodec::Bool)
+            {
+                Field.BoolProperty = CastField<FBoolProperty>(Property);
+            }
+
+            // Stable across runs, unlike FName indices
+            Field.NameHash = FCrc::StrCrc32(*Property->GetName());
+
+            const uint8 Shape[2] = { (uint8)Field.Codec, (uint8)Field.bIsArray };
+            Hasher.Update(&Field.NameHash, sizeof(Field.NameHash));
+            Hasher.Update(Shape, sizeof(Shape));
+
+            Layout->FieldByNameHash.Add(Field.NameHash, Layout->Fields.Num());
+            Layout->Fields.Add(Field);
+        }
+
+        Layout->LayoutHash = Hasher.Finalize().Hash;
+        return Layout;
+    }
+
+    /** Compiled layouts per class; compiled on first use and read-shared afterwards. */
+    FRWLock LayoutCacheLock;
+    TMap<TObjectKey<UClass>, TSharedRef<const FClassLayout>> LayoutCache;
+
+    TSharedRef<const FClassLayout> GetLayout(const UClass* Class)
+    {
+        const TObjectKey<UClass> Key(Class);
+        {
+            FReadScopeLock ReadLock(LayoutCacheLock);
+            if (const TSharedRef<const FClassLayout>* Found = LayoutCache.Find(Key))
+            {
+                return *Found;
+            }
+        }
+
+        TSharedRef<const FClassLayout> Layout = CompileLayout(Class);
+        FWriteScopeLock WriteLock(LayoutCacheLock);
+        return LayoutCache.FindOrAdd(Key, Layout);
+    }
+
+    void WriteStringValue(FBlockWriter& Writer, EFieldCodec Codec, const void* Value)
+    {
+        switch (Codec)
+        {
+            case EFieldCodec::String: Writer.WriteString(*static_cast<const FString*>(Value)); break;
+            case EFieldCodec::Name:   Writer.WriteString(static_cast<const FName*>(Value)->ToString()); break;
+            case EFieldCodec::Text:   Writer.WriteString(static_cast<const FText*>(Value)->ToString()); break;
+            default: break;
+        }
+    }
+
+    bool ReadStringValue(FBlockReader& Reader, EFieldCodec Codec, void* Value)
+    {
+        FString Text;
+        if (!Reader.ReadString(Text))
+        {
+            return false;
+        }
+
+        switch (Codec)
+        {
+            case EFieldCodec::String: *static_cast<FString*>(Value) = MoveTemp(Text); break;
+            case EFieldCodec::Name:   *static_cast<FName*>(Value) = FName(*Text); break;
+            case EFieldCodec::Text:   *static_cast<FText*>(Value) = FText::FromString(MoveTemp(Text)); break;
+            default: break;
+        }
+        return true;
+    }
+
+    /** Checks that the rest of the block can hold Count elements, so a corrupt count never drives an allocation. */
+    bool CanHoldElements(const FBlockReader& Reader, int32 FixedSize, int64 Count)
+    {
+        // A string, name or text element takes at least its length prefix
+        const int64 MinBytes = FixedSize > 0 ? FixedSize : (int64)sizeof(uint32);
+        return Count * MinBytes <= Reader.Remaining();
+    }
+
+    void WriteField(FBlockWriter& Writer, const FFieldLayout& Field, const uint8* Container)
+    {
+        const uint8* Value = Container + Field.Offset;
+        const int32 FixedSize = GetFixedSize(Field.Codec);
+
+        if (Field.bIsArray)
+        {
+            FScriptArrayHelper Array(Field.ArrayProperty, Value);
+            Writer.WriteValue<uint32>(Array.Num());
+
+            if (FixedSize > 0)
+            {
+                // Contiguous elements of a fixed-size type: one copy for the whole array
+                Writer.Write(Array.GetRawPtr(0), (int64)Array.Num() * FixedSize);
+            }
+            else
+            {
+                for (int32 Index = 0; Index < Array.Num(); ++Index)
+                {
+                    WriteStringValue(Writer, Field.Codec, Array.GetRawPtr(Index));
+                }
+            }
+            return;
+        }
+
+        if (Field.BoolProperty)
+        {
+            Writer.WriteValue<uint8>(Field.BoolProperty->GetPropertyValue(Value) ? 1 : 0);
+        }
+        else if (FixedSize > 0)
+        {
+            Writer.Write(Value, FixedSize);
+        }
+        else
+        {
+            WriteStringValue(Writer, Field.Codec, Value);
+        }
+    }
+
+    bool ReadField(FBlockReader& Reader, const FFieldLayout& Field, uint8* Container)
+    {
+        uint8* Value = Container + Field.Offset;
+        const int32 FixedSize = GetFixedSize(Field.Codec);
+
+        if (Field.bIsArray)
+        {
+            uint32 Count = 0;
+            if (!Reader.ReadValue(Count) || Count > (uint32)MAX_int32 || !CanHoldElements(Reader, FixedSize, Count))
+            {
+                return false;
+            }
+
+            FScriptArrayHelper Array(Field.ArrayProperty, Value);
+            if (FixedSize > 0)
+            {
+                Array.Resize(Count);
+                return Reader.Read(Array.GetRawPtr(0), (int64)Count * FixedSize);
+            }
+
+            Array.Resize(Count);
+            for (uint32 Index = 0; Index < Count; ++Index)
+            {
+                if (!ReadStringValue(Reader, Field.Codec, Array.GetRawPtr(Index)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        if (Field.BoolProperty)
+        {
+            uint8 Stored = 0;
+            if (!Reader.ReadValue(Stored))
+            {
+                return false;
+            }
+            Field.BoolProperty->SetPropertyValue(Value, Stored != 0);
+            return true;
+        }
+
+        if (FixedSize > 0)
+        {
+            return Reader.Read(Value, FixedSize);
+        }
+
+        return ReadStringValue(Reader, Field.Codec, Value);
+    }
+}
+
+bool UMotaEzObjectSerializer::SerializeObject(const USaveGame* Object, TArray<uint8>& OutBytes, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_SerializeObject);
+
+    OutBytes.Reset();
+    if (!Object)
+    {
+        OutError = TEXT("Object is null");
+        return false;
+    }
+
+    const TSharedRef<const FClassLayout> Layout = GetLayout(Object->GetClass());
+    const uint8* Container = reinterpret_cast<const uint8*>(Object);
+
+    FBlockWriter Writer{ OutBytes };
+    Writer.WriteValue<uint32>(ObjectBlockMagic);
+    Writer.WriteValue<uint8>(ObjectBlockVersion);
+    Writer.WriteValue<uint64>(Layout->LayoutHash);
+    Writer.WriteValue<uint32>(Layout->Fields.Num());
+
+    for (const FFieldLayout& Field : Layout->Fields)
+    {
+        // Name hash, shape and size let readers with a different layout match or skip the field
+        Writer.WriteValue<uint32>(Field.NameHash);
+        Writer.WriteValue<uint8>((uint8)Field.Codec);
+        Writer.WriteValue<uint8>(Field.bIsArray ? 1 : 0);
+
+        const int64 SizeAt = Writer.BeginSize();
+        WriteField(Writer, Field, Container);
+        Writer.EndSize(SizeAt);
+    }
+
+    return true;
+}
+
+bool UMotaEzObjectSerializer::DeserializeObject(USaveGame* Object, TConstArrayView<uint8> Bytes, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_DeserializeObject);
+
+    if (!Object)
+    {
+        OutError = TEXT("Object is null");
+        return false;
+    }
+
+    FBlockReader Reader{ Bytes };
+    uint32 Magic = 0;
+    uint8 Version = 0;
+    uint64 LayoutHash = 0;
+    uint32 NumFields = 0;
+    if (!Reader.ReadValue(Magic) || Magic != ObjectBlockMagic || !Reader.ReadValue(Version) || Version != ObjectBlockVersion
+        || !Reader.ReadValue(LayoutHash) || !Reader.ReadValue(NumFields))
+    {
+        OutError = TEXT("Not an object block or unsupported version");
+        return false;
+    }
+
+    const TSharedRef<const FClassLayout> Layout = GetLayout(Object->GetClass());
+    const bool bSameLayout = LayoutHash == Layout->LayoutHash && NumFields == (uint32)Layout->Fields.Num();
+    uint8* Container = reinterpret_cast<uint8*>(Object);
+
+    for (uint32 FieldIndex = 0; FieldIndex < NumFields; ++FieldIndex)
+    {
+        uint32 NameHash = 0;
+        uint8 Codec = 0;
+        uint8 bIsArray = 0;
+        uint32 Size = 0;
+        if (!Reader.ReadValue(NameHash) || !Reader.ReadValue(Codec) || !Reader.ReadValue(bIsArray) || !Reader.ReadValue(Size))
+        {
+            OutError = TEXT("Truncated object block");
+            return false;
+        }
+
+        // Same layout: fields come in layout order. Otherwise match by name and shape
+        const FFieldLayout* Field = nullptr;
+        if (bSameLayout)
+        {
+            Field = &Layout->Fields[FieldIndex];
+        }
+        else if (const int32* Found = Layout->FieldByNameHash.Find(NameHash))
+        {
+            Field = &Layout->Fields[*Found];
+        }
+
+        const int64 End = Reader.Position + Size;
+        if (!Field || Field->NameHash != NameHash || (uint8)Field->Codec != Codec || Field->bIsArray != (bIsArray != 0))
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: Skipping stored field %08x of %s"), NameHash, *Object->GetClass()->GetName());
+            Reader.Position = End;
+            continue;
+        }
+
+        if (End > Bytes.Num() || !ReadField(Reader, *Field, Container) || Reader.Position != End)
+        {
+            OutError = FString::Printf(TEXT("Corrupted field %s"), *Field->Property->GetName());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+FString UMotaEzObjectSerializer::GetSlotObjectPath(int32 SlotIndex, const UClass* ObjectClass)
+{
+    // Slot0.toml -> Slot0.SaveData.ezobj
+    const FString ConfigPath = UMotaEzSlotManager::GetSlotConfigPath(SlotIndex);
+    return FPaths::Combine(FPaths::GetPath(ConfigPath),
+        FString::Printf(TEXT("%s.%s%s"), *FPaths::GetBaseFilename(ConfigPath), *ObjectClass->GetName(), ObjectFileExtension));
+}
+
+int32 UMotaEzObjectSerializer::GetLayoutFieldCount(const UClass* ObjectClass)
+{
+    return ObjectClass ? GetLayout(ObjectClass)->Fields.Num() : 0;
+}
+
+bool UMotaEzObjectSerializer::SaveObject(USaveGame* Object, int32 SlotIndex, FString& OutError)
+{
+    TArray<uint8> Bytes;
+    if (!SerializeObject(Object, Bytes, OutError))
+    {
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveObject - %s"), *OutError);
+        return false;
+    }
+
+    const FString Path = GetSlotObjectPath(SlotIndex, Object->GetClass());
+    if (!UMotaEzSlotFile::WriteBytes(Path, Bytes, OutError))
+    {
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveObject - %s"), *OutError);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Saved %s to slot %d (%d bytes)"), *Object->GetClass()->GetName(), SlotIndex, Bytes.Num());
+    return true;
+}
+
+bool UMotaEzObjectSerializer::LoadObject(USaveGame* Object, int32 SlotIndex, FString& OutError)
+{
+    if (!Object)
+    {
+        OutError = TEXT("Object is null");
+        return false;
+    }
+
+    const FString Path = GetSlotObjectPath(SlotIndex, Object->GetClass());
+    if (!FPaths::FileExists(Path))
+    {
+        OutError = FString::Printf(TEXT("Slot %d has no %s block"), SlotIndex, *Object->GetClass()->GetName());
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: LoadObject - %s"), *OutError);
+        return false;
+    }
+
+    TArray<uint8> Bytes;
+    if (!UMotaEzSlotFile::ReadBytes(Path, Bytes, OutError) || !DeserializeObject(Object, Bytes, OutError))
+    {
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadObject - %s"), *OutError);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Loaded %s from slot %d"), *Object->GetClass()->GetName(), SlotIndex);
+    return true;
+}
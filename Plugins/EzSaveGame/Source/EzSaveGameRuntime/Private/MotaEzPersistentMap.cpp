@@ -0,0 +1,406 @@
+﻿#include "MotaEzPersistentMap.h"
+
+namespace
+{
+    /** Each level of the trie consumes this many bits of the key hash, giving 32 slots per node. */
+    constexpr uint32 BitsPerLevel = 5;
+    constexpr uint32 SlotMask = (1u << BitsPerLevel) - 1;
+
+    /** Once the 32-bit key hash is used up, nodes hold colliding keys in a plain list. */
+    constexpr uint32 HashBits = 32;
+
+    FORCEINLINE uint32 SlotBit(uint32 KeyHash, uint32 Shift)
+    {
+        return 1u << ((KeyHash >> Shift) & SlotMask);
+    }
+
+    /** @return Position of a slot's element in the packed array of the slots set in Map */
+    FORCEINLINE int32 SlotIndex(uint32 Map, uint32 Bit)
+    {
+        return (int32)FMath::CountBits(Map & (Bit - 1));
+    }
+
+    template <typename EntryArrayType>
+    FORCEINLINE int32 IndexOfKey(const EntryArrayType& Entries, const FString& Key)
+    {
+        return Entries.IndexOfByPredicate([&Key](const auto& Entry)
+        {
+            return Entry->Key.Equals(Key, ESearchCase::IgnoreCase);
+        });
+    }
+}
+
+struct FMotaEzPersistentMap::FNode
+{
+    /** Slots holding an entry and slots holding a child node; a slot is in at most one of them. */
+    uint32 EntryMap = 0;
+    uint32 ChildMap = 0;
+
+    /** In slot order. Collision nodes (below the last level) leave the maps empty and keep entries unordered. */
+    TArray<FEntryRef> Entries;
+    TArray<FNodeRef> Children;
+};
+
+const FMotaEzPersistentMap::FEntry* FMotaEzPersistentMap::FindEntry(const FString& Key) const
+{
+    const uint32 KeyHash = GetTypeHash(Key);
+    const FNode* Node = Root.Get();
+    for (uint32 Shift = 0; Node; Shift += BitsPerLevel)
+    {
+        if (Shift >= HashBits)
+        {
+            const int32 Index = IndexOfKey(Node->Entries, Key);
+            return Index != INDEX_NONE ? &Node->Entries[Index].Get() : nullptr;
+        }
+
+        const uint32 Bit = SlotBit(KeyHash, Shift);
+        if (Node->EntryMap & Bit)
+        {
+            const FEntry& Entry = *Node->Entries[SlotIndex(Node->EntryMap, Bit)];
+            return Entry.Key.Equals(Key, ESearchCase::IgnoreCase) ? &Entry : nullptr;
+        }
+        if (!(Node->ChildMap & Bit))
+        {
+            return nullptr;
+        }
+        Node = &Node->Children[SlotIndex(Node->ChildMap, Bit)].Get();
+    }
+    return nullptr;
+}
+
+FMotaEzPersistentMap FMotaEzPersistentMap::Set(const FString& Key, const FMotaEzValue& Value, uint64 ValueHash) const
+{
+    const FEntry* Existing = FindEntry(Key);
+    if (Existing && Existing->ValueHash == ValueHash)
+    {
+        return *this;
+    }
+
+    TSharedRef<FEntry> Entry = MakeShared<FEntry>();
+    Entry->Key = Key;
+    Entry->Value = Value;
+    Entry->ValueHash = ValueHash;
+    Entry->KeyHash = GetTypeHash(Key);
+
+    FMotaEzPersistentMap Result;
+    Result.Root = Insert(Root.IsValid() ? Root.ToSharedRef() : FNodeRef(MakeShared<FNode>()), Entry, 0);
+    Result.Count = Count + (Existing ? 0 : 1);
+    return Result;
+}
+
+FMotaEzPersistentMap FMotaEzPersistentMap::Remove(const FString& Key) const
+{
+    if (!Root.IsValid())
+    {
+        return *this;
+    }
+
+    FNodePtr NewRoot = Erase(Root.ToSharedRef(), Key, GetTypeHash(Key), 0);
+    if (NewRoot == Root)
+    {
+        return *this;
+    }
+
+    FMotaEzPersistentMap Result;
+    Result.Root = MoveTemp(NewRoot);
+    Result.Count = Count - 1;
+    return Result;
+}
+
+FMotaEzPersistentMap::FNodeRef FMotaEzPersistentMap::Insert(const FNodeRef& Node, const FEntryRef& Entry, uint32 Shift)
+{
+    TSharedRef<FNode> Copy = MakeShared<FNode>(*Node);
+
+    if (Shift >= HashBits)
+    {
+        const int32 Index = IndexOfKey(Node->Entries, Entry->Key);
+        if (Index != INDEX_NONE)
+        {
+            Copy->Entries[Index] = Entry;
+        }
+        else
+        {
+            Copy->Entries.Add(Entry);
+        }
+        return Copy;
+    }
+
+    const uint32 Bit = SlotBit(Entry->KeyHash, Shift);
+    if (Node->ChildMap & Bit)
+    {
+        const int32 Index = SlotIndex(Node->ChildMap, Bit);
+        Copy->Children[Index] = Insert(Node->Children[Index], Entry, Shift + BitsPerLevel);
+    }
+    else if (Node->EntryMap & Bit)
+    {
+        const int32 Index = SlotIndex(Node->EntryMap, Bit);
+        const FEntryRef& Existing = Node->Entries[Index];
+        if (Existing->Key.Equals(Entry->Key, ESearchCase::IgnoreCase))
+        {
+            Copy->Entries[Index] = Entry;
+        }
+        else
+        {
+            // Two keys share the slot: both move one level down
+            Copy->Entries.RemoveAt(Index);
+            Copy->EntryMap &= ~Bit;
+            Copy->Children.Insert(MakePair(Existing, Entry, Shift + BitsPerLevel), SlotIndex(Node->ChildMap, Bit));
+            Copy->ChildMap |= Bit;
+        }
+    }
+    else
+    {
+        Copy->Entries.Insert(Entry, SlotIndex(Node->EntryMap, Bit));
+        Copy->EntryMap |= Bit;
+    }
+    return Copy;
+}
+
+FMotaEzPersistentMap::FNodeRef FMotaEzPersistentMap::MakePair(const FEntryRef& A, const FEntryRef& B, uint32 Shift)
+{
+    TSharedRef<FNode> Node = MakeShared<FNode>();
+
+    if (Shift >= HashBits)
+    {
+        Node->Entries.Add(A);
+        Node->Entries.Add(B);
+        return Node;
+    }
+
+    const uint32 BitA = SlotBit(A->KeyHash, Shift);
+    const uint32 BitB = SlotBit(B->KeyHash, Shift);
+    if (BitA == BitB)
+    {
+        Node->ChildMap = BitA;
+        Node->Children.Add(MakePair(A, B, Shift + BitsPerLevel));
+    }
+    else
+    {
+        Node->EntryMap = BitA | BitB;
+        Node->Entries.Add(BitA < BitB ? A : B);
+        Node->Entries.Add(BitA < BitB ? B : A);
+    }
+    return Node;
+}
+
+FMotaEzPersistentMap::FNodePtr FMotaEzPersistentMap::Erase(const FNodeRef& Node, const FString& Key, uint32 KeyHash, uint32 Shift)
+{
+    if (Shift >= HashBits)
+    {
+        const int32 Index = IndexOfKey(Node->Entries, Key);
+        if (Index == INDEX_NONE)
+        {
+            return Node;
+        }
+        if (Node->Entries.Num() == 1)
+        {
+            return nullptr;
+        }
+
+        TSharedRef<FNode> Copy = MakeShared<FNode>(*Node);
+        Copy->Entries.RemoveAt(Index);
+        return Copy;
+    }
+
+    const uint32 Bit = SlotBit(KeyHash, Shift);
+    if (Node->EntryMap & Bit)
+    {
+        const int32 Index = SlotIndex(Node->EntryMap, Bit);
+        if (!Node->Entries[Index]->Key.Equals(Key, ESearchCase::IgnoreCase))
+        {
+            return Node;
+        }
+        if (Node->Entries.Num() == 1 && Node->Children.Num() == 0)
+        {
+            return nullptr;
+        }
+
+        TSharedRef<FNode> Copy = MakeShared<FNode>(*Node);
+        Copy->Entries.RemoveAt(Index);
+        Copy->EntryMap &= ~Bit;
+        return Copy;
+    }
+
+    if (!(Node->ChildMap & Bit))
+    {
+        return Node;
+    }
+
+    const int32 Index = SlotIndex(Node->ChildMap, Bit);
+    const FNodePtr Child = Erase(Node->Children[Index], Key, KeyHash, Shift + BitsPerLevel);
+    if (Child.Get() == &Node->Children[Index].Get())
+    {
+        return Node;
+    }
+
+    TSharedRef<FNode> Copy = MakeShared<FNode>(*Node);
+    if (!Child.IsValid())
+    {
+        Copy->Children.RemoveAt(Index);
+        Copy->ChildMap &= ~Bit;
+        if (Copy->Entries.Num() == 0 && Copy->Children.Num() == 0)
+        {
+            return nullptr;
+        }
+    }
+    else if (Child->Entries.Num() == 1 && Child->Children.Num() == 0)
+    {
+        // A child left with one entry folds back into this slot, undoing the split that created it
+        Copy->Children.RemoveAt(Index);
+        Copy->ChildMap &= ~Bit;
+        Copy->Entries.Insert(Child->Entries[0], SlotIndex(Copy->EntryMap, Bit));
+        Copy->EntryMap |= Bit;
+    }
+    else
+    {
+        Copy->Children[Index] = Child.ToSharedRef();
+    }
+    return Copy;
+}
+
+void FMotaEzPersistentMap::ForEach(TFunctionRef<void(const FEntry&)> Visitor) const
+{
+    if (Root.IsValid())
+    {
+        VisitAll(*Root, Visitor);
+    }
+}
+
+void FMotaEzPersistentMap::VisitAll(const FNode& Node, TFunctionRef<void(const FEntry&)> Visitor)
+{
+    for (const FEntryRef& Entry : Node.Entries)
+    {
+        Visitor(*Entry);
+    }
+    for (const FNodeRef& Child : Node.Children)
+    {
+        VisitAll(*Child, Visitor);
+    }
+}
+
+void FMotaEzPersistentMap::Diff(const FMotaEzPersistentMap& Other, FDiffVisitor Visitor) const
+{
+    DiffNodes(Root.Get(), Other.Root.Get(), 0, Visitor);
+}
+
+void FMotaEzPersistentMap::DiffNodes(const FNode* Before, const FNode* After, uint32 Shift, FDiffVisitor Visitor)
+{
+    // Versions share every node an update did not copy, so only the copied paths are walked
+    if (Before == After)
+    {
+        return;
+    }
+    if (!Before || !After)
+    {
+        VisitAll(Before ? *Before : *After, [Before, &Visitor](const FEntry& Entry)
+        {
+            Visitor(Entry.Key, Before ? &Entry.Value : nullptr, Before ? nullptr : &Entry.Value);
+        });
+        return;
+    }
+
+    if (Shift >= HashBits)
+    {
+        // Collision lists hold a handful of keys at most
+        for (const FEntryRef& Entry : Before->Entries)
+        {
+            const int32 Index = IndexOfKey(After->Entries, Entry->Key);
+            if (Index == INDEX_NONE)
+            {
+                Visitor(Entry->Key, &Entry->Value, nullptr);
+            }
+            else
+            {
+                DiffEntries(*Entry, *After->Entries[Index], Visitor);
+            }
+        }
+        for (const FEntryRef& Entry : After->Entries)
+        {
+            if (IndexOfKey(Before->Entries, Entry->Key) == INDEX_NONE)
+            {
+                Visitor(Entry->Key, nullptr, &Entry->Value);
+            }
+        }
+        return;
+    }
+
+    uint32 Slots = Before->EntryMap | Before->ChildMap | After->EntryMap | After->ChildMap;
+    while (Slots != 0)
+    {
+        const uint32 Bit = Slots & (0u - Slots);
+        Slots &= Slots - 1;
+
+        const FEntry* EntryBefore = (Before->EntryMap & Bit) ? &Before->Entries[SlotIndex(Before->EntryMap, Bit)].Get() : nullptr;
+        const FEntry* EntryAfter = (After->EntryMap & Bit) ? &After->Entries[SlotIndex(After->EntryMap, Bit)].Get() : nullptr;
+        const FNode* ChildBefore = (Before->ChildMap & Bit) ? &Before->Children[SlotIndex(Before->ChildMap, Bit)].Get() : nullptr;
+        const FNode* ChildAfter = (After->ChildMap & Bit) ? &After->Children[SlotIndex(After->ChildMap, Bit)].Get() : nullptr;
+
+        if (EntryBefore && EntryAfter)
+        {
+            DiffEntries(*EntryBefore, *EntryAfter, Visitor);
+        }
+        else if (EntryBefore && ChildAfter)
+        {
+            DiffEntryWithNode(*EntryBefore, *ChildAfter, true, Visitor);
+        }
+        else if (ChildBefore && EntryAfter)
+        {
+            DiffEntryWithNode(*EntryAfter, *ChildBefore, false, Visitor);
+        }
+        else if (EntryBefore)
+        {
+            Visitor(EntryBefore->Key, &EntryBefore->Value, nullptr);
+        }
+        else if (EntryAfter)
+        {
+            Visitor(EntryAfter->Key, nullptr, &EntryAfter->Value);
+        }
+        else
+        {
+            DiffNodes(ChildBefore, ChildAfter, Shift + BitsPerLevel, Visitor);
+        }
+    }
+}
+
+void FMotaEzPersistentMap::DiffEntries(const FEntry& Before, const FEntry& After, FDiffVisitor Visitor)
+{
+    if (&Before == &After)
+    {
+        return;
+    }
+
+    if (Before.Key.Equals(After.Key, ESearchCase::IgnoreCase))
+    {
+        if (Before.ValueHash != After.ValueHash)
+        {
+            Visitor(After.Key, &Before.Value, &After.Value);
+        }
+        return;
+    }
+
+    Visitor(Before.Key, &Before.Value, nullptr);
+    Visitor(After.Key, nullptr, &After.Value);
+}
+
+void FMotaEzPersistentMap::DiffEntryWithNode(const FEntry& Entry, const FNode& Node, bool bEntryIsBefore, FDiffVisitor Visitor)
+{
+    // One side kept a single key in a slot the other side split into a subtree
+    bool bMatched = false;
+    VisitAll(Node, [&Entry, bEntryIsBefore, &Visitor, &bMatched](const FEntry& Other)
+    {
+        if (Other.Key.Equals(Entry.Key, ESearchCase::IgnoreCase))
+        {
+            bMatched = true;
+            DiffEntries(bEntryIsBefore ? Entry : Other, bEntryIsBefore ? Other : Entry, Visitor);
+        }
+        else
+        {
+            Visitor(Other.Key, bEntryIsBefore ? nullptr : &Other.Value, bEntryIsBefore ? &Other.Value : nullptr);
+        }
+    });
+
+    if (!bMatched)
+    {
+        Visitor(Entry.Key, bEntryIsBefore ? &Entry.Value : nullptr, bEntryIsBefore ? nullptr : &Entry.Value);
+    }
+}
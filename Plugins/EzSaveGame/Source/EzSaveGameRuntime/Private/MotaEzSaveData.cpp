@@ -1,364 +1,2088 @@
 ﻿#include "MotaEzSaveData.h"
+#include "MotaEzSaveGameSettings.h"
+#include "MotaEzValueConversion.h"
+#include "MotaEzValidator.h"
 #include "Misc/Char.h"
 #include "Containers/UnrealString.h"
+#include "Hash/xxhash.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 namespace
 {
-    FORCEINLINE bool StringToBool(const FString& In)
+    using namespace MotaEzValueConversion;
+
+    FORCEINLINE FVector ParseVectorElem(const FString& In)
+    {
+        return StringToVector(In, FVector::ZeroVector);
+    }
+
+    FORCEINLINE FRotator ParseRotatorElem(const FString& In)
     {
-        return In.Equals(TEXT("true"), ESearchCase::IgnoreCase) ||
-               In.Equals(TEXT("1"), ESearchCase::IgnoreCase)   ||
-               In.Equals(TEXT("yes"), ESearchCase::IgnoreCase);
+        return StringToRotator(In, FRotator::ZeroRotator);
     }
 
-    FORCEINLINE FString BoolToString(bool b)
+    FORCEINLINE void HashString(FXxHash64Builder& Builder, const FString& In)
     {
-        return b ? TEXT("true") : TEXT("false");
+        const int32 Len = In.Len();
+        Builder.Update(&Len, sizeof(Len));
+        Builder.Update(*In, Len * sizeof(TCHAR));
     }
 
-    FORCEINLINE FVector StringToVector(const FString& In, const FVector& Default)
+    /**
+     * Hashes one key/value pair.
+     * Keys are hashed case-insensitively to match TMap<FString> key semantics.
+     */
+    FORCEINLINE uint64 HashEntry(const FString& Key, const FMotaEzValue& Value)
     {
-        TArray<FString> Parts;
-        In.ParseIntoArray(Parts, TEXT(","), true);
+        FXxHash64Builder Builder;
+        const uint8 Header[2] = { (uint8)Value.Type, (uint8)Value.bIsArray };
+        Builder.Update(Header, sizeof(Header));
+        HashString(Builder, Value.ScalarValue);
 
-        if (Parts.Num() != 3)
+        const int32 Count = Value.ArrayValues.Num();
+        Builder.Update(&Count, sizeof(Count));
+        for (const FString& Element : Value.ArrayValues)
         {
-            return Default;
+            HashString(Builder, Element);
         }
 
-        const float X = FCString::Atof(*Parts[0]);
-        const float Y = FCString::Atof(*Parts[1]);
-        const float Z = FCString::Atof(*Parts[2]);
-        return FVector(X, Y, Z);
+        const int32 StructBytes = Value.StructData.Num();
+        Builder.Update(&StructBytes, sizeof(StructBytes));
+        Builder.Update(Value.StructData.GetData(), StructBytes);
+
+        const int32 BlobBytes = Value.BlobData.IsValid() ? Value.BlobData->Num() : 0;
+        Builder.Update(&BlobBytes, sizeof(BlobBytes));
+        if (BlobBytes > 0)
+        {
+            Builder.Update(Value.BlobData->GetData(), BlobBytes);
+        }
+
+        // SplitMix64 finalizer so that summed entries do not cancel out
+        uint64 Hash = Builder.Finalize().Hash ^ ((uint64)GetTypeHash(Key) * 0x9E3779B97F4A7C15ull);
+        Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBull;
+        return Hash ^ (Hash >> 31);
     }
 
-    FORCEINLINE FString VectorToString(const FVector& V)
+    /** Case-insensitive order, matching TMap<FString> key equality. */
+    struct FKeyLess
     {
-        return FString::Printf(TEXT("%f,%f,%f"), V.X, V.Y, V.Z);
-    }
+        FORCEINLINE bool operator()(const FString& A, const FString& B) const
+        {
+            return A.Compare(B, ESearchCase::IgnoreCase) < 0;
+        }
+    };
+
+    /** Batches that add more keys than this rebuild the key index once instead of inserting each key. */
+    constexpr int32 KeyIndexRebuildThreshold = 256;
 
-    FORCEINLINE FRotator StringToRotator(const FString& In, const FRotator& Default)
+    /** @return Section part of a key ("Inventory" for "Inventory/Sword"), empty for keys of the root section */
+    FORCEINLINE FStringView SectionOfKey(const FString& Key)
     {
-        TArray<FString> Parts;
-        In.ParseIntoArray(Parts, TEXT(","), true);
+        int32 Separator = INDEX_NONE;
+        return Key.FindChar(UMotaEzSaveData::SectionSeparator, Separator) ? FStringView(*Key, Separator) : FStringView();
+    }
 
-        if (Parts.Num() != 3)
+    /** Wrapping add that other shard writers may race with in thread-safe mode. */
+    FORCEINLINE void AddWrapping(uint64& Target, uint64 Delta, bool bAtomic)
+    {
+        if (bAtomic)
+        {
+            // Wrapping addition, so the signed interlocked add gives the same result as the plain one
+            FPlatformAtomics::InterlockedAdd(reinterpret_cast<volatile int64*>(&Target), static_cast<int64>(Delta));
+        }
+        else
         {
-            return Default;
+            Target += Delta;
         }
+    }
+}
 
-        const float Pitch = FCString::Atof(*Parts[0]);
-        const float Yaw   = FCString::Atof(*Parts[1]);
-        const float Roll  = FCString::Atof(*Parts[2]);
-        return FRotator(Pitch, Yaw, Roll);
+static_assert(UMotaEzSaveData::NumLockShards <= 32 && FMath::IsPowerOfTwo(UMotaEzSaveData::NumLockShards),
+    "Shard masks are stored in 32 bits and shards are picked by masking the key hash");
+
+class UMotaEzSaveData::FKeyLockScope
+{
+public:
+    FKeyLockScope(const UMotaEzSaveData& InSaveData, const FString& Key, bool bInWrite)
+        : FKeyLockScope(InSaveData, MakeArrayView(&Key, 1), bInWrite)
+    {
     }
 
-    FORCEINLINE FString RotatorToString(const FRotator& R)
+    FKeyLockScope(const UMotaEzSaveData& InSaveData, TConstArrayView<FString> Keys, bool bInWrite)
+        : FKeyLockScope(InSaveData, Keys, [](const FString& Key) -> const FString& { return Key; }, bInWrite)
     {
-        return FString::Printf(TEXT("%f,%f,%f"), R.Pitch, R.Yaw, R.Roll);
     }
 
-    FORCEINLINE FVector ParseVectorElem(const FString& In)
+    /** Locks for a range of items whose keys are given by Projection (batch entries, map pairs). */
+    template <typename RangeType, typename ProjectionType>
+    FKeyLockScope(const UMotaEzSaveData& InSaveData, const RangeType& Items, ProjectionType Projection, bool bInWrite)
+        : SaveData(InSaveData)
+        , bWrite(bInWrite)
     {
-        return StringToVector(In, FVector::ZeroVector);
+        if (!SaveData.bThreadSafe)
+        {
+            return;
+        }
+
+        SaveData.StructureLock.Lock.ReadLock();
+
+        // Adding keys reshapes the map, which only the exclusive lock allows
+        if (bWrite)
+        {
+            for (const auto& Item : Items)
+            {
+                if (!SaveData.Data.Contains(Projection(Item)))
+                {
+                    SaveData.StructureLock.Lock.ReadUnlock();
+                    SaveData.StructureLock.Lock.WriteLock();
+                    bExclusive = true;
+                    return;
+                }
+            }
+        }
+
+        for (const auto& Item : Items)
+        {
+            // Same case-insensitive hash as the TMap, so a key always maps to one shard
+            ShardMask |= 1u << (GetTypeHash(Projection(Item)) & (NumLockShards - 1));
+        }
+
+        // Ascending order, so batches that share shards cannot deadlock
+        for (int32 Shard = 0; Shard < NumLockShards; ++Shard)
+        {
+            if (ShardMask & (1u << Shard))
+            {
+                bWrite ? SaveData.ShardLocks[Shard].Lock.WriteLock() : SaveData.ShardLocks[Shard].Lock.ReadLock();
+            }
+        }
+        bLocked = true;
     }
 
-    FORCEINLINE FRotator ParseRotatorElem(const FString& In)
+    /** @return true if the map may be reshaped (not thread-safe, or every other accessor is locked out) */
+    bool CanReshape() const { return !SaveData.bThreadSafe || bExclusive; }
+
+    ~FKeyLockScope()
     {
-        return StringToRotator(In, FRotator::ZeroRotator);
+        if (bExclusive)
+        {
+            SaveData.StructureLock.Lock.WriteUnlock();
+            return;
+        }
+
+        if (!bLocked)
+        {
+            return;
+        }
+
+        for (int32 Shard = NumLockShards - 1; Shard >= 0; --Shard)
+        {
+            if (ShardMask & (1u << Shard))
+            {
+                bWrite ? SaveData.ShardLocks[Shard].Lock.WriteUnlock() : SaveData.ShardLocks[Shard].Lock.ReadUnlock();
+            }
+        }
+        SaveData.StructureLock.Lock.ReadUnlock();
     }
-}
 
+private:
+    const UMotaEzSaveData& SaveData;
+    uint32 ShardMask = 0;
+    bool bWrite;
+    bool bLocked = false;
+    bool bExclusive = false;
+};
 
-int32 UMotaEzSaveData::GetInt(const FString& Key, int32 DefaultValue) const
+UMotaEzSaveData::FExclusiveScope::FExclusiveScope(const UMotaEzSaveData& InSaveData)
+    : SaveData(InSaveData)
+    , bLocked(InSaveData.bThreadSafe)
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || Found->IsArray() || Found->Type != EMotaEzFieldType::Int)
+    if (bLocked)
     {
-        return DefaultValue;
+        SaveData.StructureLock.Lock.WriteLock();
     }
+}
 
-    return FCString::Atoi(*Found->ScalarValue);
+UMotaEzSaveData::FExclusiveScope::~FExclusiveScope()
+{
+    if (bLocked)
+    {
+        SaveData.StructureLock.Lock.WriteUnlock();
+    }
 }
 
-float UMotaEzSaveData::GetFloat(const FString& Key, float DefaultValue) const
+template <typename FillType>
+void UMotaEzSaveData::WriteValue(const FString& Key, FillType&& Fill)
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || Found->IsArray() || Found->Type != EMotaEzFieldType::Float)
+    // Inside an edit, the writing thread's changes wait in the staging layer until CommitEdit
+    if (IsEditingOnThisThread())
     {
-        return DefaultValue;
+        StagedRemovals.Remove(Key);
+        FMotaEzValue* Staged = StagedWrites.Find(Key);
+        if (!Staged)
+        {
+            // Start from the stored entry so setters behave exactly as they do outside an edit
+            FMotaEzValue Initial;
+            {
+                FKeyLockScope Lock(*this, Key, false);
+                if (const FMotaEzValue* Stored = Data.Find(Key))
+                {
+                    Initial = *Stored;
+                }
+            }
+            Staged = &StagedWrites.Add(Key, MoveTemp(Initial));
+        }
+        // Records and bytes only belong to Struct and Blob values; their setters fill them again
+        Staged->StructData.Reset();
+        Staged->BlobData.Reset();
+        Fill(*Staged);
+        return;
     }
 
-    return FCString::Atof(*Found->ScalarValue);
+    FKeyLockScope Lock(*this, Key, true);
+    uint64 PreviousHash = 0;
+    FMotaEzValue& Entry = BeginMutate(Key, PreviousHash);
+    Entry.StructData.Reset();
+    Entry.BlobData.Reset();
+    Fill(Entry);
+    EndMutate(Key, Entry, PreviousHash);
 }
 
-bool UMotaEzSaveData::GetBool(const FString& Key, bool DefaultValue) const
+bool UMotaEzSaveData::IsEditingOnThisThread() const
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || Found->IsArray() || Found->Type != EMotaEzFieldType::Bool)
+    // Only the editing thread can observe its own id here, so other threads never touch the staging layer
+    return EditThreadId.load(std::memory_order_relaxed) == FPlatformTLS::GetCurrentThreadId();
+}
+
+void UMotaEzSaveData::BeginEdit()
+{
+    if (IsEditingOnThisThread())
     {
-        return DefaultValue;
+        // Nested scopes join the outer edit; only the outermost commit publishes
+        ++EditDepth;
+        return;
     }
 
-    return StringToBool(Found->ScalarValue);
+    // The staging layer belongs to one thread, so another thread's edit has to finish first
+    EditLock.Lock();
+    EditDepth = 1;
+    EditThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+    bEditAborted = false;
 }
 
-FString UMotaEzSaveData::GetString(const FString& Key, const FString& DefaultValue) const
+bool UMotaEzSaveData::CommitEdit(FMotaEzValidationResult& OutResult)
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || Found->IsArray() || Found->Type != EMotaEzFieldType::String)
+    OutResult = FMotaEzValidationResult();
+
+    if (!IsEditingOnThisThread())
+    {
+        OutResult.bIsValid = false;
+        OutResult.ErrorMessage = TEXT("CommitEdit called without a matching BeginEdit on this thread");
+        return false;
+    }
+
+    if (--EditDepth > 0)
+    {
+        return !bEditAborted;
+    }
+
+    if (bEditAborted)
+    {
+        OutResult.bIsValid = false;
+        OutResult.ErrorMessage = TEXT("Edit was aborted");
+        DiscardStaged();
+        return false;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_CommitEdit);
+
+    // Validate the whole batch before anything becomes visible
+    if (ValidationRules.IsValid())
+    {
+        for (const auto& Pair : StagedWrites)
+        {
+            const FMotaEzFieldDescriptor* Descriptor = ValidationRules->Fields.Find(Pair.Key);
+            if (!Descriptor || !Descriptor->bEnableValidation)
+            {
+                continue;
+            }
+
+            OutResult = UMotaEzValidator::ValidateField(Pair.Key, Pair.Value, *Descriptor);
+            if (!OutResult.bIsValid)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Edit rolled back, %s: %s"), *OutResult.FieldName, *OutResult.ErrorMessage);
+                DiscardStaged();
+                return false;
+            }
+        }
+    }
+
     {
-        return DefaultValue;
+        // Other threads see either none or all of the staged changes
+        FExclusiveScope Lock(*this);
+
+        for (const FString& Key : StagedRemovals)
+        {
+            RemoveStoredKey(Key);
+        }
+
+        Data.Reserve(Data.Num() + StagedWrites.Num());
+        PrepareKeyIndexForBatch(StagedWrites.Num());
+        for (auto& Pair : StagedWrites)
+        {
+            uint64 PreviousHash = 0;
+            FMotaEzValue& Entry = BeginMutate(Pair.Key, PreviousHash);
+            Entry = MoveTemp(Pair.Value);
+            EndMutate(Pair.Key, Entry, PreviousHash);
+        }
     }
 
-    return Found->ScalarValue;
+    DiscardStaged();
+    return true;
 }
 
-FVector UMotaEzSaveData::GetVector(const FString& Key, const FVector& DefaultValue) const
+void UMotaEzSaveData::AbortEdit()
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || Found->IsArray() || Found->Type != EMotaEzFieldType::Vector)
+    if (!IsEditingOnThisThread())
     {
-        return DefaultValue;
+        return;
     }
 
-    return StringToVector(Found->ScalarValue, DefaultValue);
+    bEditAborted = true;
+    if (--EditDepth == 0)
+    {
+        DiscardStaged();
+    }
 }
 
-FRotator UMotaEzSaveData::GetRotator(const FString& Key, const FRotator& DefaultValue) const
+void UMotaEzSaveData::DiscardStaged()
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || Found->IsArray() || Found->Type != EMotaEzFieldType::Rotator)
+    // Rolling back costs only what was staged; Data was never touched
+    StagedWrites.Reset();
+    StagedRemovals.Reset();
+    EditDepth = 0;
+    EditThreadId.store(0, std::memory_order_relaxed);
+    bEditAborted = false;
+    EditLock.Unlock();
+}
+
+void UMotaEzSaveData::SetValidationRules(const TSharedPtr<const FMotaEzSaveSchema>& InRules)
+{
+    ValidationRules = InRules;
+}
+
+void UMotaEzSaveData::PostInitProperties()
+{
+    Super::PostInitProperties();
+
+    if (!HasAnyFlags(RF_ClassDefaultObject))
     {
-        return DefaultValue;
+        const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+        bThreadSafe = Settings && Settings->bThreadSafeSaveData;
     }
-
-    return StringToRotator(Found->ScalarValue, DefaultValue);
 }
 
-void UMotaEzSaveData::SetInt(const FString& Key, int32 Value)
+void UMotaEzSaveData::BeginDestroy()
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Int;
-    Entry.ScalarValue = LexToString(Value);
-    Entry.ArrayValues.Reset();
+    if (ChangeTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(ChangeTickerHandle);
+        ChangeTickerHandle.Reset();
+    }
+
+    if (SnapshotTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(SnapshotTickerHandle);
+        SnapshotTickerHandle.Reset();
+    }
+
+    // Readers holding the channel keep reading the last published snapshot
+    SnapshotChannel.Reset();
+
+    Super::BeginDestroy();
 }
 
-void UMotaEzSaveData::SetFloat(const FString& Key, float Value)
+TSharedRef<FMotaEzSnapshotChannel, ESPMode::ThreadSafe> UMotaEzSaveData::GetSnapshotChannel()
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Float;
-    Entry.ScalarValue = LexToString(Value);
-    Entry.ArrayValues.Reset();
+    check(IsInGameThread());
+
+    if (!SnapshotChannel.IsValid())
+    {
+        SnapshotChannel = MakeShared<FMotaEzSnapshotChannel, ESPMode::ThreadSafe>(MakeSnapshot());
+
+        // Once per frame: publish if dirty, and free snapshots readers have moved past
+        SnapshotTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+        {
+            PublishSnapshot();
+            SnapshotChannel->Reclaim();
+            return true;
+        }));
+    }
+
+    return SnapshotChannel.ToSharedRef();
 }
 
-void UMotaEzSaveData::SetBool(const FString& Key, bool Value)
+void UMotaEzSaveData::PublishSnapshot()
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Bool;
-    Entry.ScalarValue = BoolToString(Value);
-    Entry.ArrayValues.Reset();
+    if (!SnapshotChannel.IsValid())
+    {
+        return;
+    }
+
+    {
+        FMotaEzSnapshotReadScope Published(*SnapshotChannel);
+        if (Published->Fingerprint == Fingerprint && Published->Defaults == Defaults)
+        {
+            return;
+        }
+    }
+
+    SnapshotChannel->Publish(MakeSnapshot());
 }
 
-void UMotaEzSaveData::SetString(const FString& Key, const FString& Value)
+TUniquePtr<FMotaEzSaveSnapshot> UMotaEzSaveData::MakeSnapshot() const
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::String;
-    Entry.ScalarValue = Value;
-    Entry.ArrayValues.Reset();
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_MakeSnapshot);
+
+    TUniquePtr<FMotaEzSaveSnapshot> Snapshot = MakeUnique<FMotaEzSaveSnapshot>();
+
+    FExclusiveScope Lock(*this);
+    Snapshot->Data = Data;
+    Snapshot->Defaults = Defaults;
+    Snapshot->Fingerprint = Fingerprint;
+    return Snapshot;
 }
 
-void UMotaEzSaveData::SetVector(const FString& Key, const FVector& Value)
+void UMotaEzSaveData::Serialize(FArchive& Ar)
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Vector;
-    Entry.ScalarValue = VectorToString(Value);
-    Entry.ArrayValues.Reset();
+    FExclusiveScope Lock(*this);
+
+    Super::Serialize(Ar);
+
+    if (Ar.IsLoading())
+    {
+        RecomputeFingerprint();
+    }
 }
 
-void UMotaEzSaveData::SetRotator(const FString& Key, const FRotator& Value)
+bool UMotaEzSaveData::RemoveKey(const FString& Key)
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Rotator;
-    Entry.ScalarValue = RotatorToString(Value);
-    Entry.ArrayValues.Reset();
+    if (IsEditingOnThisThread())
+    {
+        bool bIsStored = false;
+        {
+            FKeyLockScope Lock(*this, Key, false);
+            bIsStored = Data.Contains(Key);
+        }
+
+        const bool bWasStored = StagedWrites.Remove(Key) > 0 || (bIsStored && !StagedRemovals.Contains(Key));
+        if (bIsStored)
+        {
+            StagedRemovals.Add(Key);
+        }
+        return bWasStored;
+    }
+
+    FExclusiveScope Lock(*this);
+    return RemoveStoredKey(Key);
 }
 
-TArray<int32> UMotaEzSaveData::GetIntArray(const FString& Key) const
+bool UMotaEzSaveData::RemoveStoredKey(const FString& Key)
 {
     const FMotaEzValue* Found = Data.Find(Key);
-    TArray<int32> Result;
+    if (!Found)
+    {
+        return false;
+    }
 
-    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Int)
+    AddToFingerprint(Key, 0 - HashEntry(Key, *Found));
+    Data.Remove(Key);
+
+    if (bKeyIndexValid.load(std::memory_order_relaxed))
     {
-        return Result;
+        const int32 Index = Algo::BinarySearch(SortedKeys, Key, FKeyLess());
+        if (Index != INDEX_NONE)
+        {
+            SortedKeys.RemoveAt(Index, EAllowShrinking::No);
+        }
     }
 
-    Result.Reserve(Found->ArrayValues.Num());
-    for (const FString& S : Found->ArrayValues)
+    if (HasChangeListeners())
     {
-        Result.Add(FCString::Atoi(*S));
+        RecordChange(Key);
     }
-    return Result;
+    return true;
 }
 
-TArray<float> UMotaEzSaveData::GetFloatArray(const FString& Key) const
+void UMotaEzSaveData::ClearData()
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    TArray<float> Result;
+    if (IsEditingOnThisThread())
+    {
+        StagedWrites.Reset();
+        FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+        for (const auto& Pair : Data)
+        {
+            StagedRemovals.Add(Pair.Key);
+        }
+        return;
+    }
 
-    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Float)
+    FExclusiveScope Lock(*this);
+
+    if (HasChangeListeners())
     {
-        return Result;
+        for (const auto& Pair : Data)
+        {
+            RecordChange(Pair.Key);
+        }
     }
 
-    Result.Reserve(Found->ArrayValues.Num());
-    for (const FString& S : Found->ArrayValues)
+    Data.Reset();
+    SortedKeys.Reset();
+    Fingerprint = 0;
+
+    // Sections stay known with nothing in them, so saving removes their blocks
+    for (auto& Pair : SectionFingerprints)
     {
-        Result.Add(FCString::Atof(*S));
+        Pair.Value = 0;
     }
-    return Result;
 }
 
-TArray<bool> UMotaEzSaveData::GetBoolArray(const FString& Key) const
+void UMotaEzSaveData::SetDefaultsLayer(const TSharedPtr<const TMap<FString, FMotaEzValue>>& InDefaults)
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    TArray<bool> Result;
+    Defaults = InDefaults;
+}
 
-    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Bool)
+const FMotaEzValue* UMotaEzSaveData::FindValue(const FString& Key) const
+{
+    // The editing thread reads its own staged writes; everyone else sees committed data
+    if (IsEditingOnThisThread())
     {
-        return Result;
+        if (const FMotaEzValue* Staged = StagedWrites.Find(Key))
+        {
+            return Staged;
+        }
+        if (StagedRemovals.Contains(Key))
+        {
+            return Defaults.IsValid() ? Defaults->Find(Key) : nullptr;
+        }
     }
 
-    Result.Reserve(Found->ArrayValues.Num());
-    for (const FString& S : Found->ArrayValues)
+    if (const FMotaEzValue* Found = Data.Find(Key))
     {
-        Result.Add(StringToBool(S));
+        return Found;
     }
-    return Result;
+
+    return Defaults.IsValid() ? Defaults->Find(Key) : nullptr;
 }
 
-TArray<FString> UMotaEzSaveData::GetStringArray(const FString& Key) const
+void UMotaEzSaveData::ReplaceData(TMap<FString, FMotaEzValue>&& NewData)
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::String)
+    FExclusiveScope Lock(*this);
+
+    // Keys that were removed, added or changed (values compared by entry hash)
+    if (HasChangeListeners())
     {
-        return {};
+        for (const auto& Pair : Data)
+        {
+            const FMotaEzValue* Replacement = NewData.Find(Pair.Key);
+            if (!Replacement || HashEntry(Pair.Key, *Replacement) != HashEntry(Pair.Key, Pair.Value))
+            {
+                RecordChange(Pair.Key);
+            }
+        }
+        for (const auto& Pair : NewData)
+        {
+            if (!Data.Contains(Pair.Key))
+            {
+                RecordChange(Pair.Key);
+            }
+        }
     }
 
-    return Found->ArrayValues;
+    Data = MoveTemp(NewData);
+    RecomputeFingerprint();
 }
 
-TArray<FVector> UMotaEzSaveData::GetVectorArray(const FString& Key) const
+void UMotaEzSaveData::GetValues(TConstArrayView<FString> Keys, TMap<FString, FMotaEzValue>& OutValues) const
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    TArray<FVector> Result;
+    FKeyLockScope Lock(*this, Keys, false);
 
-    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Vector)
+    OutValues.Reserve(OutValues.Num() + Keys.Num());
+    for (const FString& Key : Keys)
     {
-        return Result;
+        if (const FMotaEzValue* Found = FindValue(Key))
+        {
+            OutValues.Add(Key, *Found);
+        }
     }
+}
 
-    Result.Reserve(Found->ArrayValues.Num());
-    for (const FString& S : Found->ArrayValues)
+void UMotaEzSaveData::GetValues(TConstArrayView<FString> Keys, TArray<FMotaEzValue>& OutValues) const
+{
+    FKeyLockScope Lock(*this, Keys, false);
+
+    OutValues.Reset(Keys.Num());
+    for (const FString& Key : Keys)
     {
-        Result.Add(ParseVectorElem(S));
+        const FMotaEzValue* Found = FindValue(Key);
+        OutValues.Add(Found ? *Found : FMotaEzValue());
     }
-    return Result;
 }
 
-TArray<FRotator> UMotaEzSaveData::GetRotatorArray(const FString& Key) const
+void UMotaEzSaveData::SetValues(const TMap<FString, FMotaEzValue>& Values)
 {
-    const FMotaEzValue* Found = Data.Find(Key);
-    TArray<FRotator> Result;
+    if (IsEditingOnThisThread())
+    {
+        for (const auto& Pair : Values)
+        {
+            WriteValue(Pair.Key, [&Pair](FMotaEzValue& Entry) { Entry = Pair.Value; });
+        }
+        return;
+    }
 
-    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Rotator)
+    FKeyLockScope Lock(*this, Values, [](const TPair<FString, FMotaEzValue>& Pair) -> const FString& { return Pair.Key; }, true);
+
+    if (Lock.CanReshape())
     {
-        return Result;
+        Data.Reserve(Data.Num() + Values.Num());
+        PrepareKeyIndexForBatch(Values.Num());
     }
 
-    Result.Reserve(Found->ArrayValues.Num());
-    for (const FString& S : Found->ArrayValues)
+    for (const auto& Pair : Values)
     {
-        Result.Add(ParseRotatorElem(S));
+        uint64 PreviousHash = 0;
+        FMotaEzValue& Entry = BeginMutate(Pair.Key, PreviousHash);
+        Entry = Pair.Value;
+        EndMutate(Pair.Key, Entry, PreviousHash);
     }
-    return Result;
 }
 
-void UMotaEzSaveData::SetIntArray(const FString& Key, const TArray<int32>& Values)
+void UMotaEzSaveData::SetValues(TConstArrayView<FMotaEzBatchEntry> Entries)
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Int;
-    Entry.ScalarValue.Reset();
-    Entry.ArrayValues.Reset();
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_SetValues);
+
+    if (IsEditingOnThisThread())
+    {
+        for (const FMotaEzBatchEntry& Batched : Entries)
+        {
+            WriteValue(Batched.Key, [&Batched](FMotaEzValue& Entry) { Entry = Batched.Value; });
+        }
+        return;
+    }
+
+    FKeyLockScope Lock(*this, Entries, [](const FMotaEzBatchEntry& Entry) -> const FString& { return Entry.Key; }, true);
+
+    // One growth step for the whole batch instead of rehashing as keys are added
+    if (Lock.CanReshape())
+    {
+        Data.Reserve(Data.Num() + Entries.Num());
+        PrepareKeyIndexForBatch(Entries.Num());
+    }
 
-    Entry.ArrayValues.Reserve(Values.Num());
-    for (int32 V : Values)
+    for (const FMotaEzBatchEntry& Batched : Entries)
     {
-        Entry.ArrayValues.Add(LexToString(V));
+        uint64 PreviousHash = 0;
+        FMotaEzValue& Entry = BeginMutate(Batched.Key, PreviousHash);
+        Entry = Batched.Value;
+        EndMutate(Batched.Key, Entry, PreviousHash);
     }
 }
 
-void UMotaEzSaveData::SetFloatArray(const FString& Key, const TArray<float>& Values)
+void UMotaEzSaveData::AddToFingerprint(const FString& Key, uint64 Delta)
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Float;
-    Entry.ScalarValue.Reset();
-    Entry.ArrayValues.Reset();
+    AddWrapping(Fingerprint, Delta, bThreadSafe);
 
-    Entry.ArrayValues.Reserve(Values.Num());
-    for (float V : Values)
+    // Section entries are only added together with a new key (under the exclusive lock), so the map is stable here
+    const FStringView Section = SectionOfKey(Key);
+    if (uint64* SectionFingerprint = SectionFingerprints.FindByHash(GetTypeHash(Section), Section))
     {
-        Entry.ArrayValues.Add(LexToString(V));
+        AddWrapping(*SectionFingerprint, Delta, bThreadSafe);
     }
 }
 
-void UMotaEzSaveData::SetBoolArray(const FString& Key, const TArray<bool>& Values)
+void UMotaEzSaveData::RecomputeFingerprint()
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Bool;
-    Entry.ScalarValue.Reset();
-    Entry.ArrayValues.Reset();
+    // Called after Data was replaced or written directly, so the key index is stale as well
+    InvalidateKeyIndex();
+
+    // and the undo history cannot know which keys changed
+    if (UndoHistory.IsValid())
+    {
+        UndoHistory->MarkAllChanged();
+    }
+
+    Fingerprint = 0;
+    for (auto& Pair : SectionFingerprints)
+    {
+        Pair.Value = 0;
+    }
 
-    Entry.ArrayValues.Reserve(Values.Num());
-    for (bool V : Values)
+    for (const auto& Pair : Data)
     {
-        Entry.ArrayValues.Add(BoolToString(V));
+        const uint64 Hash = HashEntry(Pair.Key, Pair.Value);
+        Fingerprint += Hash;
+        SectionFingerprints.FindOrAdd(FString(SectionOfKey(Pair.Key))) += Hash;
     }
 }
 
-void UMotaEzSaveData::SetStringArray(const FString& Key, const TArray<FString>& Values)
+void UMotaEzSaveData::MarkClean()
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::String;
-    Entry.ScalarValue.Reset();
-    Entry.ArrayValues = Values;
+    CleanFingerprint = Fingerprint;
+    CleanSectionFingerprints = SectionFingerprints;
 }
 
-void UMotaEzSaveData::SetVectorArray(const FString& Key, const TArray<FVector>& Values)
+FString UMotaEzSaveData::MakeSectionKey(const FString& Section, const FString& Key)
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Vector;
-    Entry.ScalarValue.Reset();
-    Entry.ArrayValues.Reset();
-
-    Entry.ArrayValues.Reserve(Values.Num());
-    for (const FVector& V : Values)
-    {
-        Entry.ArrayValues.Add(VectorToString(V));
-    }
+    return Section.IsEmpty() ? Key : Section + SectionSeparator + Key;
 }
 
-void UMotaEzSaveData::SetRotatorArray(const FString& Key, const TArray<FRotator>& Values)
+FString UMotaEzSaveData::GetKeySection(const FString& Key)
 {
-    FMotaEzValue& Entry = Data.FindOrAdd(Key);
-    Entry.Type = EMotaEzFieldType::Rotator;
-    Entry.ScalarValue.Reset();
-    Entry.ArrayValues.Reset();
+    return FString(SectionOfKey(Key));
+}
 
-    Entry.ArrayValues.Reserve(Values.Num());
-    for (const FRotator& R : Values)
+bool UMotaEzSaveData::HasSections() const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+    for (const auto& Pair : SectionFingerprints)
+    {
+        if (!Pair.Key.IsEmpty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+TArray<FString> UMotaEzSaveData::GetSectionNames() const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+
+    TArray<FString> Names;
+    for (const auto& Pair : SectionFingerprints)
+    {
+        if (!Pair.Key.IsEmpty())
+        {
+            Names.Add(Pair.Key);
+        }
+    }
+    return Names;
+}
+
+uint64 UMotaEzSaveData::GetSectionFingerprint(const FString& Section) const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+    const uint64* Found = SectionFingerprints.Find(Section);
+    return Found ? *Found : 0;
+}
+
+bool UMotaEzSaveData::IsSectionDirty(const FString& Section) const
+{
+    const uint64* Clean = CleanSectionFingerprints.Find(Section);
+    return GetSectionFingerprint(Section) != (Clean ? *Clean : 0);
+}
+
+void UMotaEzSaveData::MarkSectionClean(const FString& Section)
+{
+    // The whole-object fingerprint is the sum of the section fingerprints, so IsDirty follows along
+    const uint64 Current = GetSectionFingerprint(Section);
+    uint64& Clean = CleanSectionFingerprints.FindOrAdd(Section);
+    CleanFingerprint += Current - Clean;
+    Clean = Current;
+}
+
+void UMotaEzSaveData::GetSectionData(const FString& Section, TMap<FString, FMotaEzValue>& OutData) const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+
+    if (Section.IsEmpty())
+    {
+        // Root keys are not contiguous in key order, so this is a scan; it only runs when the root changed
+        for (const auto& Pair : Data)
+        {
+            if (SectionOfKey(Pair.Key).IsEmpty())
+            {
+                OutData.Add(Pair.Key, Pair.Value);
+            }
+        }
+        return;
+    }
+
+    EnsureKeyIndex();
+
+    int32 Begin = 0;
+    int32 End = 0;
+    FindPrefixRange(Section + SectionSeparator, Begin, End);
+    OutData.Reserve(OutData.Num() + End - Begin);
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        OutData.Add(SortedKeys[Index], Data.FindChecked(SortedKeys[Index]));
+    }
+}
+
+void UMotaEzSaveData::ReplaceSection(const FString& Section, TMap<FString, FMotaEzValue>&& NewData)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_ReplaceSection);
+
+    FExclusiveScope Lock(*this);
+
+    TArray<FString> OldKeys;
+    if (Section.IsEmpty())
+    {
+        for (const auto& Pair : Data)
+        {
+            if (SectionOfKey(Pair.Key).IsEmpty())
+            {
+                OldKeys.Add(Pair.Key);
+            }
+        }
+    }
+    else
+    {
+        EnsureKeyIndex();
+
+        int32 Begin = 0;
+        int32 End = 0;
+        FindPrefixRange(Section + SectionSeparator, Begin, End);
+        OldKeys.Append(SortedKeys.GetData() + Begin, End - Begin);
+    }
+
+    // Keys the new contents still have are overwritten in place, so only real changes are recorded
+    for (const FString& Key : OldKeys)
+    {
+        if (!NewData.Contains(Key))
+        {
+            RemoveStoredKey(Key);
+        }
+    }
+
+    SectionFingerprints.FindOrAdd(Section);
+    PrepareKeyIndexForBatch(NewData.Num());
+    Data.Reserve(Data.Num() + NewData.Num());
+
+    for (auto& Pair : NewData)
+    {
+        if (!SectionOfKey(Pair.Key).Equals(Section, ESearchCase::IgnoreCase))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Key '%s' does not belong to section '%s', skipped"), *Pair.Key, *Section);
+            continue;
+        }
+
+        uint64 PreviousHash = 0;
+        FMotaEzValue& Entry = BeginMutate(Pair.Key, PreviousHash);
+        Entry = MoveTemp(Pair.Value);
+        EndMutate(Pair.Key, Entry, PreviousHash);
+    }
+}
+
+FMotaEzValue& UMotaEzSaveData::BeginMutate(const FString& Key, uint64& OutPreviousHash)
+{
+    if (FMotaEzValue* Existing = Data.Find(Key))
+    {
+        OutPreviousHash = HashEntry(Key, *Existing);
+        AddToFingerprint(Key, 0 - OutPreviousHash);
+        return *Existing;
+    }
+
+    OutPreviousHash = 0;
+
+    // New keys are added under the exclusive lock, the only time the section map may grow
+    const FStringView Section = SectionOfKey(Key);
+    if (!SectionFingerprints.FindByHash(GetTypeHash(Section), Section))
+    {
+        SectionFingerprints.Add(FString(Section), 0);
+    }
+
+    if (bKeyIndexValid.load(std::memory_order_relaxed))
+    {
+        SortedKeys.Insert(Key, Algo::LowerBound(SortedKeys, Key, FKeyLess()));
+    }
+    return Data.Add(Key);
+}
+
+void UMotaEzSaveData::EnsureKeyIndex() const
+{
+    if (bKeyIndexValid.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    // Several readers may get here under the shared structure lock; one of them builds
+    FScopeLock BuildLock(&KeyIndexBuildLock);
+    if (bKeyIndexValid.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_BuildKeyIndex);
+
+    Data.GenerateKeyArray(SortedKeys);
+    Algo::Sort(SortedKeys, FKeyLess());
+    bKeyIndexValid.store(true, std::memory_order_release);
+}
+
+void UMotaEzSaveData::InvalidateKeyIndex()
+{
+    bKeyIndexValid.store(false, std::memory_order_relaxed);
+    SortedKeys.Empty();
+}
+
+void UMotaEzSaveData::PrepareKeyIndexForBatch(int32 NumWrites)
+{
+    if (NumWrites > KeyIndexRebuildThreshold && bKeyIndexValid.load(std::memory_order_relaxed))
+    {
+        InvalidateKeyIndex();
+    }
+}
+
+void UMotaEzSaveData::FindPrefixRange(const FString& Prefix, int32& OutBegin, int32& OutEnd) const
+{
+    // Keys sharing a prefix are contiguous in sorted order and the prefix itself sorts first
+    OutBegin = Algo::LowerBound(SortedKeys, Prefix, FKeyLess());
+    OutEnd = OutBegin;
+    while (OutEnd < SortedKeys.Num() && SortedKeys[OutEnd].StartsWith(Prefix, ESearchCase::IgnoreCase))
+    {
+        ++OutEnd;
+    }
+}
+
+TArray<FString> UMotaEzSaveData::GetKeysWithPrefix(const FString& Prefix) const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+    EnsureKeyIndex();
+
+    int32 Begin = 0;
+    int32 End = 0;
+    FindPrefixRange(Prefix, Begin, End);
+    return TArray<FString>(SortedKeys.GetData() + Begin, End - Begin);
+}
+
+int32 UMotaEzSaveData::RemoveKeysWithPrefix(const FString& Prefix)
+{
+    if (Prefix.IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: RemoveKeysWithPrefix called with an empty prefix; use ClearData"));
+        return 0;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_RemoveKeysWithPrefix);
+
+    if (IsEditingOnThisThread())
+    {
+        // Staged like single removals: matching staged writes are dropped, stored keys are staged for removal
+        int32 Removed = 0;
+        {
+            FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+            for (auto It = StagedWrites.CreateIterator(); It; ++It)
+            {
+                if (It.Key().StartsWith(Prefix, ESearchCase::IgnoreCase))
+                {
+                    // Stored keys are counted below when they are staged for removal
+                    Removed += Data.Contains(It.Key()) ? 0 : 1;
+                    It.RemoveCurrent();
+                }
+            }
+        }
+        for (const FString& Key : GetKeysWithPrefix(Prefix))
+        {
+            bool bAlreadyInSet = false;
+            StagedRemovals.Add(Key, &bAlreadyInSet);
+            Removed += bAlreadyInSet ? 0 : 1;
+        }
+        return Removed;
+    }
+
+    FExclusiveScope Lock(*this);
+    EnsureKeyIndex();
+
+    int32 Begin = 0;
+    int32 End = 0;
+    FindPrefixRange(Prefix, Begin, End);
+
+    const bool bRecord = HasChangeListeners();
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        const FString& Key = SortedKeys[Index];
+        if (const FMotaEzValue* Found = Data.Find(Key))
+        {
+            AddToFingerprint(Key, 0 - HashEntry(Key, *Found));
+            Data.Remove(Key);
+        }
+        if (bRecord)
+        {
+            RecordChange(Key);
+        }
+    }
+
+    // One shift of the tail for the whole range
+    SortedKeys.RemoveAt(Begin, End - Begin, EAllowShrinking::No);
+    return End - Begin;
+}
+
+void UMotaEzSaveData::ForEachKeyWithPrefix(const FString& Prefix, TFunctionRef<void(const FString&, const FMotaEzValue&)> Visitor) const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+    EnsureKeyIndex();
+
+    int32 Begin = 0;
+    int32 End = 0;
+    FindPrefixRange(Prefix, Begin, End);
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        Visitor(SortedKeys[Index], Data.FindChecked(SortedKeys[Index]));
+    }
+}
+
+void UMotaEzSaveData::ForEachKeyInRange(const FString& First, const FString& Last, TFunctionRef<void(const FString&, const FMotaEzValue&)> Visitor) const
+{
+    FKeyLockScope Lock(*this, TConstArrayView<FString>(), false);
+    EnsureKeyIndex();
+
+    const int32 Begin = Algo::LowerBound(SortedKeys, First, FKeyLess());
+    const int32 End = Last.IsEmpty() ? SortedKeys.Num() : Algo::LowerBound(SortedKeys, Last, FKeyLess());
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        Visitor(SortedKeys[Index], Data.FindChecked(SortedKeys[Index]));
+    }
+}
+
+void UMotaEzSaveData::EndMutate(const FString& Key, const FMotaEzValue& Entry, uint64 PreviousHash)
+{
+    const uint64 NewHash = HashEntry(Key, Entry);
+    AddToFingerprint(Key, NewHash);
+
+    // Writing the value a key already had is not a change
+    if (NewHash != PreviousHash && HasChangeListeners())
+    {
+        RecordChange(Key);
+    }
+}
+
+FDelegateHandle UMotaEzSaveData::SubscribeKeys(const TArray<FString>& Keys, FMotaEzKeysChangedDelegate Delegate)
+{
+    check(IsInGameThread());
+
+    FKeySubscription& Subscription = KeySubscriptions.AddDefaulted_GetRef();
+    Subscription.Keys.Append(Keys);
+    Subscription.Delegate = MoveTemp(Delegate);
+    Subscription.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+    return Subscription.Handle;
+}
+
+FDelegateHandle UMotaEzSaveData::SubscribePrefix(const FString& Prefix, FMotaEzKeysChangedDelegate Delegate)
+{
+    check(IsInGameThread());
+
+    FKeySubscription& Subscription = KeySubscriptions.AddDefaulted_GetRef();
+    Subscription.Prefix = Prefix;
+    Subscription.Delegate = MoveTemp(Delegate);
+    Subscription.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+    return Subscription.Handle;
+}
+
+void UMotaEzSaveData::Unsubscribe(FDelegateHandle Handle)
+{
+    check(IsInGameThread());
+
+    KeySubscriptions.RemoveAll([Handle](const FKeySubscription& Subscription)
+    {
+        return Subscription.Handle == Handle;
+    });
+}
+
+void UMotaEzSaveData::RecordChange(const FString& Key)
+{
+    if (UndoHistory.IsValid())
+    {
+        UndoHistory->MarkChanged(Key);
+        if (KeySubscriptions.Num() == 0 && !OnKeysChanged.IsBound())
+        {
+            return;
+        }
+    }
+
+    FScopeLock Lock(&PendingChangesLock);
+    PendingChanges.Add(Key);
+
+    // The ticker only exists while there is something to deliver
+    if (!ChangeTickerHandle.IsValid())
+    {
+        ChangeTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+        {
+            DeliverChanges();
+            return false;
+        }));
+    }
+}
+
+void UMotaEzSaveData::DeliverChanges()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_DeliverChanges);
+
+    TArray<FString> Changed;
+    {
+        FScopeLock Lock(&PendingChangesLock);
+        Changed = PendingChanges.Array();
+        PendingChanges.Reset();
+        ChangeTickerHandle.Reset();
+    }
+
+    if (Changed.Num() == 0)
+    {
+        return;
+    }
+
+    // Delegates may subscribe or unsubscribe, so iterate over a copy
+    const TArray<FKeySubscription> Subscriptions = KeySubscriptions;
+    TArray<FString> Matching;
+    for (const FKeySubscription& Subscription : Subscriptions)
+    {
+        Matching.Reset();
+        for (const FString& Key : Changed)
+        {
+            const bool bMatches = Subscription.Prefix.IsEmpty()
+                ? Subscription.Keys.Contains(Key)
+                : Key.StartsWith(Subscription.Prefix, ESearchCase::IgnoreCase);
+            if (bMatches)
+            {
+                Matching.Add(Key);
+            }
+        }
+
+        if (Matching.Num() > 0)
+        {
+            Subscription.Delegate.ExecuteIfBound(Matching);
+        }
+    }
+
+    OnKeysChanged.Broadcast(this, Changed);
+}
+
+
+int32 UMotaEzSaveData::GetInt(const FString& Key, int32 DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToInt(FindValue(Key), DefaultValue);
+}
+
+float UMotaEzSaveData::GetFloat(const FString& Key, float DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToFloat(FindValue(Key), DefaultValue);
+}
+
+bool UMotaEzSaveData::GetBool(const FString& Key, bool DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToBool(FindValue(Key), DefaultValue);
+}
+
+FString UMotaEzSaveData::GetString(const FString& Key, const FString& DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToString(FindValue(Key), DefaultValue);
+}
+
+FVector UMotaEzSaveData::GetVector(const FString& Key, const FVector& DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToVector(FindValue(Key), DefaultValue);
+}
+
+FRotator UMotaEzSaveData::GetRotator(const FString& Key, const FRotator& DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToRotator(FindValue(Key), DefaultValue);
+}
+
+int64 UMotaEzSaveData::GetInt64(const FString& Key, int64 DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToInt64(FindValue(Key), DefaultValue);
+}
+
+double UMotaEzSaveData::GetDouble(const FString& Key, double DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToDouble(FindValue(Key), DefaultValue);
+}
+
+FQuat UMotaEzSaveData::GetQuat(const FString& Key, const FQuat& DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToQuat(FindValue(Key), DefaultValue);
+}
+
+FTransform UMotaEzSaveData::GetTransform(const FString& Key, const FTransform& DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToTransform(FindValue(Key), DefaultValue);
+}
+
+FLinearColor UMotaEzSaveData::GetLinearColor(const FString& Key, const FLinearColor& DefaultValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToLinearColor(FindValue(Key), DefaultValue);
+}
+
+void UMotaEzSaveData::SetInt(const FString& Key, int32 Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Int;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = LexToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetFloat(const FString& Key, float Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Float;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = LexToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetBool(const FString& Key, bool Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Bool;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = BoolToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetString(const FString& Key, const FString& Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::String;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = Value;
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetVector(const FString& Key, const FVector& Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Vector;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = VectorToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetRotator(const FString& Key, const FRotator& Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Rotator;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = RotatorToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetInt64(const FString& Key, int64 Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Int64;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = LexToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetDouble(const FString& Key, double Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Double;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = DoubleToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetQuat(const FString& Key, const FQuat& Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Quat;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = QuatToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetTransform(const FString& Key, const FTransform& Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Transform;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = TransformToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+void UMotaEzSaveData::SetLinearColor(const FString& Key, const FLinearColor& Value)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::LinearColor;
+        Entry.bIsArray = false;
+        Entry.ScalarValue = LinearColorToString(Value);
+        Entry.ArrayValues.Reset();
+    });
+}
+
+TArray<int32> UMotaEzSaveData::GetIntArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<int32> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Int)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(FCString::Atoi(*S));
+    }
+    return Result;
+}
+
+TArray<float> UMotaEzSaveData::GetFloatArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<float> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Float)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(FCString::Atof(*S));
+    }
+    return Result;
+}
+
+TArray<bool> UMotaEzSaveData::GetBoolArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<bool> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Bool)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(StringToBool(S));
+    }
+    return Result;
+}
+
+TArray<FString> UMotaEzSaveData::GetStringArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::String)
+    {
+        return {};
+    }
+
+    return Found->ArrayValues;
+}
+
+TArray<FVector> UMotaEzSaveData::GetVectorArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<FVector> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Vector)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(ParseVectorElem(S));
+    }
+    return Result;
+}
+
+TArray<FRotator> UMotaEzSaveData::GetRotatorArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<FRotator> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Rotator)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(ParseRotatorElem(S));
+    }
+    return Result;
+}
+
+TArray<int64> UMotaEzSaveData::GetInt64Array(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<int64> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Int64)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(FCString::Atoi64(*S));
+    }
+    return Result;
+}
+
+TArray<double> UMotaEzSaveData::GetDoubleArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<double> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Double)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(FCString::Atod(*S));
+    }
+    return Result;
+}
+
+TArray<FQuat> UMotaEzSaveData::GetQuatArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<FQuat> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Quat)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(StringToQuat(S, FQuat::Identity));
+    }
+    return Result;
+}
+
+TArray<FTransform> UMotaEzSaveData::GetTransformArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<FTransform> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::Transform)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(StringToTransform(S, FTransform::Identity));
+    }
+    return Result;
+}
+
+TArray<FLinearColor> UMotaEzSaveData::GetLinearColorArray(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Found = FindValue(Key);
+    TArray<FLinearColor> Result;
+
+    if (!Found || !Found->IsArray() || Found->Type != EMotaEzFieldType::LinearColor)
+    {
+        return Result;
+    }
+
+    Result.Reserve(Found->ArrayValues.Num());
+    for (const FString& S : Found->ArrayValues)
+    {
+        Result.Add(StringToLinearColor(S, FLinearColor::White));
+    }
+    return Result;
+}
+
+void UMotaEzSaveData::SetIntArray(const FString& Key, const TArray<int32>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Int;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (int32 V : Values)
+        {
+            Entry.ArrayValues.Add(LexToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetFloatArray(const FString& Key, const TArray<float>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Float;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (float V : Values)
+        {
+            Entry.ArrayValues.Add(LexToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetBoolArray(const FString& Key, const TArray<bool>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Bool;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (bool V : Values)
+        {
+            Entry.ArrayValues.Add(BoolToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetStringArray(const FString& Key, const TArray<FString>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::String;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues = Values;
+    });
+}
+
+void UMotaEzSaveData::SetVectorArray(const FString& Key, const TArray<FVector>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Vector;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (const FVector& V : Values)
+        {
+            Entry.ArrayValues.Add(VectorToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetRotatorArray(const FString& Key, const TArray<FRotator>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Rotator;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (const FRotator& R : Values)
+        {
+            Entry.ArrayValues.Add(RotatorToString(R));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetInt64Array(const FString& Key, const TArray<int64>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Int64;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (int64 V : Values)
+        {
+            Entry.ArrayValues.Add(LexToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetDoubleArray(const FString& Key, const TArray<double>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Double;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (double V : Values)
+        {
+            Entry.ArrayValues.Add(DoubleToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetQuatArray(const FString& Key, const TArray<FQuat>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Quat;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (const FQuat& V : Values)
+        {
+            Entry.ArrayValues.Add(QuatToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetTransformArray(const FString& Key, const TArray<FTransform>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::Transform;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (const FTransform& V : Values)
+        {
+            Entry.ArrayValues.Add(TransformToString(V));
+        }
+    });
+}
+
+void UMotaEzSaveData::SetLinearColorArray(const FString& Key, const TArray<FLinearColor>& Values)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry.Type = EMotaEzFieldType::LinearColor;
+        Entry.bIsArray = true;
+        Entry.ScalarValue.Reset();
+        Entry.ArrayValues.Reset();
+
+        Entry.ArrayValues.Reserve(Values.Num());
+        for (const FLinearColor& V : Values)
+        {
+            Entry.ArrayValues.Add(LinearColorToString(V));
+        }
+    });
+}
+
+bool UMotaEzSaveData::GetStructValue(const FString& Key, const UScriptStruct* Struct, void* OutValue) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToStruct(FindValue(Key), Struct, OutValue);
+}
+
+bool UMotaEzSaveData::GetStructArrayValue(const FString& Key, const UScriptStruct* Struct, TFunctionRef<void*(int32)> Resize) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToStructArray(FindValue(Key), Struct, Resize);
+}
+
+void UMotaEzSaveData::SetStructValue(const FString& Key, const UScriptStruct* Struct, const void* Value)
+{
+    if (!Struct || !Value)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: SetStructValue - no struct given for %s"), *Key);
+        return;
+    }
+
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        UMotaEzStructCodec::MakeValue(Struct, Value, 1, false, Entry);
+    });
+}
+
+void UMotaEzSaveData::SetStructArrayValue(const FString& Key, const UScriptStruct* Struct, const void* Values, int32 Num)
+{
+    if (!Struct || Num < 0 || (Num > 0 && !Values))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: SetStructArrayValue - invalid values for %s"), *Key);
+        return;
+    }
+
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        UMotaEzStructCodec::MakeValue(Struct, Values, Num, true, Entry);
+    });
+}
+
+FMotaEzBlobPtr UMotaEzSaveData::GetBlob(const FString& Key) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    return ValueToBlob(FindValue(Key));
+}
+
+bool UMotaEzSaveData::GetBlobBytes(const FString& Key, TArray<uint8>& OutBytes) const
+{
+    FKeyLockScope Lock(*this, Key, false);
+    const FMotaEzValue* Value = FindValue(Key);
+    if (!Value || Value->Type != EMotaEzFieldType::Blob)
+    {
+        return false;
+    }
+
+    const FMotaEzBlobPtr Bytes = Value->BlobData;
+    OutBytes = Bytes.IsValid() ? *Bytes : TArray<uint8>();
+    return true;
+}
+
+void UMotaEzSaveData::SetBlob(const FString& Key, FMotaEzBlobPtr Bytes)
+{
+    WriteValue(Key, [&](FMotaEzValue& Entry)
+    {
+        Entry = MakeBlob(MoveTemp(Bytes));
+    });
+}
+
+void UMotaEzSaveData::SetBlob(const FString& Key, TArray<uint8>&& Bytes)
+{
+    SetBlob(Key, MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Bytes)));
+}
+
+void UMotaEzSaveData::SetBlobBytes(const FString& Key, const TArray<uint8>& Bytes)
+{
+    SetBlob(Key, MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(Bytes));
+}
+
+void UMotaEzSaveData::EnableUndoHistory(int32 Capacity)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_EnableUndoHistory);
+
+    FExclusiveScope Lock(*this);
+
+    FMotaEzPersistentMap State;
+    for (const auto& Pair : Data)
+    {
+        State = State.Set(Pair.Key, Pair.Value, HashEntry(Pair.Key, Pair.Value));
+    }
+    UndoHistory = MakeUnique<FMotaEzUndoHistory>(Capacity, MoveTemp(State));
+}
+
+void UMotaEzSaveData::DisableUndoHistory()
+{
+    check(IsInGameThread());
+
+    FExclusiveScope Lock(*this);
+    UndoHistory.Reset();
+}
+
+bool UMotaEzSaveData::CanStepUndoHistory(const TCHAR* Operation) const
+{
+    if (!UndoHistory.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s called without undo history; call EnableUndoHistory first"), Operation);
+        return false;
+    }
+    if (IsEditingOnThisThread())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s called inside an open edit; commit or abort it first"), Operation);
+        return false;
+    }
+    return true;
+}
+
+int32 UMotaEzSaveData::Checkpoint(const FString& Label)
+{
+    check(IsInGameThread());
+    if (!CanStepUndoHistory(TEXT("Checkpoint")))
+    {
+        return INDEX_NONE;
+    }
+
+    FExclusiveScope Lock(*this);
+    return CommitUndoCheckpoint(Label);
+}
+
+int32 UMotaEzSaveData::CommitUndoCheckpoint(const FString& Label)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_Checkpoint);
+
+    const FMotaEzUndoHistory::FCheckpoint& Current = UndoHistory->GetCurrent();
+    FMotaEzPersistentMap State = Current.State;
+
+    TSet<FString> ChangedKeys;
+    if (UndoHistory->TakePendingChanges(ChangedKeys))
+    {
+        // Data was replaced wholesale: compare every key, still sharing the entries that kept their values
+        for (const auto& Pair : Data)
+        {
+            State = State.Set(Pair.Key, Pair.Value, HashEntry(Pair.Key, Pair.Value));
+        }
+
+        TArray<FString> RemovedKeys;
+        Current.State.ForEach([this, &RemovedKeys](const FMotaEzPersistentMap::FEntry& Entry)
+        {
+            if (!Data.Contains(Entry.Key))
+            {
+                RemovedKeys.Add(Entry.Key);
+            }
+        });
+        for (const FString& Key : RemovedKeys)
+        {
+            State = State.Remove(Key);
+        }
+    }
+    else
+    {
+        for (const FString& Key : ChangedKeys)
+        {
+            const FMotaEzValue* Found = Data.Find(Key);
+            State = Found ? State.Set(Key, *Found, HashEntry(Key, *Found)) : State.Remove(Key);
+        }
+    }
+
+    // Keys written back to the values they had leave the map untouched, so they do not make a step
+    if (State.IsSameVersion(Current.State))
+    {
+        return Current.Id;
+    }
+    return UndoHistory->Push(Label, MoveTemp(State));
+}
+
+void UMotaEzSaveData::ApplyUndoCheckpoint(int32 Index)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_ApplyUndoCheckpoint);
+
+    // Data matches the current checkpoint (pending changes were just checkpointed), so only the differing keys are written.
+    // The values stay alive in the target checkpoint while they are copied in.
+    TArray<TPair<FString, const FMotaEzValue*>> Changes;
+    UndoHistory->GetCurrent().State.Diff(UndoHistory->Get(Index).State, [&Changes](const FString& Key, const FMotaEzValue*, const FMotaEzValue* After)
+    {
+        Changes.Emplace(Key, After);
+    });
+
+    PrepareKeyIndexForBatch(Changes.Num());
+    for (const TPair<FString, const FMotaEzValue*>& Change : Changes)
+    {
+        if (!Change.Value)
+        {
+            RemoveStoredKey(Change.Key);
+            continue;
+        }
+
+        uint64 PreviousHash = 0;
+        FMotaEzValue& Entry = BeginMutate(Change.Key, PreviousHash);
+        Entry = *Change.Value;
+        EndMutate(Change.Key, Entry, PreviousHash);
+    }
+
+    // The writes above restore a checkpoint rather than start a new one
+    UndoHistory->DiscardPendingChanges();
+    UndoHistory->SetCursor(Index);
+}
+
+bool UMotaEzSaveData::Undo()
+{
+    check(IsInGameThread());
+    if (!CanStepUndoHistory(TEXT("Undo")))
+    {
+        return false;
+    }
+
+    FExclusiveScope Lock(*this);
+    CommitUndoCheckpoint(FString());
+
+    if (UndoHistory->GetCursor() == 0)
+    {
+        return false;
+    }
+    ApplyUndoCheckpoint(UndoHistory->GetCursor() - 1);
+    return true;
+}
+
+bool UMotaEzSaveData::Redo()
+{
+    check(IsInGameThread());
+    if (!CanStepUndoHistory(TEXT("Redo")))
+    {
+        return false;
+    }
+
+    FExclusiveScope Lock(*this);
+    CommitUndoCheckpoint(FString());
+
+    if (UndoHistory->GetCursor() + 1 >= UndoHistory->Num())
+    {
+        return false;
+    }
+    ApplyUndoCheckpoint(UndoHistory->GetCursor() + 1);
+    return true;
+}
+
+bool UMotaEzSaveData::CanUndo() const
+{
+    return UndoHistory.IsValid() && (UndoHistory->GetCursor() > 0 || UndoHistory->HasPendingChanges());
+}
+
+bool UMotaEzSaveData::CanRedo() const
+{
+    return UndoHistory.IsValid() && UndoHistory->GetCursor() + 1 < UndoHistory->Num() && !UndoHistory->HasPendingChanges();
+}
+
+bool UMotaEzSaveData::RestoreCheckpoint(int32 CheckpointId)
+{
+    check(IsInGameThread());
+    if (!CanStepUndoHistory(TEXT("RestoreCheckpoint")))
+    {
+        return false;
+    }
+
+    FExclusiveScope Lock(*this);
+    CommitUndoCheckpoint(FString());
+
+    const int32 Index = UndoHistory->IndexOfId(CheckpointId);
+    if (Index == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Checkpoint %d is not in the undo history"), CheckpointId);
+        return false;
+    }
+    ApplyUndoCheckpoint(Index);
+    return true;
+}
+
+int32 UMotaEzSaveData::GetCurrentCheckpoint() const
+{
+    return UndoHistory.IsValid() ? UndoHistory->GetCurrent().Id : INDEX_NONE;
+}
+
+bool UMotaEzSaveData::DiffCheckpoints(int32 FromCheckpointId, int32 ToCheckpointId, TArray<FMotaEzKeyChange>& OutChanges) const
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_DiffCheckpoints);
+
+    OutChanges.Reset();
+    if (!UndoHistory.IsValid())
+    {
+        return false;
+    }
+
+    const int32 FromIndex = UndoHistory->IndexOfId(FromCheckpointId);
+    const int32 ToIndex = UndoHistory->IndexOfId(ToCheckpointId);
+    if (FromIndex == INDEX_NONE || ToIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    UndoHistory->Get(FromIndex).State.Diff(UndoHistory->Get(ToIndex).State, [&OutChanges](const FString& Key, const FMotaEzValue* Before, const FMotaEzValue* After)
+    {
+        FMotaEzKeyChange& Change = OutChanges.AddDefaulted_GetRef();
+        Change.Key = Key;
+        Change.Change = !Before ? EMotaEzKeyChangeType::Added : (!After ? EMotaEzKeyChangeType::Removed : EMotaEzKeyChangeType::Modified);
+    });
+
+    Algo::Sort(OutChanges, [](const FMotaEzKeyChange& A, const FMotaEzKeyChange& B)
+    {
+        return FKeyLess()(A.Key, B.Key);
+    });
+    return true;
+}
+
+FMotaEzEditScope::FMotaEzEditScope(UMotaEzSaveData* InSaveData)
+    : SaveData(InSaveData)
+{
+    if (SaveData)
+    {
+        SaveData->BeginEdit();
+    }
+}
+
+FMotaEzEditScope::~FMotaEzEditScope()
+{
+    if (SaveData && !bFinished)
+    {
+        SaveData->AbortEdit();
+    }
+}
+
+bool FMotaEzEditScope::Commit(FMotaEzValidationResult* OutResult)
+{
+    if (!SaveData || bFinished)
+    {
+        return false;
+    }
+
+    bFinished = true;
+    FMotaEzValidationResult Result;
+    const bool bCommitted = SaveData->CommitEdit(Result);
+    if (OutResult)
+    {
+        *OutResult = Result;
+    }
+    return bCommitted;
+}
+
+void FMotaEzEditScope::Abort()
+{
+    if (SaveData && !bFinished)
     {
-        Entry.ArrayValues.Add(RotatorToString(R));
+        bFinished = true;
+        SaveData->AbortEdit();
     }
 }
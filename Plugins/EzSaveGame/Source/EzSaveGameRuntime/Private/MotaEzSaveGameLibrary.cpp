@@ -4,6 +4,7 @@
 #include "MotaEzSaveGameSettings.h"
 #include "MotaEzSchemaGenerator.h"
 #include "MotaEzSlotManager.h"
+#include "MotaEzValueConversion.h"
 #include "Engine/World.h"
 #include "Engine/GameInstance.h"
 #include "Engine/Engine.h"
@@ -11,6 +12,58 @@
 #include "HAL/PlatformProcess.h"
 #include "HAL/FileManager.h"
 
+namespace
+{
+    /**
+     * Game-thread cache of resolved subsystems.
+     * The last context object is remembered so a burst of calls from one actor skips even the
+     * world lookup; other contexts hit the per-world map. Both are dropped on world cleanup.
+     */
+    struct FSubsystemCache
+    {
+        TMap<TObjectKey<UWorld>, TWeakObjectPtr<UMotaEzConfigSubsystem>> ByWorld;
+        TObjectKey<UObject> LastContext;
+        TWeakObjectPtr<UMotaEzConfigSubsystem> LastSubsystem;
+        FDelegateHandle WorldCleanupHandle;
+
+        UMotaEzConfigSubsystem* FindForContext(const UObject* WorldContextObject) const
+        {
+            return LastContext == TObjectKey<UObject>(WorldContextObject) ? LastSubsystem.Get() : nullptr;
+        }
+
+        UMotaEzConfigSubsystem* FindForWorld(const UWorld* World) const
+        {
+            const TWeakObjectPtr<UMotaEzConfigSubsystem>* Found = ByWorld.Find(World);
+            return Found ? Found->Get() : nullptr;
+        }
+
+        void Add(const UObject* WorldContextObject, const UWorld* World, UMotaEzConfigSubsystem* Subsystem)
+        {
+            if (!WorldCleanupHandle.IsValid())
+            {
+                WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([this](UWorld* CleanedWorld, bool, bool)
+                {
+                    ByWorld.Remove(CleanedWorld);
+                    LastContext = TObjectKey<UObject>();
+                    LastSubsystem.Reset();
+                });
+            }
+
+            ByWorld.Add(World, Subsystem);
+            LastContext = TObjectKey<UObject>(WorldContextObject);
+            LastSubsystem = Subsystem;
+        }
+    };
+
+    FSubsystemCache SubsystemCache;
+}
+
+UMotaEzSaveData* FMotaEzSaveStoreHandle::Get() const
+{
+    UMotaEzConfigSubsystem* Resolved = Subsystem.Get();
+    return Resolved ? Resolved->GetCurrentSave() : nullptr;
+}
+
 UMotaEzConfigSubsystem* UMotaEzSaveGameLibrary::GetSubsystem(const UObject* WorldContextObject)
 {
     if (!WorldContextObject)
@@ -18,19 +71,293 @@ UMotaEzConfigSubsystem* UMotaEzSaveGameLibrary::GetSubsystem(const UObject* Worl
         return nullptr;
     }
 
+    // The cache is not synchronized; other threads always take the full path
+    const bool bUseCache = IsInGameThread();
+    if (bUseCache)
+    {
+        if (UMotaEzConfigSubsystem* Cached = SubsystemCache.FindForContext(WorldContextObject))
+        {
+            return Cached;
+        }
+    }
+
     UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
     if (!World)
     {
         return nullptr;
     }
 
+    if (bUseCache)
+    {
+        if (UMotaEzConfigSubsystem* Cached = SubsystemCache.FindForWorld(World))
+        {
+            return Cached;
+        }
+    }
+
     UGameInstance* GameInstance = World->GetGameInstance();
     if (!GameInstance)
     {
         return nullptr;
     }
 
-    return GameInstance->GetSubsystem<UMotaEzConfigSubsystem>();
+    UMotaEzConfigSubsystem* Subsystem = GameInstance->GetSubsystem<UMotaEzConfigSubsystem>();
+    if (bUseCache && Subsystem)
+    {
+        SubsystemCache.Add(WorldContextObject, World, Subsystem);
+    }
+    return Subsystem;
+}
+
+namespace
+{
+    using namespace MotaEzValueConversion;
+
+    FORCEINLINE FMotaEzBatchEntry MakeEntry(const FString& Key, EMotaEzFieldType Type, FString ScalarValue)
+    {
+        FMotaEzBatchEntry Entry;
+        Entry.Key = Key;
+        Entry.Value = MakeScalar(Type, MoveTemp(ScalarValue));
+        return Entry;
+    }
+}
+
+FMotaEzBatch& FMotaEzBatch::Int(const FString& Key, int32 Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Int, LexToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Float(const FString& Key, float Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Float, LexToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Bool(const FString& Key, bool Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Bool, BoolToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::String(const FString& Key, const FString& Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::String, Value));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Vector(const FString& Key, const FVector& Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Vector, VectorToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Rotator(const FString& Key, const FRotator& Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Rotator, RotatorToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Int64(const FString& Key, int64 Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Int64, LexToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Double(const FString& Key, double Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Double, DoubleToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Quat(const FString& Key, const FQuat& Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Quat, QuatToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Transform(const FString& Key, const FTransform& Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::Transform, TransformToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::LinearColor(const FString& Key, const FLinearColor& Value)
+{
+    Entries.Add(MakeEntry(Key, EMotaEzFieldType::LinearColor, LinearColorToString(Value)));
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Struct(const FString& Key, const UScriptStruct* StructType, const void* Value)
+{
+    FMotaEzBatchEntry Entry;
+    Entry.Key = Key;
+    if (UMotaEzStructCodec::MakeValue(StructType, Value, 1, false, Entry.Value))
+    {
+        Entries.Add(MoveTemp(Entry));
+    }
+    return *this;
+}
+
+FMotaEzBatch& FMotaEzBatch::Blob(const FString& Key, FMotaEzBlobPtr Bytes)
+{
+    FMotaEzBatchEntry Entry;
+    Entry.Key = Key;
+    Entry.Value = MakeBlob(MoveTemp(Bytes));
+    Entries.Add(MoveTemp(Entry));
+    return *this;
+}
+
+void UMotaEzSaveGameLibrary::EzSetMany(const UObject* WorldContextObject, const TArray<FMotaEzBatchEntry>& Entries)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetValues(Entries);
+}
+
+TArray<FMotaEzValue> UMotaEzSaveGameLibrary::EzGetMany(const UObject* WorldContextObject, const TArray<FString>& Keys)
+{
+    TArray<FMotaEzValue> Values;
+
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    UMotaEzSaveData* SaveData = Subsystem ? Subsystem->GetCurrentSave() : nullptr;
+    if (!SaveData)
+    {
+        Values.SetNum(Keys.Num());
+        return Values;
+    }
+
+    SaveData->GetValues(Keys, Values);
+    return Values;
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzIntEntry(const FString& Key, int32 Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Int, LexToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzFloatEntry(const FString& Key, float Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Float, LexToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzBoolEntry(const FString& Key, bool Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Bool, BoolToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzStringEntry(const FString& Key, const FString& Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::String, Value);
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzVectorEntry(const FString& Key, FVector Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Vector, VectorToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzRotatorEntry(const FString& Key, FRotator Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Rotator, RotatorToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzInt64Entry(const FString& Key, int64 Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Int64, LexToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzDoubleEntry(const FString& Key, double Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Double, DoubleToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzQuatEntry(const FString& Key, const FQuat& Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Quat, QuatToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzTransformEntry(const FString& Key, const FTransform& Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::Transform, TransformToString(Value));
+}
+
+FMotaEzBatchEntry UMotaEzSaveGameLibrary::MakeEzLinearColorEntry(const FString& Key, const FLinearColor& Value)
+{
+    return MakeEntry(Key, EMotaEzFieldType::LinearColor, LinearColorToString(Value));
+}
+
+int32 UMotaEzSaveGameLibrary::EzValueAsInt(const FMotaEzValue& Value, int32 DefaultValue)
+{
+    return ValueToInt(&Value, DefaultValue);
+}
+
+float UMotaEzSaveGameLibrary::EzValueAsFloat(const FMotaEzValue& Value, float DefaultValue)
+{
+    return ValueToFloat(&Value, DefaultValue);
+}
+
+bool UMotaEzSaveGameLibrary::EzValueAsBool(const FMotaEzValue& Value, bool DefaultValue)
+{
+    return ValueToBool(&Value, DefaultValue);
+}
+
+FString UMotaEzSaveGameLibrary::EzValueAsString(const FMotaEzValue& Value, const FString& DefaultValue)
+{
+    return ValueToString(&Value, DefaultValue);
+}
+
+FVector UMotaEzSaveGameLibrary::EzValueAsVector(const FMotaEzValue& Value, FVector DefaultValue)
+{
+    return ValueToVector(&Value, DefaultValue);
+}
+
+FRotator UMotaEzSaveGameLibrary::EzValueAsRotator(const FMotaEzValue& Value, FRotator DefaultValue)
+{
+    return ValueToRotator(&Value, DefaultValue);
+}
+
+int64 UMotaEzSaveGameLibrary::EzValueAsInt64(const FMotaEzValue& Value, int64 DefaultValue)
+{
+    return ValueToInt64(&Value, DefaultValue);
+}
+
+double UMotaEzSaveGameLibrary::EzValueAsDouble(const FMotaEzValue& Value, double DefaultValue)
+{
+    return ValueToDouble(&Value, DefaultValue);
+}
+
+FQuat UMotaEzSaveGameLibrary::EzValueAsQuat(const FMotaEzValue& Value, const FQuat& DefaultValue)
+{
+    return ValueToQuat(&Value, DefaultValue);
+}
+
+FTransform UMotaEzSaveGameLibrary::EzValueAsTransform(const FMotaEzValue& Value, const FTransform& DefaultValue)
+{
+    return ValueToTransform(&Value, DefaultValue);
+}
+
+FLinearColor UMotaEzSaveGameLibrary::EzValueAsLinearColor(const FMotaEzValue& Value, const FLinearColor& DefaultValue)
+{
+    return ValueToLinearColor(&Value, DefaultValue);
+}
+
+FMotaEzSaveStoreHandle UMotaEzSaveGameLibrary::ResolveSaveStore(const UObject* WorldContextObject)
+{
+    return FMotaEzSaveStoreHandle(GetSubsystem(WorldContextObject));
+}
+
+UMotaEzSaveData* UMotaEzSaveGameLibrary::GetStoreSaveData(const FMotaEzSaveStoreHandle& Store)
+{
+    return Store.Get();
+}
+
+bool UMotaEzSaveGameLibrary::IsSaveStoreValid(const FMotaEzSaveStoreHandle& Store)
+{
+    return Store.IsValid();
 }
 
 bool UMotaEzSaveGameLibrary::QuickSave(const UObject* WorldContextObject)
@@ -135,6 +462,61 @@ FRotator UMotaEzSaveGameLibrary::EzGetRotator(const UObject* WorldContextObject,
     return SaveData->GetRotator(Key, DefaultValue);
 }
 
+int64 UMotaEzSaveGameLibrary::EzGetInt64(const UObject* WorldContextObject, const FString& Key, int64 DefaultValue)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return DefaultValue;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return DefaultValue;
+
+    return SaveData->GetInt64(Key, DefaultValue);
+}
+
+double UMotaEzSaveGameLibrary::EzGetDouble(const UObject* WorldContextObject, const FString& Key, double DefaultValue)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return DefaultValue;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return DefaultValue;
+
+    return SaveData->GetDouble(Key, DefaultValue);
+}
+
+FQuat UMotaEzSaveGameLibrary::EzGetQuat(const UObject* WorldContextObject, const FString& Key, const FQuat& DefaultValue)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return DefaultValue;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return DefaultValue;
+
+    return SaveData->GetQuat(Key, DefaultValue);
+}
+
+FTransform UMotaEzSaveGameLibrary::EzGetTransform(const UObject* WorldContextObject, const FString& Key, const FTransform& DefaultValue)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return DefaultValue;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return DefaultValue;
+
+    return SaveData->GetTransform(Key, DefaultValue);
+}
+
+FLinearColor UMotaEzSaveGameLibrary::EzGetLinearColor(const UObject* WorldContextObject, const FString& Key, const FLinearColor& DefaultValue)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return DefaultValue;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return DefaultValue;
+
+    return SaveData->GetLinearColor(Key, DefaultValue);
+}
+
 void UMotaEzSaveGameLibrary::EzSetInt(const UObject* WorldContextObject, const FString& Key, int32 Value)
 {
     UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
@@ -201,6 +583,105 @@ void UMotaEzSaveGameLibrary::EzSetRotator(const UObject* WorldContextObject, con
     SaveData->SetRotator(Key, Value);
 }
 
+void UMotaEzSaveGameLibrary::EzSetInt64(const UObject* WorldContextObject, const FString& Key, int64 Value)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetInt64(Key, Value);
+}
+
+void UMotaEzSaveGameLibrary::EzSetDouble(const UObject* WorldContextObject, const FString& Key, double Value)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetDouble(Key, Value);
+}
+
+void UMotaEzSaveGameLibrary::EzSetQuat(const UObject* WorldContextObject, const FString& Key, const FQuat& Value)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetQuat(Key, Value);
+}
+
+void UMotaEzSaveGameLibrary::EzSetTransform(const UObject* WorldContextObject, const FString& Key, const FTransform& Value)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetTransform(Key, Value);
+}
+
+void UMotaEzSaveGameLibrary::EzSetLinearColor(const UObject* WorldContextObject, const FString& Key, const FLinearColor& Value)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetLinearColor(Key, Value);
+}
+
+bool UMotaEzSaveGameLibrary::GetStructByType(const UObject* WorldContextObject, const FString& Key, const UScriptStruct* Struct, void* OutValue)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return false;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return false;
+
+    return SaveData->GetStructValue(Key, Struct, OutValue);
+}
+
+void UMotaEzSaveGameLibrary::SetStructByType(const UObject* WorldContextObject, const FString& Key, const UScriptStruct* Struct, const void* Value)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetStructValue(Key, Struct, Value);
+}
+
+bool UMotaEzSaveGameLibrary::EzGetBlob(const UObject* WorldContextObject, const FString& Key, TArray<uint8>& OutBytes)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return false;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return false;
+
+    return SaveData->GetBlobBytes(Key, OutBytes);
+}
+
+void UMotaEzSaveGameLibrary::EzSetBlob(const UObject* WorldContextObject, const FString& Key, const TArray<uint8>& Bytes)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return;
+
+    SaveData->SetBlobBytes(Key, Bytes);
+}
+
 bool UMotaEzSaveGameLibrary::HasKey(const UObject* WorldContextObject, const FString& Key)
 {
     UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
@@ -221,7 +702,29 @@ void UMotaEzSaveGameLibrary::RemoveKey(const UObject* WorldContextObject, const
     UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
     if (!SaveData) return;
 
-    SaveData->SetString(Key, TEXT(""));
+    SaveData->RemoveKey(Key);
+}
+
+TArray<FString> UMotaEzSaveGameLibrary::GetKeysWithPrefix(const UObject* WorldContextObject, const FString& Prefix)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return TArray<FString>();
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return TArray<FString>();
+
+    return SaveData->GetKeysWithPrefix(Prefix);
+}
+
+int32 UMotaEzSaveGameLibrary::RemoveKeysWithPrefix(const UObject* WorldContextObject, const FString& Prefix)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem) return 0;
+
+    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    if (!SaveData) return 0;
+
+    return SaveData->RemoveKeysWithPrefix(Prefix);
 }
 
 void UMotaEzSaveGameLibrary::ClearAllData(const UObject* WorldContextObject)
@@ -232,8 +735,8 @@ void UMotaEzSaveGameLibrary::ClearAllData(const UObject* WorldContextObject)
     UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
     if (!SaveData) return;
 
-    // Clear all data in memory (this will remove all keys)
-    SaveData->Data.Empty();
+    // Clear all stored values in memory (schema fields read their defaults again)
+    SaveData->ClearData();
     
     UE_LOG(LogTemp, Display, TEXT("EzSaveGame: All data in memory has been cleared"));
 }
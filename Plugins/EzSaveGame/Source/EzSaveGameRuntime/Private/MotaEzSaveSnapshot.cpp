@@ -0,0 +1,223 @@
+﻿#include "MotaEzSaveSnapshot.h"
+#include "MotaEzValueConversion.h"
+
+namespace
+{
+    using namespace MotaEzValueConversion;
+
+    /** Maximum number of threads that can be inside a read scope at the same time. */
+    constexpr int32 MaxReaderSlots = 256;
+
+    /** One reader thread's epoch; 0 while the thread is not reading. Padded so readers never share a line. */
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) FReaderSlot
+    {
+        std::atomic<uint64> Epoch{0};
+        std::atomic<bool> bClaimed{false};
+    };
+
+    FReaderSlot ReaderSlots[MaxReaderSlots];
+
+    /** Advanced by every publication; a snapshot retired in epoch E is unreachable once no reader is in an epoch <= E. */
+    std::atomic<uint64> GlobalEpoch{1};
+
+    /** Claims a reader slot on first use and gives it back when the thread exits. */
+    struct FThreadReaderState
+    {
+        int32 SlotIndex = INDEX_NONE;
+        int32 Depth = 0;
+
+        FReaderSlot& GetSlot()
+        {
+            if (SlotIndex == INDEX_NONE)
+            {
+                for (int32 Index = 0; Index < MaxReaderSlots; ++Index)
+                {
+                    bool bExpected = false;
+                    if (ReaderSlots[Index].bClaimed.compare_exchange_strong(bExpected, true))
+                    {
+                        SlotIndex = Index;
+                        break;
+                    }
+                }
+                checkf(SlotIndex != INDEX_NONE, TEXT("EzSaveGame: More than %d threads read save snapshots"), MaxReaderSlots);
+            }
+            return ReaderSlots[SlotIndex];
+        }
+
+        ~FThreadReaderState()
+        {
+            if (SlotIndex != INDEX_NONE)
+            {
+                ReaderSlots[SlotIndex].Epoch.store(0);
+                ReaderSlots[SlotIndex].bClaimed.store(false);
+            }
+        }
+    };
+
+    thread_local FThreadReaderState ThreadReaderState;
+
+    /** Oldest epoch an active reader is in, or MAX_uint64 if nobody is reading. */
+    uint64 GetOldestActiveEpoch()
+    {
+        uint64 Oldest = MAX_uint64;
+        for (const FReaderSlot& Slot : ReaderSlots)
+        {
+            const uint64 Epoch = Slot.Epoch.load();
+            if (Epoch != 0 && Epoch < Oldest)
+            {
+                Oldest = Epoch;
+            }
+        }
+        return Oldest;
+    }
+}
+
+const FMotaEzValue* FMotaEzSaveSnapshot::FindValue(const FString& Key) const
+{
+    if (const FMotaEzValue* Found = Data.Find(Key))
+    {
+        return Found;
+    }
+
+    return Defaults.IsValid() ? Defaults->Find(Key) : nullptr;
+}
+
+int32 FMotaEzSaveSnapshot::GetInt(const FString& Key, int32 DefaultValue) const
+{
+    return ValueToInt(FindValue(Key), DefaultValue);
+}
+
+float FMotaEzSaveSnapshot::GetFloat(const FString& Key, float DefaultValue) const
+{
+    return ValueToFloat(FindValue(Key), DefaultValue);
+}
+
+bool FMotaEzSaveSnapshot::GetBool(const FString& Key, bool DefaultValue) const
+{
+    return ValueToBool(FindValue(Key), DefaultValue);
+}
+
+FString FMotaEzSaveSnapshot::GetString(const FString& Key, const FString& DefaultValue) const
+{
+    return ValueToString(FindValue(Key), DefaultValue);
+}
+
+FVector FMotaEzSaveSnapshot::GetVector(const FString& Key, const FVector& DefaultValue) const
+{
+    return ValueToVector(FindValue(Key), DefaultValue);
+}
+
+FRotator FMotaEzSaveSnapshot::GetRotator(const FString& Key, const FRotator& DefaultValue) const
+{
+    return ValueToRotator(FindValue(Key), DefaultValue);
+}
+
+int64 FMotaEzSaveSnapshot::GetInt64(const FString& Key, int64 DefaultValue) const
+{
+    return ValueToInt64(FindValue(Key), DefaultValue);
+}
+
+double FMotaEzSaveSnapshot::GetDouble(const FString& Key, double DefaultValue) const
+{
+    return ValueToDouble(FindValue(Key), DefaultValue);
+}
+
+FQuat FMotaEzSaveSnapshot::GetQuat(const FString& Key, const FQuat& DefaultValue) const
+{
+    return ValueToQuat(FindValue(Key), DefaultValue);
+}
+
+FTransform FMotaEzSaveSnapshot::GetTransform(const FString& Key, const FTransform& DefaultValue) const
+{
+    return ValueToTransform(FindValue(Key), DefaultValue);
+}
+
+FLinearColor FMotaEzSaveSnapshot::GetLinearColor(const FString& Key, const FLinearColor& DefaultValue) const
+{
+    return ValueToLinearColor(FindValue(Key), DefaultValue);
+}
+
+bool FMotaEzSaveSnapshot::GetStructValue(const FString& Key, const UScriptStruct* Struct, void* OutValue) const
+{
+    return ValueToStruct(FindValue(Key), Struct, OutValue);
+}
+
+bool FMotaEzSaveSnapshot::GetStructArrayValue(const FString& Key, const UScriptStruct* Struct, TFunctionRef<void*(int32)> Resize) const
+{
+    return ValueToStructArray(FindValue(Key), Struct, Resize);
+}
+
+FMotaEzBlobPtr FMotaEzSaveSnapshot::GetBlob(const FString& Key) const
+{
+    return ValueToBlob(FindValue(Key));
+}
+
+FMotaEzSnapshotChannel::FMotaEzSnapshotChannel(TUniquePtr<FMotaEzSaveSnapshot> InitialSnapshot)
+    : Current(InitialSnapshot.Release())
+{
+    check(Current.load());
+}
+
+FMotaEzSnapshotChannel::~FMotaEzSnapshotChannel()
+{
+    // The last reference is gone, so no read scope can be open on this channel
+    delete Current.load();
+    for (const TPair<uint64, const FMotaEzSaveSnapshot*>& Entry : Retired)
+    {
+        delete Entry.Value;
+    }
+}
+
+void FMotaEzSnapshotChannel::Publish(TUniquePtr<FMotaEzSaveSnapshot> Snapshot)
+{
+    check(IsInGameThread());
+
+    Snapshot->Version = Current.load()->Version + 1;
+    const FMotaEzSaveSnapshot* Previous = Current.exchange(Snapshot.Release());
+
+    // Readers entering from now on are in a later epoch and can only see the new snapshot
+    Retired.Emplace(GlobalEpoch.fetch_add(1), Previous);
+
+    Reclaim();
+}
+
+void FMotaEzSnapshotChannel::Reclaim()
+{
+    if (Retired.Num() == 0)
+    {
+        return;
+    }
+
+    const uint64 OldestActive = GetOldestActiveEpoch();
+    Retired.RemoveAll([OldestActive](const TPair<uint64, const FMotaEzSaveSnapshot*>& Entry)
+    {
+        if (Entry.Key < OldestActive)
+        {
+            delete Entry.Value;
+            return true;
+        }
+        return false;
+    });
+}
+
+FMotaEzSnapshotReadScope::FMotaEzSnapshotReadScope(const FMotaEzSnapshotChannel& Channel)
+{
+    FThreadReaderState& State = ThreadReaderState;
+    if (State.Depth++ == 0)
+    {
+        // Announce the epoch before loading the pointer (both sequentially consistent), so a
+        // publisher that frees a snapshot has either seen this epoch or swapped before our load
+        State.GetSlot().Epoch.store(GlobalEpoch.load());
+    }
+
+    Snapshot = Channel.Current.load();
+}
+
+FMotaEzSnapshotReadScope::~FMotaEzSnapshotReadScope()
+{
+    FThreadReaderState& State = ThreadReaderState;
+    if (--State.Depth == 0)
+    {
+        State.GetSlot().Epoch.store(0, std::memory_order_release);
+    }
+}
@@ -0,0 +1,203 @@
+﻿#include "MotaEzSchemaCache.h"
+#include "MotaEzSaveGameSettings.h"
+#include "MotaEzSlotFile.h"
+#include "MotaEzValidator.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Hash/xxhash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+    constexpr uint32 SchemaCacheMagic = 0x43535A45; // "EZSC"
+    constexpr uint32 SchemaCacheVersion = 1;
+}
+
+void FMotaEzCompiledSchema::BuildDefaults()
+{
+    TSharedRef<TMap<FString, FMotaEzValue>> Built = MakeShared<TMap<FString, FMotaEzValue>>();
+    Built->Reserve(Schema.Fields.Num());
+
+    for (const auto& Pair : Schema.Fields)
+    {
+        const FMotaEzFieldDescriptor& Desc = Pair.Value;
+
+        FMotaEzValue& Value = Built->Add(Pair.Key);
+        Value.Type = Desc.Type;
+        Value.bIsArray = Desc.bIsArray;
+
+        if (Desc.bIsArray && Desc.Type != EMotaEzFieldType::Struct)
+        {
+            Value.ArrayValues = Desc.DefaultArray;
+        }
+        else
+        {
+            Value.ScalarValue = Desc.DefaultValue;
+        }
+    }
+
+    Defaults = Built;
+}
+
+FString UMotaEzSchemaCache::GetCachePath(const FString& SchemaPath)
+{
+    return FPaths::ChangeExtension(SchemaPath, TEXT("ezschemac"));
+}
+
+FString UMotaEzSchemaCache::GetBakedCachePath()
+{
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    return FPaths::Combine(FPaths::ProjectContentDir(), TEXT("EzSaveGame"), Settings->SchemaFileName + TEXT(".ezschemac"));
+}
+
+uint64 UMotaEzSchemaCache::HashSchemaText(const FString& SchemaText, EMotaEzConfigFormat Format)
+{
+    FXxHash64Builder Builder;
+    const uint8 FormatId = (uint8)Format;
+    Builder.Update(&FormatId, sizeof(FormatId));
+    Builder.Update(*SchemaText, SchemaText.Len() * sizeof(TCHAR));
+    return Builder.Finalize().Hash;
+}
+
+bool UMotaEzSchemaCache::ParseSchemaText(const FString& SchemaText, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& OutCompiled, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_ParseSchemaText);
+
+    FString LocalError;
+    if (!UMotaEzFormatSerializer::LoadSchema(Format, SchemaText, OutCompiled.Schema, LocalError))
+    {
+        OutError = FString::Printf(TEXT("Error parsing schema: %s"), *LocalError);
+        return false;
+    }
+
+    OutCompiled.BuildDefaults();
+    return true;
+}
+
+bool UMotaEzSchemaCache::ReadCache(const FString& CachePath, uint64 ExpectedHash, EMotaEzConfigFormat Format, bool bCheckHash, FMotaEzCompiledSchema& OutCompiled)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_ReadSchemaCache);
+
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *CachePath, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    uint64 SourceHash = 0;
+    EMotaEzConfigFormat CachedFormat = EMotaEzConfigFormat::Toml;
+    Reader << Magic << Version << SourceHash << CachedFormat;
+
+    if (Reader.IsError() || Magic != SchemaCacheMagic || Version != SchemaCacheVersion)
+    {
+        return false;
+    }
+
+    if (bCheckHash && (SourceHash != ExpectedHash || CachedFormat != Format))
+    {
+        return false;
+    }
+
+    Reader << OutCompiled;
+    return !Reader.IsError();
+}
+
+bool UMotaEzSchemaCache::WriteCache(const FString& CachePath, uint64 SourceHash, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& Compiled)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    uint32 Magic = SchemaCacheMagic;
+    uint32 Version = SchemaCacheVersion;
+    Writer << Magic << Version << SourceHash << Format;
+    Writer << Compiled;
+
+    return FFileHelper::SaveArrayToFile(Bytes, *CachePath);
+}
+
+void UMotaEzSchemaCache::PrecompileValidators(const FMotaEzCompiledSchema& Compiled)
+{
+    for (const auto& Pair : Compiled.Schema.Fields)
+    {
+        if (Pair.Value.bEnableValidation && !Pair.Value.RegexPattern.IsEmpty())
+        {
+            UMotaEzValidator::PrecompilePattern(Pair.Value.RegexPattern);
+        }
+    }
+}
+
+bool UMotaEzSchemaCache::LoadSchema(const FString& SchemaPath, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& OutCompiled, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_LoadSchemaCached);
+
+    OutCompiled = FMotaEzCompiledSchema();
+
+    if (!FPaths::FileExists(SchemaPath))
+    {
+        // Packaged builds ship the schema precompiled at cook time
+        const FString BakedPath = GetBakedCachePath();
+        if (FPaths::FileExists(BakedPath) && ReadCache(BakedPath, 0, Format, false, OutCompiled))
+        {
+            PrecompileValidators(OutCompiled);
+        }
+        return true;
+    }
+
+    FString SchemaText;
+    if (!UMotaEzSlotFile::ReadText(SchemaPath, SchemaText, OutError))
+    {
+        return false;
+    }
+
+    const uint64 SourceHash = HashSchemaText(SchemaText, Format);
+    const FString CachePath = GetCachePath(SchemaPath);
+
+    if (!ReadCache(CachePath, SourceHash, Format, true, OutCompiled))
+    {
+        OutCompiled = FMotaEzCompiledSchema();
+        if (!ParseSchemaText(SchemaText, Format, OutCompiled, OutError))
+        {
+            return false;
+        }
+
+        if (!WriteCache(CachePath, SourceHash, Format, OutCompiled))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Failed to write schema cache: %s"), *CachePath);
+        }
+    }
+
+    PrecompileValidators(OutCompiled);
+    return true;
+}
+
+bool UMotaEzSchemaCache::CompileSchemaFile(const FString& SchemaPath, EMotaEzConfigFormat Format, const FString& CachePath, FString& OutError)
+{
+    OutError.Reset();
+
+    FString SchemaText;
+    if (!UMotaEzSlotFile::ReadText(SchemaPath, SchemaText, OutError))
+    {
+        return false;
+    }
+
+    FMotaEzCompiledSchema Compiled;
+    if (!ParseSchemaText(SchemaText, Format, Compiled, OutError))
+    {
+        return false;
+    }
+
+    if (!WriteCache(CachePath, HashSchemaText(SchemaText, Format), Format, Compiled))
+    {
+        OutError = FString::Printf(TEXT("Failed to write schema cache: %s"), *CachePath);
+        return false;
+    }
+
+    return true;
+}
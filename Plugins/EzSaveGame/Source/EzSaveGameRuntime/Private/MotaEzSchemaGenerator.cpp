@@ -1,6 +1,7 @@
 ﻿#include "MotaEzSchemaGenerator.h"
 #include "MotaEzFormatSerializer.h"
 #include "MotaEzSaveGameSettings.h"
+#include "MotaEzValueConversion.h"
 #include "GameFramework/SaveGame.h"
 #include "Misc/FileHelper.h"
 #include "UObject/TextProperty.h"
@@ -40,7 +41,7 @@ bool UMotaEzSchemaGenerator::GenerateSchemaFromSaveGame(UClass* SaveGameClass, F
             void* PropertyData = Property->ContainerPtrToValuePtr<void>(CDO);
             Descriptor.DefaultValue = GetDefaultValueFromProperty(Property, PropertyData);
 
-            if (Descriptor.bIsArray)
+            if (Descriptor.bIsArray && Descriptor.Type != EMotaEzFieldType::Struct)
             {
                 GetDefaultArrayValues(Property, PropertyData, Descriptor.DefaultArray);
             }
@@ -119,20 +120,37 @@ EMotaEzFieldType UMotaEzSchemaGenerator::DetectFieldType(FProperty* Property, bo
 
     if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(Property))
     {
+        // TArray<uint8> holds raw bytes: one Blob value rather than an array of numbers
+        const FByteProperty* ByteProp = CastField<FByteProperty>(ArrayProp->Inner);
+        if (ByteProp && !ByteProp->Enum)
+        {
+            return EMotaEzFieldType::Blob;
+        }
+
         bIsArray = true;
         Property = ArrayProp->Inner;
     }
 
-    if (CastField<FIntProperty>(Property) || CastField<FInt64Property>(Property))
+    if (CastField<FIntProperty>(Property))
     {
         return EMotaEzFieldType::Int;
     }
 
-    if (CastField<FFloatProperty>(Property) || CastField<FDoubleProperty>(Property))
+    if (CastField<FInt64Property>(Property))
+    {
+        return EMotaEzFieldType::Int64;
+    }
+
+    if (CastField<FFloatProperty>(Property))
     {
         return EMotaEzFieldType::Float;
     }
 
+    if (CastField<FDoubleProperty>(Property))
+    {
+        return EMotaEzFieldType::Double;
+    }
+
     if (CastField<FBoolProperty>(Property))
     {
         return EMotaEzFieldType::Bool;
@@ -154,6 +172,23 @@ EMotaEzFieldType UMotaEzSchemaGenerator::DetectFieldType(FProperty* Property, bo
         {
             return EMotaEzFieldType::Rotator;
         }
+
+        if (StructProp->Struct == TBaseStructure<FQuat>::Get())
+        {
+            return EMotaEzFieldType::Quat;
+        }
+
+        if (StructProp->Struct == TBaseStructure<FTransform>::Get())
+        {
+            return EMotaEzFieldType::Transform;
+        }
+
+        if (StructProp->Struct == TBaseStructure<FLinearColor>::Get())
+        {
+            return EMotaEzFieldType::LinearColor;
+        }
+
+        return EMotaEzFieldType::Struct;
     }
 
     return EMotaEzFieldType::None;
@@ -168,6 +203,12 @@ FString UMotaEzSchemaGenerator::GetDefaultValueFromProperty(FProperty* Property,
 
     if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(Property))
     {
+        // Struct arrays keep the USTRUCT path as default, like scalar struct fields
+        bool bIsArray = false;
+        if (DetectFieldType(ArrayProp, bIsArray) == EMotaEzFieldType::Struct)
+        {
+            return CastFieldChecked<FStructProperty>(ArrayProp->Inner)->Struct->GetPathName();
+        }
         return TEXT("");
     }
 
@@ -180,7 +221,7 @@ FString UMotaEzSchemaGenerator::GetDefaultValueFromProperty(FProperty* Property,
     if (FInt64Property* Int64Prop = CastField<FInt64Property>(Property))
     {
         int64 Value = Int64Prop->GetPropertyValue(PropertyData);
-        return FString::Printf(TEXT("%lld"), Value);
+        return LexToString(Value);
     }
 
     if (FFloatProperty* FloatProp = CastField<FFloatProperty>(Property))
@@ -192,7 +233,7 @@ FString UMotaEzSchemaGenerator::GetDefaultValueFromProperty(FProperty* Property,
     if (FDoubleProperty* DoubleProp = CastField<FDoubleProperty>(Property))
     {
         double Value = DoubleProp->GetPropertyValue(PropertyData);
-        return FString::Printf(TEXT("%f"), Value);
+        return MotaEzValueConversion::DoubleToString(Value);
     }
 
     if (FBoolProperty* BoolProp = CastField<FBoolProperty>(Property))
@@ -223,14 +264,32 @@ FString UMotaEzSchemaGenerator::GetDefaultValueFromProperty(FProperty* Property,
         if (StructProp->Struct == TBaseStructure<FVector>::Get())
         {
             FVector* VectorPtr = static_cast<FVector*>(PropertyData);
-            return FString::Printf(TEXT("%f,%f,%f"), VectorPtr->X, VectorPtr->Y, VectorPtr->Z);
+            return MotaEzValueConversion::VectorToString(*VectorPtr);
         }
         
         if (StructProp->Struct == TBaseStructure<FRotator>::Get())
         {
             FRotator* RotatorPtr = static_cast<FRotator*>(PropertyData);
-            return FString::Printf(TEXT("%f,%f,%f"), RotatorPtr->Pitch, RotatorPtr->Yaw, RotatorPtr->Roll);
+            return MotaEzValueConversion::RotatorToString(*RotatorPtr);
+        }
+
+        if (StructProp->Struct == TBaseStructure<FQuat>::Get())
+        {
+            return MotaEzValueConversion::QuatToString(*static_cast<FQuat*>(PropertyData));
         }
+
+        if (StructProp->Struct == TBaseStructure<FTransform>::Get())
+        {
+            return MotaEzValueConversion::TransformToString(*static_cast<FTransform*>(PropertyData));
+        }
+
+        if (StructProp->Struct == TBaseStructure<FLinearColor>::Get())
+        {
+            return MotaEzValueConversion::LinearColorToString(*static_cast<FLinearColor*>(PropertyData));
+        }
+
+        // Any other USTRUCT defaults to a default-constructed record of its type
+        return StructProp->Struct->GetPathName();
     }
 
     return TEXT("");
@@ -0,0 +1,597 @@
+﻿#include "MotaEzSlotFile.h"
+#include "MotaEzEncryption.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/AsyncFileHandle.h"
+#include "Hash/xxhash.h"
+#include "HAL/IConsoleManager.h"
+
+#if PLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+// Older sysroots predate these; the values are part of the stable kernel ABI
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
+#ifndef SYS_copy_file_range
+#if defined(__x86_64__)
+#define SYS_copy_file_range 326
+#elif defined(__aarch64__)
+#define SYS_copy_file_range 285
+#endif
+#endif
+#endif
+
+static TAutoConsoleVariable<bool> CVarEzSaveForceStreamedCopy(
+    TEXT("EzSave.ForceStreamedCopy"),
+    false,
+    TEXT("Disables reflink/copy_file_range cloning and always uses the streamed copy fallback (Linux only)"),
+    ECVF_Default
+);
+
+namespace
+{
+    constexpr uint8 SlotFileVersion = 2;
+    constexpr uint8 SlotFileFlagEncrypted = 1 << 0;
+    constexpr uint8 SlotFileFlagBinary = 1 << 1;
+
+    /** Version 1 files carry only magic, version and flags before the nonce. */
+    constexpr int64 SlotFilePrefixSizeV1 = 8;
+    constexpr int64 SlotFileFixedHeaderSize = 24;
+    constexpr int64 SlotFileMaxHeaderSize = SlotFileFixedHeaderSize + FMotaEzCipherStream::NonceSize;
+
+    FORCEINLINE bool HasSlotFileMagic(const uint8* Data, int64 Size)
+    {
+        return Size >= SlotFilePrefixSizeV1 && Data[0] == 'E' && Data[1] == 'Z' && Data[2] == 'S' && Data[3] == 'V';
+    }
+
+    FORCEINLINE uint64 ReadUInt64(const uint8* Data)
+    {
+        uint64 Value = 0;
+        FMemory::Memcpy(&Value, Data, sizeof(uint64));
+        return INTEL_ORDER64(Value);
+    }
+
+    FORCEINLINE void WriteUInt64(uint8* Data, uint64 Value)
+    {
+        Value = INTEL_ORDER64(Value);
+        FMemory::Memcpy(Data, &Value, sizeof(uint64));
+    }
+
+    /**
+     * Decodes the header at the start of a file and validates it against the file size.
+     * @param Data - First bytes of the file
+     * @param Available - Number of valid bytes in Data
+     * @param FileSize - Total size of the file on disk
+     */
+    bool ParseHeader(const uint8* Data, int64 Available, int64 FileSize, FMotaEzSlotFileHeader& OutHeader, FString& OutError)
+    {
+        OutHeader = FMotaEzSlotFileHeader();
+
+        if (!HasSlotFileMagic(Data, Available))
+        {
+            OutHeader.PayloadLength = FileSize;
+            return true;
+        }
+
+        OutHeader.Version = Data[4];
+        OutHeader.Flags = Data[5];
+
+        if (OutHeader.Version == 1)
+        {
+            OutHeader.HeaderSize = SlotFilePrefixSizeV1 + (OutHeader.IsEncrypted() ? FMotaEzCipherStream::NonceSize : 0);
+            if (FileSize < OutHeader.HeaderSize)
+            {
+                OutError = TEXT("Truncated header");
+                return false;
+            }
+            OutHeader.PayloadLength = FileSize - OutHeader.HeaderSize;
+            return true;
+        }
+
+        if (OutHeader.Version != SlotFileVersion)
+        {
+            OutError = FString::Printf(TEXT("Unsupported file version %d"), OutHeader.Version);
+            return false;
+        }
+
+        OutHeader.HeaderSize = SlotFileFixedHeaderSize + (OutHeader.IsEncrypted() ? FMotaEzCipherStream::NonceSize : 0);
+        if (Available < OutHeader.HeaderSize)
+        {
+            OutError = TEXT("Truncated header");
+            return false;
+        }
+
+        if (Data[6] > (uint8)EMotaEzConfigFormat::Xml)
+        {
+            OutError = FString::Printf(TEXT("Unknown format id %d"), Data[6]);
+            return false;
+        }
+
+        OutHeader.Format = (EMotaEzConfigFormat)Data[6];
+        OutHeader.PayloadLength = ReadUInt64(Data + 8);
+        OutHeader.Checksum = ReadUInt64(Data + 16);
+
+        if ((uint64)(FileSize - OutHeader.HeaderSize) != OutHeader.PayloadLength)
+        {
+            OutError = FString::Printf(TEXT("Payload length mismatch (header %llu, file %lld)"), OutHeader.PayloadLength, FileSize - OutHeader.HeaderSize);
+            return false;
+        }
+
+        return true;
+    }
+}
+
+#if PLATFORM_LINUX
+namespace
+{
+    /**
+     * Clones a file with a reflink (FICLONE) where the filesystem supports it (XFS, btrfs),
+     * otherwise lets the kernel copy it with copy_file_range without user-space buffers.
+     * @return false if neither is available, so the caller can fall back to a streamed copy
+     */
+    bool CloneFileLinux(const FString& DestPath, const FString& SourcePath)
+    {
+        const FString SourceAbs = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SourcePath);
+        const FString DestAbs = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*DestPath);
+
+        const int SourceFd = open(TCHAR_TO_UTF8(*SourceAbs), O_RDONLY | O_CLOEXEC);
+        if (SourceFd < 0)
+        {
+            return false;
+        }
+
+        struct stat SourceStat;
+        if (fstat(SourceFd, &SourceStat) != 0)
+        {
+            close(SourceFd);
+            return false;
+        }
+
+        const int DestFd = open(TCHAR_TO_UTF8(*DestAbs), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, SourceStat.st_mode & 0777);
+        if (DestFd < 0)
+        {
+            close(SourceFd);
+            return false;
+        }
+
+        bool bSuccess = ioctl(DestFd, FICLONE, SourceFd) == 0;
+
+#ifdef SYS_copy_file_range
+        if (!bSuccess)
+        {
+            // EOPNOTSUPP/EXDEV/EINVAL from FICLONE: no reflink support, try an in-kernel copy
+            int64 Remaining = SourceStat.st_size;
+            bSuccess = true;
+            while (Remaining > 0)
+            {
+                const ssize_t Copied = syscall(SYS_copy_file_range, SourceFd, nullptr, DestFd, nullptr, (size_t)Remaining, 0u);
+                if (Copied <= 0)
+                {
+                    bSuccess = false;
+                    break;
+                }
+                Remaining -= Copied;
+            }
+        }
+#endif
+
+        close(DestFd);
+        close(SourceFd);
+
+        if (!bSuccess)
+        {
+            unlink(TCHAR_TO_UTF8(*DestAbs));
+        }
+        return bSuccess;
+    }
+}
+#endif
+
+bool FMotaEzSlotFileHeader::IsEncrypted() const
+{
+    return (Flags & SlotFileFlagEncrypted) != 0;
+}
+
+bool FMotaEzSlotFileHeader::HasChecksum() const
+{
+    return Version >= 2;
+}
+
+bool FMotaEzSlotFileHeader::IsBinary() const
+{
+    return (Flags & SlotFileFlagBinary) != 0;
+}
+
+bool UMotaEzSlotFile::WriteText(const FString& FilePath, EMotaEzConfigFormat Format, const FString& Text, FString& OutError, FMotaEzSlotFileHeader* OutHeader)
+{
+    FTCHARToUTF8 Utf8(*Text);
+    return WritePayload(FilePath, Format, 0, MakeArrayView((const uint8*)Utf8.Get(), Utf8.Length()), OutError, OutHeader);
+}
+
+bool UMotaEzSlotFile::WriteBytes(const FString& FilePath, TConstArrayView<uint8> Bytes, FString& OutError, FMotaEzSlotFileHeader* OutHeader)
+{
+    return WritePayload(FilePath, EMotaEzConfigFormat::Toml, SlotFileFlagBinary, Bytes, OutError, OutHeader);
+}
+
+bool UMotaEzSlotFile::WritePayload(const FString& FilePath, EMotaEzConfigFormat Format, uint8 ExtraFlags, TConstArrayView<uint8> Bytes, FString& OutError, FMotaEzSlotFileHeader* OutHeader)
+{
+    OutError.Reset();
+
+    const FString Dir = FPaths::GetPath(FilePath);
+    if (!IFileManager::Get().DirectoryExists(*Dir) && !IFileManager::Get().MakeDirectory(*Dir, true))
+    {
+        OutError = FString::Printf(TEXT("Failed to create directory: %s"), *Dir);
+        return false;
+    }
+
+    const uint8* Payload = Bytes.GetData();
+    const int64 PayloadSize = Bytes.Num();
+
+    const FString TempPath = FilePath + TEXT(".tmp");
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+    if (!Writer)
+    {
+        OutError = FString::Printf(TEXT("Failed to open file for writing: %s"), *TempPath);
+        return false;
+    }
+
+    const bool bEncrypt = UMotaEzEncryption::ShouldEncrypt();
+
+    uint8 Header[SlotFileMaxHeaderSize] = { 'E', 'Z', 'S', 'V', SlotFileVersion, ExtraFlags, (uint8)Format, 0 };
+    int64 HeaderSize = SlotFileFixedHeaderSize;
+    WriteUInt64(Header + 8, PayloadSize);
+
+    TUniquePtr<FMotaEzCipherStream> Cipher;
+    if (bEncrypt)
+    {
+        Header[5] |= SlotFileFlagEncrypted;
+        FMotaEzCipherStream::MakeNonce(Header + SlotFileFixedHeaderSize);
+        HeaderSize += FMotaEzCipherStream::NonceSize;
+        Cipher = MakeUnique<FMotaEzCipherStream>(UMotaEzEncryption::GetEncryptionKey(), Header + SlotFileFixedHeaderSize);
+    }
+
+    // Checksum is only known once the payload is streamed; reserve the header and patch it afterwards
+    Writer->Serialize(Header, HeaderSize);
+
+    FXxHash64Builder Hasher;
+    TArray<uint8> Chunk;
+    if (Cipher)
+    {
+        Chunk.SetNumUninitialized(FMath::Min(PayloadSize, StreamChunkSize));
+    }
+
+    for (int64 Offset = 0; Offset < PayloadSize; Offset += StreamChunkSize)
+    {
+        const int64 Count = FMath::Min(StreamChunkSize, PayloadSize - Offset);
+        uint8* Stored = const_cast<uint8*>(Payload + Offset);
+
+        if (Cipher)
+        {
+            FMemory::Memcpy(Chunk.GetData(), Stored, Count);
+            Cipher->Process(Chunk.GetData(), Count);
+            Stored = Chunk.GetData();
+        }
+
+        Hasher.Update(Stored, Count);
+        Writer->Serialize(Stored, Count);
+    }
+
+    const uint64 Checksum = Hasher.Finalize().Hash;
+    WriteUInt64(Header + 16, Checksum);
+    Writer->Seek(0);
+    Writer->Serialize(Header, SlotFileFixedHeaderSize);
+
+    Writer->Close();
+    const bool bWriteFailed = Writer->IsError();
+    Writer.Reset();
+
+    if (bWriteFailed || !IFileManager::Get().Move(*FilePath, *TempPath, true))
+    {
+        IFileManager::Get().Delete(*TempPath);
+        OutError = FString::Printf(TEXT("Failed to write file: %s"), *FilePath);
+        return false;
+    }
+
+    if (OutHeader)
+    {
+        OutHeader->Version = SlotFileVersion;
+        OutHeader->Flags = Header[5];
+        OutHeader->Format = Format;
+        OutHeader->HeaderSize = HeaderSize;
+        OutHeader->PayloadLength = PayloadSize;
+        OutHeader->Checksum = Checksum;
+    }
+
+    return true;
+}
+
+bool UMotaEzSlotFile::ReadHeader(const FString& FilePath, FMotaEzSlotFileHeader& OutHeader, FString& OutError)
+{
+    OutError.Reset();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*FilePath));
+    if (!Handle)
+    {
+        OutError = FString::Printf(TEXT("File does not exist: %s"), *FilePath);
+        return false;
+    }
+
+    const int64 FileSize = Handle->Size();
+    const int64 Available = FMath::Min(FileSize, SlotFileMaxHeaderSize);
+
+    uint8 Data[SlotFileMaxHeaderSize];
+    if (!Handle->Read(Data, Available))
+    {
+        OutError = FString::Printf(TEXT("Failed to read file: %s"), *FilePath);
+        return false;
+    }
+
+    if (!ParseHeader(Data, Available, FileSize, OutHeader, OutError))
+    {
+        OutError = FString::Printf(TEXT("%s: %s"), *OutError, *FilePath);
+        return false;
+    }
+
+    return true;
+}
+
+bool UMotaEzSlotFile::ReadText(const FString& FilePath, FString& OutText, FString& OutError, FMotaEzSlotFileHeader* OutHeader)
+{
+    OutText.Reset();
+
+    TArray<uint8> Buffer;
+    FMotaEzSlotFileHeader Header;
+    if (!ReadPayload(FilePath, Buffer, Header, OutError))
+    {
+        return false;
+    }
+
+    if (Header.IsBinary())
+    {
+        OutError = FString::Printf(TEXT("Not a text file: %s"), *FilePath);
+        return false;
+    }
+
+    if (OutHeader)
+    {
+        *OutHeader = Header;
+    }
+
+    FFileHelper::BufferToString(OutText, Buffer.GetData(), Buffer.Num());
+    return true;
+}
+
+bool UMotaEzSlotFile::ReadBytes(const FString& FilePath, TArray<uint8>& OutBytes, FString& OutError, FMotaEzSlotFileHeader* OutHeader)
+{
+    FMotaEzSlotFileHeader Header;
+    if (!ReadPayload(FilePath, OutBytes, Header, OutError))
+    {
+        OutBytes.Reset();
+        return false;
+    }
+
+    if (!Header.IsBinary())
+    {
+        OutBytes.Reset();
+        OutError = FString::Printf(TEXT("Not a binary file: %s"), *FilePath);
+        return false;
+    }
+
+    if (OutHeader)
+    {
+        *OutHeader = Header;
+    }
+    return true;
+}
+
+bool UMotaEzSlotFile::ReadPayload(const FString& FilePath, TArray<uint8>& Buffer, FMotaEzSlotFileHeader& OutHeader, FString& OutError)
+{
+    OutError.Reset();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const int64 FileSize = PlatformFile.FileSize(*FilePath);
+    if (FileSize < 0)
+    {
+        OutError = FString::Printf(TEXT("File does not exist: %s"), *FilePath);
+        return false;
+    }
+
+    FMotaEzSlotFileHeader& Header = OutHeader;
+    uint8 HeaderBytes[SlotFileMaxHeaderSize];
+    const int64 HeaderAvailable = FMath::Min(FileSize, SlotFileMaxHeaderSize);
+    FXxHash64Builder Hasher;
+    TUniquePtr<FMotaEzCipherStream> Cipher;
+
+    // Runs once the first bytes are in; the payload gets a buffer of its own, so it never has to be shifted past the header
+    auto BeginPayload = [&]() -> bool
+    {
+        if (!ParseHeader(HeaderBytes, HeaderAvailable, FileSize, Header, OutError))
+        {
+            OutError = FString::Printf(TEXT("Corrupted file (%s): %s"), *OutError, *FilePath);
+            return false;
+        }
+
+        if (Header.IsEncrypted())
+        {
+            Cipher = MakeUnique<FMotaEzCipherStream>(UMotaEzEncryption::GetEncryptionKey(), HeaderBytes + Header.HeaderSize - FMotaEzCipherStream::NonceSize);
+        }
+
+        Buffer.SetNumUninitialized(FileSize - Header.HeaderSize);
+        return true;
+    };
+
+    // Runs on each chunk of the payload as soon as it lands
+    auto ProcessChunk = [&](int64 Offset, int64 Size)
+    {
+        if (Header.HasChecksum())
+        {
+            Hasher.Update(Buffer.GetData() + Offset, Size);
+        }
+        if (Cipher)
+        {
+            Cipher->Process(Buffer.GetData() + Offset, Size);
+        }
+    };
+
+    TUniquePtr<IAsyncReadFileHandle> Handle(PlatformFile.OpenAsyncRead(*FilePath));
+    if (!Handle)
+    {
+        // Platform without async IO: blocking reads of the header and then the payload
+        TUniquePtr<IFileHandle> SyncHandle(PlatformFile.OpenRead(*FilePath));
+        if (!SyncHandle || !SyncHandle->Read(HeaderBytes, HeaderAvailable) || !BeginPayload()
+            || !SyncHandle->Seek(Header.HeaderSize) || !SyncHandle->Read(Buffer.GetData(), Buffer.Num()))
+        {
+            if (OutError.IsEmpty())
+            {
+                OutError = FString::Printf(TEXT("Failed to read file: %s"), *FilePath);
+            }
+            return false;
+        }
+        ProcessChunk(0, Buffer.Num());
+    }
+    else
+    {
+        bool bHeaderRead = true;
+        if (HeaderAvailable > 0)
+        {
+            IAsyncReadRequest* HeaderRequest = Handle->ReadRequest(0, HeaderAvailable, AIOP_Normal, nullptr, HeaderBytes);
+            bHeaderRead = HeaderRequest != nullptr;
+            if (HeaderRequest)
+            {
+                HeaderRequest->WaitCompletion();
+                bHeaderRead = HeaderRequest->GetReadResults() != nullptr;
+                delete HeaderRequest;
+            }
+        }
+
+        if (!bHeaderRead || !BeginPayload())
+        {
+            Handle.Reset();
+            if (OutError.IsEmpty())
+            {
+                OutError = FString::Printf(TEXT("Failed to read file: %s"), *FilePath);
+            }
+            return false;
+        }
+
+        const int64 PayloadSize = Buffer.Num();
+        const int64 NumChunks = (PayloadSize + StreamChunkSize - 1) / StreamChunkSize;
+
+        auto IssueRead = [&](int64 ChunkIndex) -> IAsyncReadRequest*
+        {
+            const int64 Offset = ChunkIndex * StreamChunkSize;
+            return Handle->ReadRequest(Header.HeaderSize + Offset, FMath::Min(StreamChunkSize, PayloadSize - Offset), AIOP_Normal, nullptr, Buffer.GetData() + Offset);
+        };
+
+        IAsyncReadRequest* InFlight = NumChunks > 0 ? IssueRead(0) : nullptr;
+        bool bSuccess = true;
+
+        for (int64 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+        {
+            IAsyncReadRequest* Current = InFlight;
+            InFlight = (ChunkIndex + 1 < NumChunks) ? IssueRead(ChunkIndex + 1) : nullptr;
+
+            bool bChunkRead = false;
+            if (Current)
+            {
+                Current->WaitCompletion();
+                bChunkRead = Current->GetReadResults() != nullptr;
+                delete Current;
+            }
+
+            if (!bChunkRead)
+            {
+                bSuccess = false;
+                if (InFlight)
+                {
+                    InFlight->WaitCompletion();
+                    delete InFlight;
+                }
+                break;
+            }
+
+            const int64 Offset = ChunkIndex * StreamChunkSize;
+            ProcessChunk(Offset, FMath::Min(StreamChunkSize, PayloadSize - Offset));
+        }
+
+        Handle.Reset();
+
+        if (!bSuccess)
+        {
+            OutError = FString::Printf(TEXT("Failed to read file: %s"), *FilePath);
+            return false;
+        }
+    }
+
+    if (FileSize == 0)
+    {
+        Header = FMotaEzSlotFileHeader();
+    }
+
+    if (Header.HasChecksum() && Hasher.Finalize().Hash != Header.Checksum)
+    {
+        OutError = FString::Printf(TEXT("Corrupted file (checksum mismatch): %s"), *FilePath);
+        return false;
+    }
+
+    return true;
+}
+
+uint64 UMotaEzSlotFile::MakeWriteFingerprint(uint64 ContentFingerprint, EMotaEzConfigFormat Format)
+{
+    const uint64 State = ((uint64)Format << 1) | (UMotaEzEncryption::ShouldEncrypt() ? 1 : 0);
+    return ContentFingerprint ^ ((State + 1) * 0x9E3779B97F4A7C15ull);
+}
+
+bool UMotaEzSlotFile::CloneFile(const FString& DestPath, const FString& SourcePath, FString& OutError)
+{
+    OutError.Reset();
+
+    if (!IFileManager::Get().FileExists(*SourcePath))
+    {
+        OutError = FString::Printf(TEXT("File does not exist: %s"), *SourcePath);
+        return false;
+    }
+
+    const FString Dir = FPaths::GetPath(DestPath);
+    if (!IFileManager::Get().DirectoryExists(*Dir) && !IFileManager::Get().MakeDirectory(*Dir, true))
+    {
+        OutError = FString::Printf(TEXT("Failed to create directory: %s"), *Dir);
+        return false;
+    }
+
+    const FString TempPath = DestPath + TEXT(".tmp");
+    bool bCopied = false;
+
+#if PLATFORM_LINUX
+    if (!CVarEzSaveForceStreamedCopy.GetValueOnAnyThread())
+    {
+        bCopied = CloneFileLinux(TempPath, SourcePath);
+    }
+#endif
+
+    if (!bCopied)
+    {
+        bCopied = IFileManager::Get().Copy(*TempPath, *SourcePath) == COPY_OK;
+    }
+
+    if (!bCopied || !IFileManager::Get().Move(*DestPath, *TempPath, true))
+    {
+        IFileManager::Get().Delete(*TempPath);
+        OutError = FString::Printf(TEXT("Failed to copy %s to %s"), *SourcePath, *DestPath);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,559 @@
+﻿#include "MotaEzSlotHistory.h"
+#include "MotaEzSlotManager.h"
+#include "MotaEzSlotFile.h"
+#include "MotaEzEncryption.h"
+#include "MotaEzSaveGameSettings.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Hash/xxhash.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+
+namespace
+{
+    // FastCDC parameters for an ~8 KB average chunk
+    constexpr int64 MinChunkSize = 2 * 1024;
+    constexpr int64 AvgChunkSize = 8 * 1024;
+    constexpr int64 MaxChunkSize = 64 * 1024;
+    constexpr uint64 MaskStrict = 0x0000d9f003530000ull;
+    constexpr uint64 MaskLoose = 0x0000d90003530000ull;
+
+    struct FGearTable
+    {
+        uint64 Values[256];
+
+        FGearTable()
+        {
+            // Fixed seed: boundaries must be identical across runs and machines
+            uint64 State = 0x45A53A7E5AFE5EEDull;
+            for (uint64& Value : Values)
+            {
+                State += 0x9E3779B97F4A7C15ull;
+                uint64 Z = State;
+                Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+                Value = Z ^ (Z >> 31);
+            }
+        }
+    };
+
+    const FGearTable& GetGearTable()
+    {
+        static const FGearTable Table;
+        return Table;
+    }
+
+    /**
+     * Finds the end of the next chunk using normalized chunking:
+     * a stricter mask before the average size and a looser one after it.
+     */
+    int64 FindChunkBoundary(const uint8* Data, int64 Size)
+    {
+        if (Size <= MinChunkSize)
+        {
+            return Size;
+        }
+
+        const uint64* Gear = GetGearTable().Values;
+        const int64 Limit = FMath::Min(Size, MaxChunkSize);
+        const int64 Normal = FMath::Min(Limit, AvgChunkSize);
+
+        uint64 Hash = 0;
+        int64 Index = MinChunkSize;
+
+        for (; Index < Normal; ++Index)
+        {
+            Hash = (Hash << 1) + Gear[Data[Index]];
+            if (!(Hash & MaskStrict))
+            {
+                return Index + 1;
+            }
+        }
+
+        for (; Index < Limit; ++Index)
+        {
+            Hash = (Hash << 1) + Gear[Data[Index]];
+            if (!(Hash & MaskLoose))
+            {
+                return Index + 1;
+            }
+        }
+
+        return Limit;
+    }
+
+    FORCEINLINE FString HashToString(const FXxHash128& Hash)
+    {
+        return FString::Printf(TEXT("%016llx%016llx"), Hash.HashHigh, Hash.HashLow);
+    }
+
+    FORCEINLINE FString GetChunkExtension(bool bEncrypted)
+    {
+        return bEncrypted ? TEXT(".echunk") : TEXT(".chunk");
+    }
+
+    /** Convergent nonce: identical chunks encrypt to identical bytes and still deduplicate. */
+    FORCEINLINE void MakeChunkNonce(const FXxHash128& Hash, uint8* OutNonce)
+    {
+        FMemory::Memcpy(OutNonce, &Hash.HashLow, sizeof(uint64));
+        FMemory::Memcpy(OutNonce + sizeof(uint64), &Hash.HashHigh, sizeof(uint64));
+    }
+
+    bool LoadManifest(const FString& ManifestPath, TSharedPtr<FJsonObject>& OutManifest)
+    {
+        FString JsonString;
+        if (!FFileHelper::LoadFileToString(JsonString, *ManifestPath))
+        {
+            return false;
+        }
+
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+        return FJsonSerializer::Deserialize(Reader, OutManifest) && OutManifest.IsValid();
+    }
+
+    /**
+     * Splits a block's text into chunks and writes the ones not stored yet.
+     * @param OutChunks - Receives the chunk hashes in order
+     * @param OutSize - Receives the payload size in bytes
+     * @param InOutNewChunks - Incremented per chunk written
+     */
+    bool StoreBlockChunks(const FString& Text, const FString& ChunkDir, bool bEncrypt, const FString& Key,
+        TArray<TSharedPtr<FJsonValue>>& OutChunks, int64& OutSize, int32& InOutNewChunks, FString& OutError)
+    {
+        FTCHARToUTF8 Utf8(*Text);
+        const uint8* Payload = (const uint8*)Utf8.Get();
+        const int64 PayloadSize = Utf8.Length();
+        const FString Extension = GetChunkExtension(bEncrypt);
+
+        TArray<uint8> Scratch;
+        for (int64 Offset = 0; Offset < PayloadSize; )
+        {
+            const int64 ChunkSize = FindChunkBoundary(Payload + Offset, PayloadSize - Offset);
+            const FXxHash128 Hash = FXxHash128::HashBuffer(Payload + Offset, ChunkSize);
+            const FString HashString = HashToString(Hash);
+            const FString ChunkPath = FPaths::Combine(ChunkDir, HashString + Extension);
+
+            // Content-addressed: an existing chunk with this hash already holds these bytes
+            if (!IFileManager::Get().FileExists(*ChunkPath))
+            {
+                Scratch.SetNumUninitialized(ChunkSize, EAllowShrinking::No);
+                FMemory::Memcpy(Scratch.GetData(), Payload + Offset, ChunkSize);
+
+                if (bEncrypt)
+                {
+                    uint8 Nonce[FMotaEzCipherStream::NonceSize];
+                    MakeChunkNonce(Hash, Nonce);
+                    FMotaEzCipherStream Cipher(Key, Nonce);
+                    Cipher.Process(Scratch.GetData(), ChunkSize);
+                }
+
+                const FString TempPath = ChunkPath + TEXT(".tmp");
+                if (!FFileHelper::SaveArrayToFile(Scratch, *TempPath) || !IFileManager::Get().Move(*ChunkPath, *TempPath, true))
+                {
+                    IFileManager::Get().Delete(*TempPath);
+                    OutError = FString::Printf(TEXT("Failed to write chunk: %s"), *ChunkPath);
+                    return false;
+                }
+                ++InOutNewChunks;
+            }
+
+            OutChunks.Add(MakeShared<FJsonValueString>(HashString));
+            Offset += ChunkSize;
+        }
+
+        OutSize = PayloadSize;
+        return true;
+    }
+
+    /** Reassembles, decrypts and verifies a block from its chunks. */
+    bool LoadBlockChunks(const TArray<TSharedPtr<FJsonValue>>& Chunks, int64 Size, const FString& ChunkDir, bool bEncrypted, const FString& Key,
+        FString& OutText, FString& OutError)
+    {
+        const FString Extension = GetChunkExtension(bEncrypted);
+
+        TArray<uint8> Payload;
+        Payload.Reserve(Size);
+        TArray<uint8> Chunk;
+
+        for (const TSharedPtr<FJsonValue>& Entry : Chunks)
+        {
+            const FString HashString = Entry->AsString();
+            const FString ChunkPath = FPaths::Combine(ChunkDir, HashString + Extension);
+
+            if (!FFileHelper::LoadFileToArray(Chunk, *ChunkPath))
+            {
+                OutError = FString::Printf(TEXT("Missing history chunk: %s"), *ChunkPath);
+                return false;
+            }
+
+            if (bEncrypted)
+            {
+                // The nonce is derived from the plaintext hash, which the chunk name encodes
+                FXxHash128 Expected;
+                Expected.HashHigh = FParse::HexNumber64(*HashString.Left(16));
+                Expected.HashLow = FParse::HexNumber64(*HashString.Mid(16));
+
+                uint8 Nonce[FMotaEzCipherStream::NonceSize];
+                MakeChunkNonce(Expected, Nonce);
+                FMotaEzCipherStream Cipher(Key, Nonce);
+                Cipher.Process(Chunk.GetData(), Chunk.Num());
+            }
+
+            if (HashToString(FXxHash128::HashBuffer(Chunk.GetData(), Chunk.Num())) != HashString)
+            {
+                OutError = FString::Printf(TEXT("Corrupted history chunk: %s"), *ChunkPath);
+                return false;
+            }
+
+            Payload.Append(Chunk);
+        }
+
+        if (Payload.Num() != Size)
+        {
+            return false;
+        }
+
+        FFileHelper::BufferToString(OutText, Payload.GetData(), Payload.Num());
+        return true;
+    }
+
+    /** Visits the chunk list of every block of a manifest: the root block, then each section. */
+    void ForEachManifestBlock(const FJsonObject& Manifest, TFunctionRef<void(const FString& /*Section*/, const FJsonObject& /*Block*/)> Visitor)
+    {
+        Visitor(FString(), Manifest);
+
+        const TSharedPtr<FJsonObject>* Sections = nullptr;
+        if (Manifest.TryGetObjectField(TEXT("Sections"), Sections))
+        {
+            for (const auto& Pair : (*Sections)->Values)
+            {
+                const TSharedPtr<FJsonObject>* Block = nullptr;
+                if (Pair.Value->TryGetObject(Block))
+                {
+                    Visitor(Pair.Key, **Block);
+                }
+            }
+        }
+    }
+
+    /** Returns recorded version numbers of a slot history directory, ascending. */
+    TArray<int32> FindVersionNumbers(const FString& SlotHistoryDir)
+    {
+        TArray<FString> Files;
+        IFileManager::Get().FindFiles(Files, *FPaths::Combine(SlotHistoryDir, TEXT("v*.json")), true, false);
+
+        TArray<int32> Versions;
+        for (const FString& File : Files)
+        {
+            const FString Number = FPaths::GetBaseFilename(File).RightChop(1);
+            if (Number.IsNumeric())
+            {
+                Versions.Add(FCString::Atoi(*Number));
+            }
+        }
+
+        Versions.Sort();
+        return Versions;
+    }
+}
+
+FString UMotaEzSlotHistory::GetHistoryDirectory()
+{
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    return FPaths::Combine(FPaths::ProjectSavedDir(), Settings->SaveDirectory.Path, TEXT("History"));
+}
+
+FString UMotaEzSlotHistory::GetChunkDirectory()
+{
+    return FPaths::Combine(GetHistoryDirectory(), TEXT("Chunks"));
+}
+
+FString UMotaEzSlotHistory::GetSlotHistoryDirectory(int32 SlotIndex)
+{
+    return FPaths::Combine(GetHistoryDirectory(), FPaths::GetBaseFilename(UMotaEzSlotManager::GetSlotConfigPath(SlotIndex)));
+}
+
+FString UMotaEzSlotHistory::GetManifestPath(int32 SlotIndex, int32 Version)
+{
+    return FPaths::Combine(GetSlotHistoryDirectory(SlotIndex), FString::Printf(TEXT("v%d.json"), Version));
+}
+
+bool UMotaEzSlotHistory::RecordVersion(int32 SlotIndex, EMotaEzConfigFormat Format, const FString& Text, FString& OutError)
+{
+    TMap<FString, FString> Blocks;
+    Blocks.Add(FString(), Text);
+    return RecordBlocks(SlotIndex, Format, Blocks, OutError);
+}
+
+bool UMotaEzSlotHistory::RecordBlocks(int32 SlotIndex, EMotaEzConfigFormat Format, const TMap<FString, FString>& Blocks, FString& OutError)
+{
+    OutError.Reset();
+
+    const FString* RootText = Blocks.Find(FString());
+    if (!RootText)
+    {
+        OutError = FString::Printf(TEXT("Slot %d version has no root block"), SlotIndex);
+        return false;
+    }
+
+    const FString ChunkDir = GetChunkDirectory();
+    const FString SlotDir = GetSlotHistoryDirectory(SlotIndex);
+    if (!IFileManager::Get().MakeDirectory(*ChunkDir, true) || !IFileManager::Get().MakeDirectory(*SlotDir, true))
+    {
+        OutError = FString::Printf(TEXT("Failed to create history directory: %s"), *SlotDir);
+        return false;
+    }
+
+    const bool bEncrypt = UMotaEzEncryption::ShouldEncrypt();
+    const FString Key = bEncrypt ? UMotaEzEncryption::GetEncryptionKey() : FString();
+
+    // The root block keeps the top-level Size and Chunks fields, so versions of unsectioned slots read as before
+    TArray<TSharedPtr<FJsonValue>> ChunkList;
+    int64 PayloadSize = 0;
+    int32 NewChunks = 0;
+    if (!StoreBlockChunks(*RootText, ChunkDir, bEncrypt, Key, ChunkList, PayloadSize, NewChunks, OutError))
+    {
+        return false;
+    }
+
+    int32 TotalChunks = ChunkList.Num();
+    TSharedPtr<FJsonObject> Sections = MakeShareable(new FJsonObject());
+    for (const auto& Pair : Blocks)
+    {
+        if (Pair.Key.IsEmpty())
+        {
+            continue;
+        }
+
+        TArray<TSharedPtr<FJsonValue>> SectionChunks;
+        int64 SectionSize = 0;
+        if (!StoreBlockChunks(Pair.Value, ChunkDir, bEncrypt, Key, SectionChunks, SectionSize, NewChunks, OutError))
+        {
+            return false;
+        }
+
+        TotalChunks += SectionChunks.Num();
+        TSharedPtr<FJsonObject> Block = MakeShareable(new FJsonObject());
+        Block->SetNumberField(TEXT("Size"), SectionSize);
+        Block->SetArrayField(TEXT("Chunks"), SectionChunks);
+        Sections->SetObjectField(Pair.Key, Block);
+    }
+
+    const TArray<int32> Existing = FindVersionNumbers(SlotDir);
+    const int32 Version = Existing.Num() > 0 ? Existing.Last() + 1 : 1;
+
+    TSharedPtr<FJsonObject> Manifest = MakeShareable(new FJsonObject());
+    Manifest->SetNumberField(TEXT("Version"), Version);
+    Manifest->SetNumberField(TEXT("SlotIndex"), SlotIndex);
+    Manifest->SetStringField(TEXT("Timestamp"), FDateTime::Now().ToString());
+    Manifest->SetNumberField(TEXT("Format"), (int32)Format);
+    Manifest->SetNumberField(TEXT("Size"), PayloadSize);
+    Manifest->SetBoolField(TEXT("Encrypted"), bEncrypt);
+    Manifest->SetArrayField(TEXT("Chunks"), ChunkList);
+    if (Sections->Values.Num() > 0)
+    {
+        Manifest->SetObjectField(TEXT("Sections"), Sections);
+    }
+
+    // Written like the chunks, so a crash never leaves a truncated manifest whose chunks garbage collection would free
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    const FString ManifestPath = GetManifestPath(SlotIndex, Version);
+    const FString TempManifestPath = ManifestPath + TEXT(".tmp");
+    if (!FJsonSerializer::Serialize(Manifest.ToSharedRef(), Writer)
+        || !FFileHelper::SaveStringToFile(JsonString, *TempManifestPath)
+        || !IFileManager::Get().Move(*ManifestPath, *TempManifestPath, true))
+    {
+        IFileManager::Get().Delete(*TempManifestPath);
+        OutError = FString::Printf(TEXT("Failed to write manifest for slot %d version %d"), SlotIndex, Version);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: History - Slot %d version %d recorded (%d blocks, %d chunks, %d new)"),
+        SlotIndex, Version, Blocks.Num(), TotalChunks, NewChunks);
+
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    if (Settings && Settings->MaxHistoryVersions > 0)
+    {
+        PruneSlotHistory(SlotIndex, Settings->MaxHistoryVersions);
+    }
+
+    return true;
+}
+
+bool UMotaEzSlotHistory::SnapshotSlot(int32 SlotIndex, FString& OutError)
+{
+    TMap<FString, FString> Blocks;
+    FMotaEzSlotFileHeader Header;
+    if (!UMotaEzSlotFile::ReadText(UMotaEzSlotManager::GetSlotConfigPath(SlotIndex), Blocks.Add(FString()), OutError, &Header))
+    {
+        return false;
+    }
+
+    // Section blocks are part of the slot; a version without them could not restore it
+    for (const FString& Section : UMotaEzSlotManager::GetSlotSectionNames(SlotIndex))
+    {
+        if (!UMotaEzSlotFile::ReadText(UMotaEzSlotManager::GetSlotSectionPath(SlotIndex, Section), Blocks.Add(Section), OutError))
+        {
+            OutError = FString::Printf(TEXT("Section '%s': %s"), *Section, *OutError);
+            return false;
+        }
+    }
+
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    const EMotaEzConfigFormat Format = Header.HasChecksum() ? Header.Format : Settings->DefaultFormat;
+    return RecordBlocks(SlotIndex, Format, Blocks, OutError);
+}
+
+TArray<FMotaEzSlotVersionInfo> UMotaEzSlotHistory::GetSlotVersions(int32 SlotIndex)
+{
+    TArray<FMotaEzSlotVersionInfo> Result;
+
+    for (int32 Version : FindVersionNumbers(GetSlotHistoryDirectory(SlotIndex)))
+    {
+        TSharedPtr<FJsonObject> Manifest;
+        if (!LoadManifest(GetManifestPath(SlotIndex, Version), Manifest))
+        {
+            continue;
+        }
+
+        FMotaEzSlotVersionInfo& Info = Result.AddDefaulted_GetRef();
+        Info.Version = Version;
+        ForEachManifestBlock(*Manifest, [&Info](const FString&, const FJsonObject& Block)
+        {
+            Info.Size += (int64)Block.GetNumberField(TEXT("Size"));
+            Info.NumChunks += Block.GetArrayField(TEXT("Chunks")).Num();
+        });
+        FDateTime::Parse(Manifest->GetStringField(TEXT("Timestamp")), Info.Timestamp);
+    }
+
+    return Result;
+}
+
+bool UMotaEzSlotHistory::RestoreSlotVersion(int32 SlotIndex, int32 Version, FString& OutError)
+{
+    OutError.Reset();
+
+    TSharedPtr<FJsonObject> Manifest;
+    if (!LoadManifest(GetManifestPath(SlotIndex, Version), Manifest))
+    {
+        OutError = FString::Printf(TEXT("Slot %d has no version %d"), SlotIndex, Version);
+        return false;
+    }
+
+    const bool bEncrypted = Manifest->GetBoolField(TEXT("Encrypted"));
+    const EMotaEzConfigFormat Format = (EMotaEzConfigFormat)Manifest->GetIntegerField(TEXT("Format"));
+    const FString ChunkDir = GetChunkDirectory();
+    const FString Key = bEncrypted ? UMotaEzEncryption::GetEncryptionKey() : FString();
+
+    // Every block is rebuilt and verified before any file is touched
+    TMap<FString, FString> Blocks;
+    bool bComplete = true;
+    ForEachManifestBlock(*Manifest, [&](const FString& Section, const FJsonObject& Block)
+    {
+        if (bComplete && !LoadBlockChunks(Block.GetArrayField(TEXT("Chunks")), (int64)Block.GetNumberField(TEXT("Size")),
+            ChunkDir, bEncrypted, Key, Blocks.Add(Section), OutError))
+        {
+            bComplete = false;
+        }
+    });
+
+    if (!bComplete)
+    {
+        if (OutError.IsEmpty())
+        {
+            OutError = FString::Printf(TEXT("Slot %d version %d is incomplete"), SlotIndex, Version);
+        }
+        return false;
+    }
+
+    // Nothing cached or prefetched may outlive the files it was read from
+    UMotaEzSlotManager::InvalidateSlotWriteState(SlotIndex);
+
+    // Section blocks the version did not have would otherwise be loaded on top of the restored root
+    for (const FString& Section : UMotaEzSlotManager::GetSlotSectionNames(SlotIndex))
+    {
+        if (!Blocks.Contains(Section))
+        {
+            IFileManager::Get().Delete(*UMotaEzSlotManager::GetSlotSectionPath(SlotIndex, Section));
+        }
+    }
+
+    for (const auto& Pair : Blocks)
+    {
+        if (!UMotaEzSlotFile::WriteText(UMotaEzSlotManager::GetSlotSectionPath(SlotIndex, Pair.Key), Format, Pair.Value, OutError))
+        {
+            return false;
+        }
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: History - Slot %d restored to version %d (%d blocks)"), SlotIndex, Version, Blocks.Num());
+    return true;
+}
+
+int32 UMotaEzSlotHistory::PruneSlotHistory(int32 SlotIndex, int32 KeepVersions)
+{
+    const TArray<int32> Versions = FindVersionNumbers(GetSlotHistoryDirectory(SlotIndex));
+    const int32 NumToDelete = FMath::Max(0, Versions.Num() - FMath::Max(0, KeepVersions));
+
+    for (int32 i = 0; i < NumToDelete; ++i)
+    {
+        IFileManager::Get().Delete(*GetManifestPath(SlotIndex, Versions[i]));
+    }
+
+    if (NumToDelete > 0)
+    {
+        const int32 DeletedChunks = CollectGarbageChunks();
+        UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: History - Pruned %d versions of slot %d (%d chunks freed)"), NumToDelete, SlotIndex, DeletedChunks);
+    }
+
+    return NumToDelete;
+}
+
+void UMotaEzSlotHistory::DeleteSlotHistory(int32 SlotIndex)
+{
+    IFileManager::Get().DeleteDirectory(*GetSlotHistoryDirectory(SlotIndex), false, true);
+    CollectGarbageChunks();
+}
+
+int32 UMotaEzSlotHistory::CollectGarbageChunks()
+{
+    TSet<FString> Referenced;
+
+    TArray<FString> Manifests;
+    IFileManager::Get().FindFilesRecursive(Manifests, *GetHistoryDirectory(), TEXT("v*.json"), true, false);
+
+    for (const FString& ManifestPath : Manifests)
+    {
+        TSharedPtr<FJsonObject> Manifest;
+        if (!LoadManifest(ManifestPath, Manifest))
+        {
+            continue;
+        }
+
+        const FString Extension = GetChunkExtension(Manifest->GetBoolField(TEXT("Encrypted")));
+        ForEachManifestBlock(*Manifest, [&Referenced, &Extension](const FString&, const FJsonObject& Block)
+        {
+            for (const TSharedPtr<FJsonValue>& Entry : Block.GetArrayField(TEXT("Chunks")))
+            {
+                Referenced.Add(Entry->AsString() + Extension);
+            }
+        });
+    }
+
+    TArray<FString> Chunks;
+    IFileManager::Get().FindFiles(Chunks, *FPaths::Combine(GetChunkDirectory(), TEXT("*")), true, false);
+
+    int32 Deleted = 0;
+    for (const FString& ChunkFile : Chunks)
+    {
+        if (!Referenced.Contains(ChunkFile) && IFileManager::Get().Delete(*FPaths::Combine(GetChunkDirectory(), ChunkFile)))
+        {
+            ++Deleted;
+        }
+    }
+
+    return Deleted;
+}
@@ -3,6 +3,10 @@
 #include "MotaEzSaveData.h"
 #include "MotaEzSaveGameSettings.h"
 #include "MotaEzFormatSerializer.h"
+#include "MotaEzSlotFile.h"
+#include "MotaEzEncryption.h"
+#include "MotaEzSlotHistory.h"
+#include "MotaEzObjectSerializer.h"
 #include "Engine/World.h"
 #include "Engine/GameInstance.h"
 #include "Engine/Engine.h"
@@ -15,10 +19,491 @@
 #include "Dom/JsonObject.h"
 #include "ImageUtils.h"
 #include "Engine/GameViewportClient.h"
+#include "Misc/Compression.h"
+#include "HAL/FileManager.h"
+#include "Tasks/Task.h"
+#include "Containers/Ticker.h"
+#include "Misc/PackageName.h"
+#include "Algo/AnyOf.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
 
 const FString UMotaEzSlotManager::LastUsedSlotKey = TEXT("LastUsedSlot");
 const int32 UMotaEzSlotManager::AutoSaveSlotIndex = -1;
 
+namespace
+{
+    /** Write fingerprint of the last successful save or load per slot. */
+    TMap<int32, uint64> LastWrittenFingerprints;
+
+    /** Slot index last recorded as LastUsedSlot in the global config. */
+    int32 LastWrittenGlobalSlot = INDEX_NONE;
+
+    FORCEINLINE uint64 MakeWriteFingerprint(const UMotaEzSaveData* SaveData, EMotaEzConfigFormat Format)
+    {
+        return UMotaEzSlotFile::MakeWriteFingerprint(SaveData->GetFingerprint(), Format);
+    }
+
+    /** Write fingerprint of each section block per slot, the root block under the empty name. */
+    TMap<int32, TMap<FString, uint64>> LastWrittenSectionFingerprints;
+
+    /** Parsed slot contents; shared between the cache and its readers, never modified once built. */
+    typedef TSharedPtr<const TMap<FString, FMotaEzValue>, ESPMode::ThreadSafe> FParsedSlotDataPtr;
+
+    /** A parsed slot kept in memory, either as the live map or compressed once it goes cold. */
+    struct FParsedSlotEntry
+    {
+        FParsedSlotDataPtr Data;
+        TArray<uint8> Compressed;
+        int32 UncompressedSize = 0;
+        EMotaEzConfigFormat Format = EMotaEzConfigFormat::Toml;
+        FDateTime FileTimestamp;
+        int64 FileSize = 0;
+        uint64 Checksum = 0;
+        bool bHasChecksum = false;
+        int64 MemoryBytes = 0;
+        uint64 LastUse = 0;
+
+        bool IsCompressed() const { return UncompressedSize > 0; }
+    };
+
+    FORCEINLINE int64 EstimateMemory(const TMap<FString, FMotaEzValue>& Data)
+    {
+        int64 Bytes = Data.GetAllocatedSize();
+        for (const auto& Pair : Data)
+        {
+            Bytes += Pair.Key.GetAllocatedSize() + Pair.Value.ScalarValue.GetAllocatedSize() + Pair.Value.ArrayValues.GetAllocatedSize()
+                + Pair.Value.StructData.GetAllocatedSize() + (Pair.Value.BlobData.IsValid() ? Pair.Value.BlobData->GetAllocatedSize() : 0);
+            for (const FString& Element : Pair.Value.ArrayValues)
+            {
+                Bytes += Element.GetAllocatedSize();
+            }
+        }
+        return Bytes;
+    }
+
+    /**
+     * LRU cache of parsed slot files, bounded by UMotaEzSaveGameSettings::SlotCacheBudgetKB.
+     * An entry is valid while the file keeps its timestamp and size, or, if only the timestamp
+     * changed, while its header checksum is unchanged. A hit needs no file read and no parsing,
+     * and hands out the cached map itself rather than a copy of it.
+     */
+    class FParsedSlotCache
+    {
+    public:
+        bool Find(int32 SlotIndex, const FString& FilePath, FParsedSlotDataPtr& OutData, EMotaEzConfigFormat& OutFormat)
+        {
+            const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+            FParsedSlotEntry* Entry = Entries.Find(SlotIndex);
+            if (!Entry || !Settings->bEnableSlotCache)
+            {
+                return false;
+            }
+
+            const FFileStatData Stat = IFileManager::Get().GetStatData(*FilePath);
+            if (!Stat.bIsValid || Stat.FileSize != Entry->FileSize)
+            {
+                Remove(SlotIndex);
+                return false;
+            }
+
+            if (Stat.ModificationTime != Entry->FileTimestamp)
+            {
+                // Touched or rewritten: still usable if the stored bytes are the same
+                FMotaEzSlotFileHeader Header;
+                FString Error;
+                if (!Entry->bHasChecksum || !UMotaEzSlotFile::ReadHeader(FilePath, Header, Error)
+                    || !Header.HasChecksum() || Header.Checksum != Entry->Checksum)
+                {
+                    Remove(SlotIndex);
+                    return false;
+                }
+                Entry->FileTimestamp = Stat.ModificationTime;
+            }
+
+            if (Entry->IsCompressed() && !Decompress(*Entry))
+            {
+                Remove(SlotIndex);
+                return false;
+            }
+
+            Entry->LastUse = ++Clock;
+            OutData = Entry->Data;
+            OutFormat = Entry->Format;
+
+            Trim(SlotIndex);
+            return true;
+        }
+
+        void Add(int32 SlotIndex, const FString& FilePath, TMap<FString, FMotaEzValue> Data, EMotaEzConfigFormat Format, const FMotaEzSlotFileHeader& Header)
+        {
+            Add(SlotIndex, IFileManager::Get().GetStatData(*FilePath), MoveTemp(Data), Format, Header);
+        }
+
+        /** Adds an entry for file contents that were read when the file had the given stat data. */
+        void Add(int32 SlotIndex, const FFileStatData& Stat, TMap<FString, FMotaEzValue> Data, EMotaEzConfigFormat Format, const FMotaEzSlotFileHeader& Header)
+        {
+            Remove(SlotIndex);
+
+            const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+            if (!Settings->bEnableSlotCache || !Stat.bIsValid)
+            {
+                return;
+            }
+
+            FParsedSlotEntry& Entry = Entries.Add(SlotIndex);
+            Entry.Data = MakeShared<TMap<FString, FMotaEzValue>, ESPMode::ThreadSafe>(MoveTemp(Data));
+            Entry.Format = Format;
+            Entry.FileTimestamp = Stat.ModificationTime;
+            Entry.FileSize = Stat.FileSize;
+            Entry.Checksum = Header.Checksum;
+            Entry.bHasChecksum = Header.HasChecksum();
+            Entry.MemoryBytes = EstimateMemory(*Entry.Data);
+            Entry.LastUse = ++Clock;
+            TotalBytes += Entry.MemoryBytes;
+
+            Trim(SlotIndex);
+        }
+
+        /** Duplicates an entry after its file was cloned, so the copy is cached without re-reading; both share the parsed map. */
+        void Copy(int32 FromSlot, int32 ToSlot, const FString& ToPath)
+        {
+            Remove(ToSlot);
+
+            const FParsedSlotEntry* Source = Entries.Find(FromSlot);
+            const FFileStatData Stat = IFileManager::Get().GetStatData(*ToPath);
+            if (!Source || !Stat.bIsValid || Stat.FileSize != Source->FileSize)
+            {
+                return;
+            }
+
+            FParsedSlotEntry Copied = *Source;
+            Copied.FileTimestamp = Stat.ModificationTime;
+            Copied.LastUse = ++Clock;
+            TotalBytes += Copied.MemoryBytes;
+            Entries.Add(ToSlot, MoveTemp(Copied));
+
+            Trim(ToSlot);
+        }
+
+        bool Contains(int32 SlotIndex) const
+        {
+            return Entries.Contains(SlotIndex);
+        }
+
+        void Remove(int32 SlotIndex)
+        {
+            FParsedSlotEntry Removed;
+            if (Entries.RemoveAndCopyValue(SlotIndex, Removed))
+            {
+                TotalBytes -= Removed.MemoryBytes;
+            }
+        }
+
+    private:
+        bool Compress(FParsedSlotEntry& Entry)
+        {
+            TArray<uint8> Raw;
+            FMemoryWriter Writer(Raw);
+            Writer << const_cast<TMap<FString, FMotaEzValue>&>(*Entry.Data);
+
+            int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Raw.Num());
+            TArray<uint8> Compressed;
+            Compressed.SetNumUninitialized(CompressedSize);
+
+            if (!FCompression::CompressMemory(NAME_Oodle, Compressed.GetData(), CompressedSize, Raw.GetData(), Raw.Num()))
+            {
+                return false;
+            }
+
+            Compressed.SetNum(CompressedSize);
+            Compressed.Shrink();
+
+            // Readers still holding the map keep it alive; the cache only drops its reference
+            TotalBytes -= Entry.MemoryBytes;
+            Entry.Data.Reset();
+            Entry.Compressed = MoveTemp(Compressed);
+            Entry.UncompressedSize = Raw.Num();
+            Entry.MemoryBytes = Entry.Compressed.GetAllocatedSize();
+            TotalBytes += Entry.MemoryBytes;
+            return true;
+        }
+
+        bool Decompress(FParsedSlotEntry& Entry)
+        {
+            TArray<uint8> Raw;
+            Raw.SetNumUninitialized(Entry.UncompressedSize);
+
+            if (!FCompression::UncompressMemory(NAME_Oodle, Raw.GetData(), Raw.Num(), Entry.Compressed.GetData(), Entry.Compressed.Num()))
+            {
+                return false;
+            }
+
+            TMap<FString, FMotaEzValue> Data;
+            FMemoryReader Reader(Raw);
+            Reader << Data;
+
+            TotalBytes -= Entry.MemoryBytes;
+            Entry.Data = MakeShared<TMap<FString, FMotaEzValue>, ESPMode::ThreadSafe>(MoveTemp(Data));
+            Entry.Compressed.Empty();
+            Entry.UncompressedSize = 0;
+            Entry.MemoryBytes = EstimateMemory(*Entry.Data);
+            TotalBytes += Entry.MemoryBytes;
+            return !Reader.IsError();
+        }
+
+        /**
+         * Compresses, then evicts, least recently used entries until the cache fits its budget.
+         * @param KeepSlot - Slot just added or looked up; never compressed or evicted, even if it alone is over budget
+         */
+        void Trim(int32 KeepSlot)
+        {
+            const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+            const int64 Budget = (int64)FMath::Max(Settings->SlotCacheBudgetKB, 0) * 1024;
+
+            while (TotalBytes > Budget && Entries.Num() > 0)
+            {
+                int32 ColdestLive = INDEX_NONE;
+                int32 Coldest = INDEX_NONE;
+                uint64 ColdestLiveUse = MAX_uint64;
+                uint64 ColdestUse = MAX_uint64;
+
+                for (const auto& Pair : Entries)
+                {
+                    if (Pair.Key == KeepSlot)
+                    {
+                        continue;
+                    }
+                    if (Pair.Value.LastUse < ColdestUse)
+                    {
+                        Coldest = Pair.Key;
+                        ColdestUse = Pair.Value.LastUse;
+                    }
+                    if (!Pair.Value.IsCompressed() && Pair.Value.LastUse < ColdestLiveUse)
+                    {
+                        ColdestLive = Pair.Key;
+                        ColdestLiveUse = Pair.Value.LastUse;
+                    }
+                }
+
+                if (Settings->bCompressColdSlotCache && ColdestLive != INDEX_NONE && Compress(Entries[ColdestLive]))
+                {
+                    continue;
+                }
+
+                if (Coldest == INDEX_NONE)
+                {
+                    break;
+                }
+                Remove(Coldest);
+            }
+        }
+
+        TMap<int32, FParsedSlotEntry> Entries;
+        int64 TotalBytes = 0;
+        uint64 Clock = 0;
+    };
+
+    FParsedSlotCache ParsedSlotCache;
+
+    /** A slot file read and parsed, on the game thread or on a prefetch task. */
+    struct FParsedSlotFile
+    {
+        TMap<FString, FMotaEzValue> Data;
+        FMotaEzSlotFileHeader Header;
+        EMotaEzConfigFormat Format = EMotaEzConfigFormat::Toml;
+        FFileStatData Stat;
+        FString Error;
+        bool bSuccess = false;
+    };
+
+    /**
+     * Reads, verifies, decrypts and parses a slot file. Thread-safe.
+     * @param bCancelled - Optional flag set by the game thread; checked between steps so a cancelled read stops early
+     */
+    FParsedSlotFile ReadSlotFile(const FString& FilePath, EMotaEzConfigFormat DefaultFormat, const std::atomic<bool>* bCancelled = nullptr)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_ReadSlotFile);
+
+        FParsedSlotFile Result;
+
+        // Stat before reading: if the file changes meanwhile, the cache entry just fails validation later
+        Result.Stat = IFileManager::Get().GetStatData(*FilePath);
+
+        // Reject truncated or foreign files before reading the payload
+        if (!UMotaEzSlotFile::ReadHeader(FilePath, Result.Header, Result.Error))
+        {
+            return Result;
+        }
+
+        if (bCancelled && bCancelled->load())
+        {
+            Result.Error = TEXT("Cancelled");
+            return Result;
+        }
+
+        FString ConfigText;
+        if (!UMotaEzSlotFile::ReadText(FilePath, ConfigText, Result.Error, &Result.Header))
+        {
+            return Result;
+        }
+
+        if (bCancelled && bCancelled->load())
+        {
+            Result.Error = TEXT("Cancelled");
+            return Result;
+        }
+
+        // Files with a container header know their own format; legacy files use the project default
+        Result.Format = Result.Header.HasChecksum() ? Result.Header.Format : DefaultFormat;
+
+        FString ParseError;
+        if (!UMotaEzFormatSerializer::LoadConfig(Result.Format, ConfigText, Result.Data, ParseError))
+        {
+            Result.Error = FString::Printf(TEXT("Deserialization failed: %s"), *ParseError);
+            return Result;
+        }
+
+        Result.bSuccess = true;
+        return Result;
+    }
+
+    /** What a prefetch task read: the root block, unless it was already cached, and the named section blocks. */
+    struct FPrefetchedSlot
+    {
+        TOptional<FParsedSlotFile> Root;
+        TMap<FString, FParsedSlotFile> Sections;
+    };
+
+    /**
+     * A slot being read on a worker task, with the keys its manifest expects. Results only reach
+     * the parsed slot cache through this map on the game thread, so a prefetch removed from it
+     * can never publish its data.
+     */
+    struct FPendingPrefetch
+    {
+        UE::Tasks::TTask<FPrefetchedSlot> Task;
+        TArray<FString> ExpectedKeys;
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+    };
+
+    TMap<int32, FPendingPrefetch> PendingPrefetches;
+    FTSTicker::FDelegateHandle PrefetchTickerHandle;
+
+    /**
+     * Named section blocks read by a prefetch, per slot, held until a load takes them.
+     * The parsed slot cache only holds root blocks, so sections are handed over once instead of cached.
+     */
+    TMap<int32, TMap<FString, FParsedSlotFile>> PrefetchedSections;
+
+    /**
+     * Takes a prefetched section block, if there is one and its file is unchanged since it was read.
+     * @param Path - Path of the section block
+     * @return true if OutParsed holds the block's data
+     */
+    bool TakePrefetchedSection(int32 SlotIndex, const FString& Section, const FString& Path, FParsedSlotFile& OutParsed)
+    {
+        TMap<FString, FParsedSlotFile>* Staged = PrefetchedSections.Find(SlotIndex);
+        FParsedSlotFile* Found = Staged ? Staged->Find(Section) : nullptr;
+        if (!Found)
+        {
+            return false;
+        }
+
+        OutParsed = MoveTemp(*Found);
+        Staged->Remove(Section);
+        if (Staged->Num() == 0)
+        {
+            PrefetchedSections.Remove(SlotIndex);
+        }
+
+        const FFileStatData Stat = IFileManager::Get().GetStatData(*Path);
+        return Stat.bIsValid && Stat.FileSize == OutParsed.Stat.FileSize && Stat.ModificationTime == OutParsed.Stat.ModificationTime;
+    }
+
+    void CompletePrefetch(int32 SlotIndex, FPendingPrefetch& Pending)
+    {
+        FPrefetchedSlot& Result = Pending.Task.GetResult();
+
+        if (Result.Root.IsSet())
+        {
+            FParsedSlotFile& Root = Result.Root.GetValue();
+            if (!Root.bSuccess)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Prefetch of slot %d failed: %s"), SlotIndex, *Root.Error);
+            }
+            else
+            {
+                for (const FString& Key : Pending.ExpectedKeys)
+                {
+                    const bool bInSection = Algo::AnyOf(Result.Sections, [&Key](const TPair<FString, FParsedSlotFile>& Pair)
+                    {
+                        return Pair.Value.Data.Contains(Key);
+                    });
+                    if (!Root.Data.Contains(Key) && !bInSection)
+                    {
+                        UE_LOG(LogTemp, Log, TEXT("EzSaveGame: Preload manifest expects key '%s' in slot %d, but the slot does not contain it"), *Key, SlotIndex);
+                    }
+                }
+
+                UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: Prefetched slot %d (%d keys, %d section blocks)"), SlotIndex, Root.Data.Num(), Result.Sections.Num());
+                ParsedSlotCache.Add(SlotIndex, Root.Stat, MoveTemp(Root.Data), Root.Format, Root.Header);
+            }
+        }
+
+        if (Result.Sections.Num() > 0)
+        {
+            TMap<FString, FParsedSlotFile>& Staged = PrefetchedSections.FindOrAdd(SlotIndex);
+            for (TPair<FString, FParsedSlotFile>& Pair : Result.Sections)
+            {
+                Staged.Add(Pair.Key, MoveTemp(Pair.Value));
+            }
+        }
+    }
+
+    /** Moves finished prefetches into the parsed slot cache. */
+    void DrainCompletedPrefetches()
+    {
+        for (auto It = PendingPrefetches.CreateIterator(); It; ++It)
+        {
+            if (It->Value.Task.IsCompleted())
+            {
+                CompletePrefetch(It->Key, It->Value);
+                It.RemoveCurrent();
+            }
+        }
+    }
+
+    /** Blocks on a slot's prefetch if it is still running, so a load never reads the file twice. */
+    void WaitForPrefetch(int32 SlotIndex)
+    {
+        FPendingPrefetch Pending;
+        if (PendingPrefetches.RemoveAndCopyValue(SlotIndex, Pending))
+        {
+            CompletePrefetch(SlotIndex, Pending);
+        }
+    }
+
+    /**
+     * Discards an in-flight prefetch, and the section blocks it already read, for a slot whose files are
+     * about to change. Waits for the worker to stop, so it no longer holds a file open when the caller
+     * replaces or deletes it.
+     */
+    void CancelPrefetch(int32 SlotIndex)
+    {
+        PrefetchedSections.Remove(SlotIndex);
+
+        FPendingPrefetch Pending;
+        if (PendingPrefetches.RemoveAndCopyValue(SlotIndex, Pending))
+        {
+            Pending.bCancelled->store(true);
+            Pending.Task.Wait();
+        }
+    }
+}
+
 static UMotaEzConfigSubsystem* GetSubsystem(const UObject* WorldContextObject)
 {
     if (!WorldContextObject) return nullptr;
@@ -56,23 +541,366 @@ FString UMotaEzSlotManager::GetSlotMetadataPath(int32 SlotIndex)
     const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
     if (!Settings) return TEXT("");
 
-    FString SaveDir = FPaths::Combine(FPaths::ProjectSavedDir(), Settings->SaveDirectory.Path);
-    FString SlotName = (SlotIndex == AutoSaveSlotIndex) ? TEXT("AutoSave") : FString::Printf(TEXT("Slot%d"), SlotIndex);
-    
-    return FPaths::Combine(SaveDir, FString::Printf(TEXT("%s_Metadata.json"), *SlotName));
+    FString SaveDir = FPaths::Combine(FPaths::ProjectSavedDir(), Settings->SaveDirectory.Path);
+    FString SlotName = (SlotIndex == AutoSaveSlotIndex) ? TEXT("AutoSave") : FString::Printf(TEXT("Slot%d"), SlotIndex);
+    
+    return FPaths::Combine(SaveDir, FString::Printf(TEXT("%s_Metadata.json"), *SlotName));
+}
+
+FString UMotaEzSlotManager::GetSlotSectionPath(int32 SlotIndex, const FString& Section)
+{
+    const FString ConfigPath = GetSlotConfigPath(SlotIndex);
+    if (Section.IsEmpty())
+    {
+        return ConfigPath;
+    }
+
+    // Slot0.toml -> Slot0.<Section>.toml
+    return FPaths::Combine(FPaths::GetPath(ConfigPath),
+        FString::Printf(TEXT("%s.%s%s"), *FPaths::GetBaseFilename(ConfigPath), *Section, *FPaths::GetExtension(ConfigPath, true)));
+}
+
+FString UMotaEzSlotManager::GetSlotBlockPath(int32 SlotIndex, const FString& BlockName)
+{
+    const FString ConfigPath = GetSlotConfigPath(SlotIndex);
+    return FPaths::Combine(FPaths::GetPath(ConfigPath),
+        FString::Printf(TEXT("%s.%s.ezblock"), *FPaths::GetBaseFilename(ConfigPath), *BlockName));
+}
+
+TArray<FString> UMotaEzSlotManager::GetSlotSectionNames(int32 SlotIndex)
+{
+    const FString ConfigPath = GetSlotConfigPath(SlotIndex);
+    const FString Prefix = FPaths::GetBaseFilename(ConfigPath) + TEXT(".");
+    const FString Extension = FPaths::GetExtension(ConfigPath, true);
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *FPaths::Combine(FPaths::GetPath(ConfigPath), Prefix + TEXT("*") + Extension), true, false);
+
+    TArray<FString> Sections;
+    for (const FString& File : Files)
+    {
+        const FString Section = File.Mid(Prefix.Len(), File.Len() - Prefix.Len() - Extension.Len());
+        if (!Section.IsEmpty())
+        {
+            Sections.Add(Section);
+        }
+    }
+    return Sections;
+}
+
+bool UMotaEzSlotManager::WriteSlotSections(UMotaEzSaveData* SaveData, int32 SlotIndex, const TArray<FString>* OnlySections, int32& OutWritten, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_WriteSlotSections);
+
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    const EMotaEzConfigFormat Format = Settings->DefaultFormat;
+    TMap<FString, uint64>& WrittenSections = LastWrittenSectionFingerprints.FindOrAdd(SlotIndex);
+
+    TArray<FString> Sections;
+    if (OnlySections)
+    {
+        Sections = *OnlySections;
+    }
+    else
+    {
+        Sections.Add(FString());
+        Sections.Append(SaveData->GetSectionNames());
+
+        // Complete data replaces the whole slot, so blocks of sections it does not have are dropped
+        if (SaveData->UnloadedSections.Num() == 0)
+        {
+            for (const FString& OnDisk : GetSlotSectionNames(SlotIndex))
+            {
+                if (!Sections.Contains(OnDisk))
+                {
+                    IFileManager::Get().Delete(*GetSlotSectionPath(SlotIndex, OnDisk));
+                    WrittenSections.Remove(OnDisk);
+                }
+            }
+        }
+    }
+
+    OutWritten = 0;
+    for (const FString& Section : Sections)
+    {
+        const FString Path = GetSlotSectionPath(SlotIndex, Section);
+        const uint64 WriteFingerprint = UMotaEzSlotFile::MakeWriteFingerprint(SaveData->GetSectionFingerprint(Section), Format);
+        const uint64* LastFingerprint = WrittenSections.Find(Section);
+        const bool bExists = FPaths::FileExists(Path);
+
+        if (LastFingerprint && *LastFingerprint == WriteFingerprint && bExists)
+        {
+            continue;
+        }
+
+        TMap<FString, FMotaEzValue> SectionData;
+        SaveData->GetSectionData(Section, SectionData);
+
+        // An emptied named section has no block; the root block always exists so the slot stays occupied
+        if (!Section.IsEmpty() && SectionData.Num() == 0)
+        {
+            if (bExists && !IFileManager::Get().Delete(*Path))
+            {
+                OutError = FString::Printf(TEXT("Failed to delete empty section block: %s"), *Path);
+                return false;
+            }
+            WrittenSections.Remove(Section);
+            continue;
+        }
+
+        FString SectionText;
+        if (!UMotaEzFormatSerializer::SaveConfig(Format, SectionData, SectionText, OutError))
+        {
+            OutError = FString::Printf(TEXT("Serialization of section '%s' failed: %s"), *Section, *OutError);
+            return false;
+        }
+
+        FMotaEzSlotFileHeader WrittenHeader;
+        if (!UMotaEzSlotFile::WriteText(Path, Format, SectionText, OutError, &WrittenHeader))
+        {
+            WrittenSections.Remove(Section);
+            if (Section.IsEmpty())
+            {
+                ParsedSlotCache.Remove(SlotIndex);
+            }
+            return false;
+        }
+
+        WrittenSections.Add(Section, WriteFingerprint);
+        ++OutWritten;
+
+        // The parsed slot cache holds the root block, which is what LoadFromSlot reads through it
+        if (Section.IsEmpty())
+        {
+            ParsedSlotCache.Add(SlotIndex, Path, MoveTemp(SectionData), Format, WrittenHeader);
+        }
+    }
+
+    return true;
+}
+
+bool UMotaEzSlotManager::SaveSlotSections(const UObject* WorldContextObject, int32 SlotIndex, const TArray<FString>& Sections, FString& OutError)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    UMotaEzSaveData* SaveData = Subsystem ? Subsystem->GetCurrentSave() : nullptr;
+    if (!SaveData)
+    {
+        OutError = TEXT("No data to save");
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveSlotSections - No data to save"));
+        return false;
+    }
+
+    CancelPrefetch(SlotIndex);
+
+    int32 WrittenBlocks = 0;
+    if (!WriteSlotSections(SaveData, SlotIndex, &Sections, WrittenBlocks, OutError))
+    {
+        LastWrittenFingerprints.Remove(SlotIndex);
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveSlotSections - %s"), *OutError);
+        return false;
+    }
+
+    // Other sections may still differ from their blocks, so the whole-slot shortcut no longer applies
+    LastWrittenFingerprints.Remove(SlotIndex);
+
+    if (Subsystem->FindDocument(SlotIndex) == SaveData)
+    {
+        SaveData->MarkSectionClean(FString());
+        for (const FString& Section : Sections)
+        {
+            SaveData->MarkSectionClean(Section);
+        }
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: SaveSlotSections %d - Rewrote %d of %d section block(s)"), SlotIndex, WrittenBlocks, Sections.Num());
+    return true;
+}
+
+bool UMotaEzSlotManager::SaveSlotBlock(int32 SlotIndex, const FString& BlockName, TConstArrayView<uint8> Bytes, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_SaveSlotBlock);
+
+    if (BlockName.IsEmpty())
+    {
+        OutError = TEXT("Block name is empty");
+        return false;
+    }
+
+    if (!UMotaEzSlotFile::WriteBytes(GetSlotBlockPath(SlotIndex, BlockName), Bytes, OutError))
+    {
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveSlotBlock - %s"), *OutError);
+        return false;
+    }
+    return true;
+}
+
+bool UMotaEzSlotManager::LoadSlotBlock(int32 SlotIndex, const FString& BlockName, TArray<uint8>& OutBytes, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_LoadSlotBlock);
+
+    const FString BlockPath = GetSlotBlockPath(SlotIndex, BlockName);
+    if (BlockName.IsEmpty() || !FPaths::FileExists(BlockPath))
+    {
+        OutError = FString::Printf(TEXT("Slot %d has no block '%s'"), SlotIndex, *BlockName);
+        return false;
+    }
+
+    if (!UMotaEzSlotFile::ReadBytes(BlockPath, OutBytes, OutError))
+    {
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadSlotBlock - %s"), *OutError);
+        return false;
+    }
+    return true;
+}
+
+bool UMotaEzSlotManager::LoadSlotSections(const UObject* WorldContextObject, int32 SlotIndex, const TArray<FString>& Sections, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_LoadSlotSections);
+
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem)
+    {
+        OutError = TEXT("Failed to get subsystem");
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadSlotSections - Failed to get subsystem"));
+        return false;
+    }
+
+    if (!IsSlotOccupied(SlotIndex))
+    {
+        OutError = FString::Printf(TEXT("Slot %d is empty"), SlotIndex);
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: LoadSlotSections - %s"), *OutError);
+        return false;
+    }
+
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    const bool bWasResident = Subsystem->FindDocument(SlotIndex) != nullptr;
+    UMotaEzSaveData* Document = Subsystem->FindOrAddDocument(SlotIndex);
+    TMap<FString, uint64>& WrittenSections = LastWrittenSectionFingerprints.FindOrAdd(SlotIndex);
+
+    // The root block is always needed: it holds every key outside a named section
+    TArray<FString> Wanted;
+    Wanted.Add(FString());
+    for (const FString& Section : Sections)
+    {
+        Wanted.AddUnique(Section);
+    }
+
+    WaitForPrefetch(SlotIndex);
+
+    int32 ReadBlocks = 0;
+    for (const FString& Section : Wanted)
+    {
+        // A resident section that is unchanged and matches its block needs no read
+        const uint64* LastFingerprint = WrittenSections.Find(Section);
+        if (bWasResident && !Document->UnloadedSections.Contains(Section) && !Document->IsSectionDirty(Section) && LastFingerprint
+            && *LastFingerprint == UMotaEzSlotFile::MakeWriteFingerprint(Document->GetSectionFingerprint(Section), Settings->DefaultFormat))
+        {
+            continue;
+        }
+
+        const FString Path = GetSlotSectionPath(SlotIndex, Section);
+        TMap<FString, FMotaEzValue> SectionData;
+        EMotaEzConfigFormat Format = Settings->DefaultFormat;
+        FParsedSlotDataPtr Cached;
+
+        if (Section.IsEmpty() && ParsedSlotCache.Find(SlotIndex, Path, Cached, Format))
+        {
+            // Served from the parsed slot cache; the document gets its own copy to edit
+            SectionData = *Cached;
+        }
+        else if (FPaths::FileExists(Path))
+        {
+            // A named section the prefetch already parsed is handed over; otherwise it is read here
+            FParsedSlotFile Parsed;
+            if (Section.IsEmpty() || !TakePrefetchedSection(SlotIndex, Section, Path, Parsed))
+            {
+                Parsed = ReadSlotFile(Path, Settings->DefaultFormat);
+                ++ReadBlocks;
+            }
+            if (!Parsed.bSuccess)
+            {
+                OutError = FString::Printf(TEXT("Section '%s': %s"), *Section, *Parsed.Error);
+                UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadSlotSections - %s"), *OutError);
+                return false;
+            }
+            Format = Parsed.Format;
+            SectionData = MoveTemp(Parsed.Data);
+        }
+
+        Document->ReplaceSection(Section, MoveTemp(SectionData));
+        Document->MarkSectionClean(Section);
+        Document->UnloadedSections.Remove(Section);
+        WrittenSections.Add(Section, UMotaEzSlotFile::MakeWriteFingerprint(Document->GetSectionFingerprint(Section), Format));
+    }
+
+    // Blocks on disk that this document never read must survive its saves
+    const TArray<FString> Known = Document->GetSectionNames();
+    for (const FString& OnDisk : GetSlotSectionNames(SlotIndex))
+    {
+        if (!Wanted.Contains(OnDisk) && !Known.Contains(OnDisk))
+        {
+            Document->UnloadedSections.Add(OnDisk);
+        }
+    }
+
+    if (SlotIndex != AutoSaveSlotIndex)
+    {
+        Document->SetInt(LastUsedSlotKey, SlotIndex);
+        Document->MarkSectionClean(FString());
+    }
+
+    // Only a document holding every section represents the whole slot
+    if (Document->UnloadedSections.Num() == 0 && !Document->IsDirty())
+    {
+        LastWrittenFingerprints.Add(SlotIndex, MakeWriteFingerprint(Document, Settings->DefaultFormat));
+    }
+    else
+    {
+        LastWrittenFingerprints.Remove(SlotIndex);
+    }
+
+    Subsystem->SetCurrentSave(Document);
+
+    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: LoadSlotSections %d - Read %d block(s) for %d section(s)"), SlotIndex, ReadBlocks, Wanted.Num());
+    return true;
+}
+
+bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem)
+    {
+        OutError = TEXT("Failed to get subsystem");
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - Failed to get subsystem"));
+        return false;
+    }
+
+    return SaveDataToSlot(Subsystem, Subsystem->GetCurrentSave(), SlotIndex, OutError);
 }
 
-bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError)
+bool UMotaEzSlotManager::SaveDocument(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError)
 {
     UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
     if (!Subsystem)
     {
         OutError = TEXT("Failed to get subsystem");
-        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - Failed to get subsystem"));
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveDocument - Failed to get subsystem"));
+        return false;
+    }
+
+    UMotaEzSaveData* Document = Subsystem->FindDocument(SlotIndex);
+    if (!Document)
+    {
+        OutError = FString::Printf(TEXT("Slot %d has no resident document"), SlotIndex);
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: SaveDocument - %s"), *OutError);
         return false;
     }
 
-    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
+    return SaveDataToSlot(Subsystem, Document, SlotIndex, OutError);
+}
+
+bool UMotaEzSlotManager::SaveDataToSlot(UMotaEzConfigSubsystem* Subsystem, UMotaEzSaveData* SaveData, int32 SlotIndex, FString& OutError)
+{
     if (!SaveData)
     {
         OutError = TEXT("No data to save");
@@ -90,21 +918,105 @@ bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 Slo
         return false;
     }
 
-    FString ConfigText;
-    if (!UMotaEzFormatSerializer::SaveConfig(Settings->DefaultFormat, SaveData->Data, ConfigText, OutError))
+    // Recorded before fingerprinting, so the file holds it and the document is clean after the write
+    if (SlotIndex != AutoSaveSlotIndex)
     {
-        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - Serialization failed: %s"), *OutError);
-        return false;
+        SaveData->SetInt(LastUsedSlotKey, SlotIndex);
     }
 
     FString ConfigPath = GetSlotConfigPath(SlotIndex);
-    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: SaveToSlot - Writing to: %s"), *ConfigPath);
-    
-    if (!FFileHelper::SaveStringToFile(ConfigText, *ConfigPath))
+
+    // Skip serialization and I/O entirely when the slot already holds exactly this data
+    const uint64 WriteFingerprint = MakeWriteFingerprint(SaveData, Settings->DefaultFormat);
+    const uint64* LastFingerprint = LastWrittenFingerprints.Find(SlotIndex);
+
+    if (LastFingerprint && *LastFingerprint == WriteFingerprint && FPaths::FileExists(ConfigPath))
     {
-        OutError = FString::Printf(TEXT("Failed to write file: %s"), *ConfigPath);
-        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - %s"), *OutError);
-        return false;
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: SaveToSlot %d - No changes since last write, skipping"), SlotIndex);
+    }
+    else if (SaveData->HasSections() || GetSlotSectionNames(SlotIndex).Num() > 0)
+    {
+        // Sectioned slot: only the blocks of sections that changed are rewritten
+        CancelPrefetch(SlotIndex);
+
+        int32 WrittenBlocks = 0;
+        if (!WriteSlotSections(SaveData, SlotIndex, nullptr, WrittenBlocks, OutError))
+        {
+            LastWrittenFingerprints.Remove(SlotIndex);
+            UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - %s"), *OutError);
+            return false;
+        }
+
+        // Sections that were never loaded are still on disk, so the whole slot does not match this data
+        if (SaveData->UnloadedSections.Num() == 0)
+        {
+            LastWrittenFingerprints.Add(SlotIndex, WriteFingerprint);
+        }
+        else
+        {
+            LastWrittenFingerprints.Remove(SlotIndex);
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: SaveToSlot %d - Rewrote %d changed section block(s)"), SlotIndex, WrittenBlocks);
+
+        // Unchanged blocks were not serialized, so the version is taken from the blocks on disk
+        if (Settings->bEnableSlotHistory && WrittenBlocks > 0)
+        {
+            FString HistoryError;
+            if (!UMotaEzSlotHistory::SnapshotSlot(SlotIndex, HistoryError))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: SaveToSlot - History not recorded: %s"), *HistoryError);
+            }
+        }
+    }
+    else
+    {
+        FString ConfigText;
+        TMap<FString, FMotaEzValue> WrittenData;
+        {
+            // Other threads may be writing in thread-safe mode
+            UMotaEzSaveData::FExclusiveScope Lock(*SaveData);
+            if (!UMotaEzFormatSerializer::SaveConfig(Settings->DefaultFormat, SaveData->Data, ConfigText, OutError))
+            {
+                UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - Serialization failed: %s"), *OutError);
+                return false;
+            }
+
+            if (Settings->bEnableSlotCache)
+            {
+                WrittenData = SaveData->Data;
+            }
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: SaveToSlot - Writing to: %s"), *ConfigPath);
+
+        CancelPrefetch(SlotIndex);
+
+        FMotaEzSlotFileHeader WrittenHeader;
+        if (!UMotaEzSlotFile::WriteText(ConfigPath, Settings->DefaultFormat, ConfigText, OutError, &WrittenHeader))
+        {
+            LastWrittenFingerprints.Remove(SlotIndex);
+            ParsedSlotCache.Remove(SlotIndex);
+            UE_LOG(LogTemp, Error, TEXT("EzSaveGame: SaveToSlot - %s"), *OutError);
+            return false;
+        }
+
+        LastWrittenFingerprints.Add(SlotIndex, WriteFingerprint);
+        ParsedSlotCache.Add(SlotIndex, ConfigPath, MoveTemp(WrittenData), Settings->DefaultFormat, WrittenHeader);
+
+        // Without sections the root block is the whole data
+        TMap<FString, uint64>& WrittenSections = LastWrittenSectionFingerprints.FindOrAdd(SlotIndex);
+        WrittenSections.Reset();
+        WrittenSections.Add(FString(), WriteFingerprint);
+
+        if (Settings->bEnableSlotHistory)
+        {
+            FString HistoryError;
+            if (!UMotaEzSlotHistory::RecordVersion(SlotIndex, Settings->DefaultFormat, ConfigText, HistoryError))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: SaveToSlot - History not recorded: %s"), *HistoryError);
+            }
+        }
     }
 
     FMotaEzSlotInfo SlotInfo;
@@ -128,12 +1040,15 @@ bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 Slo
 
     SaveSlotMetadata(SlotIndex, SlotInfo);
 
-    // Update LastUsedSlot in both memory and global config
-    if (SlotIndex != AutoSaveSlotIndex)
+    // The slot's own document now matches its file; another slot's data written here makes it stale
+    if (Subsystem->FindDocument(SlotIndex) == SaveData)
+    {
+        SaveData->MarkClean();
+    }
+
+    // Save to global config for persistence, unless it already points at this slot
+    if (SlotIndex != AutoSaveSlotIndex && LastWrittenGlobalSlot != SlotIndex)
     {
-        SaveData->SetInt(LastUsedSlotKey, SlotIndex);
-        
-        // Save to global config for persistence
         FString GlobalConfigPath = Settings->GetConfigFilePath();
         TMap<FString, FMotaEzValue> GlobalData;
         
@@ -141,9 +1056,9 @@ bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 Slo
         if (FPaths::FileExists(GlobalConfigPath))
         {
             FString GlobalConfigText;
-            if (FFileHelper::LoadFileToString(GlobalConfigText, *GlobalConfigPath))
+            FString Error;
+            if (UMotaEzSlotFile::ReadText(GlobalConfigPath, GlobalConfigText, Error))
             {
-                FString Error;
                 UMotaEzFormatSerializer::LoadConfig(Settings->DefaultFormat, GlobalConfigText, GlobalData, Error);
             }
         }
@@ -157,9 +1072,10 @@ bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 Slo
         // Save global config
         FString GlobalConfigText;
         FString Error;
-        if (UMotaEzFormatSerializer::SaveConfig(Settings->DefaultFormat, GlobalData, GlobalConfigText, Error))
+        if (UMotaEzFormatSerializer::SaveConfig(Settings->DefaultFormat, GlobalData, GlobalConfigText, Error)
+            && UMotaEzSlotFile::WriteText(GlobalConfigPath, Settings->DefaultFormat, GlobalConfigText, Error))
         {
-            FFileHelper::SaveStringToFile(GlobalConfigText, *GlobalConfigPath);
+            LastWrittenGlobalSlot = SlotIndex;
             UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Updated LastUsedSlot to %d in global config"), SlotIndex);
         }
     }
@@ -169,6 +1085,26 @@ bool UMotaEzSlotManager::SaveToSlot(const UObject* WorldContextObject, int32 Slo
 }
 
 bool UMotaEzSlotManager::LoadFromSlot(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError)
+{
+    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
+    if (!Subsystem)
+    {
+        OutError = TEXT("Failed to get subsystem");
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadFromSlot - Failed to get subsystem"));
+        return false;
+    }
+
+    UMotaEzSaveData* Document = nullptr;
+    if (!LoadSlotDocument(Subsystem, SlotIndex, Document, OutError))
+    {
+        return false;
+    }
+
+    Subsystem->SetCurrentSave(Document);
+    return true;
+}
+
+bool UMotaEzSlotManager::LoadSlotDocument(UMotaEzConfigSubsystem* Subsystem, int32 SlotIndex, UMotaEzSaveData*& OutDocument, FString& OutError)
 {
     FString ConfigPath = GetSlotConfigPath(SlotIndex);
     
@@ -181,14 +1117,6 @@ bool UMotaEzSlotManager::LoadFromSlot(const UObject* WorldContextObject, int32 S
         return false;
     }
 
-    UMotaEzConfigSubsystem* Subsystem = GetSubsystem(WorldContextObject);
-    if (!Subsystem)
-    {
-        OutError = TEXT("Failed to get subsystem");
-        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadFromSlot - Failed to get subsystem"));
-        return false;
-    }
-
     const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
     if (!Settings)
     {
@@ -197,24 +1125,63 @@ bool UMotaEzSlotManager::LoadFromSlot(const UObject* WorldContextObject, int32 S
         return false;
     }
 
-    FString ConfigText;
-    if (!FFileHelper::LoadFileToString(ConfigText, *ConfigPath))
+    // A resident document without unsaved changes whose file was last written or read by us is already up to date
+    UMotaEzSaveData* Resident = Subsystem->FindDocument(SlotIndex);
+    const uint64* LastFingerprint = LastWrittenFingerprints.Find(SlotIndex);
+    if (Resident && !Resident->IsDirty() && LastFingerprint && *LastFingerprint == MakeWriteFingerprint(Resident, Settings->DefaultFormat))
     {
-        OutError = FString::Printf(TEXT("Failed to read file: %s"), *ConfigPath);
-        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadFromSlot - %s"), *OutError);
-        return false;
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: LoadFromSlot %d - Using resident document"), SlotIndex);
+        OutDocument = Resident;
+        return true;
     }
 
-    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: LoadFromSlot - File loaded, size: %d bytes"), ConfigText.Len());
-
     TMap<FString, FMotaEzValue> LoadedData;
-    if (!UMotaEzFormatSerializer::LoadConfig(Settings->DefaultFormat, ConfigText, LoadedData, OutError))
+    EMotaEzConfigFormat Format = Settings->DefaultFormat;
+    FParsedSlotDataPtr Cached;
+
+    WaitForPrefetch(SlotIndex);
+
+    if (ParsedSlotCache.Find(SlotIndex, ConfigPath, Cached, Format))
     {
-        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadFromSlot - Deserialization failed: %s"), *OutError);
-        return false;
+        // The document gets its own copy to edit; the cached map stays shared
+        LoadedData = *Cached;
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: LoadFromSlot - Served %d keys from the parsed slot cache"), LoadedData.Num());
+    }
+    else
+    {
+        FParsedSlotFile Parsed = ReadSlotFile(ConfigPath, Settings->DefaultFormat);
+        if (!Parsed.bSuccess)
+        {
+            OutError = Parsed.Error;
+            UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadFromSlot - %s"), *OutError);
+            return false;
+        }
+
+        Format = Parsed.Format;
+        LoadedData = Parsed.Data;
+        ParsedSlotCache.Add(SlotIndex, Parsed.Stat, MoveTemp(Parsed.Data), Format, Parsed.Header);
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: LoadFromSlot - Loaded %d keys"), LoadedData.Num());
     }
 
-    UE_LOG(LogTemp, Display, TEXT("EzSaveGame: LoadFromSlot - Loaded %d keys"), LoadedData.Num());
+    // Named sections are separate blocks next to the slot file, already parsed if the slot was prefetched
+    const TArray<FString> Sections = GetSlotSectionNames(SlotIndex);
+    for (const FString& Section : Sections)
+    {
+        const FString SectionPath = GetSlotSectionPath(SlotIndex, Section);
+        FParsedSlotFile ParsedSection;
+        if (!TakePrefetchedSection(SlotIndex, Section, SectionPath, ParsedSection))
+        {
+            ParsedSection = ReadSlotFile(SectionPath, Settings->DefaultFormat);
+        }
+        if (!ParsedSection.bSuccess)
+        {
+            OutError = FString::Printf(TEXT("Section '%s': %s"), *Section, *ParsedSection.Error);
+            UE_LOG(LogTemp, Error, TEXT("EzSaveGame: LoadFromSlot - %s"), *OutError);
+            return false;
+        }
+        LoadedData.Append(MoveTemp(ParsedSection.Data));
+    }
 
     // Log all loaded keys for debugging
     for (const auto& Pair : LoadedData)
@@ -222,15 +1189,27 @@ bool UMotaEzSlotManager::LoadFromSlot(const UObject* WorldContextObject, int32 S
         UE_LOG(LogTemp, Verbose, TEXT("EzSaveGame: LoadFromSlot - Key: %s"), *Pair.Key);
     }
 
-    UMotaEzSaveData* SaveData = Subsystem->GetCurrentSave();
-    if (SaveData)
+    UMotaEzSaveData* SaveData = Subsystem->FindOrAddDocument(SlotIndex);
+    SaveData->ReplaceData(MoveTemp(LoadedData));
+
+    if (SlotIndex != AutoSaveSlotIndex)
+    {
+        SaveData->SetInt(LastUsedSlotKey, SlotIndex);
+    }
+
+    // The slot file now matches memory (LastUsedSlot is bookkeeping, not a change the player made),
+    // so an immediate re-save can be skipped and a later load can reuse this document
+    LastWrittenFingerprints.Add(SlotIndex, MakeWriteFingerprint(SaveData, Format));
+    SaveData->MarkClean();
+    SaveData->UnloadedSections.Reset();
+    OutDocument = SaveData;
+
+    TMap<FString, uint64>& WrittenSections = LastWrittenSectionFingerprints.FindOrAdd(SlotIndex);
+    WrittenSections.Reset();
+    WrittenSections.Add(FString(), UMotaEzSlotFile::MakeWriteFingerprint(SaveData->GetSectionFingerprint(FString()), Format));
+    for (const FString& Section : Sections)
     {
-        SaveData->Data = LoadedData;
-        
-        if (SlotIndex != AutoSaveSlotIndex)
-        {
-            SaveData->SetInt(LastUsedSlotKey, SlotIndex);
-        }
+        WrittenSections.Add(Section, UMotaEzSlotFile::MakeWriteFingerprint(SaveData->GetSectionFingerprint(Section), Format));
     }
 
     UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Loaded from slot %d: %s"), SlotIndex, *ConfigPath);
@@ -245,6 +1224,28 @@ bool UMotaEzSlotManager::DeleteSlot(int32 SlotIndex)
 
     bool bSuccess = true;
 
+    LastWrittenFingerprints.Remove(SlotIndex);
+    LastWrittenSectionFingerprints.Remove(SlotIndex);
+    ParsedSlotCache.Remove(SlotIndex);
+    CancelPrefetch(SlotIndex);
+
+    for (const FString& Section : GetSlotSectionNames(SlotIndex))
+    {
+        bSuccess &= IFileManager::Get().Delete(*GetSlotSectionPath(SlotIndex, Section));
+    }
+
+    // Binary blocks: objects written by UMotaEzObjectSerializer (Slot0.<Class>.ezobj) and named blocks (Slot0.<Name>.ezblock)
+    const FString SlotBaseName = FPaths::GetBaseFilename(ConfigPath);
+    for (const TCHAR* BlockExtension : { UMotaEzObjectSerializer::ObjectFileExtension, TEXT(".ezblock") })
+    {
+        TArray<FString> BlockFiles;
+        IFileManager::Get().FindFiles(BlockFiles, *FPaths::Combine(FPaths::GetPath(ConfigPath), SlotBaseName + TEXT(".*") + BlockExtension), true, false);
+        for (const FString& BlockFile : BlockFiles)
+        {
+            bSuccess &= IFileManager::Get().Delete(*FPaths::Combine(FPaths::GetPath(ConfigPath), BlockFile));
+        }
+    }
+
     if (FPaths::FileExists(ConfigPath))
     {
         bSuccess &= IFileManager::Get().Delete(*ConfigPath);
@@ -280,6 +1281,18 @@ FMotaEzSlotInfo UMotaEzSlotManager::GetSlotInfo(int32 SlotIndex)
     LoadSlotMetadata(SlotIndex, Info);
     Info.SlotIndex = SlotIndex;
     Info.bIsOccupied = IsSlotOccupied(SlotIndex);
+
+    if (Info.bIsOccupied)
+    {
+        FMotaEzSlotFileHeader Header;
+        FString Error;
+        Info.bIsCorrupted = !UMotaEzSlotFile::ReadHeader(GetSlotConfigPath(SlotIndex), Header, Error);
+        if (Info.bIsCorrupted)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: GetSlotInfo - %s"), *Error);
+        }
+    }
+
     return Info;
 }
 
@@ -374,12 +1387,97 @@ bool UMotaEzSlotManager::CopySlot(int32 FromSlot, int32 ToSlot)
     FString FromMetadata = GetSlotMetadataPath(FromSlot);
     FString ToMetadata = GetSlotMetadataPath(ToSlot);
 
+    FString Error;
     bool bSuccess = true;
-    bSuccess &= IFileManager::Get().Copy(*ToConfig, *FromConfig) == COPY_OK;
+    CancelPrefetch(ToSlot);
+    WaitForPrefetch(FromSlot);
+    bSuccess &= UMotaEzSlotFile::CloneFile(ToConfig, FromConfig, Error);
+
+    // Section blocks travel with the slot; stale blocks of the destination go away
+    const TArray<FString> FromSections = GetSlotSectionNames(FromSlot);
+    for (const FString& Section : GetSlotSectionNames(ToSlot))
+    {
+        if (!FromSections.Contains(Section))
+        {
+            IFileManager::Get().Delete(*GetSlotSectionPath(ToSlot, Section));
+        }
+    }
+    for (const FString& Section : FromSections)
+    {
+        if (bSuccess)
+        {
+            bSuccess = UMotaEzSlotFile::CloneFile(GetSlotSectionPath(ToSlot, Section), GetSlotSectionPath(FromSlot, Section), Error);
+        }
+    }
+
+    // So do binary blocks: objects written by UMotaEzObjectSerializer (Slot0.<Class>.ezobj) and named blocks (Slot0.<Name>.ezblock)
+    const FString FromDir = FPaths::GetPath(FromConfig);
+    const FString ToDir = FPaths::GetPath(ToConfig);
+    const FString FromBaseName = FPaths::GetBaseFilename(FromConfig);
+    const FString ToBaseName = FPaths::GetBaseFilename(ToConfig);
+    for (const TCHAR* BlockExtension : { UMotaEzObjectSerializer::ObjectFileExtension, TEXT(".ezblock") })
+    {
+        TArray<FString> FromBlocks;
+        TArray<FString> ToBlocks;
+        IFileManager::Get().FindFiles(FromBlocks, *FPaths::Combine(FromDir, FromBaseName + TEXT(".*") + BlockExtension), true, false);
+        IFileManager::Get().FindFiles(ToBlocks, *FPaths::Combine(ToDir, ToBaseName + TEXT(".*") + BlockExtension), true, false);
+
+        // Blocks are matched by what follows the slot's base name, e.g. ".MyClass.ezobj" or ".Transforms.ezblock"
+        for (const FString& ToBlock : ToBlocks)
+        {
+            if (!FromBlocks.Contains(FromBaseName + ToBlock.Mid(ToBaseName.Len())))
+            {
+                IFileManager::Get().Delete(*FPaths::Combine(ToDir, ToBlock));
+            }
+        }
+        for (const FString& FromBlock : FromBlocks)
+        {
+            if (bSuccess)
+            {
+                bSuccess = UMotaEzSlotFile::CloneFile(FPaths::Combine(ToDir, ToBaseName + FromBlock.Mid(FromBaseName.Len())), FPaths::Combine(FromDir, FromBlock), Error);
+            }
+        }
+    }
+
+    // The destination now holds the source's bytes, so it inherits the source's fingerprint
+    const uint64* FromFingerprint = LastWrittenFingerprints.Find(FromSlot);
+    if (bSuccess && FromFingerprint)
+    {
+        LastWrittenFingerprints.Add(ToSlot, *FromFingerprint);
+    }
+    else
+    {
+        LastWrittenFingerprints.Remove(ToSlot);
+    }
+
+    const TMap<FString, uint64>* FromSectionFingerprints = LastWrittenSectionFingerprints.Find(FromSlot);
+    if (bSuccess && FromSectionFingerprints)
+    {
+        LastWrittenSectionFingerprints.Add(ToSlot, *FromSectionFingerprints);
+    }
+    else
+    {
+        LastWrittenSectionFingerprints.Remove(ToSlot);
+    }
+
+    // Cached slots are copied in memory as well, so loading the copy needs no read or parse
+    if (bSuccess)
+    {
+        ParsedSlotCache.Copy(FromSlot, ToSlot, ToConfig);
+    }
+    else
+    {
+        ParsedSlotCache.Remove(ToSlot);
+    }
     
     if (FPaths::FileExists(FromMetadata))
     {
-        bSuccess &= IFileManager::Get().Copy(*ToMetadata, *FromMetadata) == COPY_OK;
+        bSuccess &= UMotaEzSlotFile::CloneFile(ToMetadata, FromMetadata, Error);
+    }
+
+    if (!bSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("EzSaveGame: CopySlot %d -> %d failed: %s"), FromSlot, ToSlot, *Error);
     }
 
     return bSuccess;
@@ -396,10 +1494,10 @@ int32 UMotaEzSlotManager::GetLastUsedSlot()
     if (FPaths::FileExists(ConfigPath))
     {
         FString ConfigText;
-        if (FFileHelper::LoadFileToString(ConfigText, *ConfigPath))
+        FString Error;
+        if (UMotaEzSlotFile::ReadText(ConfigPath, ConfigText, Error))
         {
             TMap<FString, FMotaEzValue> LoadedData;
-            FString Error;
             if (UMotaEzFormatSerializer::LoadConfig(Settings->DefaultFormat, ConfigText, LoadedData, Error))
             {
                 if (LoadedData.Contains(LastUsedSlotKey))
@@ -483,6 +1581,7 @@ bool UMotaEzSlotManager::DeleteAllSaveData(int32 MaxSlots)
     }
 
     // Delete main config and schema files
+    LastWrittenGlobalSlot = INDEX_NONE;
     FString ConfigPath = Settings->GetConfigFilePath();
     if (FPaths::FileExists(ConfigPath))
     {
@@ -525,6 +1624,139 @@ bool UMotaEzSlotManager::DeleteAllSaveData(int32 MaxSlots)
     return bSuccess;
 }
 
+void UMotaEzSlotManager::PrefetchSlots(const TArray<int32>& SlotIndices)
+{
+    for (int32 SlotIndex : SlotIndices)
+    {
+        StartSlotPrefetch(SlotIndex, TArray<FString>());
+    }
+}
+
+bool UMotaEzSlotManager::PrefetchManifest(FName ManifestName)
+{
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    if (!Settings)
+    {
+        return false;
+    }
+
+    const FMotaEzPreloadManifest* Manifest = Settings->PreloadManifests.FindByPredicate([ManifestName](const FMotaEzPreloadManifest& Entry)
+    {
+        return Entry.Name == ManifestName;
+    });
+
+    if (!Manifest)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: PrefetchManifest - No preload manifest named %s"), *ManifestName.ToString());
+        return false;
+    }
+
+    for (const FMotaEzPreloadSlot& Slot : Manifest->Slots)
+    {
+        StartSlotPrefetch(Slot.SlotIndex, Slot.Keys);
+    }
+    return true;
+}
+
+void UMotaEzSlotManager::PrefetchForMap(const FString& MapName)
+{
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    if (!Settings || MapName.IsEmpty())
+    {
+        return;
+    }
+
+    const FString ShortName = FPackageName::GetShortName(UWorld::RemovePIEPrefix(MapName));
+
+    for (const FMotaEzPreloadManifest& Manifest : Settings->PreloadManifests)
+    {
+        if (Manifest.Map.IsNull() || !FPackageName::GetShortName(Manifest.Map.ToSoftObjectPath().GetLongPackageName()).Equals(ShortName, ESearchCase::IgnoreCase))
+        {
+            continue;
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("EzSaveGame: Prefetching %d slots for map %s"), Manifest.Slots.Num(), *ShortName);
+        for (const FMotaEzPreloadSlot& Slot : Manifest.Slots)
+        {
+            StartSlotPrefetch(Slot.SlotIndex, Slot.Keys);
+        }
+    }
+}
+
+void UMotaEzSlotManager::StartSlotPrefetch(int32 SlotIndex, const TArray<FString>& ExpectedKeys)
+{
+    const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
+    if (!Settings || !Settings->bEnableSlotCache)
+    {
+        return;
+    }
+
+    const FString ConfigPath = GetSlotConfigPath(SlotIndex);
+    if (PendingPrefetches.Contains(SlotIndex) || !FPaths::FileExists(ConfigPath))
+    {
+        return;
+    }
+
+    // Section blocks are read too, so loading a sectioned slot does no file I/O on the game thread
+    TMap<FString, FString> SectionPaths;
+    if (!PrefetchedSections.Contains(SlotIndex))
+    {
+        for (const FString& Section : GetSlotSectionNames(SlotIndex))
+        {
+            SectionPaths.Add(Section, GetSlotSectionPath(SlotIndex, Section));
+        }
+    }
+
+    const bool bReadRoot = !ParsedSlotCache.Contains(SlotIndex);
+    if (!bReadRoot && SectionPaths.Num() == 0)
+    {
+        return;
+    }
+
+    FPendingPrefetch& Pending = PendingPrefetches.Add(SlotIndex);
+    Pending.ExpectedKeys = ExpectedKeys;
+    Pending.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+        [ConfigPath, SectionPaths = MoveTemp(SectionPaths), bReadRoot, DefaultFormat = Settings->DefaultFormat, bCancelled = Pending.bCancelled]()
+    {
+        FPrefetchedSlot Result;
+        if (bReadRoot)
+        {
+            Result.Root = ReadSlotFile(ConfigPath, DefaultFormat, &bCancelled.Get());
+        }
+
+        for (const TPair<FString, FString>& Pair : SectionPaths)
+        {
+            if (bCancelled->load())
+            {
+                break;
+            }
+
+            // A block that fails here is simply read, and its error reported, by the load that needs it
+            FParsedSlotFile Parsed = ReadSlotFile(Pair.Value, DefaultFormat, &bCancelled.Get());
+            if (Parsed.bSuccess)
+            {
+                Result.Sections.Add(Pair.Key, MoveTemp(Parsed));
+            }
+        }
+        return Result;
+    });
+
+    // Results are moved into the cache on the game thread as they finish
+    if (!PrefetchTickerHandle.IsValid())
+    {
+        PrefetchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+        {
+            DrainCompletedPrefetches();
+            if (PendingPrefetches.Num() == 0)
+            {
+                PrefetchTickerHandle.Reset();
+                return false;
+            }
+            return true;
+        }));
+    }
+}
+
 bool UMotaEzSlotManager::LoadSlotMetadata(int32 SlotIndex, FMotaEzSlotInfo& OutInfo)
 {
     FString MetadataPath = GetSlotMetadataPath(SlotIndex);
@@ -587,3 +1819,10 @@ bool UMotaEzSlotManager::SaveSlotMetadata(int32 SlotIndex, const FMotaEzSlotInfo
     return FFileHelper::SaveStringToFile(JsonString, *MetadataPath);
 }
 
+void UMotaEzSlotManager::InvalidateSlotWriteState(int32 SlotIndex)
+{
+    LastWrittenFingerprints.Remove(SlotIndex);
+    LastWrittenSectionFingerprints.Remove(SlotIndex);
+    ParsedSlotCache.Remove(SlotIndex);
+    CancelPrefetch(SlotIndex);
+}
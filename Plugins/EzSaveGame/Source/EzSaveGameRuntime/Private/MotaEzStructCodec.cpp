@@ -0,0 +1,1015 @@
+﻿#include "MotaEzStructCodec.h"
+#include "MotaEzBlockBuffer.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "UObject/TextProperty.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/ObjectKey.h"
+#include "Hash/xxhash.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Struct records store members in native byte order, which must be little-endian");
+
+const TCHAR* UMotaEzStructCodec::StructField = TEXT("$struct");
+const TCHAR* UMotaEzStructCodec::ItemsField = TEXT("$items");
+
+namespace
+{
+    using namespace MotaEzBlockBuffer;
+
+    struct FStructCodec;
+
+    /** What a member, or an element of an array member, holds. */
+    enum class EValueKind : uint8
+    {
+        Bool,
+        Integer,
+        Real,
+        Enum,
+        String,
+        Name,
+        Text,
+        Struct
+    };
+
+    /** How one value is read and written, resolved once per member. */
+    struct FValueHandler
+    {
+        EValueKind Kind = EValueKind::Integer;
+        int32 Size = 0;
+        bool bUnsigned = false;
+
+        const FBoolProperty* BoolProperty = nullptr;
+        const FNumericProperty* Numeric = nullptr;
+        const UEnum* Enum = nullptr;
+        TSharedPtr<const FStructCodec> Struct;
+
+        /** @return true if values are copied as raw bytes, so arrays of them are a single copy */
+        bool IsPlainData() const;
+    };
+
+    /** One member, as the text formats see it. */
+    struct FMember
+    {
+        FString Name;
+        int32 Offset = 0;
+        FValueHandler Value;
+
+        /** Set for TArray members; Value then describes the elements. */
+        const FArrayProperty* ArrayProperty = nullptr;
+    };
+
+    /** Step of a record, with nested structs already inlined. */
+    enum class EOpKind : uint8
+    {
+        Copy,
+        Bool,
+        String,
+        Name,
+        Text,
+        Array
+    };
+
+    struct FRecordOp
+    {
+        EOpKind Kind = EOpKind::Copy;
+        int32 Offset = 0;
+        int32 Size = 0;
+
+        /** Bitfield bools go through the property instead of the offset. */
+        const FBoolProperty* BoolProperty = nullptr;
+        const FArrayProperty* ArrayProperty = nullptr;
+        FValueHandler Element;
+    };
+
+    struct FStructCodec
+    {
+        const UScriptStruct* Struct = nullptr;
+        int32 Size = 0;
+
+        /** Members by name for text, and the flattened steps for records. */
+        TArray<FMember> Members;
+        TMap<FString, int32> MemberByName;
+        TArray<FRecordOp> Ops;
+
+        /** The whole struct is one copy: no padding, strings, bitfields or arrays. */
+        bool bIsPlainData = false;
+        uint64 LayoutHash = 0;
+
+        /** Properties the codec was compiled from; user-defined structs get new ones when recompiled. */
+        const FField* CompiledFrom = nullptr;
+    };
+
+    bool FValueHandler::IsPlainData() const
+    {
+        switch (Kind)
+        {
+            case EValueKind::Bool:   return BoolProperty->IsNativeBool();
+            case EValueKind::String:
+            case EValueKind::Name:
+            case EValueKind::Text:   return false;
+            case EValueKind::Struct: return Struct->bIsPlainData;
+            default:                 return true;
+        }
+    }
+
+    TSharedRef<const FStructCodec> GetCodec(const UScriptStruct* Struct, TArray<const UScriptStruct*>& Compiling);
+
+    bool DetectHandler(const FProperty* Property, FValueHandler& OutHandler, TArray<const UScriptStruct*>& Compiling)
+    {
+        OutHandler.Size = Property->GetElementSize();
+
+        if (const FBoolProperty* BoolProp = CastField<FBoolProperty>(Property))
+        {
+            OutHandler.Kind = EValueKind::Bool;
+            OutHandler.BoolProperty = BoolProp;
+            return true;
+        }
+
+        if (const FEnumProperty* EnumProp = CastField<FEnumProperty>(Property))
+        {
+            OutHandler.Kind = EValueKind::Enum;
+            OutHandler.Numeric = EnumProp->GetUnderlyingProperty();
+            OutHandler.Enum = EnumProp->GetEnum();
+            return true;
+        }
+
+        if (const FNumericProperty* Numeric = CastField<FNumericProperty>(Property))
+        {
+            OutHandler.Numeric = Numeric;
+            OutHandler.Enum = Numeric->GetIntPropertyEnum();
+            OutHandler.Kind = OutHandler.Enum ? EValueKind::Enum : Numeric->IsFloatingPoint() ? EValueKind::Real : EValueKind::Integer;
+            OutHandler.bUnsigned = CastField<FByteProperty>(Property) || CastField<FUInt16Property>(Property)
+                || CastField<FUInt32Property>(Property) || CastField<FUInt64Property>(Property);
+            return true;
+        }
+
+        if (CastField<FStrProperty>(Property))  { OutHandler.Kind = EValueKind::String; return true; }
+        if (CastField<FNameProperty>(Property)) { OutHandler.Kind = EValueKind::Name;   return true; }
+        if (CastField<FTextProperty>(Property)) { OutHandler.Kind = EValueKind::Text;   return true; }
+
+        if (const FStructProperty* StructProp = CastField<FStructProperty>(Property))
+        {
+            // A struct reached again while it is being compiled (an array of itself) has no finite codec
+            if (Compiling.Contains(StructProp->Struct))
+            {
+                return false;
+            }
+            OutHandler.Kind = EValueKind::Struct;
+            OutHandler.Struct = GetCodec(StructProp->Struct, Compiling);
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Adds a raw copy, merged into the previous step when the bytes are adjacent. */
+    void AppendCopy(TArray<FRecordOp>& Ops, int32 Offset, int32 Size)
+    {
+        if (Ops.Num() > 0 && Ops.Last().Kind == EOpKind::Copy && Ops.Last().Offset + Ops.Last().Size == Offset)
+        {
+            Ops.Last().Size += Size;
+            return;
+        }
+
+        FRecordOp& Op = Ops.AddDefaulted_GetRef();
+        Op.Kind = EOpKind::Copy;
+        Op.Offset = Offset;
+        Op.Size = Size;
+    }
+
+    void AppendOps(TArray<FRecordOp>& Ops, const FMember& Member)
+    {
+        const FValueHandler& Value = Member.Value;
+
+        if (Member.ArrayProperty)
+        {
+            FRecordOp& Op = Ops.AddDefaulted_GetRef();
+            Op.Kind = EOpKind::Array;
+            Op.Offset = Member.Offset;
+            Op.ArrayProperty = Member.ArrayProperty;
+            Op.Element = Value;
+            return;
+        }
+
+        switch (Value.Kind)
+        {
+            case EValueKind::Struct:
+                // Inlined, so fixed-size members merge across struct boundaries
+                for (const FRecordOp& NestedOp : Value.Struct->Ops)
+                {
+                    if (NestedOp.Kind == EOpKind::Copy)
+                    {
+                        AppendCopy(Ops, Member.Offset + NestedOp.Offset, NestedOp.Size);
+                    }
+                    else
+                    {
+                        FRecordOp& Op = Ops.Add_GetRef(NestedOp);
+                        Op.Offset += Member.Offset;
+                    }
+                }
+                break;
+
+            case EValueKind::Bool:
+                if (Value.BoolProperty->IsNativeBool())
+                {
+                    AppendCopy(Ops, Member.Offset, Value.Size);
+                }
+                else
+                {
+                    FRecordOp& Op = Ops.AddDefaulted_GetRef();
+                    Op.Kind = EOpKind::Bool;
+                    Op.Offset = Member.Offset;
+                    Op.BoolProperty = Value.BoolProperty;
+                }
+                break;
+
+            case EValueKind::String:
+            case EValueKind::Name:
+            case EValueKind::Text:
+            {
+                FRecordOp& Op = Ops.AddDefaulted_GetRef();
+                Op.Kind = Value.Kind == EValueKind::String ? EOpKind::String : Value.Kind == EValueKind::Name ? EOpKind::Name : EOpKind::Text;
+                Op.Offset = Member.Offset;
+                break;
+            }
+
+            default:
+                AppendCopy(Ops, Member.Offset, Value.Size);
+                break;
+        }
+    }
+
+    TSharedRef<const FStructCodec> CompileCodec(const UScriptStruct* Struct, TArray<const UScriptStruct*>& Compiling)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_CompileStructCodec);
+
+        Compiling.Push(Struct);
+
+        TSharedRef<FStructCodec> Codec = MakeShared<FStructCodec>();
+        Codec->Struct = Struct;
+        Codec->Size = Struct->GetStructureSize();
+        Codec->CompiledFrom = Struct->ChildProperties;
+        FXxHash64Builder Hasher;
+
+        for (TFieldIterator<FProperty> PropIt(Struct); PropIt; ++PropIt)
+        {
+            const FProperty* Property = *PropIt;
+            if (Property->HasAnyPropertyFlags(CPF_Transient))
+            {
+                continue;
+            }
+
+            FMember Member;
+            Member.Name = Property->GetAuthoredName();
+            Member.Offset = Property->GetOffset_ForInternal();
+            Member.ArrayProperty = CastField<FArrayProperty>(Property);
+
+            const FProperty* ValueProperty = Member.ArrayProperty ? Member.ArrayProperty->Inner : Property;
+            if (Property->ArrayDim != 1 || !DetectHandler(ValueProperty, Member.Value, Compiling))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s.%s has an unsupported type and is not serialized"), *Struct->GetName(), *Member.Name);
+                continue;
+            }
+
+            // Name, shape and nested layout: anything that changes how records read
+            const uint32 NameHash = FCrc::StrCrc32(*Member.Name);
+            const uint8 Shape[2] = { (uint8)Member.Value.Kind, (uint8)(Member.ArrayProperty != nullptr) };
+            const uint64 NestedHash = Member.Value.Struct ? Member.Value.Struct->LayoutHash : 0;
+            Hasher.Update(&NameHash, sizeof(NameHash));
+            Hasher.Update(Shape, sizeof(Shape));
+            Hasher.Update(&Member.Value.Size, sizeof(Member.Value.Size));
+            Hasher.Update(&NestedHash, sizeof(NestedHash));
+
+            AppendOps(Codec->Ops, Member);
+            Codec->MemberByName.Add(Member.Name, Codec->Members.Num());
+            Codec->Members.Add(MoveTemp(Member));
+        }
+
+        Codec->bIsPlainData = Codec->Ops.Num() == 1 && Codec->Ops[0].Kind == EOpKind::Copy
+            && Codec->Ops[0].Offset == 0 && Codec->Ops[0].Size == Codec->Size;
+        Codec->LayoutHash = Hasher.Finalize().Hash;
+
+        Compiling.Pop();
+        return Codec;
+    }
+
+    /** Compiled codecs per struct; compiled on first use and read-shared afterwards. */
+    FRWLock CodecCacheLock;
+    TMap<TObjectKey<UScriptStruct>, TSharedRef<const FStructCodec>> CodecCache;
+
+    TSharedRef<const FStructCodec> GetCodec(const UScriptStruct* Struct, TArray<const UScriptStruct*>& Compiling)
+    {
+        const TObjectKey<UScriptStruct> Key(Struct);
+        {
+            FReadScopeLock ReadLock(CodecCacheLock);
+            if (const TSharedRef<const FStructCodec>* Found = CodecCache.Find(Key))
+            {
+                if ((*Found)->CompiledFrom == Struct->ChildProperties)
+                {
+                    return *Found;
+                }
+            }
+        }
+
+        TSharedRef<const FStructCodec> Codec = CompileCodec(Struct, Compiling);
+        FWriteScopeLock WriteLock(CodecCacheLock);
+        TSharedRef<const FStructCodec>& Cached = CodecCache.FindOrAdd(Key, Codec);
+        if (Cached->CompiledFrom != Struct->ChildProperties)
+        {
+            Cached = Codec;
+        }
+        return Cached;
+    }
+
+    TSharedRef<const FStructCodec> GetCodec(const UScriptStruct* Struct)
+    {
+        TArray<const UScriptStruct*> Compiling;
+        return GetCodec(Struct, Compiling);
+    }
+
+    /** Initialized values of a struct in one allocation, destroyed with the buffer. */
+    class FStructValues
+    {
+    public:
+        explicit FStructValues(const UScriptStruct* InStruct) : Struct(InStruct) {}
+        ~FStructValues() { Reset(); }
+
+        UE_NONCOPYABLE(FStructValues);
+
+        uint8* Allocate(int32 InNum)
+        {
+            Reset();
+            if (InNum > 0)
+            {
+                Memory = static_cast<uint8*>(FMemory::Malloc((SIZE_T)InNum * Struct->GetStructureSize(), Struct->GetMinAlignment()));
+                Struct->InitializeStruct(Memory, InNum);
+                Num = InNum;
+            }
+            return Memory;
+        }
+
+        void Reset()
+        {
+            if (Memory)
+            {
+                Struct->DestroyStruct(Memory, Num);
+                FMemory::Free(Memory);
+                Memory = nullptr;
+                Num = 0;
+            }
+        }
+
+        int32 GetNum() const { return Num; }
+        uint8* operator[](int32 Index) const { return Memory + (int64)Index * Struct->GetStructureSize(); }
+
+    private:
+        const UScriptStruct* Struct;
+        uint8* Memory = nullptr;
+        int32 Num = 0;
+    };
+
+    // ---- Records ----
+
+    void WriteOps(FBlockWriter& Writer, const TArray<FRecordOp>& Ops, const uint8* Base);
+
+    void WriteElements(FBlockWriter& Writer, const FValueHandler& Element, const uint8* Values, int32 Num)
+    {
+        if (Element.IsPlainData())
+        {
+            // Contiguous plain values: one copy for all of them
+            Writer.Write(Values, (int64)Num * Element.Size);
+            return;
+        }
+
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            const uint8* Value = Values + (int64)Index * Element.Size;
+            switch (Element.Kind)
+            {
+                case EValueKind::Struct: WriteOps(Writer, Element.Struct->Ops, Value); break;
+                case EValueKind::String: Writer.WriteString(*reinterpret_cast<const FString*>(Value)); break;
+                case EValueKind::Name:   Writer.WriteString(reinterpret_cast<const FName*>(Value)->ToString()); break;
+                case EValueKind::Text:   Writer.WriteString(reinterpret_cast<const FText*>(Value)->ToString()); break;
+                default:                 Writer.Write(Value, Element.Size); break;
+            }
+        }
+    }
+
+    void WriteOps(FBlockWriter& Writer, const TArray<FRecordOp>& Ops, const uint8* Base)
+    {
+        for (const FRecordOp& Op : Ops)
+        {
+            const uint8* Value = Base + Op.Offset;
+            switch (Op.Kind)
+            {
+                case EOpKind::Copy:   Writer.Write(Value, Op.Size); break;
+                case EOpKind::Bool:   Writer.WriteValue<uint8>(Op.BoolProperty->GetPropertyValue(Value) ? 1 : 0); break;
+                case EOpKind::String: Writer.WriteString(*reinterpret_cast<const FString*>(Value)); break;
+                case EOpKind::Name:   Writer.WriteString(reinterpret_cast<const FName*>(Value)->ToString()); break;
+                case EOpKind::Text:   Writer.WriteString(reinterpret_cast<const FText*>(Value)->ToString()); break;
+                case EOpKind::Array:
+                {
+                    FScriptArrayHelper Array(Op.ArrayProperty, Value);
+                    Writer.WriteValue<uint32>(Array.Num());
+                    if (Array.Num() > 0)
+                    {
+                        WriteElements(Writer, Op.Element, Array.GetRawPtr(0), Array.Num());
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    bool ReadString(FBlockReader& Reader, EValueKind Kind, uint8* Value)
+    {
+        FString Text;
+        if (!Reader.ReadString(Text))
+        {
+            return false;
+        }
+
+        switch (Kind)
+        {
+            case EValueKind::String: *reinterpret_cast<FString*>(Value) = MoveTemp(Text); break;
+            case EValueKind::Name:   *reinterpret_cast<FName*>(Value) = FName(*Text); break;
+            case EValueKind::Text:   *reinterpret_cast<FText*>(Value) = FText::FromString(MoveTemp(Text)); break;
+            default: break;
+        }
+        return true;
+    }
+
+    bool ReadOps(FBlockReader& Reader, const TArray<FRecordOp>& Ops, uint8* Base);
+
+    /** @return true if Count elements can fit in what is left of the buffer */
+    bool CanHoldElements(const FBlockReader& Reader, const FValueHandler& Element, int64 Count)
+    {
+        // Every element but an empty struct takes at least a byte
+        const int64 MinBytes = Element.IsPlainData() ? Element.Size : (Element.Kind == EValueKind::Struct && Element.Struct->Ops.Num() == 0 ? 0 : 1);
+        return Count * MinBytes <= Reader.Remaining();
+    }
+
+    bool ReadElements(FBlockReader& Reader, const FValueHandler& Element, uint8* Values, int32 Num)
+    {
+        if (Element.IsPlainData())
+        {
+            return Reader.Read(Values, (int64)Num * Element.Size);
+        }
+
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            uint8* Value = Values + (int64)Index * Element.Size;
+            const bool bRead = Element.Kind == EValueKind::Struct
+                ? ReadOps(Reader, Element.Struct->Ops, Value)
+                : ReadString(Reader, Element.Kind, Value);
+            if (!bRead)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ReadOps(FBlockReader& Reader, const TArray<FRecordOp>& Ops, uint8* Base)
+    {
+        for (const FRecordOp& Op : Ops)
+        {
+            uint8* Value = Base + Op.Offset;
+            switch (Op.Kind)
+            {
+                case EOpKind::Copy:
+                    if (!Reader.Read(Value, Op.Size))
+                    {
+                        return false;
+                    }
+                    break;
+
+                case EOpKind::Bool:
+                {
+                    uint8 Stored = 0;
+                    if (!Reader.ReadValue(Stored))
+                    {
+                        return false;
+                    }
+                    Op.BoolProperty->SetPropertyValue(Value, Stored != 0);
+                    break;
+                }
+
+                case EOpKind::String:
+                case EOpKind::Name:
+                case EOpKind::Text:
+                {
+                    const EValueKind Kind = Op.Kind == EOpKind::String ? EValueKind::String : Op.Kind == EOpKind::Name ? EValueKind::Name : EValueKind::Text;
+                    if (!ReadString(Reader, Kind, Value))
+                    {
+                        return false;
+                    }
+                    break;
+                }
+
+                case EOpKind::Array:
+                {
+                    uint32 Count = 0;
+                    if (!Reader.ReadValue(Count) || Count > (uint32)MAX_int32 || !CanHoldElements(Reader, Op.Element, Count))
+                    {
+                        return false;
+                    }
+
+                    FScriptArrayHelper Array(Op.ArrayProperty, Value);
+                    Array.Resize(Count);
+                    if (Count > 0 && !ReadElements(Reader, Op.Element, Array.GetRawPtr(0), Count))
+                    {
+                        return false;
+                    }
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    // ---- Text ----
+
+    /** Integers beyond 2^53 do not survive a JSON number, so they are written as strings. */
+    constexpr int64 MaxExactJsonInteger = int64(1) << 53;
+
+    TSharedRef<FJsonObject> StructToJson(const FStructCodec& Codec, const uint8* Base);
+
+    TSharedPtr<FJsonValue> ValueToJson(const FValueHandler& Handler, const uint8* Value)
+    {
+        switch (Handler.Kind)
+        {
+            case EValueKind::Bool:
+                return MakeShared<FJsonValueBoolean>(Handler.BoolProperty->GetPropertyValue(Value));
+
+            case EValueKind::Integer:
+                if (Handler.bUnsigned)
+                {
+                    const uint64 Number = Handler.Numeric->GetUnsignedIntPropertyValue(Value);
+                    return Number <= (uint64)MaxExactJsonInteger
+                        ? StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueNumber>((double)Number))
+                        : StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueString>(LexToString(Number)));
+                }
+                else
+                {
+                    const int64 Number = Handler.Numeric->GetSignedIntPropertyValue(Value);
+                    return Number >= -MaxExactJsonInteger && Number <= MaxExactJsonInteger
+                        ? StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueNumber>((double)Number))
+                        : StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueString>(LexToString(Number)));
+                }
+
+            case EValueKind::Real:
+                return MakeShared<FJsonValueNumber>(Handler.Numeric->GetFloatingPointPropertyValue(Value));
+
+            case EValueKind::Enum:
+            {
+                // By name, so reordering the enum keeps saved values; values without a name stay numbers
+                const int64 Number = Handler.Numeric->GetSignedIntPropertyValue(Value);
+                const FString Name = Handler.Enum->GetNameStringByValue(Number);
+                return Name.IsEmpty()
+                    ? StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueNumber>((double)Number))
+                    : StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueString>(Name));
+            }
+
+            case EValueKind::String:
+                return MakeShared<FJsonValueString>(*reinterpret_cast<const FString*>(Value));
+
+            case EValueKind::Name:
+                return MakeShared<FJsonValueString>(reinterpret_cast<const FName*>(Value)->ToString());
+
+            case EValueKind::Text:
+                return MakeShared<FJsonValueString>(reinterpret_cast<const FText*>(Value)->ToString());
+
+            case EValueKind::Struct:
+                return MakeShared<FJsonValueObject>(StructToJson(*Handler.Struct, Value));
+        }
+
+        return MakeShared<FJsonValueNull>();
+    }
+
+    TSharedRef<FJsonObject> StructToJson(const FStructCodec& Codec, const uint8* Base)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+
+        for (const FMember& Member : Codec.Members)
+        {
+            const uint8* Value = Base + Member.Offset;
+            if (!Member.ArrayProperty)
+            {
+                Object->SetField(Member.Name, ValueToJson(Member.Value, Value));
+                continue;
+            }
+
+            FScriptArrayHelper Array(Member.ArrayProperty, Value);
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            Elements.Reserve(Array.Num());
+            for (int32 Index = 0; Index < Array.Num(); ++Index)
+            {
+                Elements.Add(ValueToJson(Member.Value, Array.GetRawPtr(Index)));
+            }
+            Object->SetArrayField(Member.Name, Elements);
+        }
+
+        return Object;
+    }
+
+    /** Numbers may arrive as strings from formats without typed scalars (YAML, XML). */
+    bool JsonToDouble(const FJsonValue& Json, double& OutNumber)
+    {
+        switch (Json.Type)
+        {
+            case EJson::Number:
+                OutNumber = Json.AsNumber();
+                return true;
+            case EJson::Boolean:
+                OutNumber = Json.AsBool() ? 1.0 : 0.0;
+                return true;
+            case EJson::String:
+            {
+                const FString Text = Json.AsString().TrimStartAndEnd();
+                TCHAR* End = nullptr;
+                OutNumber = FCString::Strtod(*Text, &End);
+                return !Text.IsEmpty() && End && *End == TCHAR('\0');
+            }
+            default:
+                return false;
+        }
+    }
+
+    void JsonToStruct(const FStructCodec& Codec, const FJsonObject& Object, uint8* Base);
+
+    void JsonToValue(const FValueHandler& Handler, const FJsonValue& Json, uint8* Value)
+    {
+        double Number = 0.0;
+
+        switch (Handler.Kind)
+        {
+            case EValueKind::Bool:
+                if (Json.Type == EJson::String)
+                {
+                    const FString Text = Json.AsString();
+                    Handler.BoolProperty->SetPropertyValue(Value, Text.Equals(TEXT("true"), ESearchCase::IgnoreCase) || Text == TEXT("1"));
+                }
+                else if (JsonToDouble(Json, Number))
+                {
+                    Handler.BoolProperty->SetPropertyValue(Value, Number != 0.0);
+                }
+                break;
+
+            case EValueKind::Integer:
+                if (Json.Type == EJson::String)
+                {
+                    // Exact for the 64-bit values written as strings
+                    const FString Text = Json.AsString();
+                    if (Handler.bUnsigned)
+                    {
+                        Handler.Numeric->SetIntPropertyValue(Value, FCString::Strtoui64(*Text, nullptr, 10));
+                    }
+                    else
+                    {
+                        Handler.Numeric->SetIntPropertyValue(Value, FCString::Atoi64(*Text));
+                    }
+                }
+                else if (JsonToDouble(Json, Number))
+                {
+                    if (Handler.bUnsigned)
+                    {
+                        Handler.Numeric->SetIntPropertyValue(Value, (uint64)FMath::Max(Number, 0.0));
+                    }
+                    else
+                    {
+                        Handler.Numeric->SetIntPropertyValue(Value, (int64)Number);
+                    }
+                }
+                break;
+
+            case EValueKind::Real:
+                if (JsonToDouble(Json, Number))
+                {
+                    Handler.Numeric->SetFloatingPointPropertyValue(Value, Number);
+                }
+                break;
+
+            case EValueKind::Enum:
+            {
+                int64 EnumValue = INDEX_NONE;
+                if (Json.Type == EJson::String)
+                {
+                    EnumValue = Handler.Enum->GetValueByNameString(Json.AsString());
+                }
+                if (EnumValue == INDEX_NONE && JsonToDouble(Json, Number))
+                {
+                    EnumValue = (int64)Number;
+                }
+                if (EnumValue != INDEX_NONE)
+                {
+                    Handler.Numeric->SetIntPropertyValue(Value, EnumValue);
+                }
+                break;
+            }
+
+            case EValueKind::String:
+            case EValueKind::Name:
+            case EValueKind::Text:
+            {
+                FString Text;
+                if (!Json.TryGetString(Text))
+                {
+                    break;
+                }
+                if (Handler.Kind == EValueKind::String)
+                {
+                    *reinterpret_cast<FString*>(Value) = MoveTemp(Text);
+                }
+                else if (Handler.Kind == EValueKind::Name)
+                {
+                    *reinterpret_cast<FName*>(Value) = FName(*Text);
+                }
+                else
+                {
+                    *reinterpret_cast<FText*>(Value) = FText::FromString(MoveTemp(Text));
+                }
+                break;
+            }
+
+            case EValueKind::Struct:
+                if (Json.Type == EJson::Object)
+                {
+                    JsonToStruct(*Handler.Struct, *Json.AsObject(), Value);
+                }
+                break;
+        }
+    }
+
+    void JsonToStruct(const FStructCodec& Codec, const FJsonObject& Object, uint8* Base)
+    {
+        for (const auto& Pair : Object.Values)
+        {
+            // Unknown members are skipped and missing ones keep their defaults
+            const int32* MemberIndex = Codec.MemberByName.Find(Pair.Key);
+            if (!MemberIndex || !Pair.Value.IsValid())
+            {
+                continue;
+            }
+
+            const FMember& Member = Codec.Members[*MemberIndex];
+            uint8* Value = Base + Member.Offset;
+            if (!Member.ArrayProperty)
+            {
+                JsonToValue(Member.Value, *Pair.Value, Value);
+                continue;
+            }
+
+            const TArray<TSharedPtr<FJsonValue>>* Elements = nullptr;
+            if (!Pair.Value->TryGetArray(Elements))
+            {
+                continue;
+            }
+
+            FScriptArrayHelper Array(Member.ArrayProperty, Value);
+            Array.EmptyAndAddValues(Elements->Num());
+            for (int32 Index = 0; Index < Elements->Num(); ++Index)
+            {
+                if ((*Elements)[Index].IsValid())
+                {
+                    JsonToValue(Member.Value, *(*Elements)[Index], Array.GetRawPtr(Index));
+                }
+            }
+        }
+    }
+
+    /** Record header: layout hash and element count. */
+    constexpr int32 RecordHeaderSize = sizeof(uint64) + sizeof(uint32);
+}
+
+bool UMotaEzStructCodec::PackRecords(const UScriptStruct* Struct, const void* Values, int32 Num, TArray<uint8>& OutRecords)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_PackStructRecords);
+
+    OutRecords.Reset();
+    if (!Struct || Num < 0 || (Num > 0 && !Values))
+    {
+        return false;
+    }
+
+    const TSharedRef<const FStructCodec> Codec = GetCodec(Struct);
+    if (Codec->bIsPlainData)
+    {
+        OutRecords.Reserve(RecordHeaderSize + (int64)Num * Codec->Size);
+    }
+
+    FBlockWriter Writer{ OutRecords };
+    Writer.WriteValue<uint64>(Codec->LayoutHash);
+    Writer.WriteValue<uint32>(Num);
+
+    FValueHandler Element;
+    Element.Kind = EValueKind::Struct;
+    Element.Size = Codec->Size;
+    Element.Struct = Codec;
+    WriteElements(Writer, Element, static_cast<const uint8*>(Values), Num);
+    return true;
+}
+
+bool UMotaEzStructCodec::UnpackRecords(const UScriptStruct* Struct, TConstArrayView<uint8> Records, TFunctionRef<void*(int32)> GetValues, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_UnpackStructRecords);
+
+    if (!Struct)
+    {
+        OutError = TEXT("Struct is null");
+        return false;
+    }
+
+    const TSharedRef<const FStructCodec> Codec = GetCodec(Struct);
+
+    FBlockReader Reader{ Records };
+    uint64 LayoutHash = 0;
+    uint32 Count = 0;
+    if (!Reader.ReadValue(LayoutHash) || !Reader.ReadValue(Count))
+    {
+        OutError = FString::Printf(TEXT("Truncated %s records"), *Struct->GetName());
+        return false;
+    }
+
+    if (LayoutHash != Codec->LayoutHash)
+    {
+        OutError = FString::Printf(TEXT("%s records were written with a different layout of the struct"), *Struct->GetName());
+        return false;
+    }
+
+    FValueHandler Element;
+    Element.Kind = EValueKind::Struct;
+    Element.Size = Codec->Size;
+    Element.Struct = Codec;
+
+    if (Count > (uint32)MAX_int32 || !CanHoldElements(Reader, Element, Count))
+    {
+        OutError = FString::Printf(TEXT("Corrupted %s records"), *Struct->GetName());
+        return false;
+    }
+
+    uint8* Values = static_cast<uint8*>(GetValues(Count));
+    if (Count > 0 && !Values)
+    {
+        OutError = FString::Printf(TEXT("Unexpected number of %s records (%u)"), *Struct->GetName(), Count);
+        return false;
+    }
+
+    if ((Count > 0 && !ReadElements(Reader, Element, Values, Count)) || Reader.Remaining() != 0)
+    {
+        OutError = FString::Printf(TEXT("Corrupted %s records"), *Struct->GetName());
+        return false;
+    }
+
+    return true;
+}
+
+bool UMotaEzStructCodec::MakeValue(const UScriptStruct* Struct, const void* Values, int32 Num, bool bIsArray, FMotaEzValue& OutValue)
+{
+    if (!Struct || (!bIsArray && Num != 1))
+    {
+        return false;
+    }
+
+    OutValue.Type = EMotaEzFieldType::Struct;
+    OutValue.bIsArray = bIsArray;
+    OutValue.ScalarValue = Struct->GetPathName();
+    OutValue.ArrayValues.Reset();
+    return PackRecords(Struct, Values, Num, OutValue.StructData);
+}
+
+bool UMotaEzStructCodec::ToJson(const FMotaEzValue& Value, TArray<TSharedPtr<FJsonValue>>& OutElements, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_StructToJson);
+
+    OutElements.Reset();
+
+    const UScriptStruct* Struct = FindStruct(Value.ScalarValue);
+    if (!Struct)
+    {
+        OutError = FString::Printf(TEXT("Unknown struct %s"), *Value.ScalarValue);
+        return false;
+    }
+
+    const TSharedRef<const FStructCodec> Codec = GetCodec(Struct);
+
+    // Records decode into live values first; members are then written by name
+    FStructValues Values(Struct);
+    if (Value.StructData.IsEmpty())
+    {
+        Values.Allocate(Value.bIsArray ? 0 : 1);
+    }
+    else if (!UnpackRecords(Struct, Value.StructData, [&Values](int32 Num) { return Values.Allocate(Num); }, OutError))
+    {
+        return false;
+    }
+
+    OutElements.Reserve(Values.GetNum());
+    for (int32 Index = 0; Index < Values.GetNum(); ++Index)
+    {
+        OutElements.Add(MakeShared<FJsonValueObject>(StructToJson(*Codec, Values[Index])));
+    }
+    return true;
+}
+
+bool UMotaEzStructCodec::FromJson(const FString& StructPath, bool bIsArray, TConstArrayView<TSharedPtr<FJsonValue>> Elements, FMotaEzValue& OutValue, FString& OutError)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(EzSaveGame_StructFromJson);
+
+    const UScriptStruct* Struct = FindStruct(StructPath);
+    if (!Struct)
+    {
+        OutError = FString::Printf(TEXT("Unknown struct %s"), *StructPath);
+        return false;
+    }
+
+    if (!bIsArray && Elements.Num() != 1)
+    {
+        OutError = FString::Printf(TEXT("A %s value needs exactly one object"), *Struct->GetName());
+        return false;
+    }
+
+    const TSharedRef<const FStructCodec> Codec = GetCodec(Struct);
+
+    FStructValues Values(Struct);
+    Values.Allocate(Elements.Num());
+    for (int32 Index = 0; Index < Elements.Num(); ++Index)
+    {
+        const TSharedPtr<FJsonObject>* Object = nullptr;
+        if (Elements[Index].IsValid() && Elements[Index]->TryGetObject(Object))
+        {
+            JsonToStruct(*Codec, **Object, Values[Index]);
+        }
+    }
+
+    return MakeValue(Struct, Values[0], Values.GetNum(), bIsArray, OutValue);
+}
+
+TSharedPtr<FJsonObject> UMotaEzStructCodec::ToJsonObject(const FMotaEzValue& Value, FString& OutError)
+{
+    TArray<TSharedPtr<FJsonValue>> Elements;
+    if (!ToJson(Value, Elements, OutError))
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+    Object->SetStringField(StructField, Value.ScalarValue);
+
+    if (Value.bIsArray)
+    {
+        Object->SetArrayField(ItemsField, Elements);
+    }
+    else
+    {
+        Object->Values.Append(Elements[0]->AsObject()->Values);
+    }
+    return Object;
+}
+
+bool UMotaEzStructCodec::FromJsonObject(const FJsonObject& Object, FMotaEzValue& OutValue, FString& OutError)
+{
+    FString StructPath;
+    if (!Object.TryGetStringField(StructField, StructPath))
+    {
+        OutError = TEXT("Object has no struct path");
+        return false;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+    if (Object.TryGetArrayField(ItemsField, Items))
+    {
+        return FromJson(StructPath, true, *Items, OutValue, OutError);
+    }
+
+    // The "$struct" field is not a member, so it is skipped like any unknown one
+    const TSharedPtr<FJsonValue> Element = MakeShared<FJsonValueObject>(MakeShared<FJsonObject>(Object));
+    return FromJson(StructPath, false, MakeArrayView(&Element, 1), OutValue, OutError);
+}
+
+bool UMotaEzStructCodec::IsStructObject(const FJsonObject& Object)
+{
+    return Object.HasTypedField<EJson::String>(StructField);
+}
+
+const UScriptStruct* UMotaEzStructCodec::FindStruct(const FString& StructPath)
+{
+    if (StructPath.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    if (const UScriptStruct* Struct = FindObject<UScriptStruct>(nullptr, *StructPath))
+    {
+        return Struct;
+    }
+
+    // User-defined structs are assets that may not be loaded yet
+    return IsInGameThread() ? LoadObject<UScriptStruct>(nullptr, *StructPath, nullptr, LOAD_NoWarn) : nullptr;
+}
+
+int32 UMotaEzStructCodec::GetMemberCount(const UScriptStruct* Struct)
+{
+    return Struct ? GetCodec(Struct)->Members.Num() : 0;
+}
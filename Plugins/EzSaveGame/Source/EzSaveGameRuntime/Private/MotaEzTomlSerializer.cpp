@@ -1,9 +1,13 @@
 ﻿// MotaEzTomlSerializer.cpp
 
 #include "MotaEzTomlSerializer.h"
+#include "MotaEzValueConversion.h"
+#include "MotaEzStructCodec.h"
 
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
 
 #define TOML_EXCEPTIONS 1
 
@@ -57,6 +61,144 @@ namespace
     }
 
 
+    // Struct values travel as the codec's JSON objects, mapped one-to-one onto TOML tables and arrays
+    toml::array JsonArrayToToml(const TArray<TSharedPtr<FJsonValue>>& Elements);
+    toml::table JsonObjectToToml(const FJsonObject& Object);
+
+    FORCEINLINE bool IsTomlInteger(double Number)
+    {
+        return Number == FMath::RoundToDouble(Number) && FMath::Abs(Number) <= 9007199254740992.0;
+    }
+
+    void InsertJsonValue(toml::table& Table, const std::string& Key, const FJsonValue& Json)
+    {
+        switch (Json.Type)
+        {
+        case EJson::Boolean: Table.insert_or_assign(Key, Json.AsBool()); break;
+        case EJson::String:  Table.insert_or_assign(Key, FStringToStd(Json.AsString())); break;
+        case EJson::Array:   Table.insert_or_assign(Key, JsonArrayToToml(Json.AsArray())); break;
+        case EJson::Object:  Table.insert_or_assign(Key, JsonObjectToToml(*Json.AsObject())); break;
+        case EJson::Number:
+        {
+            const double Number = Json.AsNumber();
+            if (IsTomlInteger(Number))
+            {
+                Table.insert_or_assign(Key, (int64_t)Number);
+            }
+            else
+            {
+                Table.insert_or_assign(Key, Number);
+            }
+            break;
+        }
+        default: break;
+        }
+    }
+
+    void PushJsonValue(toml::array& Array, const FJsonValue& Json)
+    {
+        switch (Json.Type)
+        {
+        case EJson::Boolean: Array.push_back(Json.AsBool()); break;
+        case EJson::String:  Array.push_back(FStringToStd(Json.AsString())); break;
+        case EJson::Array:   Array.push_back(JsonArrayToToml(Json.AsArray())); break;
+        case EJson::Object:  Array.push_back(JsonObjectToToml(*Json.AsObject())); break;
+        case EJson::Number:
+        {
+            const double Number = Json.AsNumber();
+            if (IsTomlInteger(Number))
+            {
+                Array.push_back((int64_t)Number);
+            }
+            else
+            {
+                Array.push_back(Number);
+            }
+            break;
+        }
+        default: break;
+        }
+    }
+
+    toml::array JsonArrayToToml(const TArray<TSharedPtr<FJsonValue>>& Elements)
+    {
+        toml::array Array;
+        for (const TSharedPtr<FJsonValue>& Element : Elements)
+        {
+            if (Element.IsValid())
+            {
+                PushJsonValue(Array, *Element);
+            }
+        }
+        return Array;
+    }
+
+    toml::table JsonObjectToToml(const FJsonObject& Object)
+    {
+        toml::table Table;
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+        {
+            if (Field.Value.IsValid())
+            {
+                InsertJsonValue(Table, FStringToStd(Field.Key), *Field.Value);
+            }
+        }
+        return Table;
+    }
+
+    TSharedPtr<FJsonValue> TomlToJson(const toml::node& Node)
+    {
+        if (const toml::table* Table = Node.as_table())
+        {
+            TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+            for (auto&& [Key, Child] : *Table)
+            {
+                if (TSharedPtr<FJsonValue> Value = TomlToJson(Child))
+                {
+                    Object->SetField(StdToFString(std::string(Key.str())), Value);
+                }
+            }
+            return MakeShared<FJsonValueObject>(Object);
+        }
+        if (const toml::array* Array = Node.as_array())
+        {
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            Elements.Reserve((int32)Array->size());
+            for (const toml::node& Element : *Array)
+            {
+                if (TSharedPtr<FJsonValue> Value = TomlToJson(Element))
+                {
+                    Elements.Add(Value);
+                }
+            }
+            return MakeShared<FJsonValueArray>(Elements);
+        }
+        if (Node.is_integer())
+        {
+            const int64 Integer = Node.as_integer()->get();
+            // Same rule as the codec: integers a double cannot hold exactly stay strings
+            if (!IsTomlInteger((double)Integer))
+            {
+                return MakeShared<FJsonValueString>(FString::Printf(TEXT("%lld"), (long long)Integer));
+            }
+            return MakeShared<FJsonValueNumber>((double)Integer);
+        }
+        if (Node.is_floating_point())
+        {
+            return MakeShared<FJsonValueNumber>(Node.as_floating_point()->get());
+        }
+        if (Node.is_boolean())
+        {
+            return MakeShared<FJsonValueBoolean>(Node.as_boolean()->get());
+        }
+        if (Node.is_string())
+        {
+            return MakeShared<FJsonValueString>(StdToFString(Node.as_string()->get()));
+        }
+        return nullptr;
+    }
+
+
     bool InternalLoadFromTomlText(
         const FString& InTomlText,
         TMap<FString, FMotaEzValue>& OutValues,
@@ -94,7 +236,35 @@ namespace
             Value.ScalarValue.Reset();
             Value.ArrayValues.Reset();
 
-            if (auto Arr = Node.as_array())
+            auto NodeTable = Node.as_table();
+            auto BlobText = NodeTable ? NodeTable->get_as<std::string>(FStringToStd(MotaEzValueConversion::BlobField)) : nullptr;
+
+            if (BlobText)
+            {
+                // ---------- BLOB ----------
+                if (!MotaEzValueConversion::Base64ToBlob(StdToFString(BlobText->get()), Value))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping %s - invalid Base64 blob"), *KeyF);
+                    continue;
+                }
+            }
+            else if (NodeTable)
+            {
+                // ---------- STRUCT ----------
+                if (!NodeTable->contains(FStringToStd(UMotaEzStructCodec::StructField)))
+                {
+                    continue;
+                }
+
+                const TSharedPtr<FJsonValue> Json = TomlToJson(Node);
+                FString StructError;
+                if (!UMotaEzStructCodec::FromJsonObject(*Json->AsObject(), Value, StructError))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping struct key '%s': %s"), *KeyF, *StructError);
+                    continue;
+                }
+            }
+            else if (auto Arr = Node.as_array())
             {
                 // ---------- ARRAY ----------
                 const int32 Num = (int32)Arr->size();
@@ -113,11 +283,15 @@ namespace
                         Value.ArrayValues.Add(
                             FString::Printf(TEXT("%lld"), (long long)*Iv)
                         );
+                        if (*Iv < MIN_int32 || *Iv > MAX_int32)
+                        {
+                            Value.Type = EMotaEzFieldType::Int64;
+                        }
                     }
                     else if (auto Fv = Elem.value<double>())
                     {
                         Value.ArrayValues.Add(
-                            LexToString((float)*Fv)
+                            MotaEzValueConversion::DoubleToString(*Fv)
                         );
                     }
                     else if (auto Bv = Elem.value<bool>())
@@ -142,10 +316,15 @@ namespace
                 {
                     Value.ScalarValue =
                         FString::Printf(TEXT("%lld"), (long long)*Iv);
+                    if (*Iv < MIN_int32 || *Iv > MAX_int32)
+                    {
+                        Value.Type = EMotaEzFieldType::Int64;
+                    }
                 }
                 else if (auto Fv = Node.value<double>())
                 {
-                    Value.ScalarValue = LexToString((float)*Fv);
+                    // TOML floats are doubles; keep every digit so Double values survive the round trip
+                    Value.ScalarValue = MotaEzValueConversion::DoubleToString(*Fv);
                 }
                 else if (auto Bv = Node.value<bool>())
                 {
@@ -208,7 +387,25 @@ namespace
 
             std::string KeyStd = FStringToStd(KeyF);
 
-            if (Val.IsArray())
+            if (Val.Type == EMotaEzFieldType::Struct)
+            {
+                FString StructError;
+                const TSharedPtr<FJsonObject> Object = UMotaEzStructCodec::ToJsonObject(Val, StructError);
+                if (!Object.IsValid())
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping struct key '%s': %s"), *KeyF, *StructError);
+                    continue;
+                }
+
+                Tbl.insert_or_assign(std::move(KeyStd), JsonObjectToToml(*Object));
+            }
+            else if (Val.Type == EMotaEzFieldType::Blob)
+            {
+                toml::table BlobTable;
+                BlobTable.insert_or_assign(FStringToStd(MotaEzValueConversion::BlobField), FStringToStd(MotaEzValueConversion::BlobToBase64(Val)));
+                Tbl.insert_or_assign(std::move(KeyStd), std::move(BlobTable));
+            }
+            else if (Val.IsArray())
             {
                 toml::array Arr;
 
@@ -230,6 +427,22 @@ namespace
                     }
                     break;
 
+                case EMotaEzFieldType::Int64:
+                    for (const FString& S : Val.ArrayValues)
+                    {
+                        const int64_t V = (int64_t)FCString::Atoi64(*S);
+                        Arr.push_back(V);
+                    }
+                    break;
+
+                case EMotaEzFieldType::Double:
+                    for (const FString& S : Val.ArrayValues)
+                    {
+                        const double V = FCString::Atod(*S);
+                        Arr.push_back(V);
+                    }
+                    break;
+
                 case EMotaEzFieldType::Bool:
                     for (const FString& S : Val.ArrayValues)
                     {
@@ -267,6 +480,18 @@ namespace
                     Tbl.insert_or_assign(std::move(KeyStd), V);
                     break;
                 }
+                case EMotaEzFieldType::Int64:
+                {
+                    const int64_t V = (int64_t)FCString::Atoi64(*Val.ScalarValue);
+                    Tbl.insert_or_assign(std::move(KeyStd), V);
+                    break;
+                }
+                case EMotaEzFieldType::Double:
+                {
+                    const double V = FCString::Atod(*Val.ScalarValue);
+                    Tbl.insert_or_assign(std::move(KeyStd), V);
+                    break;
+                }
                 case EMotaEzFieldType::Bool:
                 {
                     const bool B =
@@ -375,6 +600,20 @@ bool UMotaEzTomlSerializer::LoadSchema(
                     Desc.Type = EMotaEzFieldType::Vector;
                 else if (TypeStr.Equals(TEXT("Rotator"), ESearchCase::IgnoreCase))
                     Desc.Type = EMotaEzFieldType::Rotator;
+                else if (TypeStr.Equals(TEXT("Int64"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::Int64;
+                else if (TypeStr.Equals(TEXT("Double"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::Double;
+                else if (TypeStr.Equals(TEXT("Quat"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::Quat;
+                else if (TypeStr.Equals(TEXT("Transform"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::Transform;
+                else if (TypeStr.Equals(TEXT("LinearColor"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::LinearColor;
+                else if (TypeStr.Equals(TEXT("Struct"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::Struct;
+                else if (TypeStr.Equals(TEXT("Blob"), ESearchCase::IgnoreCase))
+                    Desc.Type = EMotaEzFieldType::Blob;
             }
 
             // IsArray
@@ -456,6 +695,13 @@ bool UMotaEzTomlSerializer::SaveSchema(
             case EMotaEzFieldType::String:  TypeStr = TEXT("String"); break;
             case EMotaEzFieldType::Vector:  TypeStr = TEXT("Vector"); break;
             case EMotaEzFieldType::Rotator: TypeStr = TEXT("Rotator"); break;
+            case EMotaEzFieldType::Int64:   TypeStr = TEXT("Int64"); break;
+            case EMotaEzFieldType::Double:  TypeStr = TEXT("Double"); break;
+            case EMotaEzFieldType::Quat:    TypeStr = TEXT("Quat"); break;
+            case EMotaEzFieldType::Transform:   TypeStr = TEXT("Transform"); break;
+            case EMotaEzFieldType::LinearColor: TypeStr = TEXT("LinearColor"); break;
+            case EMotaEzFieldType::Struct:  TypeStr = TEXT("Struct"); break;
+            case EMotaEzFieldType::Blob:    TypeStr = TEXT("Blob"); break;
             default:                        TypeStr = TEXT("None"); break;
             }
             FieldTable.insert_or_assign("Type", FStringToStd(TypeStr));
@@ -0,0 +1,190 @@
+﻿#include "MotaEzTypes.h"
+#include "MotaEzValueConversion.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Packed values are written in native byte order, which must be little-endian");
+
+namespace
+{
+    using namespace MotaEzValueConversion;
+
+    /** Largest packed element: a transform, ten doubles. */
+    constexpr int32 MaxPackedBytes = 10 * sizeof(double);
+
+    FORCEINLINE int32 GetPackedSize(EMotaEzFieldType Type)
+    {
+        return Type == EMotaEzFieldType::LinearColor
+            ? GetPackedComponentCount(Type) * (int32)sizeof(float)
+            : GetPackedComponentCount(Type) * (int32)sizeof(double);
+    }
+
+    void PackElement(EMotaEzFieldType Type, const FString& Text, uint8* Out)
+    {
+        const int32 NumComponents = GetPackedComponentCount(Type);
+        if (Type == EMotaEzFieldType::Int64)
+        {
+            const int64 Value = FCString::Atoi64(*Text);
+            FMemory::Memcpy(Out, &Value, sizeof(Value));
+            return;
+        }
+
+        double Components[10] = {};
+        if (NumComponents == 1)
+        {
+            Components[0] = FCString::Atod(*Text);
+        }
+        else
+        {
+            StringToComponents(Text, Components, NumComponents);
+        }
+
+        if (Type == EMotaEzFieldType::LinearColor)
+        {
+            for (int32 Index = 0; Index < NumComponents; ++Index)
+            {
+                const float Component = (float)Components[Index];
+                FMemory::Memcpy(Out + Index * sizeof(float), &Component, sizeof(float));
+            }
+            return;
+        }
+
+        FMemory::Memcpy(Out, Components, NumComponents * sizeof(double));
+    }
+
+    FString UnpackElement(EMotaEzFieldType Type, const uint8* In)
+    {
+        const int32 NumComponents = GetPackedComponentCount(Type);
+        if (Type == EMotaEzFieldType::Int64)
+        {
+            int64 Value = 0;
+            FMemory::Memcpy(&Value, In, sizeof(Value));
+            return LexToString(Value);
+        }
+
+        if (Type == EMotaEzFieldType::LinearColor)
+        {
+            float Components[4];
+            FMemory::Memcpy(Components, In, sizeof(Components));
+            return ComponentsToString(Components, NumComponents);
+        }
+
+        double Components[10];
+        FMemory::Memcpy(Components, In, NumComponents * sizeof(double));
+        return ComponentsToString(Components, NumComponents);
+    }
+
+    /** Scalar or array of a fixed-size type as raw numbers: the array is a count followed by the elements. */
+    void SerializePacked(FArchive& Ar, FMotaEzValue& Value)
+    {
+        const int32 ElementSize = GetPackedSize(Value.Type);
+        uint8 Element[MaxPackedBytes];
+
+        if (!Value.bIsArray)
+        {
+            if (Ar.IsLoading())
+            {
+                Ar.Serialize(Element, ElementSize);
+                Value.ScalarValue = UnpackElement(Value.Type, Element);
+                Value.ArrayValues.Reset();
+            }
+            else
+            {
+                PackElement(Value.Type, Value.ScalarValue, Element);
+                Ar.Serialize(Element, ElementSize);
+            }
+            return;
+        }
+
+        int32 Num = Value.ArrayValues.Num();
+        Ar << Num;
+
+        if (Ar.IsLoading())
+        {
+            Value.ScalarValue.Reset();
+            Value.ArrayValues.Reset();
+            if (Num < 0 || (Ar.TotalSize() >= 0 && (int64)Num * ElementSize > Ar.TotalSize() - Ar.Tell()))
+            {
+                Ar.SetError();
+                return;
+            }
+
+            TArray<uint8> Packed;
+            Packed.SetNumUninitialized(Num * ElementSize);
+            Ar.Serialize(Packed.GetData(), Packed.Num());
+
+            Value.ArrayValues.Reserve(Num);
+            for (int32 Index = 0; Index < Num; ++Index)
+            {
+                Value.ArrayValues.Add(UnpackElement(Value.Type, Packed.GetData() + Index * ElementSize));
+            }
+            return;
+        }
+
+        // Packed into one buffer so the archive gets a single write
+        TArray<uint8> Packed;
+        Packed.SetNumUninitialized(Num * ElementSize);
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            PackElement(Value.Type, Value.ArrayValues[Index], Packed.GetData() + Index * ElementSize);
+        }
+        Ar.Serialize(Packed.GetData(), Packed.Num());
+    }
+}
+
+FArchive& operator<<(FArchive& Ar, FMotaEzValue& Value)
+{
+    Ar << Value.Type;
+    Ar << Value.bIsArray;
+
+    // Struct records are already packed; they are copied as one block
+    if (Value.Type == EMotaEzFieldType::Struct)
+    {
+        Ar << Value.ScalarValue;
+        Ar << Value.StructData;
+        return Ar;
+    }
+
+    // Blob bytes are written straight from the shared buffer and read into a single new one
+    if (Value.Type == EMotaEzFieldType::Blob)
+    {
+        int32 Num = Value.BlobData.IsValid() ? Value.BlobData->Num() : 0;
+        Ar << Num;
+
+        if (!Ar.IsLoading())
+        {
+            if (Num > 0)
+            {
+                Ar.Serialize(const_cast<uint8*>(Value.BlobData->GetData()), Num);
+            }
+            return Ar;
+        }
+
+        Value.ScalarValue.Reset();
+        Value.ArrayValues.Reset();
+        Value.BlobData.Reset();
+        if (Num < 0 || (Ar.TotalSize() >= 0 && Num > Ar.TotalSize() - Ar.Tell()))
+        {
+            Ar.SetError();
+            return Ar;
+        }
+
+        if (Num > 0)
+        {
+            TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Bytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+            Bytes->SetNumUninitialized(Num);
+            Ar.Serialize(Bytes->GetData(), Num);
+            Value.BlobData = Bytes;
+        }
+        return Ar;
+    }
+
+    // Types that existed before packing are still written as text, so older archives load unchanged
+    if (GetPackedComponentCount(Value.Type) > 0 && !Ar.IsTextFormat())
+    {
+        SerializePacked(Ar, Value);
+        return Ar;
+    }
+
+    Ar << Value.ScalarValue;
+    Ar << Value.ArrayValues;
+    return Ar;
+}
@@ -0,0 +1,101 @@
+﻿#include "MotaEzUndoHistory.h"
+
+FMotaEzUndoHistory::FMotaEzUndoHistory(int32 InCapacity, FMotaEzPersistentMap&& InitialState)
+{
+    // One step back needs two checkpoints
+    Ring.SetNum(FMath::Max(InCapacity, 2));
+    Push(TEXT("Initial"), MoveTemp(InitialState));
+}
+
+void FMotaEzUndoHistory::MarkChanged(const FString& Key)
+{
+    FScopeLock Lock(&PendingLock);
+    if (!bPendingAll)
+    {
+        PendingKeys.Add(Key);
+    }
+}
+
+void FMotaEzUndoHistory::MarkAllChanged()
+{
+    FScopeLock Lock(&PendingLock);
+    bPendingAll = true;
+    PendingKeys.Empty();
+}
+
+bool FMotaEzUndoHistory::HasPendingChanges() const
+{
+    FScopeLock Lock(&PendingLock);
+    return bPendingAll || PendingKeys.Num() > 0;
+}
+
+bool FMotaEzUndoHistory::TakePendingChanges(TSet<FString>& OutKeys)
+{
+    FScopeLock Lock(&PendingLock);
+    const bool bAll = bPendingAll;
+    OutKeys = MoveTemp(PendingKeys);
+    PendingKeys.Reset();
+    bPendingAll = false;
+    return bAll;
+}
+
+void FMotaEzUndoHistory::DiscardPendingChanges()
+{
+    FScopeLock Lock(&PendingLock);
+    PendingKeys.Reset();
+    bPendingAll = false;
+}
+
+const FMotaEzUndoHistory::FCheckpoint& FMotaEzUndoHistory::Get(int32 Index) const
+{
+    check(Index >= 0 && Index < Count);
+    return Ring[(Head + Index) % Ring.Num()];
+}
+
+int32 FMotaEzUndoHistory::IndexOfId(int32 Id) const
+{
+    // Ids are not contiguous once redo steps were dropped, and the ring is small, so just search it
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        if (Get(Index).Id == Id)
+        {
+            return Index;
+        }
+    }
+    return INDEX_NONE;
+}
+
+int32 FMotaEzUndoHistory::Push(const FString& Label, FMotaEzPersistentMap&& State)
+{
+    // A new checkpoint after an undo replaces the redo steps; their slots release what only they shared
+    if (Count > 0)
+    {
+        for (int32 Index = Cursor + 1; Index < Count; ++Index)
+        {
+            GetMutable(Index) = FCheckpoint();
+        }
+        Count = Cursor + 1;
+    }
+
+    if (Count == Ring.Num())
+    {
+        Ring[Head] = FCheckpoint();
+        Head = (Head + 1) % Ring.Num();
+        --Count;
+    }
+
+    FCheckpoint& Checkpoint = GetMutable(Count);
+    Checkpoint.Id = NextId++;
+    Checkpoint.Label = Label;
+    Checkpoint.State = MoveTemp(State);
+
+    Cursor = Count;
+    ++Count;
+    return Checkpoint.Id;
+}
+
+void FMotaEzUndoHistory::SetCursor(int32 Index)
+{
+    check(Index >= 0 && Index < Count);
+    Cursor = Index;
+}
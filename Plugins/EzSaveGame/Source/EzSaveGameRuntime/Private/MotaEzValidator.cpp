@@ -2,6 +2,24 @@
 
 #include "MotaEzValidator.h"
 #include "Internationalization/Regex.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    // Compiled regex per pattern: building an FRegexPattern is far more expensive than matching it
+    FCriticalSection PatternCacheLock;
+    TMap<FString, FRegexPattern> PatternCache;
+
+    FRegexPattern GetCompiledPattern(const FString& Pattern)
+    {
+        FScopeLock Lock(&PatternCacheLock);
+        if (const FRegexPattern* Found = PatternCache.Find(Pattern))
+        {
+            return *Found;
+        }
+        return PatternCache.Add(Pattern, FRegexPattern(Pattern));
+    }
+}
 
 FMotaEzValidationResult UMotaEzValidator::ValidateField(const FString& FieldName, const FMotaEzValue& Value, const FMotaEzFieldDescriptor& Descriptor)
 {
@@ -29,6 +47,8 @@ FMotaEzValidationResult UMotaEzValidator::ValidateField(const FString& FieldName
     {
         case EMotaEzFieldType::Int:
         case EMotaEzFieldType::Float:
+        case EMotaEzFieldType::Int64:
+        case EMotaEzFieldType::Double:
         {
             float NumValue = FCString::Atof(*Value.ScalarValue);
             FString Error;
@@ -111,7 +131,7 @@ bool UMotaEzValidator::ValidateStringPattern(const FString& Value, const FString
         return true;
     }
 
-    FRegexPattern RegexPattern(Pattern);
+    const FRegexPattern RegexPattern = GetCompiledPattern(Pattern);
     FRegexMatcher Matcher(RegexPattern, Value);
 
     if (!Matcher.FindNext())
@@ -133,6 +153,8 @@ bool UMotaEzValidator::ValidateArray(const TArray<FString>& ArrayValues, const F
         {
             case EMotaEzFieldType::Int:
             case EMotaEzFieldType::Float:
+            case EMotaEzFieldType::Int64:
+            case EMotaEzFieldType::Double:
             {
                 float NumValue = FCString::Atof(*ElementValue);
                 if (!ValidateNumberRange(NumValue, Descriptor.MinValue, Descriptor.MaxValue, OutError))
@@ -164,3 +186,10 @@ bool UMotaEzValidator::ValidateArray(const TArray<FString>& ArrayValues, const F
     return true;
 }
 
+void UMotaEzValidator::PrecompilePattern(const FString& Pattern)
+{
+    if (!Pattern.IsEmpty())
+    {
+        GetCompiledPattern(Pattern);
+    }
+}
@@ -0,0 +1,410 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "MotaEzTypes.h"
+#include "MotaEzStructCodec.h"
+#include "MotaEzBase64.h"
+#include <type_traits>
+
+/**
+ * Conversions between typed values and the string form FMotaEzValue stores them in.
+ * Shared by UMotaEzSaveData and its published snapshots so both read values identically.
+ */
+namespace MotaEzValueConversion
+{
+    FORCEINLINE bool StringToBool(const FString& In)
+    {
+        return In.Equals(TEXT("true"), ESearchCase::IgnoreCase) ||
+               In.Equals(TEXT("1"), ESearchCase::IgnoreCase)   ||
+               In.Equals(TEXT("yes"), ESearchCase::IgnoreCase);
+    }
+
+    FORCEINLINE FString BoolToString(bool b)
+    {
+        return b ? TEXT("true") : TEXT("false");
+    }
+
+    /** Shortest text (15-17 significant digits) that reads back as the same double. */
+    FORCEINLINE FString DoubleToString(double V)
+    {
+        FString Out = FString::Printf(TEXT("%.15g"), V);
+        if (FCString::Atod(*Out) != V)
+        {
+            Out = FString::Printf(TEXT("%.16g"), V);
+        }
+        if (FCString::Atod(*Out) != V)
+        {
+            Out = FString::Printf(TEXT("%.17g"), V);
+        }
+        return Out;
+    }
+
+    /** Shortest text (6-9 significant digits) that reads back as the same float. */
+    FORCEINLINE FString FloatToString(float V)
+    {
+        FString Out = FString::Printf(TEXT("%.6g"), V);
+        if ((float)FCString::Atod(*Out) != V)
+        {
+            Out = FString::Printf(TEXT("%.7g"), V);
+        }
+        if ((float)FCString::Atod(*Out) != V)
+        {
+            Out = FString::Printf(TEXT("%.8g"), V);
+        }
+        if ((float)FCString::Atod(*Out) != V)
+        {
+            Out = FString::Printf(TEXT("%.9g"), V);
+        }
+        return Out;
+    }
+
+    /** @return true if the text is a plain integer literal, e.g. an int64 a text format could not tag */
+    FORCEINLINE bool IsIntegerString(const FString& In)
+    {
+        const TCHAR* Char = *In;
+        if (*Char == TEXT('-') || *Char == TEXT('+'))
+        {
+            ++Char;
+        }
+        if (!FChar::IsDigit(*Char))
+        {
+            return false;
+        }
+        while (FChar::IsDigit(*Char))
+        {
+            ++Char;
+        }
+        return *Char == TEXT('\0');
+    }
+
+    /** "1,2,3" with the shortest round-trip text for each component. */
+    template <typename T>
+    FString ComponentsToString(const T* Components, int32 Num)
+    {
+        FString Out;
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            if (Index > 0)
+            {
+                Out += TEXT(',');
+            }
+            if constexpr (std::is_same_v<T, float>)
+            {
+                Out += FloatToString(Components[Index]);
+            }
+            else
+            {
+                Out += DoubleToString(Components[Index]);
+            }
+        }
+        return Out;
+    }
+
+    /** @return true if the text has exactly Num comma-separated numbers */
+    FORCEINLINE bool StringToComponents(const FString& In, double* OutComponents, int32 Num)
+    {
+        TArray<FString> Parts;
+        In.ParseIntoArray(Parts, TEXT(","), true);
+
+        if (Parts.Num() != Num)
+        {
+            return false;
+        }
+
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            OutComponents[Index] = FCString::Atod(*Parts[Index]);
+        }
+        return true;
+    }
+
+    FORCEINLINE FVector StringToVector(const FString& In, const FVector& Default)
+    {
+        double C[3];
+        return StringToComponents(In, C, 3) ? FVector(C[0], C[1], C[2]) : Default;
+    }
+
+    FORCEINLINE FString VectorToString(const FVector& V)
+    {
+        const double C[3] = { V.X, V.Y, V.Z };
+        return ComponentsToString(C, 3);
+    }
+
+    FORCEINLINE FRotator StringToRotator(const FString& In, const FRotator& Default)
+    {
+        double C[3];
+        return StringToComponents(In, C, 3) ? FRotator(C[0], C[1], C[2]) : Default;
+    }
+
+    FORCEINLINE FString RotatorToString(const FRotator& R)
+    {
+        const double C[3] = { R.Pitch, R.Yaw, R.Roll };
+        return ComponentsToString(C, 3);
+    }
+
+    FORCEINLINE FQuat StringToQuat(const FString& In, const FQuat& Default)
+    {
+        double C[4];
+        return StringToComponents(In, C, 4) ? FQuat(C[0], C[1], C[2], C[3]) : Default;
+    }
+
+    FORCEINLINE FString QuatToString(const FQuat& Q)
+    {
+        const double C[4] = { Q.X, Q.Y, Q.Z, Q.W };
+        return ComponentsToString(C, 4);
+    }
+
+    /** Translation, rotation quaternion and scale: "Tx,Ty,Tz,Qx,Qy,Qz,Qw,Sx,Sy,Sz". */
+    FORCEINLINE FTransform StringToTransform(const FString& In, const FTransform& Default)
+    {
+        double C[10];
+        if (!StringToComponents(In, C, 10))
+        {
+            return Default;
+        }
+        return FTransform(FQuat(C[3], C[4], C[5], C[6]), FVector(C[0], C[1], C[2]), FVector(C[7], C[8], C[9]));
+    }
+
+    FORCEINLINE FString TransformToString(const FTransform& T)
+    {
+        const FVector L = T.GetTranslation();
+        const FQuat Q = T.GetRotation();
+        const FVector S = T.GetScale3D();
+        const double C[10] = { L.X, L.Y, L.Z, Q.X, Q.Y, Q.Z, Q.W, S.X, S.Y, S.Z };
+        return ComponentsToString(C, 10);
+    }
+
+    FORCEINLINE FLinearColor StringToLinearColor(const FString& In, const FLinearColor& Default)
+    {
+        double C[4];
+        return StringToComponents(In, C, 4) ? FLinearColor((float)C[0], (float)C[1], (float)C[2], (float)C[3]) : Default;
+    }
+
+    FORCEINLINE FString LinearColorToString(const FLinearColor& Color)
+    {
+        const float C[4] = { Color.R, Color.G, Color.B, Color.A };
+        return ComponentsToString(C, 4);
+    }
+
+    /**
+     * Number of numbers a fixed-size type is packed into in binary archives; 0 for types kept as text.
+     * Int64 is one int64, LinearColor four floats, the rest doubles.
+     */
+    FORCEINLINE int32 GetPackedComponentCount(EMotaEzFieldType Type)
+    {
+        switch (Type)
+        {
+            case EMotaEzFieldType::Int64:       return 1;
+            case EMotaEzFieldType::Double:      return 1;
+            case EMotaEzFieldType::Quat:        return 4;
+            case EMotaEzFieldType::Transform:   return 10;
+            case EMotaEzFieldType::LinearColor: return 4;
+            default:                            return 0;
+        }
+    }
+
+    FORCEINLINE bool IsScalarOfType(const FMotaEzValue* Value, EMotaEzFieldType Type)
+    {
+        return Value && !Value->IsArray() && Value->Type == Type;
+    }
+
+    FORCEINLINE int32 ValueToInt(const FMotaEzValue* Value, int32 Default)
+    {
+        return IsScalarOfType(Value, EMotaEzFieldType::Int) ? FCString::Atoi(*Value->ScalarValue) : Default;
+    }
+
+    FORCEINLINE float ValueToFloat(const FMotaEzValue* Value, float Default)
+    {
+        return IsScalarOfType(Value, EMotaEzFieldType::Float) ? FCString::Atof(*Value->ScalarValue) : Default;
+    }
+
+    FORCEINLINE bool ValueToBool(const FMotaEzValue* Value, bool Default)
+    {
+        return IsScalarOfType(Value, EMotaEzFieldType::Bool) ? StringToBool(Value->ScalarValue) : Default;
+    }
+
+    FORCEINLINE FString ValueToString(const FMotaEzValue* Value, const FString& Default)
+    {
+        return IsScalarOfType(Value, EMotaEzFieldType::String) ? Value->ScalarValue : Default;
+    }
+
+    FORCEINLINE FVector ValueToVector(const FMotaEzValue* Value, const FVector& Default)
+    {
+        return IsScalarOfType(Value, EMotaEzFieldType::Vector) ? StringToVector(Value->ScalarValue, Default) : Default;
+    }
+
+    FORCEINLINE FRotator ValueToRotator(const FMotaEzValue* Value, const FRotator& Default)
+    {
+        return IsScalarOfType(Value, EMotaEzFieldType::Rotator) ? StringToRotator(Value->ScalarValue, Default) : Default;
+    }
+
+    /** Reads Int64 and Int values, and integers a text format stored untagged (Float or String). */
+    FORCEINLINE int64 ValueToInt64(const FMotaEzValue* Value, int64 Default)
+    {
+        if (!Value || Value->IsArray())
+        {
+            return Default;
+        }
+
+        switch (Value->Type)
+        {
+            case EMotaEzFieldType::Int64:
+            case EMotaEzFieldType::Int:
+                return FCString::Atoi64(*Value->ScalarValue);
+            case EMotaEzFieldType::Float:
+            case EMotaEzFieldType::String:
+                return IsIntegerString(Value->ScalarValue) ? FCString::Atoi64(*Value->ScalarValue) : Default;
+            default:
+                return Default;
+        }
+    }
+
+    /** Reads Double values and widens Float, Int and Int64 ones. */
+    FORCEINLINE double ValueToDouble(const FMotaEzValue* Value, double Default)
+    {
+        if (!Value || Value->IsArray())
+        {
+            return Default;
+        }
+
+        switch (Value->Type)
+        {
+            case EMotaEzFieldType::Double:
+            case EMotaEzFieldType::Float:
+            case EMotaEzFieldType::Int:
+            case EMotaEzFieldType::Int64:
+                return FCString::Atod(*Value->ScalarValue);
+            default:
+                return Default;
+        }
+    }
+
+    /** Math types come back from text formats as strings, so those are parsed too. */
+    FORCEINLINE bool IsScalarOfTypeOrString(const FMotaEzValue* Value, EMotaEzFieldType Type)
+    {
+        return Value && !Value->IsArray() && (Value->Type == Type || Value->Type == EMotaEzFieldType::String);
+    }
+
+    FORCEINLINE FQuat ValueToQuat(const FMotaEzValue* Value, const FQuat& Default)
+    {
+        return IsScalarOfTypeOrString(Value, EMotaEzFieldType::Quat) ? StringToQuat(Value->ScalarValue, Default) : Default;
+    }
+
+    FORCEINLINE FTransform ValueToTransform(const FMotaEzValue* Value, const FTransform& Default)
+    {
+        return IsScalarOfTypeOrString(Value, EMotaEzFieldType::Transform) ? StringToTransform(Value->ScalarValue, Default) : Default;
+    }
+
+    FORCEINLINE FLinearColor ValueToLinearColor(const FMotaEzValue* Value, const FLinearColor& Default)
+    {
+        return IsScalarOfTypeOrString(Value, EMotaEzFieldType::LinearColor) ? StringToLinearColor(Value->ScalarValue, Default) : Default;
+    }
+
+    /** @return true if the value is a Struct value of exactly this struct type */
+    FORCEINLINE bool IsStructValueOf(const FMotaEzValue* Value, const UScriptStruct* Struct, bool bIsArray)
+    {
+        return Value && Struct && Value->Type == EMotaEzFieldType::Struct && Value->IsArray() == bIsArray
+            && Value->ScalarValue == Struct->GetPathName();
+    }
+
+    /**
+     * Reads a Struct value into an initialized struct; a value without records reads as the default.
+     * @return true if the value was read, false if it is missing, of another type or unreadable
+     */
+    inline bool ValueToStruct(const FMotaEzValue* Value, const UScriptStruct* Struct, void* OutValue)
+    {
+        if (!OutValue || !IsStructValueOf(Value, Struct, false))
+        {
+            return false;
+        }
+
+        if (Value->StructData.IsEmpty())
+        {
+            Struct->ClearScriptStruct(OutValue);
+            return true;
+        }
+
+        FString Error;
+        if (!UMotaEzStructCodec::UnpackRecords(Struct, Value->StructData, [OutValue](int32 Num) { return Num == 1 ? OutValue : nullptr; }, Error))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s"), *Error);
+            return false;
+        }
+        return true;
+    }
+
+    /** Reads a Struct array value; Resize gets the element count and returns that many initialized elements. */
+    inline bool ValueToStructArray(const FMotaEzValue* Value, const UScriptStruct* Struct, TFunctionRef<void*(int32)> Resize)
+    {
+        if (!IsStructValueOf(Value, Struct, true))
+        {
+            return false;
+        }
+
+        if (Value->StructData.IsEmpty())
+        {
+            Resize(0);
+            return true;
+        }
+
+        FString Error;
+        if (!UMotaEzStructCodec::UnpackRecords(Struct, Value->StructData, Resize, Error))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: %s"), *Error);
+            return false;
+        }
+        return true;
+    }
+
+    /** @return The shared bytes of a Blob value, or null if the value is missing, empty or of another type */
+    FORCEINLINE FMotaEzBlobPtr ValueToBlob(const FMotaEzValue* Value)
+    {
+        return Value && Value->Type == EMotaEzFieldType::Blob ? Value->BlobData : FMotaEzBlobPtr();
+    }
+
+    /** Field that marks a Blob value in formats without a byte type: {"$blob": "<Base64>"}. */
+    inline const TCHAR* const BlobField = TEXT("$blob");
+
+    FORCEINLINE FString BlobToBase64(const FMotaEzValue& Value)
+    {
+        FString Text;
+        if (Value.BlobData.IsValid())
+        {
+            MotaEzBase64::Encode(*Value.BlobData, Text);
+        }
+        return Text;
+    }
+
+    /** Makes a Blob value from Base64 text. @return false if the text is not valid Base64 */
+    inline bool Base64ToBlob(FStringView Text, FMotaEzValue& OutValue)
+    {
+        TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Bytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+        if (!MotaEzBase64::Decode(Text, *Bytes))
+        {
+            return false;
+        }
+
+        OutValue.Type = EMotaEzFieldType::Blob;
+        OutValue.bIsArray = false;
+        OutValue.ScalarValue.Reset();
+        OutValue.ArrayValues.Reset();
+        OutValue.BlobData = Bytes->Num() > 0 ? FMotaEzBlobPtr(Bytes) : FMotaEzBlobPtr();
+        return true;
+    }
+
+    FORCEINLINE FMotaEzValue MakeScalar(EMotaEzFieldType Type, FString ScalarValue)
+    {
+        FMotaEzValue Value;
+        Value.Type = Type;
+        Value.ScalarValue = MoveTemp(ScalarValue);
+        return Value;
+    }
+
+    FORCEINLINE FMotaEzValue MakeBlob(FMotaEzBlobPtr Bytes)
+    {
+        FMotaEzValue Value;
+        Value.Type = EMotaEzFieldType::Blob;
+        Value.BlobData = Bytes.IsValid() && Bytes->Num() > 0 ? MoveTemp(Bytes) : FMotaEzBlobPtr();
+        return Value;
+    }
+}
@@ -1,8 +1,11 @@
 ﻿// MotaEzXmlSerializer.cpp
 
 #include "MotaEzXmlSerializer.h"
+#include "MotaEzValueConversion.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
 
 #include <string>
 
@@ -33,6 +36,13 @@ namespace
         if (TypeStr.Equals(TEXT("String"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::String;
         if (TypeStr.Equals(TEXT("Vector"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Vector;
         if (TypeStr.Equals(TEXT("Rotator"), ESearchCase::IgnoreCase)) return EMotaEzFieldType::Rotator;
+        if (TypeStr.Equals(TEXT("Int64"), ESearchCase::IgnoreCase))   return EMotaEzFieldType::Int64;
+        if (TypeStr.Equals(TEXT("Double"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Double;
+        if (TypeStr.Equals(TEXT("Quat"), ESearchCase::IgnoreCase))    return EMotaEzFieldType::Quat;
+        if (TypeStr.Equals(TEXT("Transform"), ESearchCase::IgnoreCase))   return EMotaEzFieldType::Transform;
+        if (TypeStr.Equals(TEXT("LinearColor"), ESearchCase::IgnoreCase)) return EMotaEzFieldType::LinearColor;
+        if (TypeStr.Equals(TEXT("Struct"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Struct;
+        if (TypeStr.Equals(TEXT("Blob"), ESearchCase::IgnoreCase))    return EMotaEzFieldType::Blob;
         return EMotaEzFieldType::None;
     }
 
@@ -46,6 +56,13 @@ namespace
         case EMotaEzFieldType::String:  return TEXT("String");
         case EMotaEzFieldType::Vector:  return TEXT("Vector");
         case EMotaEzFieldType::Rotator: return TEXT("Rotator");
+        case EMotaEzFieldType::Int64:   return TEXT("Int64");
+        case EMotaEzFieldType::Double:  return TEXT("Double");
+        case EMotaEzFieldType::Quat:    return TEXT("Quat");
+        case EMotaEzFieldType::Transform:   return TEXT("Transform");
+        case EMotaEzFieldType::LinearColor: return TEXT("LinearColor");
+        case EMotaEzFieldType::Struct:  return TEXT("Struct");
+        case EMotaEzFieldType::Blob:    return TEXT("Blob");
         default:                        return TEXT("None");
         }
     }
@@ -75,6 +92,85 @@ namespace
 
         return bIsInt ? EMotaEzFieldType::Int : EMotaEzFieldType::String;
     }
+
+    // Struct values travel as the codec's JSON objects: objects become <Member Name="..."> children,
+    // arrays an <Array> of <Item> elements like top-level fields, and scalars plain text
+    void JsonToXml(XMLDocument& Doc, XMLElement* Elem, const FJsonValue& Json)
+    {
+        std::string Buffer;
+        switch (Json.Type)
+        {
+        case EJson::Boolean:
+            Elem->SetText(Json.AsBool() ? "true" : "false");
+            break;
+        case EJson::Number:
+            Elem->SetText(FStringToCStr(MotaEzValueConversion::DoubleToString(Json.AsNumber()), Buffer));
+            break;
+        case EJson::String:
+            Elem->SetText(FStringToCStr(Json.AsString(), Buffer));
+            break;
+        case EJson::Array:
+        {
+            XMLElement* ArrayElem = Doc.NewElement("Array");
+            for (const TSharedPtr<FJsonValue>& Element : Json.AsArray())
+            {
+                XMLElement* ItemElem = Doc.NewElement("Item");
+                if (Element.IsValid())
+                {
+                    JsonToXml(Doc, ItemElem, *Element);
+                }
+                ArrayElem->InsertEndChild(ItemElem);
+            }
+            Elem->InsertEndChild(ArrayElem);
+            break;
+        }
+        case EJson::Object:
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Json.AsObject()->Values)
+            {
+                if (!Field.Value.IsValid())
+                {
+                    continue;
+                }
+
+                XMLElement* MemberElem = Doc.NewElement("Member");
+                MemberElem->SetAttribute("Name", FStringToCStr(Field.Key, Buffer));
+                JsonToXml(Doc, MemberElem, *Field.Value);
+                Elem->InsertEndChild(MemberElem);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // XML text carries no type; scalars come back as strings, which the struct codec parses per member
+    TSharedPtr<FJsonValue> XmlToJson(const XMLElement* Elem)
+    {
+        if (const XMLElement* ArrayElem = Elem->FirstChildElement("Array"))
+        {
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            for (const XMLElement* Item = ArrayElem->FirstChildElement("Item"); Item != nullptr; Item = Item->NextSiblingElement("Item"))
+            {
+                Elements.Add(XmlToJson(Item));
+            }
+            return MakeShared<FJsonValueArray>(Elements);
+        }
+
+        if (Elem->FirstChildElement("Member"))
+        {
+            TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+            for (const XMLElement* Member = Elem->FirstChildElement("Member"); Member != nullptr; Member = Member->NextSiblingElement("Member"))
+            {
+                if (const char* NameCStr = Member->Attribute("Name"))
+                {
+                    Object->SetField(CStrToFString(NameCStr), XmlToJson(Member));
+                }
+            }
+            return MakeShared<FJsonValueObject>(Object);
+        }
+
+        return MakeShared<FJsonValueString>(CStrToFString(Elem->GetText()));
+    }
 }
 
 bool UMotaEzXmlSerializer::LoadConfig(
@@ -113,9 +209,39 @@ bool UMotaEzXmlSerializer::LoadConfig(
         FString Key = CStrToFString(KeyCStr);
         FMotaEzValue Val;
 
-        // Check si es array
+        // Structs llevan la ruta del USTRUCT en el atributo "Struct"
         XMLElement* ArrayElem = Field->FirstChildElement("Array");
-        if (ArrayElem)
+        if (Field->Attribute("Encoding", "Base64"))
+        {
+            // Blobs: bytes en Base64 como texto del campo
+            if (!MotaEzValueConversion::Base64ToBlob(CStrToFString(Field->GetText()), Val))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping %s - invalid Base64 blob"), *Key);
+                continue;
+            }
+        }
+        else if (const char* StructCStr = Field->Attribute("Struct"))
+        {
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            const TSharedPtr<FJsonValue> Json = XmlToJson(Field);
+            if (ArrayElem)
+            {
+                Elements = Json->AsArray();
+            }
+            else
+            {
+                // Un struct sin miembros no tiene hijos <Member>: se carga con sus valores por defecto
+                Elements.Add(Json->Type == EJson::Object ? Json : MakeShared<FJsonValueObject>(MakeShared<FJsonObject>()));
+            }
+
+            FString StructError;
+            if (!UMotaEzStructCodec::FromJson(CStrToFString(StructCStr), ArrayElem != nullptr, Elements, Val, StructError))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping struct key '%s': %s"), *Key, *StructError);
+                continue;
+            }
+        }
+        else if (ArrayElem)
         {
             Val.bIsArray = true;
 
@@ -189,7 +315,34 @@ bool UMotaEzXmlSerializer::SaveConfig(
         XMLElement* FieldElem = Doc.NewElement("Field");
         FieldElem->SetAttribute("Name", FStringToCStr(Key, KeyBuffer));
 
-        if (Val.bIsArray)
+        if (Val.Type == EMotaEzFieldType::Struct)
+        {
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            FString StructError;
+            if (!UMotaEzStructCodec::ToJson(Val, Elements, StructError))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping struct key '%s': %s"), *Key, *StructError);
+                continue;
+            }
+
+            std::string StructBuffer;
+            FieldElem->SetAttribute("Struct", FStringToCStr(Val.ScalarValue, StructBuffer));
+            if (Val.bIsArray)
+            {
+                JsonToXml(Doc, FieldElem, FJsonValueArray(Elements));
+            }
+            else
+            {
+                JsonToXml(Doc, FieldElem, *Elements[0]);
+            }
+        }
+        else if (Val.Type == EMotaEzFieldType::Blob)
+        {
+            std::string BlobBuffer;
+            FieldElem->SetAttribute("Encoding", "Base64");
+            FieldElem->SetText(FStringToCStr(MotaEzValueConversion::BlobToBase64(Val), BlobBuffer));
+        }
+        else if (Val.bIsArray)
         {
             XMLElement* ArrayElem = Doc.NewElement("Array");
             
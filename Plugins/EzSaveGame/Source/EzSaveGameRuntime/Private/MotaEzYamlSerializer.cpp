@@ -1,8 +1,12 @@
 ﻿// MotaEzYamlSerializer.cpp
 
 #include "MotaEzYamlSerializer.h"
+#include "MotaEzStructCodec.h"
+#include "MotaEzValueConversion.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
 
 THIRD_PARTY_INCLUDES_START
 #include "yaml-cpp/yaml.h"
@@ -28,6 +32,13 @@ namespace
         if (TypeStr.Equals(TEXT("String"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::String;
         if (TypeStr.Equals(TEXT("Vector"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Vector;
         if (TypeStr.Equals(TEXT("Rotator"), ESearchCase::IgnoreCase)) return EMotaEzFieldType::Rotator;
+        if (TypeStr.Equals(TEXT("Int64"), ESearchCase::IgnoreCase))   return EMotaEzFieldType::Int64;
+        if (TypeStr.Equals(TEXT("Double"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Double;
+        if (TypeStr.Equals(TEXT("Quat"), ESearchCase::IgnoreCase))    return EMotaEzFieldType::Quat;
+        if (TypeStr.Equals(TEXT("Transform"), ESearchCase::IgnoreCase))   return EMotaEzFieldType::Transform;
+        if (TypeStr.Equals(TEXT("LinearColor"), ESearchCase::IgnoreCase)) return EMotaEzFieldType::LinearColor;
+        if (TypeStr.Equals(TEXT("Struct"), ESearchCase::IgnoreCase))  return EMotaEzFieldType::Struct;
+        if (TypeStr.Equals(TEXT("Blob"), ESearchCase::IgnoreCase))    return EMotaEzFieldType::Blob;
         return EMotaEzFieldType::None;
     }
 
@@ -41,9 +52,104 @@ namespace
         case EMotaEzFieldType::String:  return TEXT("String");
         case EMotaEzFieldType::Vector:  return TEXT("Vector");
         case EMotaEzFieldType::Rotator: return TEXT("Rotator");
+        case EMotaEzFieldType::Int64:   return TEXT("Int64");
+        case EMotaEzFieldType::Double:  return TEXT("Double");
+        case EMotaEzFieldType::Quat:    return TEXT("Quat");
+        case EMotaEzFieldType::Transform:   return TEXT("Transform");
+        case EMotaEzFieldType::LinearColor: return TEXT("LinearColor");
+        case EMotaEzFieldType::Struct:  return TEXT("Struct");
+        case EMotaEzFieldType::Blob:    return TEXT("Blob");
         default:                        return TEXT("None");
         }
     }
+
+    // Struct values travel as the codec's JSON objects: members become nested maps and sequences
+    void EmitJsonValue(YAML::Emitter& Out, const FJsonValue& Json)
+    {
+        switch (Json.Type)
+        {
+        case EJson::Boolean:
+            Out << Json.AsBool();
+            break;
+        case EJson::Number:
+        {
+            const double Number = Json.AsNumber();
+            if (Number == FMath::RoundToDouble(Number) && FMath::Abs(Number) <= 9007199254740992.0)
+            {
+                Out << (long long)Number;
+            }
+            else
+            {
+                Out << YAML::Precision(17) << Number;
+            }
+            break;
+        }
+        case EJson::String:
+            Out << FStringToStd(Json.AsString());
+            break;
+        case EJson::Array:
+            Out << YAML::BeginSeq;
+            for (const TSharedPtr<FJsonValue>& Element : Json.AsArray())
+            {
+                if (Element.IsValid())
+                {
+                    EmitJsonValue(Out, *Element);
+                }
+            }
+            Out << YAML::EndSeq;
+            break;
+        case EJson::Object:
+            Out << YAML::BeginMap;
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Json.AsObject()->Values)
+            {
+                if (Field.Value.IsValid())
+                {
+                    Out << YAML::Key << FStringToStd(Field.Key) << YAML::Value;
+                    EmitJsonValue(Out, *Field.Value);
+                }
+            }
+            Out << YAML::EndMap;
+            break;
+        default:
+            Out << YAML::Null;
+            break;
+        }
+    }
+
+    // YAML scalars carry no type; they come back as strings, which the struct codec parses per member
+    TSharedPtr<FJsonValue> YamlToJson(const YAML::Node& Node)
+    {
+        if (Node.IsMap())
+        {
+            TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+            for (const auto& Pair : Node)
+            {
+                if (TSharedPtr<FJsonValue> Value = YamlToJson(Pair.second))
+                {
+                    Object->SetField(StdToFString(Pair.first.as<std::string>()), Value);
+                }
+            }
+            return MakeShared<FJsonValueObject>(Object);
+        }
+        if (Node.IsSequence())
+        {
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            Elements.Reserve((int32)Node.size());
+            for (const auto& Element : Node)
+            {
+                if (TSharedPtr<FJsonValue> Value = YamlToJson(Element))
+                {
+                    Elements.Add(Value);
+                }
+            }
+            return MakeShared<FJsonValueArray>(Elements);
+        }
+        if (Node.IsScalar())
+        {
+            return MakeShared<FJsonValueString>(StdToFString(Node.as<std::string>()));
+        }
+        return nullptr;
+    }
 }
 
 bool UMotaEzYamlSerializer::LoadConfig(
@@ -66,7 +172,31 @@ bool UMotaEzYamlSerializer::LoadConfig(
 
             FMotaEzValue Val;
 
-            if (ValNode.IsSequence())
+            if (ValNode.IsMap() && ValNode[FStringToStd(MotaEzValueConversion::BlobField)])
+            {
+                const std::string Text = ValNode[FStringToStd(MotaEzValueConversion::BlobField)].as<std::string>();
+                if (!MotaEzValueConversion::Base64ToBlob(StdToFString(Text), Val))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping %s - invalid Base64 blob"), *Key);
+                    continue;
+                }
+            }
+            else if (ValNode.IsMap())
+            {
+                if (!ValNode[FStringToStd(UMotaEzStructCodec::StructField)])
+                {
+                    continue;
+                }
+
+                const TSharedPtr<FJsonValue> Json = YamlToJson(ValNode);
+                FString StructError;
+                if (!UMotaEzStructCodec::FromJsonObject(*Json->AsObject(), Val, StructError))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping struct key '%s': %s"), *Key, *StructError);
+                    continue;
+                }
+            }
+            else if (ValNode.IsSequence())
             {
                 Val.bIsArray = true;
                 
@@ -191,6 +321,30 @@ bool UMotaEzYamlSerializer::SaveConfig(
             const FString& Key = Pair.Key;
             const FMotaEzValue& Val = Pair.Value;
 
+            if (Val.Type == EMotaEzFieldType::Struct)
+            {
+                FString StructError;
+                const TSharedPtr<FJsonObject> Object = UMotaEzStructCodec::ToJsonObject(Val, StructError);
+                if (!Object.IsValid())
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("EzSaveGame: Skipping struct key '%s': %s"), *Key, *StructError);
+                    continue;
+                }
+
+                Out << YAML::Key << FStringToStd(Key) << YAML::Value;
+                EmitJsonValue(Out, FJsonValueObject(Object));
+                continue;
+            }
+
+            if (Val.Type == EMotaEzFieldType::Blob)
+            {
+                Out << YAML::Key << FStringToStd(Key) << YAML::Value << YAML::BeginMap;
+                Out << YAML::Key << FStringToStd(MotaEzValueConversion::BlobField);
+                Out << YAML::Value << FStringToStd(MotaEzValueConversion::BlobToBase64(Val));
+                Out << YAML::EndMap;
+                continue;
+            }
+
             Out << YAML::Key << FStringToStd(Key);
 
             if (Val.bIsArray)
@@ -0,0 +1,189 @@
+﻿#include "MotaEzBase64.h"
+#include "MotaEzSaveData.h"
+#include "MotaEzFormatSerializer.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    TArray<uint8> ToBytes(const ANSICHAR* Text)
+    {
+        return TArray<uint8>(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+    }
+
+    bool BlobMatches(const FMotaEzBlobPtr& Blob, const TArray<uint8>& Expected)
+    {
+        return Expected.Num() == 0 ? !Blob.IsValid() : Blob.IsValid() && *Blob == Expected;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzBase64RoundTripTest, "EzSaveGame.Base64.RoundTrip",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzBase64RoundTripTest::RunTest(const FString& Parameters)
+{
+    // RFC 4648 vectors: no tail, and one or two bytes left over after the last full group
+    const TPair<const ANSICHAR*, const TCHAR*> Vectors[] =
+    {
+        { "", TEXT("") },
+        { "f", TEXT("Zg==") },
+        { "fo", TEXT("Zm8=") },
+        { "foo", TEXT("Zm9v") },
+        { "foob", TEXT("Zm9vYg==") },
+        { "fooba", TEXT("Zm9vYmE=") },
+        { "foobar", TEXT("Zm9vYmFy") },
+    };
+
+    for (const TPair<const ANSICHAR*, const TCHAR*>& Vector : Vectors)
+    {
+        const TArray<uint8> Bytes = ToBytes(Vector.Key);
+
+        FString Encoded;
+        MotaEzBase64::Encode(Bytes, Encoded);
+        TestEqual(*FString::Printf(TEXT("Encode of %d bytes"), Bytes.Num()), Encoded, FString(Vector.Value));
+        TestEqual(*FString::Printf(TEXT("Encoded length of %d bytes"), Bytes.Num()), Encoded.Len(), MotaEzBase64::GetEncodedLength(Bytes.Num()));
+
+        TArray<uint8> Decoded;
+        TestTrue(*FString::Printf(TEXT("Decode of '%s'"), Vector.Value), MotaEzBase64::Decode(Vector.Value, Decoded) && Decoded == Bytes);
+
+        // Padding is optional on input
+        FString Unpadded = Vector.Value;
+        Unpadded.RemoveFromEnd(TEXT("=="));
+        Unpadded.RemoveFromEnd(TEXT("="));
+        TestTrue(*FString::Printf(TEXT("Decode of unpadded '%s'"), *Unpadded), MotaEzBase64::Decode(Unpadded, Decoded) && Decoded == Bytes);
+    }
+
+    // Every byte value, with each tail length
+    TArray<uint8> AllBytes;
+    for (int32 Value = 0; Value < 256; ++Value)
+    {
+        AllBytes.Add((uint8)Value);
+    }
+    for (int32 Trim = 0; Trim < 3; ++Trim)
+    {
+        const TArray<uint8> Bytes(AllBytes.GetData(), AllBytes.Num() - Trim);
+        FString Encoded;
+        MotaEzBase64::Encode(Bytes, Encoded);
+        TArray<uint8> Decoded;
+        TestTrue(*FString::Printf(TEXT("All byte values, %d bytes"), Bytes.Num()), MotaEzBase64::Decode(Encoded, Decoded) && Decoded == Bytes);
+    }
+
+    // Encode appends after what the string already holds, and keeps it terminated
+    FString Appended = TEXT("prefix:");
+    MotaEzBase64::Encode(ToBytes("fo"), Appended);
+    MotaEzBase64::Encode(ToBytes("f"), Appended);
+    TestEqual(TEXT("Encode appends"), Appended, FString(TEXT("prefix:Zm8=Zg==")));
+    TestEqual(TEXT("Appended string length"), FCString::Strlen(*Appended), Appended.Len());
+
+    TArray<uint8> Decoded;
+    TestTrue(TEXT("Surrounding whitespace is ignored"), MotaEzBase64::Decode(TEXT("  Zm9vYmE=\n"), Decoded) && Decoded == ToBytes("fooba"));
+
+    // Rejected input empties the output
+    const TCHAR* Invalid[] =
+    {
+        TEXT("Zm9*"),           // bad digit in a full group
+        TEXT("Zm9vY*=="),       // bad digit in the tail
+        TEXT("Zm 9"),           // whitespace inside the text
+        TEXT("Zm9\u00F1"),     // Latin-1 character
+        TEXT("Zm9\u4E2D"),     // character above 255
+        TEXT("Zm9vY"),          // Len % 4 == 1
+        TEXT("Z"),
+    };
+    for (const TCHAR* Text : Invalid)
+    {
+        Decoded = ToBytes("stale");
+        TestFalse(*FString::Printf(TEXT("Decode rejects '%s'"), Text), MotaEzBase64::Decode(Text, Decoded));
+        TestEqual(*FString::Printf(TEXT("Rejected '%s' leaves no bytes"), Text), Decoded.Num(), 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzBlobFormatsTest, "EzSaveGame.Blob.Formats",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzBlobFormatsTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Payload;
+    for (int32 Index = 0; Index < 1000; ++Index)
+    {
+        Payload.Add((uint8)(Index * 37 + 11));
+    }
+    const FMotaEzBlobPtr Shared = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(Payload);
+
+    UMotaEzSaveData* Source = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    Source->SetBlob(TEXT("Thumbnail"), Shared);
+    Source->SetBlob(TEXT("Tail"), ToBytes("fooba"));
+    Source->SetBlobBytes(TEXT("Empty"), TArray<uint8>());
+    Source->SetInt(TEXT("Neighbour"), 7);
+
+    // Storing and copying a value hands out the same bytes instead of duplicating them
+    TestTrue(TEXT("GetBlob returns the stored bytes"), Source->GetBlob(TEXT("Thumbnail")) == Shared);
+    const TMap<FString, FMotaEzValue> Copied = Source->Data;
+    TestTrue(TEXT("Copied values share the bytes"), Copied.FindChecked(TEXT("Thumbnail")).BlobData == Shared);
+
+    auto CheckLoaded = [this](const FString& Stage, TMap<FString, FMotaEzValue>&& Loaded, const TArray<uint8>& Expected)
+    {
+        const FMotaEzValue* Thumbnail = Loaded.Find(TEXT("Thumbnail"));
+        if (!TestTrue(*FString::Printf(TEXT("%s: blob is loaded as a Blob"), *Stage), Thumbnail && Thumbnail->Type == EMotaEzFieldType::Blob))
+        {
+            return;
+        }
+        const FMotaEzBlobPtr LoadedBytes = Thumbnail->BlobData;
+
+        UMotaEzSaveData* Target = NewObject<UMotaEzSaveData>(GetTransientPackage());
+        Target->ReplaceData(MoveTemp(Loaded));
+
+        TestTrue(*FString::Printf(TEXT("%s: bytes round-trip"), *Stage), BlobMatches(Target->GetBlob(TEXT("Thumbnail")), Expected));
+        TestTrue(*FString::Printf(TEXT("%s: loaded bytes are shared, not copied"), *Stage), Target->GetBlob(TEXT("Thumbnail")) == LoadedBytes);
+        TestTrue(*FString::Printf(TEXT("%s: tail bytes round-trip"), *Stage), BlobMatches(Target->GetBlob(TEXT("Tail")), ToBytes("fooba")));
+        TestTrue(*FString::Printf(TEXT("%s: empty blob round-trips"), *Stage),
+            Target->Data.Contains(TEXT("Empty")) && Target->Data.FindChecked(TEXT("Empty")).Type == EMotaEzFieldType::Blob && !Target->GetBlob(TEXT("Empty")).IsValid());
+        TestEqual(*FString::Printf(TEXT("%s: neighbouring key"), *Stage), Target->GetInt(TEXT("Neighbour"), -1), 7);
+
+        Target->MarkAsGarbage();
+    };
+
+    const int32 ReferencesBefore = Shared.GetSharedReferenceCount();
+
+    const EMotaEzConfigFormat Formats[] = { EMotaEzConfigFormat::Json, EMotaEzConfigFormat::Xml };
+    for (EMotaEzConfigFormat Format : Formats)
+    {
+        const FString FormatName = StaticEnum<EMotaEzConfigFormat>()->GetNameStringByValue((int64)Format);
+
+        FString Text;
+        FString Error;
+        TMap<FString, FMotaEzValue> Loaded;
+        if (!TestTrue(*FString::Printf(TEXT("%s: SaveConfig succeeds"), *FormatName), UMotaEzFormatSerializer::SaveConfig(Format, Source->Data, Text, Error))
+            || !TestTrue(*FString::Printf(TEXT("%s: LoadConfig succeeds"), *FormatName), UMotaEzFormatSerializer::LoadConfig(Format, Text, Loaded, Error)))
+        {
+            AddError(Error);
+            continue;
+        }
+        CheckLoaded(FormatName, MoveTemp(Loaded), Payload);
+    }
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    Writer << Source->Data;
+
+    TMap<FString, FMotaEzValue> FromBytes;
+    FMemoryReader Reader(Bytes);
+    Reader << FromBytes;
+    if (TestFalse(TEXT("Binary archive reads back"), Reader.IsError()))
+    {
+        CheckLoaded(TEXT("Binary"), MoveTemp(FromBytes), Payload);
+    }
+
+    // Writing never copied or released the source's bytes
+    TestTrue(TEXT("Source still holds the same bytes"), Source->GetBlob(TEXT("Thumbnail")) == Shared);
+    TestEqual(TEXT("Writing takes no lasting reference"), Shared.GetSharedReferenceCount(), ReferencesBefore);
+
+    Source->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
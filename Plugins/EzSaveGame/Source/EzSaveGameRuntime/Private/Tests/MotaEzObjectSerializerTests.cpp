@@ -0,0 +1,71 @@
+﻿#include "MotaEzObjectSerializer.h"
+#include "MotaEzTestTypes.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzObjectSerializerRoundTripTest, "EzSaveGame.ObjectSerializer.RoundTrip",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzObjectSerializerRoundTripTest::RunTest(const FString& Parameters)
+{
+    UMotaEzTestSaveGame* Source = NewObject<UMotaEzTestSaveGame>(GetTransientPackage());
+    Source->Level = 42;
+    Source->Experience = 9876543210ll;
+    Source->Health = 73.5f;
+    Source->Gold = 1234.5678;
+    Source->Difficulty = 3;
+    Source->bTutorialDone = true;
+    Source->PlayerName = TEXT("José");
+    Source->Zone = TEXT("Forest_02");
+    Source->Title = FText::FromString(TEXT("Ranger"));
+    Source->Position = FVector(1.f, -2.5f, 300.f);
+    Source->Facing = FRotator(10.f, 90.f, -45.f);
+    Source->Inventory = { 7, 0, -3, 1 << 20 };
+    Source->Quests = { TEXT("Intro"), TEXT(""), TEXT("Main_01") };
+    Source->NotSaved = 5;
+
+    TestEqual(TEXT("Layout covers every SaveGame property"), UMotaEzObjectSerializer::GetLayoutFieldCount(UMotaEzTestSaveGame::StaticClass()), 13);
+
+    TArray<uint8> Bytes;
+    FString Error;
+    if (!TestTrue(TEXT("SerializeObject succeeds"), UMotaEzObjectSerializer::SerializeObject(Source, Bytes, Error)))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    UMotaEzTestSaveGame* Loaded = NewObject<UMotaEzTestSaveGame>(GetTransientPackage());
+    Loaded->NotSaved = 11;
+    if (!TestTrue(TEXT("DeserializeObject succeeds"), UMotaEzObjectSerializer::DeserializeObject(Loaded, Bytes, Error)))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    TestEqual(TEXT("Level"), Loaded->Level, Source->Level);
+    TestEqual(TEXT("Experience"), Loaded->Experience, Source->Experience);
+    TestEqual(TEXT("Health"), Loaded->Health, Source->Health);
+    TestEqual(TEXT("Gold"), Loaded->Gold, Source->Gold);
+    TestEqual(TEXT("Difficulty"), (int32)Loaded->Difficulty, (int32)Source->Difficulty);
+    TestEqual(TEXT("bTutorialDone"), Loaded->bTutorialDone, Source->bTutorialDone);
+    TestEqual(TEXT("PlayerName"), Loaded->PlayerName, Source->PlayerName);
+    TestTrue(TEXT("Zone"), Loaded->Zone == Source->Zone);
+    TestEqual(TEXT("Title"), Loaded->Title.ToString(), Source->Title.ToString());
+    TestEqual(TEXT("Position"), Loaded->Position, Source->Position);
+    TestEqual(TEXT("Facing"), Loaded->Facing, Source->Facing);
+    TestTrue(TEXT("Inventory"), Loaded->Inventory == Source->Inventory);
+    TestTrue(TEXT("Quests"), Loaded->Quests == Source->Quests);
+    TestEqual(TEXT("Non-SaveGame property untouched"), Loaded->NotSaved, 11);
+
+    // A second pass through the cached layout produces the same bytes
+    TArray<uint8> Again;
+    TestTrue(TEXT("SerializeObject succeeds again"), UMotaEzObjectSerializer::SerializeObject(Loaded, Again, Error));
+    TestTrue(TEXT("Re-serialized bytes match"), Again == Bytes);
+
+    Source->MarkAsGarbage();
+    Loaded->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,255 @@
+﻿#include "MotaEzPersistentMap.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Keys tried before giving up on a full 32-bit hash collision; the birthday bound makes one likely after ~80k. */
+    constexpr int32 MaxCollisionSearch = 1 << 20;
+
+    /** Slot bits of the first trie level (FMotaEzPersistentMap uses 5 bits per level). */
+    constexpr uint32 RootSlotMask = 31;
+
+    FMotaEzValue MakeIntValue(int32 Value)
+    {
+        FMotaEzValue Result;
+        Result.Type = EMotaEzFieldType::Int;
+        Result.ScalarValue = FString::FromInt(Value);
+        return Result;
+    }
+
+    /** Sets a key to an int; the int doubles as the value hash. */
+    FMotaEzPersistentMap SetInt(const FMotaEzPersistentMap& Map, const FString& Key, int32 Value)
+    {
+        return Map.Set(Key, MakeIntValue(Value), (uint64)Value);
+    }
+
+    int32 GetInt(const FMotaEzPersistentMap& Map, const FString& Key)
+    {
+        const FMotaEzValue* Value = Map.Find(Key);
+        return Value ? FCString::Atoi(*Value->ScalarValue) : INDEX_NONE;
+    }
+
+    /** Random upper-case keys: varied enough that the key hash behaves randomly across them. */
+    FString MakeRandomKey(FRandomStream& Random)
+    {
+        static const TCHAR Alphabet[] = TEXT("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789");
+        FString Key;
+        for (int32 Index = 0; Index < 12; ++Index)
+        {
+            Key.AppendChar(Alphabet[Random.RandRange(0, (int32)UE_ARRAY_COUNT(Alphabet) - 2)]);
+        }
+        return Key;
+    }
+
+    /** Finds two different keys with the same full key hash, so they end up in a collision node. */
+    bool FindCollidingKeys(FString& OutA, FString& OutB)
+    {
+        FRandomStream Random(0x5EED);
+        TMap<uint32, FString> Seen;
+        for (int32 Attempt = 0; Attempt < MaxCollisionSearch; ++Attempt)
+        {
+            FString Key = MakeRandomKey(Random);
+            const uint32 Hash = GetTypeHash(Key);
+            if (const FString* Found = Seen.Find(Hash))
+            {
+                if (!Found->Equals(Key, ESearchCase::IgnoreCase))
+                {
+                    OutA = *Found;
+                    OutB = MoveTemp(Key);
+                    return true;
+                }
+                continue;
+            }
+            Seen.Add(Hash, MoveTemp(Key));
+        }
+        return false;
+    }
+
+    /** Finds keys whose hashes pick the same slot as the first one at the root, but differ below it. */
+    TArray<FString> FindKeysSharingRootSlot(int32 Num)
+    {
+        FRandomStream Random(0xD1FF);
+        TArray<FString> Keys;
+        Keys.Add(MakeRandomKey(Random));
+        const uint32 FirstHash = GetTypeHash(Keys[0]);
+        while (Keys.Num() < Num)
+        {
+            const FString Key = MakeRandomKey(Random);
+            const uint32 Hash = GetTypeHash(Key);
+            if ((Hash & RootSlotMask) == (FirstHash & RootSlotMask) && ((Hash >> 5) & RootSlotMask) != ((FirstHash >> 5) & RootSlotMask))
+            {
+                Keys.AddUnique(Key);
+            }
+        }
+        return Keys;
+    }
+
+    /** Diff output as sorted "+Key", "-Key" and "~Key" lines. */
+    TArray<FString> DiffLines(const FMotaEzPersistentMap& Before, const FMotaEzPersistentMap& After)
+    {
+        TArray<FString> Lines;
+        Before.Diff(After, [&Lines](const FString& Key, const FMotaEzValue* Old, const FMotaEzValue* New)
+        {
+            Lines.Add((!Old ? TEXT("+") : !New ? TEXT("-") : TEXT("~")) + Key);
+        });
+        Lines.Sort();
+        return Lines;
+    }
+
+    /** Expected diff lines, in the order DiffLines gives them. */
+    TArray<FString> Sorted(TArray<FString> Lines)
+    {
+        Lines.Sort();
+        return Lines;
+    }
+
+    /** The same lines computed by looking every key up in both maps. */
+    TArray<FString> BruteForceDiffLines(const FMotaEzPersistentMap& Before, const FMotaEzPersistentMap& After)
+    {
+        TArray<FString> Lines;
+        Before.ForEach([&Lines, &After](const FMotaEzPersistentMap::FEntry& Entry)
+        {
+            const FMotaEzPersistentMap::FEntry* Other = After.FindEntry(Entry.Key);
+            if (!Other)
+            {
+                Lines.Add(TEXT("-") + Entry.Key);
+            }
+            else if (Other->ValueHash != Entry.ValueHash)
+            {
+                Lines.Add(TEXT("~") + Entry.Key);
+            }
+        });
+        After.ForEach([&Lines, &Before](const FMotaEzPersistentMap::FEntry& Entry)
+        {
+            if (!Before.FindEntry(Entry.Key))
+            {
+                Lines.Add(TEXT("+") + Entry.Key);
+            }
+        });
+        Lines.Sort();
+        return Lines;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzPersistentMapCollisionsTest, "EzSaveGame.PersistentMap.Collisions",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzPersistentMapCollisionsTest::RunTest(const FString& Parameters)
+{
+    FString KeyA;
+    FString KeyB;
+    if (!TestTrue(TEXT("Found two keys with the same full hash"), FindCollidingKeys(KeyA, KeyB)))
+    {
+        return false;
+    }
+
+    // Both keys take the same path through every level and end up in one collision node
+    FMotaEzPersistentMap Empty;
+    const FMotaEzPersistentMap OnlyA = SetInt(Empty, KeyA, 1);
+    const FMotaEzPersistentMap Both = SetInt(OnlyA, KeyB, 2);
+    TestEqual(TEXT("Both colliding keys are counted"), Both.Num(), 2);
+    TestEqual(TEXT("First colliding key is found"), GetInt(Both, KeyA), 1);
+    TestEqual(TEXT("Second colliding key is found"), GetInt(Both, KeyB), 2);
+    TestEqual(TEXT("Lookup ignores case"), GetInt(Both, KeyB.ToLower()), 2);
+
+    const FMotaEzPersistentMap Updated = SetInt(Both, KeyA, 3);
+    TestEqual(TEXT("Updating a colliding key keeps the count"), Updated.Num(), 2);
+    TestEqual(TEXT("Updated colliding key"), GetInt(Updated, KeyA), 3);
+    TestEqual(TEXT("Other colliding key is untouched"), GetInt(Updated, KeyB), 2);
+    TestEqual(TEXT("Older version keeps its value"), GetInt(Both, KeyA), 1);
+    TestTrue(TEXT("Setting the same value returns the same version"), SetInt(Updated, KeyA, 3).IsSameVersion(Updated));
+    TestTrue(TEXT("Diff inside a collision node"), DiffLines(Both, Updated) == Sorted({ TEXT("~") + KeyA }));
+
+    // Removing one key leaves the other alone in the collision node, and the path folds back up
+    const FMotaEzPersistentMap AfterRemove = Updated.Remove(KeyA);
+    TestEqual(TEXT("Removal from a collision node"), AfterRemove.Num(), 1);
+    TestNull(TEXT("Removed colliding key is gone"), AfterRemove.Find(KeyA));
+    TestEqual(TEXT("Remaining colliding key is found"), GetInt(AfterRemove, KeyB), 2);
+    TestTrue(TEXT("Removing a missing key returns the same version"), AfterRemove.Remove(KeyA).IsSameVersion(AfterRemove));
+    TestTrue(TEXT("Folded map has the contents of a fresh one"), DiffLines(AfterRemove, SetInt(Empty, KeyB, 2)).Num() == 0);
+    TestTrue(TEXT("Diff against the collision node"), DiffLines(Updated, AfterRemove) == Sorted({ TEXT("-") + KeyA }));
+    TestTrue(TEXT("Diff from the folded map"), DiffLines(AfterRemove, Updated) == Sorted({ TEXT("+") + KeyA }));
+
+    // The folded map splits again on re-insert, and becomes empty when the last key goes
+    const FMotaEzPersistentMap Reinserted = SetInt(AfterRemove, KeyA, 4);
+    TestEqual(TEXT("Re-inserted colliding key"), GetInt(Reinserted, KeyA), 4);
+    TestEqual(TEXT("Other key after re-insert"), GetInt(Reinserted, KeyB), 2);
+    const FMotaEzPersistentMap Cleared = Reinserted.Remove(KeyB).Remove(KeyA);
+    TestEqual(TEXT("Removing every key empties the map"), Cleared.Num(), 0);
+    TestTrue(TEXT("Empty maps are the same version"), Cleared.IsSameVersion(Empty));
+
+    int32 Visited = 0;
+    Both.ForEach([&Visited](const FMotaEzPersistentMap::FEntry&) { ++Visited; });
+    TestEqual(TEXT("ForEach visits both colliding keys"), Visited, 2);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzPersistentMapDiffTest, "EzSaveGame.PersistentMap.Diff",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzPersistentMapDiffTest::RunTest(const FString& Parameters)
+{
+    // Three keys in the same root slot: one alone keeps an entry there, two split it into a subtree
+    const TArray<FString> Keys = FindKeysSharingRootSlot(3);
+    const FString& A = Keys[0];
+    const FString& B = Keys[1];
+    const FString& C = Keys[2];
+
+    const FMotaEzPersistentMap OnlyA = SetInt(FMotaEzPersistentMap(), A, 1);
+    const FMotaEzPersistentMap SplitAB = SetInt(OnlyA, B, 2);
+
+    TestTrue(TEXT("Split: added key"), DiffLines(OnlyA, SplitAB) == Sorted({ TEXT("+") + B }));
+    TestTrue(TEXT("Split, reversed: removed key"), DiffLines(SplitAB, OnlyA) == Sorted({ TEXT("-") + B }));
+
+    const FMotaEzPersistentMap SplitChanged = SetInt(SplitAB, A, 5);
+    TestTrue(TEXT("Split with the slot's key changed"), DiffLines(OnlyA, SplitChanged) == Sorted({ TEXT("+") + B, TEXT("~") + A }));
+    TestTrue(TEXT("Split with the slot's key changed, reversed"), DiffLines(SplitChanged, OnlyA) == Sorted({ TEXT("-") + B, TEXT("~") + A }));
+
+    const FMotaEzPersistentMap Replaced = SetInt(SetInt(OnlyA.Remove(A), B, 2), C, 3);
+    TestTrue(TEXT("Slot's key replaced by a subtree"), DiffLines(OnlyA, Replaced) == Sorted({ TEXT("+") + B, TEXT("+") + C, TEXT("-") + A }));
+    TestTrue(TEXT("Subtree replaced by a slot's key"), DiffLines(Replaced, OnlyA) == Sorted({ TEXT("+") + A, TEXT("-") + B, TEXT("-") + C }));
+
+    // Removing B folds A back into the root slot; the result matches the version that never split
+    const FMotaEzPersistentMap Folded = SplitAB.Remove(B);
+    TestEqual(TEXT("Folded map keeps the other key"), GetInt(Folded, A), 1);
+    TestTrue(TEXT("Folded map has no changes against the unsplit one"), DiffLines(OnlyA, Folded).Num() == 0);
+    TestTrue(TEXT("Diff of a version with itself is empty"), DiffLines(SplitAB, SplitAB).Num() == 0);
+
+    // Random versions of one map, with shared keys, collisions at the root and removals, against a brute-force diff
+    FRandomStream Random(0xD1FF);
+    TArray<FString> Pool = Keys;
+    for (int32 Index = 0; Index < 200; ++Index)
+    {
+        Pool.Add(FString::Printf(TEXT("Key_%d"), Index));
+    }
+
+    TArray<FMotaEzPersistentMap> Versions;
+    Versions.Add(FMotaEzPersistentMap());
+    for (int32 Step = 0; Step < 64; ++Step)
+    {
+        FMotaEzPersistentMap Next = Versions.Last();
+        const int32 NumOps = Random.RandRange(1, 24);
+        for (int32 Op = 0; Op < NumOps; ++Op)
+        {
+            const FString& Key = Pool[Random.RandRange(0, Pool.Num() - 1)];
+            Next = Random.RandRange(0, 3) == 0 ? Next.Remove(Key) : SetInt(Next, Key, Random.RandRange(0, 4));
+        }
+        Versions.Add(MoveTemp(Next));
+    }
+
+    for (int32 Pair = 0; Pair < 200; ++Pair)
+    {
+        const FMotaEzPersistentMap& Before = Versions[Random.RandRange(0, Versions.Num() - 1)];
+        const FMotaEzPersistentMap& After = Versions[Random.RandRange(0, Versions.Num() - 1)];
+        if (!TestTrue(*FString::Printf(TEXT("Random diff %d matches a brute-force diff"), Pair), DiffLines(Before, After) == BruteForceDiffLines(Before, After)))
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
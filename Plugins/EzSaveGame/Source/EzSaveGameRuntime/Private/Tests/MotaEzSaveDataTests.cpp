@@ -0,0 +1,239 @@
+﻿#include "MotaEzSaveData.h"
+#include "MotaEzSaveSnapshot.h"
+#include "MotaEzFormatSerializer.h"
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+#include "Math/RandomStream.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    constexpr int32 ContentionThreads = 8;
+    constexpr int32 ContentionOps = 20000;
+    constexpr int32 SharedKeys = 256;
+    constexpr int32 OwnedKeysPerThread = 64;
+
+    FString GetSharedKey(int32 Index)
+    {
+        return FString::Printf(TEXT("Shared_%d"), Index);
+    }
+
+    FString GetOwnedKey(int32 ThreadIndex, int32 Index)
+    {
+        return FString::Printf(TEXT("Owned_%d_%d"), ThreadIndex, Index);
+    }
+
+    /** Value of an owned key after the run: the last operation that wrote it. */
+    int32 GetExpectedOwnedValue(int32 Index)
+    {
+        return ContentionOps - OwnedKeysPerThread + Index;
+    }
+
+    /** Runs Body once on each of NumThreads dedicated threads and waits for all of them. */
+    void RunThreads(int32 NumThreads, TFunction<void(int32)> Body)
+    {
+        TArray<TFuture<void>> Workers;
+        for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+        {
+            Workers.Add(Async(EAsyncExecution::Thread, [&Body, ThreadIndex]() { Body(ThreadIndex); }));
+        }
+        for (TFuture<void>& Worker : Workers)
+        {
+            Worker.Wait();
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzSaveDataContentionTest, "EzSaveGame.SaveData.Contention",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzSaveDataContentionTest::RunTest(const FString& Parameters)
+{
+    // Transient object; garbage collection cannot run while the game thread waits on the workers
+    UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    SaveData->SetThreadSafe(true);
+
+    for (int32 Index = 0; Index < SharedKeys; ++Index)
+    {
+        SaveData->SetInt(GetSharedKey(Index), Index);
+    }
+
+    // Shared keys are read and overwritten by every thread; owned keys are added while the others run
+    std::atomic<int32> BadReads{0};
+    RunThreads(ContentionThreads, [SaveData, &BadReads](int32 ThreadIndex)
+    {
+        FRandomStream Random(ThreadIndex + 1);
+        for (int32 Op = 0; Op < ContentionOps; ++Op)
+        {
+            SaveData->SetInt(GetOwnedKey(ThreadIndex, Op % OwnedKeysPerThread), Op);
+
+            const FString Key = GetSharedKey(Random.RandHelper(SharedKeys));
+            if (Random.RandHelper(100) < 10)
+            {
+                SaveData->SetInt(Key, Op);
+            }
+            else
+            {
+                // Every value ever stored is an initial index or an operation number; anything else is torn
+                const int32 Value = SaveData->GetInt(Key, -1);
+                if (Value < 0 || Value >= FMath::Max(ContentionOps, SharedKeys))
+                {
+                    ++BadReads;
+                }
+            }
+        }
+    });
+
+    TestEqual(TEXT("No torn or missing reads"), BadReads.load(), 0);
+    TestEqual(TEXT("Key count"), SaveData->Data.Num(), SharedKeys + ContentionThreads * OwnedKeysPerThread);
+
+    int32 WrongOwned = 0;
+    for (int32 ThreadIndex = 0; ThreadIndex < ContentionThreads; ++ThreadIndex)
+    {
+        for (int32 Index = 0; Index < OwnedKeysPerThread; ++Index)
+        {
+            WrongOwned += SaveData->GetInt(GetOwnedKey(ThreadIndex, Index), -1) != GetExpectedOwnedValue(Index);
+        }
+    }
+    TestEqual(TEXT("Owned keys hold their last write"), WrongOwned, 0);
+
+    // The running fingerprint must still match the contents after concurrent writes
+    const uint64 RunningFingerprint = SaveData->GetFingerprint();
+    SaveData->RecomputeFingerprint();
+    TestEqual(TEXT("Running fingerprint matches the contents"), RunningFingerprint, SaveData->GetFingerprint());
+
+    // Lock-free readers see the same contents
+    const TSharedRef<FMotaEzSnapshotChannel, ESPMode::ThreadSafe> Channel = SaveData->GetSnapshotChannel();
+    std::atomic<int32> WrongSnapshots{0};
+    RunThreads(ContentionThreads, [&Channel, &WrongSnapshots, Fingerprint = SaveData->GetFingerprint()](int32 ThreadIndex)
+    {
+        FMotaEzSnapshotReadScope Snapshot(*Channel);
+        if (Snapshot->Fingerprint != Fingerprint)
+        {
+            ++WrongSnapshots;
+        }
+        for (int32 Index = 0; Index < OwnedKeysPerThread; ++Index)
+        {
+            if (Snapshot->GetInt(GetOwnedKey(ThreadIndex, Index), -1) != GetExpectedOwnedValue(Index))
+            {
+                ++WrongSnapshots;
+            }
+        }
+    });
+    TestEqual(TEXT("Snapshots match the contents"), WrongSnapshots.load(), 0);
+
+    SaveData->MarkAsGarbage();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzSaveDataConcurrentEditsTest, "EzSaveGame.SaveData.ConcurrentEdits",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzSaveDataConcurrentEditsTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 EditsPerThread = 500;
+
+    UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    SaveData->SetThreadSafe(true);
+    SaveData->SetInt(TEXT("Counter"), 0);
+
+    // Edits from different threads take turns, so each read-modify-write sees the previous commit
+    std::atomic<int32> FailedCommits{0};
+    RunThreads(ContentionThreads, [SaveData, &FailedCommits](int32 ThreadIndex)
+    {
+        for (int32 Edit = 0; Edit < EditsPerThread; ++Edit)
+        {
+            FMotaEzEditScope Outer(SaveData);
+            SaveData->SetInt(TEXT("Counter"), SaveData->GetInt(TEXT("Counter")) + 1);
+            {
+                // A nested scope on the same thread joins the open edit
+                FMotaEzEditScope Inner(SaveData);
+                SaveData->SetInt(GetOwnedKey(ThreadIndex, 0), Edit);
+                Inner.Commit();
+            }
+            if (!Outer.Commit())
+            {
+                ++FailedCommits;
+            }
+        }
+    });
+
+    TestEqual(TEXT("Every edit committed"), FailedCommits.load(), 0);
+    TestEqual(TEXT("No increment was lost"), SaveData->GetInt(TEXT("Counter")), ContentionThreads * EditsPerThread);
+    TestFalse(TEXT("No edit left open"), SaveData->IsEditing());
+    for (int32 ThreadIndex = 0; ThreadIndex < ContentionThreads; ++ThreadIndex)
+    {
+        TestEqual(TEXT("Nested writes committed"), SaveData->GetInt(GetOwnedKey(ThreadIndex, 0), -1), EditsPerThread - 1);
+    }
+
+    SaveData->MarkAsGarbage();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzSaveDataArrayOverwriteTest, "EzSaveGame.SaveData.ArrayOverwrite",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzSaveDataArrayOverwriteTest::RunTest(const FString& Parameters)
+{
+    UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+
+    // Array to scalar, scalar to array, and array to scalar inside an edit
+    SaveData->SetInt64Array(TEXT("Big"), { 1, 2, 3 });
+    SaveData->SetInt64(TEXT("Big"), 5);
+    SaveData->SetInt(TEXT("Small"), 3);
+    SaveData->SetIntArray(TEXT("Small"), { 4, 5 });
+    SaveData->SetDoubleArray(TEXT("Real"), { 0.5, 1.5 });
+    {
+        FMotaEzEditScope Edit(SaveData);
+        SaveData->SetDouble(TEXT("Real"), 2.5);
+        TestTrue(TEXT("Edit commits"), Edit.Commit());
+    }
+
+    auto CheckValues = [this](const TCHAR* Stage, const UMotaEzSaveData* Data)
+    {
+        TestEqual(*FString::Printf(TEXT("%s: Int64 scalar after array"), Stage), Data->GetInt64(TEXT("Big"), -1), (int64)5);
+        TestTrue(*FString::Printf(TEXT("%s: Int array after scalar"), Stage), Data->GetIntArray(TEXT("Small")) == TArray<int32>({ 4, 5 }));
+        TestEqual(*FString::Printf(TEXT("%s: Double scalar after array in an edit"), Stage), Data->GetDouble(TEXT("Real"), -1.0), 2.5);
+    };
+
+    CheckValues(TEXT("Memory"), SaveData);
+    TestFalse(TEXT("Scalar setter clears the array flag"), SaveData->Data.FindChecked(TEXT("Big")).IsArray());
+    TestTrue(TEXT("Array setter sets the array flag"), SaveData->Data.FindChecked(TEXT("Small")).IsArray());
+
+    // Text formats and the binary archive both write by the array flag
+    FString Text;
+    FString Error;
+    TMap<FString, FMotaEzValue> FromText;
+    if (TestTrue(TEXT("SaveConfig succeeds"), UMotaEzFormatSerializer::SaveConfig(EMotaEzConfigFormat::Json, SaveData->Data, Text, Error))
+        && TestTrue(TEXT("LoadConfig succeeds"), UMotaEzFormatSerializer::LoadConfig(EMotaEzConfigFormat::Json, Text, FromText, Error)))
+    {
+        UMotaEzSaveData* Loaded = NewObject<UMotaEzSaveData>(GetTransientPackage());
+        Loaded->ReplaceData(MoveTemp(FromText));
+        CheckValues(TEXT("Json"), Loaded);
+        Loaded->MarkAsGarbage();
+    }
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    Writer << SaveData->Data;
+
+    TMap<FString, FMotaEzValue> FromBytes;
+    FMemoryReader Reader(Bytes);
+    Reader << FromBytes;
+    if (TestFalse(TEXT("Binary archive reads back"), Reader.IsError()))
+    {
+        UMotaEzSaveData* Loaded = NewObject<UMotaEzSaveData>(GetTransientPackage());
+        Loaded->ReplaceData(MoveTemp(FromBytes));
+        CheckValues(TEXT("Binary"), Loaded);
+        Loaded->MarkAsGarbage();
+    }
+
+    SaveData->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
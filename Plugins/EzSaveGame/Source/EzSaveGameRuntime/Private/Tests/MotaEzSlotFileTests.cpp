@@ -0,0 +1,112 @@
+﻿#include "MotaEzSlotFile.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Several stream chunks plus an odd tail, so chunk boundaries are crossed. */
+    TArray<uint8> MakeTestPayload()
+    {
+        TArray<uint8> Bytes;
+        Bytes.SetNumUninitialized(3 * UMotaEzSlotFile::StreamChunkSize + 1237);
+        FRandomStream Random(0x5A17);
+        for (uint8& Byte : Bytes)
+        {
+            Byte = (uint8)Random.RandRange(0, 255);
+        }
+        return Bytes;
+    }
+
+    FString GetTestDirectory()
+    {
+        return FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("EzSaveGame"), TEXT("SlotFile"));
+    }
+
+    /** Clones Source to Dest and checks that both files hold the same bytes. */
+    bool CloneAndCompare(FAutomationTestBase& Test, const FString& Source, const FString& Dest)
+    {
+        FString Error;
+        if (!Test.TestTrue(TEXT("CloneFile succeeds"), UMotaEzSlotFile::CloneFile(Dest, Source, Error)))
+        {
+            Test.AddError(Error);
+            return false;
+        }
+
+        TArray<uint8> SourceBytes;
+        TArray<uint8> DestBytes;
+        Test.TestTrue(TEXT("Source readable"), FFileHelper::LoadFileToArray(SourceBytes, *Source));
+        Test.TestTrue(TEXT("Clone readable"), FFileHelper::LoadFileToArray(DestBytes, *Dest));
+        Test.TestFalse(TEXT("No temporary file left"), IFileManager::Get().FileExists(*(Dest + TEXT(".tmp"))));
+        return Test.TestTrue(TEXT("Clone is byte-identical"), SourceBytes == DestBytes);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzSlotFileRoundTripTest, "EzSaveGame.SlotFile.RoundTrip",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzSlotFileRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Path = FPaths::Combine(GetTestDirectory(), TEXT("RoundTrip.bin"));
+    const TArray<uint8> Payload = MakeTestPayload();
+
+    FString Error;
+    FMotaEzSlotFileHeader Written;
+    if (!TestTrue(TEXT("WriteBytes succeeds"), UMotaEzSlotFile::WriteBytes(Path, Payload, Error, &Written)))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    TArray<uint8> Read;
+    FMotaEzSlotFileHeader Header;
+    TestTrue(TEXT("ReadBytes succeeds"), UMotaEzSlotFile::ReadBytes(Path, Read, Error, &Header));
+    TestEqual(TEXT("Payload length"), Read.Num(), Payload.Num());
+    TestTrue(TEXT("Payload round-trips"), Read == Payload);
+    TestEqual(TEXT("Header size"), Header.HeaderSize, Written.HeaderSize);
+
+    IFileManager::Get().DeleteDirectory(*GetTestDirectory(), false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzSlotFileCloneTest, "EzSaveGame.SlotFile.Clone",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzSlotFileCloneTest::RunTest(const FString& Parameters)
+{
+    const FString Source = FPaths::Combine(GetTestDirectory(), TEXT("Source.bin"));
+    FString Error;
+    if (!TestTrue(TEXT("WriteBytes succeeds"), UMotaEzSlotFile::WriteBytes(Source, MakeTestPayload(), Error)))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    IConsoleVariable* ForceStreamed = IConsoleManager::Get().FindConsoleVariable(TEXT("EzSave.ForceStreamedCopy"));
+    if (!TestNotNull(TEXT("EzSave.ForceStreamedCopy exists"), ForceStreamed))
+    {
+        return false;
+    }
+    const bool bWasForced = ForceStreamed->GetBool();
+
+    // Platform path (reflink or copy_file_range on Linux), then the streamed fallback
+    ForceStreamed->Set(false, ECVF_SetByCode);
+    CloneAndCompare(*this, Source, FPaths::Combine(GetTestDirectory(), TEXT("Cloned.bin")));
+
+    ForceStreamed->Set(true, ECVF_SetByCode);
+    CloneAndCompare(*this, Source, FPaths::Combine(GetTestDirectory(), TEXT("Streamed.bin")));
+
+    // Replacing an existing destination goes through the same temporary file and move
+    CloneAndCompare(*this, Source, FPaths::Combine(GetTestDirectory(), TEXT("Streamed.bin")));
+
+    ForceStreamed->Set(bWasForced, ECVF_SetByCode);
+
+    IFileManager::Get().DeleteDirectory(*GetTestDirectory(), false, true);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,93 @@
+﻿#include "MotaEzSlotHistory.h"
+#include "MotaEzSlotManager.h"
+#include "MotaEzSlotFile.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Far above any slot a game uses; the test deletes it and its history before and after. */
+    constexpr int32 HistoryTestSlot = 9044;
+
+    void DeleteTestSlot()
+    {
+        UMotaEzSlotManager::DeleteSlot(HistoryTestSlot);
+        UMotaEzSlotHistory::DeleteSlotHistory(HistoryTestSlot);
+    }
+
+    bool WriteBlock(FAutomationTestBase& Test, const FString& Section, const FString& Text)
+    {
+        FString Error;
+        const bool bWritten = UMotaEzSlotFile::WriteText(UMotaEzSlotManager::GetSlotSectionPath(HistoryTestSlot, Section), EMotaEzConfigFormat::Json, Text, Error);
+        if (!bWritten)
+        {
+            Test.AddError(Error);
+        }
+        return bWritten;
+    }
+
+    FString ReadBlock(const FString& Section)
+    {
+        FString Text;
+        FString Error;
+        UMotaEzSlotFile::ReadText(UMotaEzSlotManager::GetSlotSectionPath(HistoryTestSlot, Section), Text, Error);
+        return Text;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzSlotHistorySectionsTest, "EzSaveGame.SlotHistory.Sections",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzSlotHistorySectionsTest::RunTest(const FString& Parameters)
+{
+    DeleteTestSlot();
+
+    const FString Root = TEXT("{ \"Gold\": 10 }");
+    const FString Forest = TEXT("{ \"Forest/Chests\": 3 }");
+    if (!WriteBlock(*this, FString(), Root) || !WriteBlock(*this, TEXT("Forest"), Forest))
+    {
+        DeleteTestSlot();
+        return false;
+    }
+
+    FString Error;
+    if (!TestTrue(TEXT("SnapshotSlot succeeds"), UMotaEzSlotHistory::SnapshotSlot(HistoryTestSlot, Error)))
+    {
+        AddError(Error);
+        DeleteTestSlot();
+        return false;
+    }
+
+    const TArray<FMotaEzSlotVersionInfo> Versions = UMotaEzSlotHistory::GetSlotVersions(HistoryTestSlot);
+    if (!TestEqual(TEXT("One version recorded"), Versions.Num(), 1))
+    {
+        DeleteTestSlot();
+        return false;
+    }
+    TestEqual(TEXT("Version size covers every block"), Versions[0].Size, (int64)(FTCHARToUTF8(*Root).Length() + FTCHARToUTF8(*Forest).Length()));
+
+    // Change the root, drop the recorded section and add one the version never had
+    WriteBlock(*this, FString(), TEXT("{ \"Gold\": 99 }"));
+    WriteBlock(*this, TEXT("Desert"), TEXT("{ \"Desert/Wells\": 1 }"));
+    IFileManager::Get().Delete(*UMotaEzSlotManager::GetSlotSectionPath(HistoryTestSlot, TEXT("Forest")));
+
+    if (!TestTrue(TEXT("RestoreSlotVersion succeeds"), UMotaEzSlotHistory::RestoreSlotVersion(HistoryTestSlot, Versions[0].Version, Error)))
+    {
+        AddError(Error);
+    }
+
+    TestEqual(TEXT("Root block restored"), ReadBlock(FString()), Root);
+    TestEqual(TEXT("Section block restored"), ReadBlock(TEXT("Forest")), Forest);
+
+    TArray<FString> Sections = UMotaEzSlotManager::GetSlotSectionNames(HistoryTestSlot);
+    Sections.Sort();
+    TestTrue(TEXT("Only the recorded sections remain"), Sections == TArray<FString>({ TEXT("Forest") }));
+
+    DeleteTestSlot();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,139 @@
+﻿#include "MotaEzStructCodec.h"
+#include "MotaEzSaveData.h"
+#include "MotaEzFormatSerializer.h"
+#include "MotaEzTestTypes.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    TArray<FMotaEzTestRecord> MakeTestRecords()
+    {
+        TArray<FMotaEzTestRecord> Records;
+        for (int32 Index = 0; Index < 3; ++Index)
+        {
+            FMotaEzTestRecord& Record = Records.AddDefaulted_GetRef();
+            Record.Id = 100 + Index;
+            Record.Weight = 0.25f * (Index + 1);
+            Record.bActive = Index != 1;
+            Record.Position = FVector((double)Index, -2.5 * Index, 64.0);
+            Record.Label = Index == 2 ? FString() : FString::Printf(TEXT("Record %d ñ"), Index);
+            Record.Tag = *FString::Printf(TEXT("Tag_%d"), Index);
+            for (int32 Count = 0; Count < Index * 2; ++Count)
+            {
+                Record.Counts.Add(Count * 7 - 3);
+            }
+        }
+        return Records;
+    }
+
+    /** Compares member by member through reflection, the way the codec sees the struct. */
+    bool RecordsMatch(const TArray<FMotaEzTestRecord>& A, const TArray<FMotaEzTestRecord>& B)
+    {
+        if (A.Num() != B.Num())
+        {
+            return false;
+        }
+        for (int32 Index = 0; Index < A.Num(); ++Index)
+        {
+            if (!FMotaEzTestRecord::StaticStruct()->CompareScriptStruct(&A[Index], &B[Index], PPF_None))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzStructCodecRecordsTest, "EzSaveGame.StructCodec.Records",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzStructCodecRecordsTest::RunTest(const FString& Parameters)
+{
+    const UScriptStruct* Struct = FMotaEzTestRecord::StaticStruct();
+    const TArray<FMotaEzTestRecord> Records = MakeTestRecords();
+
+    TestEqual(TEXT("Codec covers every member"), UMotaEzStructCodec::GetMemberCount(Struct), 7);
+
+    TArray<uint8> Packed;
+    if (!TestTrue(TEXT("PackRecords succeeds"), UMotaEzStructCodec::PackRecords(Struct, Records.GetData(), Records.Num(), Packed)))
+    {
+        return false;
+    }
+
+    TArray<FMotaEzTestRecord> Unpacked;
+    FString Error;
+    TestTrue(TEXT("UnpackRecords succeeds"), UMotaEzStructCodec::UnpackRecords(Struct, Packed, [&Unpacked](int32 Num)
+    {
+        Unpacked.SetNum(Num);
+        return (void*)Unpacked.GetData();
+    }, Error));
+    TestTrue(TEXT("Records round-trip"), RecordsMatch(Unpacked, Records));
+
+    // Through a save data object, as scalar and as array
+    UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    SaveData->SetStruct(TEXT("Single"), Records[0]);
+    SaveData->SetStructArray(TEXT("Records"), Records);
+
+    FMotaEzTestRecord Single;
+    TestTrue(TEXT("GetStruct succeeds"), SaveData->GetStruct(TEXT("Single"), Single));
+    TestTrue(TEXT("Scalar round-trips"), RecordsMatch({ Single }, { Records[0] }));
+
+    TArray<FMotaEzTestRecord> Stored;
+    TestTrue(TEXT("GetStructArray succeeds"), SaveData->GetStructArray(TEXT("Records"), Stored));
+    TestTrue(TEXT("Array round-trips"), RecordsMatch(Stored, Records));
+
+    SaveData->MarkAsGarbage();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzStructCodecTextFormatsTest, "EzSaveGame.StructCodec.TextFormats",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzStructCodecTextFormatsTest::RunTest(const FString& Parameters)
+{
+    const TArray<FMotaEzTestRecord> Records = MakeTestRecords();
+
+    UMotaEzSaveData* Source = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    Source->SetStruct(TEXT("Single"), Records[1]);
+    Source->SetStructArray(TEXT("Records"), Records);
+
+    const EMotaEzConfigFormat Formats[] = { EMotaEzConfigFormat::Toml, EMotaEzConfigFormat::Json, EMotaEzConfigFormat::Yaml, EMotaEzConfigFormat::Xml };
+    for (EMotaEzConfigFormat Format : Formats)
+    {
+        const FString FormatName = StaticEnum<EMotaEzConfigFormat>()->GetNameStringByValue((int64)Format);
+
+        FString Text;
+        FString Error;
+        if (!TestTrue(*FString::Printf(TEXT("%s: SaveConfig succeeds"), *FormatName), UMotaEzFormatSerializer::SaveConfig(Format, Source->Data, Text, Error)))
+        {
+            AddError(Error);
+            continue;
+        }
+
+        TMap<FString, FMotaEzValue> Loaded;
+        if (!TestTrue(*FString::Printf(TEXT("%s: LoadConfig succeeds"), *FormatName), UMotaEzFormatSerializer::LoadConfig(Format, Text, Loaded, Error)))
+        {
+            AddError(Error);
+            continue;
+        }
+
+        UMotaEzSaveData* Target = NewObject<UMotaEzSaveData>(GetTransientPackage());
+        Target->ReplaceData(MoveTemp(Loaded));
+
+        FMotaEzTestRecord Single;
+        TArray<FMotaEzTestRecord> Stored;
+        TestTrue(*FString::Printf(TEXT("%s: scalar round-trips"), *FormatName),
+            Target->GetStruct(TEXT("Single"), Single) && RecordsMatch({ Single }, { Records[1] }));
+        TestTrue(*FString::Printf(TEXT("%s: array round-trips"), *FormatName),
+            Target->GetStructArray(TEXT("Records"), Stored) && RecordsMatch(Stored, Records));
+
+        Target->MarkAsGarbage();
+    }
+
+    Source->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "MotaEzTestTypes.generated.h"
+
+/**
+ * Struct used by the EzSaveGame struct codec tests: plain data, a nested struct, strings and an array,
+ * so records mix merged copies with per-member steps.
+ */
+USTRUCT()
+struct FMotaEzTestRecord
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = 0;
+
+    UPROPERTY()
+    float Weight = 0.f;
+
+    UPROPERTY()
+    bool bActive = false;
+
+    UPROPERTY()
+    FVector Position = FVector::ZeroVector;
+
+    UPROPERTY()
+    FString Label;
+
+    UPROPERTY()
+    FName Tag;
+
+    UPROPERTY()
+    TArray<int32> Counts;
+};
+
+/**
+ * Save object used by the EzSaveGame automation tests.
+ * One SaveGame property per type the object serializer supports, plus one it must leave alone.
+ */
+UCLASS(Transient, HideDropdown)
+class UMotaEzTestSaveGame : public USaveGame
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(SaveGame)
+    int32 Level = 0;
+
+    UPROPERTY(SaveGame)
+    int64 Experience = 0;
+
+    UPROPERTY(SaveGame)
+    float Health = 0.f;
+
+    UPROPERTY(SaveGame)
+    double Gold = 0.0;
+
+    UPROPERTY(SaveGame)
+    uint8 Difficulty = 0;
+
+    UPROPERTY(SaveGame)
+    bool bTutorialDone = false;
+
+    UPROPERTY(SaveGame)
+    FString PlayerName;
+
+    UPROPERTY(SaveGame)
+    FName Zone;
+
+    UPROPERTY(SaveGame)
+    FText Title;
+
+    UPROPERTY(SaveGame)
+    FVector Position = FVector::ZeroVector;
+
+    UPROPERTY(SaveGame)
+    FRotator Facing = FRotator::ZeroRotator;
+
+    UPROPERTY(SaveGame)
+    TArray<int32> Inventory;
+
+    UPROPERTY(SaveGame)
+    TArray<FString> Quests;
+
+    /** Not a SaveGame property; serialization must not touch it. */
+    UPROPERTY()
+    int32 NotSaved = 0;
+};
@@ -0,0 +1,150 @@
+﻿#include "MotaEzSaveData.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Diff of two checkpoints as sorted "+Key", "-Key" and "~Key" lines. */
+    TArray<FString> DiffLines(const UMotaEzSaveData* SaveData, int32 FromId, int32 ToId)
+    {
+        TArray<FMotaEzKeyChange> Changes;
+        TArray<FString> Lines;
+        if (!SaveData->DiffCheckpoints(FromId, ToId, Changes))
+        {
+            Lines.Add(TEXT("<not kept>"));
+            return Lines;
+        }
+        for (const FMotaEzKeyChange& Change : Changes)
+        {
+            const TCHAR* Prefix = Change.Change == EMotaEzKeyChangeType::Added ? TEXT("+") : Change.Change == EMotaEzKeyChangeType::Removed ? TEXT("-") : TEXT("~");
+            Lines.Add(Prefix + Change.Key);
+        }
+        return Lines;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzUndoHistoryStepsTest, "EzSaveGame.UndoHistory.Steps",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzUndoHistoryStepsTest::RunTest(const FString& Parameters)
+{
+    UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    SaveData->SetInt(TEXT("Gold"), 1);
+    SaveData->SetInt(TEXT("Level"), 7);
+
+    SaveData->EnableUndoHistory(8);
+    const int32 Initial = SaveData->GetCurrentCheckpoint();
+    TestFalse(TEXT("Nothing to undo after enabling"), SaveData->CanUndo());
+
+    SaveData->SetInt(TEXT("Gold"), 2);
+    SaveData->SetString(TEXT("Item"), TEXT("Sword"));
+    const int32 First = SaveData->Checkpoint(TEXT("First"));
+
+    SaveData->SetInt(TEXT("Gold"), 3);
+    SaveData->RemoveKey(TEXT("Item"));
+    const int32 Second = SaveData->Checkpoint(TEXT("Second"));
+
+    TestEqual(TEXT("Checkpoint without changes keeps the current one"), SaveData->Checkpoint(TEXT("Same")), Second);
+    SaveData->SetInt(TEXT("Gold"), 3);
+    TestEqual(TEXT("Rewriting a value it already had makes no step"), SaveData->Checkpoint(TEXT("Rewrite")), Second);
+
+    TestTrue(TEXT("Diff of the first step"), DiffLines(SaveData, Initial, First) == TArray<FString>({ TEXT("~Gold"), TEXT("+Item") }));
+    TestTrue(TEXT("Diff of the second step"), DiffLines(SaveData, First, Second) == TArray<FString>({ TEXT("~Gold"), TEXT("-Item") }));
+    TestTrue(TEXT("Diff across both steps"), DiffLines(SaveData, Initial, Second) == TArray<FString>({ TEXT("~Gold") }));
+
+    // Undo and Redo walk the checkpoints one at a time
+    TestTrue(TEXT("Undo to the first checkpoint"), SaveData->Undo());
+    TestEqual(TEXT("Undo: current checkpoint"), SaveData->GetCurrentCheckpoint(), First);
+    TestEqual(TEXT("Undo: Gold"), SaveData->GetInt(TEXT("Gold")), 2);
+    TestEqual(TEXT("Undo: removed key comes back"), SaveData->GetString(TEXT("Item")), FString(TEXT("Sword")));
+    TestTrue(TEXT("Redo is available after Undo"), SaveData->CanRedo());
+
+    TestTrue(TEXT("Undo to the initial checkpoint"), SaveData->Undo());
+    TestEqual(TEXT("Undo: Gold back to the start"), SaveData->GetInt(TEXT("Gold")), 1);
+    TestFalse(TEXT("Undo: added key is gone"), SaveData->Data.Contains(TEXT("Item")));
+    TestEqual(TEXT("Untouched key keeps its value"), SaveData->GetInt(TEXT("Level")), 7);
+    TestFalse(TEXT("Nothing before the initial checkpoint"), SaveData->CanUndo());
+    TestFalse(TEXT("Undo at the oldest checkpoint fails"), SaveData->Undo());
+
+    TestTrue(TEXT("Redo to the first checkpoint"), SaveData->Redo());
+    TestEqual(TEXT("Redo: Gold"), SaveData->GetInt(TEXT("Gold")), 2);
+    TestTrue(TEXT("Redo to the second checkpoint"), SaveData->Redo());
+    TestEqual(TEXT("Redo: Gold"), SaveData->GetInt(TEXT("Gold")), 3);
+    TestFalse(TEXT("Redo: removed key is gone again"), SaveData->Data.Contains(TEXT("Item")));
+    TestFalse(TEXT("Redo at the newest checkpoint fails"), SaveData->Redo());
+
+    // RestoreCheckpoint jumps over several steps in either direction
+    TestTrue(TEXT("Restore the initial checkpoint"), SaveData->RestoreCheckpoint(Initial));
+    TestEqual(TEXT("Restore: Gold"), SaveData->GetInt(TEXT("Gold")), 1);
+    TestTrue(TEXT("Restore the second checkpoint"), SaveData->RestoreCheckpoint(Second));
+    TestEqual(TEXT("Restore: Gold"), SaveData->GetInt(TEXT("Gold")), 3);
+    TestFalse(TEXT("Restore an unknown checkpoint"), SaveData->RestoreCheckpoint(Second + 100));
+
+    // Uncommitted changes are checkpointed first, so Undo drops them and Redo brings them back
+    SaveData->SetInt(TEXT("Gold"), 4);
+    TestTrue(TEXT("Pending changes can be undone"), SaveData->CanUndo());
+    TestFalse(TEXT("Pending changes hide the redo steps"), SaveData->CanRedo());
+    TestTrue(TEXT("Undo pending changes"), SaveData->Undo());
+    TestEqual(TEXT("Undo pending: Gold"), SaveData->GetInt(TEXT("Gold")), 3);
+    TestEqual(TEXT("Undo pending: back at the second checkpoint"), SaveData->GetCurrentCheckpoint(), Second);
+    TestTrue(TEXT("Redo pending changes"), SaveData->Redo());
+    TestEqual(TEXT("Redo pending: Gold"), SaveData->GetInt(TEXT("Gold")), 4);
+
+    SaveData->DisableUndoHistory();
+    TestEqual(TEXT("Disabled history has no checkpoint"), SaveData->GetCurrentCheckpoint(), (int32)INDEX_NONE);
+    TestFalse(TEXT("Undo without history fails"), SaveData->Undo());
+
+    SaveData->MarkAsGarbage();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMotaEzUndoHistoryRingTest, "EzSaveGame.UndoHistory.Ring",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMotaEzUndoHistoryRingTest::RunTest(const FString& Parameters)
+{
+    UMotaEzSaveData* SaveData = NewObject<UMotaEzSaveData>(GetTransientPackage());
+    SaveData->SetInt(TEXT("Counter"), 0);
+    SaveData->EnableUndoHistory(3);
+    const int32 Initial = SaveData->GetCurrentCheckpoint();
+
+    // Five checkpoints into a ring of three: the initial one and the two oldest are dropped
+    TArray<int32> Ids;
+    for (int32 Value = 1; Value <= 5; ++Value)
+    {
+        SaveData->SetInt(TEXT("Counter"), Value);
+        Ids.Add(SaveData->Checkpoint(FString::Printf(TEXT("Counter %d"), Value)));
+    }
+
+    TestFalse(TEXT("Initial checkpoint was dropped"), SaveData->RestoreCheckpoint(Initial));
+    TestFalse(TEXT("Oldest checkpoint was dropped"), SaveData->RestoreCheckpoint(Ids[0]));
+    TestFalse(TEXT("Second oldest checkpoint was dropped"), SaveData->RestoreCheckpoint(Ids[1]));
+    TestEqual(TEXT("Failed restores leave the data alone"), SaveData->GetInt(TEXT("Counter")), 5);
+
+    TestTrue(TEXT("Undo within the ring"), SaveData->Undo());
+    TestTrue(TEXT("Undo to the oldest kept checkpoint"), SaveData->Undo());
+    TestEqual(TEXT("Oldest kept value"), SaveData->GetInt(TEXT("Counter")), 3);
+    TestEqual(TEXT("Oldest kept checkpoint"), SaveData->GetCurrentCheckpoint(), Ids[2]);
+    TestFalse(TEXT("No undo past the oldest kept checkpoint"), SaveData->Undo());
+
+    // A new checkpoint after undoing drops the redo steps
+    SaveData->SetInt(TEXT("Counter"), 10);
+    const int32 Branch = SaveData->Checkpoint(TEXT("Branch"));
+    TestFalse(TEXT("No redo after a new checkpoint"), SaveData->CanRedo());
+    TestFalse(TEXT("Dropped redo step cannot be restored"), SaveData->RestoreCheckpoint(Ids[3]));
+    TArray<FMotaEzKeyChange> Changes;
+    TestFalse(TEXT("Dropped redo step cannot be diffed"), SaveData->DiffCheckpoints(Ids[2], Ids[4], Changes));
+    TestTrue(TEXT("Diff to the new branch"), DiffLines(SaveData, Ids[2], Branch) == TArray<FString>({ TEXT("~Counter") }));
+
+    TestTrue(TEXT("Undo the branch"), SaveData->Undo());
+    TestEqual(TEXT("Undo the branch: Counter"), SaveData->GetInt(TEXT("Counter")), 3);
+    TestTrue(TEXT("Redo the branch"), SaveData->Redo());
+    TestEqual(TEXT("Redo the branch: Counter"), SaveData->GetInt(TEXT("Counter")), 10);
+    TestFalse(TEXT("Nothing after the branch"), SaveData->Redo());
+
+    SaveData->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,18 +4,43 @@
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "MotaEzTypes.h"
 #include "MotaEzFormatSerializer.h"
+#include "MotaEzSchemaCache.h"
+#include "Tasks/Task.h"
+#include "Containers/Ticker.h"
+#include <atomic>
 #include "MotaEzConfigSubsystem.generated.h"
 
 class UMotaEzSaveData;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMotaEzOnReady);
+
+/** Schema parsed on a worker task during initialization. */
+struct FMotaEzSchemaLoadResult
+{
+    FMotaEzCompiledSchema Schema;
+    FString Error;
+    bool bSuccess = false;
+};
+
+/** Raw config parsed on a worker task during initialization. */
+struct FMotaEzConfigLoadResult
+{
+    TMap<FString, FMotaEzValue> RawConfig;
+    FString Error;
+    bool bSuccess = false;
+};
+
 /**
  * Game instance subsystem responsible for loading and saving EzSaveGame configuration.
  * 
  * Features:
  * - Reads schema and config from human-readable formats (TOML/JSON/YAML/XML)
- * - Merges with defaults into UMotaEzSaveData
+ * - Layers the config over the shared schema defaults in UMotaEzSaveData
  * - Exposes current save data to the game
  * - Handles automatic initialization on game start
+ * - Keeps one resident document per loaded slot, so switching slots is a pointer change
+ * - Loads schema and config in parallel on worker tasks so startup is not blocked
+ * - Parses the text schema only when it changes (binary schema cache, baked at cook time)
  */
 UCLASS()
 class EZSAVEGAMERUNTIME_API UMotaEzConfigSubsystem : public UGameInstanceSubsystem
@@ -30,10 +55,71 @@ public:
 
     /**
      * Gets the current save data object.
+     * Blocks until the background load finishes if it is still running. On the game thread this also
+     * merges the result and broadcasts OnReady; other threads only wait for the worker tasks, so they
+     * may still see defaults until the game thread completes the load.
      * @return Pointer to current save data, never null after initialization
      */
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
-    UMotaEzSaveData* GetCurrentSave() const { return CurrentSave; }
+    UMotaEzSaveData* GetCurrentSave() const;
+
+    /**
+     * Gets the resident document of a slot, reading the slot file only on first access.
+     * Use UMotaEzSlotManager::LoadFromSlot to discard its changes and re-read the file.
+     * Documents of different slots stay in memory side by side, each with its own dirty state,
+     * so code that works on a fixed slot does not disturb the current save.
+     * @param SlotIndex - Slot the document belongs to
+     * @return Document for the slot (empty if the slot has no file yet)
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    UMotaEzSaveData* GetDocument(int32 SlotIndex);
+
+    /**
+     * Checks whether a slot's document is in memory.
+     * @param SlotIndex - Slot to check
+     * @return true if the document is resident
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame")
+    bool IsDocumentResident(int32 SlotIndex) const { return Documents.Contains(SlotIndex); }
+
+    /**
+     * Drops a slot's document from memory. Unsaved changes in it are lost.
+     * The current save stays valid even if it was this document.
+     * @param SlotIndex - Slot whose document to release
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void ReleaseDocument(int32 SlotIndex);
+
+    /**
+     * Finds a resident document without reading anything from disk.
+     * @param SlotIndex - Slot the document belongs to
+     * @return Document or nullptr if not resident
+     */
+    UMotaEzSaveData* FindDocument(int32 SlotIndex) const;
+
+    /**
+     * Gets a slot's resident document, creating an empty one over the schema defaults if needed.
+     * @param SlotIndex - Slot the document belongs to
+     * @return Resident document, never null
+     */
+    UMotaEzSaveData* FindOrAddDocument(int32 SlotIndex);
+
+    /**
+     * Makes a document the current save used by the EzGet/EzSet functions, SaveToDisk and SaveToSlot.
+     * @param SaveData - Document to make current
+     */
+    void SetCurrentSave(UMotaEzSaveData* SaveData);
+
+    /**
+     * Checks whether the initial background load has finished.
+     * @return true if save data is loaded and can be accessed without blocking
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame")
+    bool IsReady() const { return bIsReady.load(); }
+
+    /** Broadcast on the game thread once the initial background load has finished. */
+    UPROPERTY(BlueprintAssignable, Category="EzSaveGame")
+    FMotaEzOnReady OnReady;
 
     /**
      * Forces reload of all data from disk.
@@ -54,17 +140,47 @@ private:
     UPROPERTY()
     TObjectPtr<UMotaEzSaveData> CurrentSave;
 
+    /** Per-slot documents kept in memory; CurrentSave usually points at one of them. */
+    UPROPERTY()
+    TMap<int32, TObjectPtr<UMotaEzSaveData>> Documents;
+
+    /** Schema defaults shared as the defaults layer of every document. */
+    TSharedPtr<const TMap<FString, FMotaEzValue>> SchemaDefaults;
+
+    /** Schema descriptors shared with every document so edits are validated at commit. */
+    TSharedPtr<const FMotaEzSaveSchema> SchemaRules;
+
+    /** Write fingerprint (content, format and encryption) of CurrentSave at the last successful SaveInternal. */
+    TOptional<uint64> LastSavedFingerprint;
+
+    /** Starts parsing schema and config on worker tasks. */
+    void StartBackgroundLoad();
+
+    /** Waits for the worker tasks if needed, builds the save data and broadcasts OnReady. Game thread only. */
+    void CompleteBackgroundLoad();
+
+    UE::Tasks::TTask<FMotaEzSchemaLoadResult> SchemaTask;
+    UE::Tasks::TTask<FMotaEzConfigLoadResult> ConfigTask;
+    FTSTicker::FDelegateHandle ReadyTickerHandle;
+    std::atomic<bool> bIsReady = false;
+
+    /** Prefetches the preload manifests of a map that is about to load. */
+    void HandlePreLoadMap(const FString& MapName);
+    FDelegateHandle PreLoadMapHandle;
+
     bool LoadInternal(FString& OutError);
     bool SaveInternal(FString& OutError);
 
-    bool LoadTextFile(const FString& FilePath, FString& OutText, FString& OutError) const;
-    bool SaveTextFile(const FString& FilePath, const FString& Text, FString& OutError) const;
+    static bool LoadTextFile(const FString& FilePath, FString& OutText, FString& OutError);
+    static bool LoadSchemaFile(const FString& SchemaPath, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& OutSchema, FString& OutError);
+    static bool LoadConfigFile(const FString& ConfigPath, EMotaEzConfigFormat Format, TMap<FString, FMotaEzValue>& OutConfig, FString& OutError);
+    bool SaveTextFile(const FString& FilePath, EMotaEzConfigFormat Format, const FString& Text, FString& OutError) const;
 
     void BuildSaveDataFromSchemaAndConfig(
-        const FMotaEzSaveSchema& Schema,
-        const TMap<FString, FMotaEzValue>& RawConfig,
+        const FMotaEzCompiledSchema& Schema,
+        TMap<FString, FMotaEzValue>&& RawConfig,
         UMotaEzSaveData* OutSave
-    ) const;
+    );
 
     void ExecuteAutoSaveOnExit();
 };
@@ -2,16 +2,59 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "Misc/AES.h"
 #include "MotaEzEncryption.generated.h"
 
+/**
+ * Streaming cipher stage used by the slot file pipeline.
+ * AES-256 in counter mode: the keystream is generated block by block from a per-file nonce,
+ * so data can be processed in arbitrary chunks, in place, with no padding and no size inflation.
+ * Counter mode is symmetric - the same call both encrypts and decrypts.
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzCipherStream
+{
+public:
+    static constexpr int32 NonceSize = 16;
+
+    /**
+     * @param Key - Encryption key string (see UMotaEzEncryption::GetEncryptionKey)
+     * @param InNonce - Per-file nonce stored alongside the ciphertext
+     */
+    FMotaEzCipherStream(const FString& Key, const uint8* InNonce);
+
+    /**
+     * Applies the keystream to a chunk of bytes in place.
+     * Consecutive calls continue where the previous chunk ended.
+     * @param Data - Bytes to transform
+     * @param NumBytes - Number of bytes in Data
+     */
+    void Process(uint8* Data, int64 NumBytes);
+
+    /**
+     * Fills a buffer with a fresh random nonce.
+     * @param OutNonce - Destination, must hold NonceSize bytes
+     */
+    static void MakeNonce(uint8* OutNonce);
+
+private:
+    void RefillKeystream(int64 NumBlocks);
+
+    FAESKey AesKey;
+    uint8 Nonce[NonceSize];
+    uint64 NextCounter = 0;
+
+    TArray<uint8> Keystream;
+    int32 KeystreamOffset = 0;
+};
+
 /**
  * Encryption module for EzSaveGame.
- * Implements AES-256 encryption with 14 transformation rounds for save file security.
+ * Implements AES-256 (counter mode) encryption for save file security.
  * 
  * Features:
  * - AES-256 encryption with 32-byte key
- * - Automatic PKCS7 padding
- * - 16-byte block processing
+ * - Streaming, chunked processing on raw bytes (see FMotaEzCipherStream)
+ * - Applied automatically to slot and config files by the slot file pipeline
  * - Editor: Always disabled for easy debugging
  * - Packaged game: Configurable via Project Settings
  * 
@@ -67,6 +110,13 @@ public:
      */
     static FString GenerateRandomKey();
 
+    /**
+     * Derives the 256-bit AES key used by the cipher stage from a key string.
+     * @param Key - Encryption key string
+     * @return Expanded AES-256 key
+     */
+    static FAESKey DeriveAESKey(const FString& Key);
+
 private:
     static bool EncryptAES(const TArray<uint8>& PlainData, const FString& Key, TArray<uint8>& OutEncrypted);
     static bool DecryptAES(const TArray<uint8>& EncryptedData, const FString& Key, TArray<uint8>& OutDecrypted);
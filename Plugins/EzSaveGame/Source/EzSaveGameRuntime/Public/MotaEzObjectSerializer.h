@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MotaEzObjectSerializer.generated.h"
+
+class USaveGame;
+
+/**
+ * Serializes the SaveGame properties of USaveGame objects directly, without going through the
+ * Key -> FMotaEzValue map.
+ * 
+ * The first use of a class compiles its layout: every CPF_SaveGame property the plugin supports
+ * (the types UMotaEzSchemaGenerator detects, plus bytes/enums and double precision) with its offset
+ * and a binary codec. Layouts are cached per UClass, so later saves and loads only copy values
+ * between the object and a packed little-endian buffer.
+ * 
+ * Each field is tagged with its name hash and size. A buffer written with the same layout is read
+ * back in one pass; after the class changed, fields are matched by name and unknown ones skipped.
+ */
+UCLASS()
+class EZSAVEGAMERUNTIME_API UMotaEzObjectSerializer : public UObject
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Serializes an object's SaveGame properties into a buffer.
+     * @param Object - Object to read
+     * @param OutBytes - Receives the packed fields
+     * @param OutError - Error message if the object cannot be serialized
+     * @return true if serialization was successful, false otherwise
+     */
+    static bool SerializeObject(const USaveGame* Object, TArray<uint8>& OutBytes, FString& OutError);
+
+    /**
+     * Writes the fields of a buffer made by SerializeObject into an object.
+     * Properties missing from the buffer keep their current values.
+     * @param Object - Object to write
+     * @param Bytes - Packed fields
+     * @param OutError - Error message if the buffer is invalid
+     * @return true if deserialization was successful, false otherwise
+     */
+    static bool DeserializeObject(USaveGame* Object, TConstArrayView<uint8> Bytes, FString& OutError);
+
+    /**
+     * Saves an object's SaveGame properties to a slot, next to the slot's key/value file.
+     * Each class has its own block, so several save objects can share a slot.
+     * @param Object - Object to save
+     * @param SlotIndex - Target slot index (0-N for regular slots, -1 for auto-save)
+     * @param OutError - Error message if save fails
+     * @return true if save was successful, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Objects")
+    static bool SaveObject(USaveGame* Object, int32 SlotIndex, FString& OutError);
+
+    /**
+     * Loads an object's SaveGame properties from a slot.
+     * @param Object - Object to fill
+     * @param SlotIndex - Source slot index
+     * @param OutError - Error message if load fails
+     * @return true if load was successful, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Objects")
+    static bool LoadObject(USaveGame* Object, int32 SlotIndex, FString& OutError);
+
+    /**
+     * Gets the path of a class's object block in a slot.
+     * @param SlotIndex - Slot index
+     * @param ObjectClass - Class of the saved object
+     * @return Absolute path of the block file
+     */
+    static FString GetSlotObjectPath(int32 SlotIndex, const UClass* ObjectClass);
+
+    /**
+     * Gets the number of fields in a class's compiled layout, compiling it if needed.
+     * @param ObjectClass - USaveGame-derived class
+     * @return Number of SaveGame properties that are serialized
+     */
+    static int32 GetLayoutFieldCount(const UClass* ObjectClass);
+
+    /** Extension of object block files. */
+    static const TCHAR* ObjectFileExtension;
+};
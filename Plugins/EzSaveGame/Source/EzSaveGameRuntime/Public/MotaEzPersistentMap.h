@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "MotaEzTypes.h"
+
+/**
+ * Immutable map from keys to values, stored as a hash array mapped trie.
+ *
+ * Set and Remove return a new map that shares every node the update did not touch with the
+ * old one: an update copies the path to its key (at most eight small nodes), and keeping many
+ * versions costs memory only for what differs between them. Copying a map copies one pointer.
+ * Keys are compared case-insensitively, matching TMap<FString> key semantics.
+ *
+ * A map is never modified after it is built, so versions can be read from any thread.
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzPersistentMap
+{
+public:
+    /** One key/value pair, shared by every version that contains it. */
+    struct FEntry
+    {
+        FString Key;
+        FMotaEzValue Value;
+
+        /** Content hash given by the writer; entries with equal hashes are treated as equal values. */
+        uint64 ValueHash = 0;
+
+        /** Case-insensitive hash of Key that picks the entry's path through the trie. */
+        uint32 KeyHash = 0;
+    };
+
+    /** Called per differing key with the value before and after; one of them is null for added and removed keys. */
+    typedef TFunctionRef<void(const FString& /*Key*/, const FMotaEzValue* /*Before*/, const FMotaEzValue* /*After*/)> FDiffVisitor;
+
+    /** @return Number of keys */
+    int32 Num() const { return Count; }
+
+    /**
+     * Finds the entry of a key.
+     * @param Key - Key to look up
+     * @return Entry or nullptr if the map has no such key
+     */
+    const FEntry* FindEntry(const FString& Key) const;
+
+    /**
+     * Finds the value of a key.
+     * @param Key - Key to look up
+     * @return Value or nullptr if the map has no such key
+     */
+    const FMotaEzValue* Find(const FString& Key) const
+    {
+        const FEntry* Entry = FindEntry(Key);
+        return Entry ? &Entry->Value : nullptr;
+    }
+
+    /**
+     * Returns a map with a key set to a value. Returns this map unchanged if the key already
+     * holds a value with the same hash.
+     * @param Key - Key to set
+     * @param Value - Value to copy in
+     * @param ValueHash - Content hash of the value
+     * @return Updated map
+     */
+    FMotaEzPersistentMap Set(const FString& Key, const FMotaEzValue& Value, uint64 ValueHash) const;
+
+    /**
+     * Returns a map without a key. Returns this map unchanged if it has no such key.
+     * @param Key - Key to remove
+     * @return Updated map
+     */
+    FMotaEzPersistentMap Remove(const FString& Key) const;
+
+    /** Visits every entry, in no particular order. */
+    void ForEach(TFunctionRef<void(const FEntry&)> Visitor) const;
+
+    /**
+     * Visits the keys whose values differ between this map (before) and another one (after).
+     * Subtrees both maps share are skipped without being visited, so comparing two versions
+     * of the same map costs time proportional to the updates between them.
+     * @param Other - Map to compare against
+     * @param Visitor - Called once per differing key
+     */
+    void Diff(const FMotaEzPersistentMap& Other, FDiffVisitor Visitor) const;
+
+    /** @return true if both maps are the same version (not merely equal contents) */
+    bool IsSameVersion(const FMotaEzPersistentMap& Other) const { return Root == Other.Root; }
+
+private:
+    struct FNode;
+
+    typedef TSharedRef<const FEntry> FEntryRef;
+    typedef TSharedRef<const FNode> FNodeRef;
+    typedef TSharedPtr<const FNode> FNodePtr;
+
+    /** @return Copy of the path to the entry's slot with the entry stored there */
+    static FNodeRef Insert(const FNodeRef& Node, const FEntryRef& Entry, uint32 Shift);
+
+    /** @return Node holding two entries whose keys share every slot above Shift */
+    static FNodeRef MakePair(const FEntryRef& A, const FEntryRef& B, uint32 Shift);
+
+    /** @return Copy of the path without the key, Node itself if the key is missing, null if nothing is left */
+    static FNodePtr Erase(const FNodeRef& Node, const FString& Key, uint32 KeyHash, uint32 Shift);
+
+    static void VisitAll(const FNode& Node, TFunctionRef<void(const FEntry&)> Visitor);
+    static void DiffNodes(const FNode* Before, const FNode* After, uint32 Shift, FDiffVisitor Visitor);
+    static void DiffEntries(const FEntry& Before, const FEntry& After, FDiffVisitor Visitor);
+    static void DiffEntryWithNode(const FEntry& Entry, const FNode& Node, bool bEntryIsBefore, FDiffVisitor Visitor);
+
+    FNodePtr Root;
+    int32 Count = 0;
+};
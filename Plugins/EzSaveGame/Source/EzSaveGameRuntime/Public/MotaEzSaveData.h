@@ -3,11 +3,51 @@
 #include "CoreMinimal.h"
 #include "GameFramework/SaveGame.h"
 #include "MotaEzTypes.h"
+#include "MotaEzSaveSnapshot.h"
+#include "MotaEzValidator.h"
+#include "MotaEzUndoHistory.h"
+#include "Containers/Ticker.h"
 #include "MotaEzSaveData.generated.h"
 
+class UMotaEzSaveData;
+
+/** Called once per frame with the subscribed keys that changed during the frame. */
+DECLARE_DELEGATE_OneParam(FMotaEzKeysChangedDelegate, const TArray<FString>& /*ChangedKeys*/);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FMotaEzOnKeysChanged, UMotaEzSaveData*, SaveData, const TArray<FString>&, ChangedKeys);
+
 /**
  * Universal save game object used by EzSaveGame plugin.
  * Contains a map of Key -> FMotaEzValue for flexible data storage.
+ * 
+ * Keeps a running, order-independent content fingerprint that every setter and RemoveKey updates in O(1),
+ * so savers can tell whether anything changed since the last write without serializing.
+ * Code that writes to Data directly must call RecomputeFingerprint() afterwards.
+ * 
+ * Data holds only the values that were set or loaded. Reads fall through to a shared, immutable
+ * defaults layer (the compiled schema defaults), so defaults are never copied into each save.
+ * 
+ * In thread-safe mode the getters, setters and batch functions may be called from any thread.
+ * Keys are spread over NumLockShards reader-writer locks by hash, so threads touching different keys
+ * do not block each other; adding or removing keys briefly locks the whole object. Code that reads or
+ * writes Data directly must hold an FExclusiveScope while doing so.
+ * 
+ * Multi-key updates can be grouped in an edit (BeginEdit/CommitEdit/AbortEdit, or FMotaEzEditScope).
+ * Writes from the editing thread are staged; at commit they are validated against the schema as one
+ * batch and applied together, and an abort simply drops the staged values.
+ * 
+ * Keys of the form "Section/Name" belong to a named section (per level, per system, per region);
+ * every other key is in the root section. Each section has its own fingerprint and dirty state,
+ * and the slot manager stores, loads and saves sections as separate blocks.
+ * 
+ * Stored keys are also kept in a sorted index, built on the first prefix or range query and then
+ * maintained as keys are added and removed, so queries like "every key of actor X" do not scan the map.
+ * 
+ * Instead of polling, code can subscribe to keys or key prefixes. Changes are collected while they
+ * happen and delivered in one batch per frame on the game thread; nothing runs while nothing changes.
+ * 
+ * Readers that read often and never write can use published snapshots instead (GetSnapshotChannel),
+ * which need no lock at all and are refreshed by the game thread at most once per frame.
  */
 UCLASS(BlueprintType)
 class EZSAVEGAMERUNTIME_API UMotaEzSaveData : public USaveGame
@@ -16,9 +56,283 @@ class EZSAVEGAMERUNTIME_API UMotaEzSaveData : public USaveGame
 
 public:
 
+    /** Number of reader-writer locks the key space is sharded over in thread-safe mode. */
+    static constexpr int32 NumLockShards = 16;
+
+    /** Separates the section from the rest of a key: "Inventory/Sword" is in section "Inventory". */
+    static constexpr TCHAR SectionSeparator = TEXT('/');
+
+    /**
+     * Locks the whole object for direct access to Data (e.g. serializing it) until destroyed.
+     * Does nothing unless thread-safe mode is enabled. Not reentrant.
+     */
+    class EZSAVEGAMERUNTIME_API FExclusiveScope
+    {
+    public:
+        explicit FExclusiveScope(const UMotaEzSaveData& InSaveData);
+        ~FExclusiveScope();
+
+    private:
+        const UMotaEzSaveData& SaveData;
+        bool bLocked;
+    };
+
     UPROPERTY(SaveGame)
     TMap<FString, FMotaEzValue> Data;
 
+    /** Broadcast once per frame with every key that changed during the frame. */
+    UPROPERTY(Transient, BlueprintAssignable, Category="EzSaveGame")
+    FMotaEzOnKeysChanged OnKeysChanged;
+
+    /**
+     * Subscribes to changes of specific keys. Game thread only.
+     * @param Keys - Keys to watch
+     * @param Delegate - Called once per frame with the watched keys that changed
+     * @return Handle for Unsubscribe
+     */
+    FDelegateHandle SubscribeKeys(const TArray<FString>& Keys, FMotaEzKeysChangedDelegate Delegate);
+
+    /**
+     * Subscribes to changes of every key that starts with a prefix (e.g. "Quest."). Game thread only.
+     * @param Prefix - Case-insensitive key prefix
+     * @param Delegate - Called once per frame with the matching keys that changed
+     * @return Handle for Unsubscribe
+     */
+    FDelegateHandle SubscribePrefix(const FString& Prefix, FMotaEzKeysChangedDelegate Delegate);
+
+    /**
+     * Removes a subscription made with SubscribeKeys or SubscribePrefix.
+     * @param Handle - Handle returned when subscribing
+     */
+    void Unsubscribe(FDelegateHandle Handle);
+
+    virtual void PostInitProperties() override;
+    virtual void BeginDestroy() override;
+    virtual void Serialize(FArchive& Ar) override;
+
+    /**
+     * Gets the channel that lock-free snapshots of this object are published to. Game thread only.
+     * The first call publishes a snapshot right away; afterwards a new one is published at the end
+     * of every frame in which the contents changed.
+     * @return Channel to read snapshots from with FMotaEzSnapshotReadScope, on any thread
+     */
+    TSharedRef<FMotaEzSnapshotChannel, ESPMode::ThreadSafe> GetSnapshotChannel();
+
+    /** Publishes a snapshot now if the contents changed since the last one. Game thread only. */
+    void PublishSnapshot();
+
+    /**
+     * Enables or disables thread-safe access. New objects use the "Thread-Safe Save Data" project setting.
+     * Must only be switched while no other thread is using the object.
+     * @param bEnable - Whether getters and setters lock
+     */
+    void SetThreadSafe(bool bEnable) { bThreadSafe = bEnable; }
+
+    /** @return true if getters and setters may be called from any thread */
+    bool IsThreadSafe() const { return bThreadSafe; }
+
+    /**
+     * Reads several values under a single lock acquisition, so they are consistent with each other.
+     * @param Keys - Keys to read
+     * @param OutValues - Receives a copy of every key found in either layer
+     */
+    void GetValues(TConstArrayView<FString> Keys, TMap<FString, FMotaEzValue>& OutValues) const;
+
+    /**
+     * Reads several values under a single lock acquisition, in the order of Keys.
+     * @param Keys - Keys to read
+     * @param OutValues - Receives one value per key; keys found in neither layer give a value of type None
+     */
+    void GetValues(TConstArrayView<FString> Keys, TArray<FMotaEzValue>& OutValues) const;
+
+    /**
+     * Writes several values under a single lock acquisition; other threads see all of them or none.
+     * @param Values - Key/value pairs to store
+     */
+    void SetValues(const TMap<FString, FMotaEzValue>& Values);
+
+    /**
+     * Writes a batch in one pass: one lock acquisition, one map growth step, one change notification.
+     * @param Entries - Key/value pairs to store; a later entry for the same key wins
+     */
+    void SetValues(TConstArrayView<FMotaEzBatchEntry> Entries);
+
+    /**
+     * Removes a stored value. A key covered by the defaults layer reads its default again.
+     * @param Key - Key to remove
+     * @return true if a value was stored for the key, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    bool RemoveKey(const FString& Key);
+
+    /** Removes all stored values; keys covered by the defaults layer read their default again. */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void ClearData();
+
+    /**
+     * Gets the stored keys that start with a prefix (e.g. an actor id), in sorted order.
+     * Uses the sorted key index, so the cost is O(log n + k) rather than a scan of every key.
+     * Keys only present in the defaults layer are not included.
+     * @param Prefix - Case-insensitive key prefix; empty returns every stored key
+     * @return Matching keys
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Keys")
+    TArray<FString> GetKeysWithPrefix(const FString& Prefix) const;
+
+    /**
+     * Removes every stored value whose key starts with a prefix, e.g. all keys of a destroyed actor.
+     * @param Prefix - Case-insensitive key prefix; must not be empty (use ClearData)
+     * @return Number of keys removed
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Keys")
+    int32 RemoveKeysWithPrefix(const FString& Prefix);
+
+    /**
+     * Visits the stored entries whose key starts with a prefix, in sorted key order.
+     * The visitor runs under the object's read lock and must not write to this object.
+     * @param Prefix - Case-insensitive key prefix
+     * @param Visitor - Called with each key and its stored value
+     */
+    void ForEachKeyWithPrefix(const FString& Prefix, TFunctionRef<void(const FString&, const FMotaEzValue&)> Visitor) const;
+
+    /**
+     * Visits the stored entries with First <= Key < Last (case-insensitive), in sorted key order.
+     * The visitor runs under the object's read lock and must not write to this object.
+     * @param First - Inclusive lower bound
+     * @param Last - Exclusive upper bound; empty means no upper bound
+     * @param Visitor - Called with each key and its stored value
+     */
+    void ForEachKeyInRange(const FString& First, const FString& Last, TFunctionRef<void(const FString&, const FMotaEzValue&)> Visitor) const;
+
+    /**
+     * Starts an edit. Until CommitEdit, this thread's writes are staged: this thread reads them back,
+     * other threads keep seeing the committed values. Edits nest; only the outermost commit publishes.
+     * One thread edits at a time: BeginEdit on another thread waits until the open edit is committed or aborted.
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Edit")
+    void BeginEdit();
+
+    /**
+     * Validates the staged writes against the schema rules and applies them all at once.
+     * If any value fails validation, nothing is applied and the edit is rolled back.
+     * @param OutResult - First validation failure, if any
+     * @return true if the changes were applied (or, for a nested edit, can still be)
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Edit")
+    bool CommitEdit(FMotaEzValidationResult& OutResult);
+
+    /** Drops everything staged since BeginEdit. Inside a nested edit, the outermost commit will fail. */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Edit")
+    void AbortEdit();
+
+    /** @return true if an edit is open */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Edit")
+    bool IsEditing() const { return EditDepth.load(std::memory_order_relaxed) > 0; }
+
+    /**
+     * Sets the schema whose validation rules CommitEdit checks staged values against.
+     * @param InRules - Shared schema descriptors (may be null to skip validation)
+     */
+    void SetValidationRules(const TSharedPtr<const FMotaEzSaveSchema>& InRules);
+
+    /**
+     * Sets the shared defaults layer that reads fall through to.
+     * @param InDefaults - Immutable defaults shared by every save built from the same schema (may be null)
+     */
+    void SetDefaultsLayer(const TSharedPtr<const TMap<FString, FMotaEzValue>>& InDefaults);
+
+    /**
+     * Finds a value, looking at stored values first and then at the defaults layer.
+     * Does not lock; in thread-safe mode use the getters or GetValues instead.
+     * @param Key - Key to look up
+     * @return Value or nullptr if neither layer has the key
+     */
+    const FMotaEzValue* FindValue(const FString& Key) const;
+
+    /**
+     * Replaces all data at once and rebuilds the fingerprint.
+     * @param NewData - Data to take ownership of
+     */
+    void ReplaceData(TMap<FString, FMotaEzValue>&& NewData);
+
+    /** Rebuilds the fingerprint from scratch. Required after writing to Data directly (inside an FExclusiveScope). */
+    void RecomputeFingerprint();
+
+    /**
+     * Gets the order-independent fingerprint of the current contents.
+     * Equal contents always produce equal fingerprints, regardless of insertion order.
+     * @return 64-bit content fingerprint
+     */
+    uint64 GetFingerprint() const { return Fingerprint; }
+
+    /**
+     * Checks whether the contents changed since the last MarkClean (last load or save).
+     * @return true if there are unsaved changes
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame")
+    bool IsDirty() const { return Fingerprint != CleanFingerprint; }
+
+    /** Records the current contents (and every section) as saved. */
+    void MarkClean();
+
+    /**
+     * Builds the key of a value in a section, e.g. ("Inventory", "Sword") -> "Inventory/Sword".
+     * @param Section - Section name; empty for the root section
+     * @param Key - Key within the section
+     * @return Full key to use with the getters and setters
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Sections")
+    static FString MakeSectionKey(const FString& Section, const FString& Key);
+
+    /**
+     * Gets the section a key belongs to: the part before the first SectionSeparator.
+     * @param Key - Full key
+     * @return Section name, empty for keys of the root section
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Sections")
+    static FString GetKeySection(const FString& Key);
+
+    /** @return true if any key belongs to a named section */
+    bool HasSections() const;
+
+    /** @return Names of the named sections this object has held keys for since its last load */
+    TArray<FString> GetSectionNames() const;
+
+    /**
+     * Gets the fingerprint of one section's contents, maintained like the whole-object fingerprint.
+     * @param Section - Section name; empty for the root section
+     * @return Order-independent fingerprint, 0 for an empty or unknown section
+     */
+    uint64 GetSectionFingerprint(const FString& Section) const;
+
+    /**
+     * Checks whether a section changed since the last MarkClean or MarkSectionClean.
+     * @param Section - Section name; empty for the root section
+     * @return true if the section has unsaved changes
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Sections")
+    bool IsSectionDirty(const FString& Section) const;
+
+    /** Records the current contents of one section as saved. */
+    void MarkSectionClean(const FString& Section);
+
+    /**
+     * Copies the stored values of one section.
+     * @param Section - Section name; empty for the root section
+     * @param OutData - Receives the section's keys (full keys) and values
+     */
+    void GetSectionData(const FString& Section, TMap<FString, FMotaEzValue>& OutData) const;
+
+    /**
+     * Replaces the stored values of one section and leaves every other section untouched.
+     * @param Section - Section name; empty for the root section
+     * @param NewData - New contents; keys outside the section are skipped
+     */
+    void ReplaceSection(const FString& Section, TMap<FString, FMotaEzValue>&& NewData);
+
+    /** Sections that exist in this object's slot but were not loaded into it; saving leaves them alone. */
+    TSet<FString> UnloadedSections;
+
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     int32 GetInt(const FString& Key, int32 DefaultValue = 0) const;
 
@@ -37,6 +351,21 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     FRotator GetRotator(const FString& Key, const FRotator& DefaultValue = FRotator::ZeroRotator) const;
 
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    int64 GetInt64(const FString& Key, int64 DefaultValue = 0) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    double GetDouble(const FString& Key, double DefaultValue = 0.0) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    FQuat GetQuat(const FString& Key, const FQuat& DefaultValue = FQuat::Identity) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    FTransform GetTransform(const FString& Key, const FTransform& DefaultValue = FTransform::Identity) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    FLinearColor GetLinearColor(const FString& Key, const FLinearColor& DefaultValue = FLinearColor::White) const;
+
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     void SetInt(const FString& Key, int32 Value);
 
@@ -55,6 +384,21 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     void SetRotator(const FString& Key, const FRotator& Value);
 
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetInt64(const FString& Key, int64 Value);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetDouble(const FString& Key, double Value);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetQuat(const FString& Key, const FQuat& Value);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetTransform(const FString& Key, const FTransform& Value);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetLinearColor(const FString& Key, const FLinearColor& Value);
+
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     TArray<int32> GetIntArray(const FString& Key) const;
 
@@ -73,6 +417,21 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     TArray<FRotator> GetRotatorArray(const FString& Key) const;
 
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    TArray<int64> GetInt64Array(const FString& Key) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    TArray<double> GetDoubleArray(const FString& Key) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    TArray<FQuat> GetQuatArray(const FString& Key) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    TArray<FTransform> GetTransformArray(const FString& Key) const;
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    TArray<FLinearColor> GetLinearColorArray(const FString& Key) const;
+
 
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     void SetIntArray(const FString& Key, const TArray<int32>& Values);
@@ -91,4 +450,354 @@ public:
 
     UFUNCTION(BlueprintCallable, Category="EzSaveGame")
     void SetRotatorArray(const FString& Key, const TArray<FRotator>& Values);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetInt64Array(const FString& Key, const TArray<int64>& Values);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetDoubleArray(const FString& Key, const TArray<double>& Values);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetQuatArray(const FString& Key, const TArray<FQuat>& Values);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetTransformArray(const FString& Key, const TArray<FTransform>& Values);
+
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetLinearColorArray(const FString& Key, const TArray<FLinearColor>& Values);
+
+    /**
+     * Reads a Struct value into an initialized struct.
+     * A schema default without stored records reads as the default-constructed struct.
+     * @param Key - Key to read
+     * @param Struct - Expected struct type; values of other types are not read
+     * @param OutValue - Struct to write
+     * @return true if the value was read, false otherwise (OutValue is unchanged unless records were corrupted)
+     */
+    bool GetStructValue(const FString& Key, const UScriptStruct* Struct, void* OutValue) const;
+
+    /**
+     * Reads a Struct array value.
+     * @param Key - Key to read
+     * @param Struct - Expected struct type
+     * @param Resize - Gets the element count and returns that many initialized elements to write
+     * @return true if the value was read, false otherwise
+     */
+    bool GetStructArrayValue(const FString& Key, const UScriptStruct* Struct, TFunctionRef<void*(int32)> Resize) const;
+
+    /**
+     * Stores a struct value as packed records.
+     * @param Key - Key to write
+     * @param Struct - Struct type
+     * @param Value - Value to store
+     */
+    void SetStructValue(const FString& Key, const UScriptStruct* Struct, const void* Value);
+
+    /**
+     * Stores an array of struct values as packed records.
+     * @param Key - Key to write
+     * @param Struct - Struct type
+     * @param Values - First of Num values laid out as in a TArray
+     * @param Num - Number of values
+     */
+    void SetStructArrayValue(const FString& Key, const UScriptStruct* Struct, const void* Values, int32 Num);
+
+    template <typename T>
+    bool GetStruct(const FString& Key, T& OutValue) const
+    {
+        return GetStructValue(Key, TBaseStructure<T>::Get(), &OutValue);
+    }
+
+    template <typename T>
+    bool GetStructArray(const FString& Key, TArray<T>& OutValues) const
+    {
+        return GetStructArrayValue(Key, TBaseStructure<T>::Get(), [&OutValues](int32 Num)
+        {
+            OutValues.SetNum(Num);
+            return static_cast<void*>(OutValues.GetData());
+        });
+    }
+
+    template <typename T>
+    void SetStruct(const FString& Key, const T& Value)
+    {
+        SetStructValue(Key, TBaseStructure<T>::Get(), &Value);
+    }
+
+    template <typename T>
+    void SetStructArray(const FString& Key, const TArray<T>& Values)
+    {
+        SetStructArrayValue(Key, TBaseStructure<T>::Get(), Values.GetData(), Values.Num());
+    }
+
+    /**
+     * Gets the bytes of a Blob value without copying them.
+     * @param Key - Key to read
+     * @return The shared bytes, or null if the key is missing, empty or not a Blob
+     */
+    FMotaEzBlobPtr GetBlob(const FString& Key) const;
+
+    /**
+     * Copies the bytes of a Blob value.
+     * @param Key - Key to read
+     * @param OutBytes - Receives the bytes
+     * @return true if the key holds a Blob value, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    bool GetBlobBytes(const FString& Key, TArray<uint8>& OutBytes) const;
+
+    /**
+     * Stores shared bytes as a Blob value; the bytes must not change afterwards.
+     * @param Key - Key to write
+     * @param Bytes - Bytes to share
+     */
+    void SetBlob(const FString& Key, FMotaEzBlobPtr Bytes);
+
+    /**
+     * Stores bytes as a Blob value, taking over the buffer.
+     * @param Key - Key to write
+     * @param Bytes - Bytes to move in
+     */
+    void SetBlob(const FString& Key, TArray<uint8>&& Bytes);
+
+    /**
+     * Stores a copy of the bytes as a Blob value.
+     * @param Key - Key to write
+     * @param Bytes - Bytes to copy
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame")
+    void SetBlobBytes(const FString& Key, const TArray<uint8>& Bytes);
+
+    /**
+     * Starts recording undo history, with the current contents as the first checkpoint.
+     * Checkpoints share the values that did not change between them, so each one costs time
+     * and memory proportional to the keys written since the previous checkpoint.
+     * Calling it again restarts the history. History calls are game thread only.
+     * @param Capacity - Maximum number of checkpoints kept; the oldest are dropped first
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    void EnableUndoHistory(int32 Capacity = 64);
+
+    /** Stops recording undo history and releases every checkpoint. */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    void DisableUndoHistory();
+
+    /** @return true if undo history is being recorded */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Undo")
+    bool IsUndoHistoryEnabled() const { return UndoHistory.IsValid(); }
+
+    /**
+     * Records the current contents as a checkpoint after the current one. Redo steps are dropped.
+     * Nothing is added if the contents did not change since the current checkpoint.
+     * Not allowed while an edit is open on this thread.
+     * @param Label - Free text describing the checkpoint
+     * @return Id of the new (or unchanged current) checkpoint, or INDEX_NONE if history is disabled
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    int32 Checkpoint(const FString& Label);
+
+    /**
+     * Steps back to the previous checkpoint. Changes made since the current checkpoint are
+     * checkpointed first, so undoing them is the first step and Redo brings them back.
+     * Only keys that differ are written; subscribers are told about them as usual.
+     * @return true if a step was taken
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    bool Undo();
+
+    /**
+     * Steps forward to the next checkpoint. Changes made since the current checkpoint drop the redo steps.
+     * @return true if a step was taken
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    bool Redo();
+
+    /** @return true if Undo would take a step */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Undo")
+    bool CanUndo() const;
+
+    /** @return true if Redo would take a step */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Undo")
+    bool CanRedo() const;
+
+    /**
+     * Jumps to any kept checkpoint, as a number of Undo or Redo steps would.
+     * @param CheckpointId - Id returned by Checkpoint
+     * @return true if the checkpoint is kept and was restored
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    bool RestoreCheckpoint(int32 CheckpointId);
+
+    /** @return Id of the current checkpoint, or INDEX_NONE if history is disabled */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Undo")
+    int32 GetCurrentCheckpoint() const;
+
+    /**
+     * Lists the keys that differ between two kept checkpoints, sorted by key.
+     * Costs time proportional to the changes between them, not to the size of the save.
+     * @param FromCheckpointId - Checkpoint to compare from
+     * @param ToCheckpointId - Checkpoint to compare to
+     * @param OutChanges - Receives the differing keys
+     * @return true if both checkpoints are kept
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Undo")
+    bool DiffCheckpoints(int32 FromCheckpointId, int32 ToCheckpointId, TArray<FMotaEzKeyChange>& OutChanges) const;
+
+private:
+    /** Holds the locks one key (or a set of keys) needs, in a fixed order. */
+    class FKeyLockScope;
+
+    /** Writes one key, either into the staging layer of an open edit or into Data. */
+    template <typename FillType>
+    void WriteValue(const FString& Key, FillType&& Fill);
+
+    /** Removes a stored value; the caller holds the exclusive lock or is the only user. */
+    bool RemoveStoredKey(const FString& Key);
+
+    bool IsEditingOnThisThread() const;
+    void DiscardStaged();
+
+    /** Builds the sorted key index if it is not valid. Caller holds at least the structure read lock. */
+    void EnsureKeyIndex() const;
+
+    /** Drops the key index; the next query rebuilds it. Caller holds the exclusive lock. */
+    void InvalidateKeyIndex();
+
+    /** Drops the key index before a batch that adds so many keys that one sort beats inserting each. */
+    void PrepareKeyIndexForBatch(int32 NumWrites);
+
+    /** @return Range [OutBegin, OutEnd) of SortedKeys that start with Prefix; index must be valid */
+    void FindPrefixRange(const FString& Prefix, int32& OutBegin, int32& OutEnd) const;
+
+    /**
+     * Adds to the fingerprint and to the fingerprint of the key's section.
+     * Atomic in thread-safe mode, where writers to different shards run concurrently.
+     */
+    void AddToFingerprint(const FString& Key, uint64 Delta);
+
+    /** Finds or adds an entry and removes its current contribution from the fingerprint. */
+    FMotaEzValue& BeginMutate(const FString& Key, uint64& OutPreviousHash);
+
+    /** Adds the entry's new contribution back to the fingerprint and records the key if its value changed. */
+    void EndMutate(const FString& Key, const FMotaEzValue& Entry, uint64 PreviousHash);
+
+    struct FKeySubscription
+    {
+        TSet<FString> Keys;
+        FString Prefix;
+        FMotaEzKeysChangedDelegate Delegate;
+        FDelegateHandle Handle;
+    };
+
+    /** @return true if anyone would be told about changes (or the undo history tracks them), so they are worth recording */
+    bool HasChangeListeners() const { return KeySubscriptions.Num() > 0 || OnKeysChanged.IsBound() || UndoHistory.IsValid(); }
+
+    /** Queues a changed key for this frame's notification batch and marks it for the next checkpoint. Thread-safe. */
+    void RecordChange(const FString& Key);
+
+    /** Delivers the batch of keys changed since the last delivery. Game thread only. */
+    void DeliverChanges();
+
+    TArray<FKeySubscription> KeySubscriptions;
+
+    /** Writes and removals of the open edit, invisible to other threads until committed. */
+    TMap<FString, FMotaEzValue> StagedWrites;
+    TSet<FString> StagedRemovals;
+    std::atomic<int32> EditDepth{0};
+    std::atomic<uint32> EditThreadId{0};
+    bool bEditAborted = false;
+
+    /** Held by the editing thread from the outermost BeginEdit until it commits or aborts. */
+    FCriticalSection EditLock;
+
+    /** Schema descriptors with the validation rules applied at commit. */
+    TSharedPtr<const FMotaEzSaveSchema> ValidationRules;
+
+    /** Keys changed since the last delivery; written by any thread in thread-safe mode. */
+    TSet<FString> PendingChanges;
+    FCriticalSection PendingChangesLock;
+    FTSTicker::FDelegateHandle ChangeTickerHandle;
+
+    /** Sum of per-entry hashes; addition makes it independent of map order. */
+    uint64 Fingerprint = 0;
+
+    /** Fingerprint at the last load or save, for IsDirty. */
+    uint64 CleanFingerprint = 0;
+
+    /** Fingerprint per section (the root section under the empty name), and their values at the last load or save. */
+    TMap<FString, uint64> SectionFingerprints;
+    TMap<FString, uint64> CleanSectionFingerprints;
+
+    /**
+     * Stored keys in case-insensitive order, valid while bKeyIndexValid. Keys are inserted and removed
+     * under the exclusive lock; the lazy build under a read lock is serialized by KeyIndexBuildLock.
+     */
+    mutable TArray<FString> SortedKeys;
+    mutable std::atomic<bool> bKeyIndexValid{false};
+    mutable FCriticalSection KeyIndexBuildLock;
+
+    /** Schema defaults shared between saves; never written through. */
+    TSharedPtr<const TMap<FString, FMotaEzValue>> Defaults;
+
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) FPaddedLock
+    {
+        FRWLock Lock;
+    };
+
+    /** Read-locked by every keyed access, write-locked when keys are added or removed. */
+    mutable FPaddedLock StructureLock;
+
+    /** Protects the values of the keys that hash to each shard. */
+    mutable FPaddedLock ShardLocks[NumLockShards];
+
+    bool bThreadSafe = false;
+
+    /** Creates a snapshot of the current contents. */
+    TUniquePtr<FMotaEzSaveSnapshot> MakeSnapshot() const;
+
+    TSharedPtr<FMotaEzSnapshotChannel, ESPMode::ThreadSafe> SnapshotChannel;
+    FTSTicker::FDelegateHandle SnapshotTickerHandle;
+
+    /** @return true if undo history is enabled and no edit is open on this thread; logs otherwise */
+    bool CanStepUndoHistory(const TCHAR* Operation) const;
+
+    /** Checkpoints the changes since the current checkpoint, if any. Caller holds the exclusive lock. */
+    int32 CommitUndoCheckpoint(const FString& Label);
+
+    /** Writes the keys that differ from the current checkpoint to the one at Index. Caller holds the exclusive lock. */
+    void ApplyUndoCheckpoint(int32 Index);
+
+    TUniquePtr<FMotaEzUndoHistory> UndoHistory;
+};
+
+/**
+ * Groups writes to a save data object into one edit for the lifetime of the scope.
+ * Call Commit to validate and apply them; a scope that ends without Commit rolls back.
+ *
+ *     FMotaEzEditScope Edit(SaveData);
+ *     SaveData->SetInt(TEXT("Gold"), Gold - Price);
+ *     SaveData->SetStringArray(TEXT("Inventory"), Items);
+ *     Edit.Commit();
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzEditScope
+{
+public:
+    explicit FMotaEzEditScope(UMotaEzSaveData* InSaveData);
+    ~FMotaEzEditScope();
+
+    UE_NONCOPYABLE(FMotaEzEditScope);
+
+    /**
+     * Validates and applies the staged writes.
+     * @param OutResult - Optional; receives the first validation failure
+     * @return true if the writes were applied
+     */
+    bool Commit(FMotaEzValidationResult* OutResult = nullptr);
+
+    /** Drops the staged writes. */
+    void Abort();
+
+private:
+    UMotaEzSaveData* SaveData;
+    bool bFinished = false;
 };
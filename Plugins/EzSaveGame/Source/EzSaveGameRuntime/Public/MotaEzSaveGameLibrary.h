@@ -8,6 +8,79 @@
 #include "MotaEzTypes.h"
 #include "MotaEzSaveGameLibrary.generated.h"
 
+class UMotaEzConfigSubsystem;
+class UMotaEzSaveData;
+
+/**
+ * Save store resolved once from a world context, for code that reads or writes many keys.
+ * Always refers to the subsystem's current save, so it stays correct across LoadFromSlot;
+ * it becomes invalid when the game instance shuts down.
+ *
+ * C++:        FMotaEzSaveStoreHandle Store = UMotaEzSaveGameLibrary::ResolveSaveStore(this);
+ *             if (Store) { Store->SetInt(TEXT("Coins"), Store->GetInt(TEXT("Coins")) + 1); }
+ * Blueprint:  Resolve Save Store in BeginPlay, keep it in a variable, then Get Store Save Data.
+ */
+USTRUCT(BlueprintType)
+struct EZSAVEGAMERUNTIME_API FMotaEzSaveStoreHandle
+{
+    GENERATED_BODY()
+
+    FMotaEzSaveStoreHandle() = default;
+    explicit FMotaEzSaveStoreHandle(UMotaEzConfigSubsystem* InSubsystem) : Subsystem(InSubsystem) {}
+
+    /** @return Current save data, or nullptr if the subsystem is gone */
+    UMotaEzSaveData* Get() const;
+
+    bool IsValid() const { return Subsystem.IsValid(); }
+    explicit operator bool() const { return Get() != nullptr; }
+    UMotaEzSaveData* operator->() const { return Get(); }
+
+private:
+    UPROPERTY()
+    TWeakObjectPtr<UMotaEzConfigSubsystem> Subsystem;
+};
+
+/**
+ * Typed builder for EzSetMany.
+ *
+ *     UMotaEzSaveGameLibrary::EzSetMany(this, FMotaEzBatch(3)
+ *         .Int(TEXT("Score"), 1000)
+ *         .Bool(TEXT("HasSword"), true)
+ *         .Vector(TEXT("SpawnPoint"), FVector(0, 0, 100)));
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzBatch
+{
+public:
+    /** @param ExpectedNum - Number of entries to reserve room for */
+    explicit FMotaEzBatch(int32 ExpectedNum = 0) { Entries.Reserve(ExpectedNum); }
+
+    FMotaEzBatch& Int(const FString& Key, int32 Value);
+    FMotaEzBatch& Float(const FString& Key, float Value);
+    FMotaEzBatch& Bool(const FString& Key, bool Value);
+    FMotaEzBatch& String(const FString& Key, const FString& Value);
+    FMotaEzBatch& Vector(const FString& Key, const FVector& Value);
+    FMotaEzBatch& Rotator(const FString& Key, const FRotator& Value);
+    FMotaEzBatch& Int64(const FString& Key, int64 Value);
+    FMotaEzBatch& Double(const FString& Key, double Value);
+    FMotaEzBatch& Quat(const FString& Key, const FQuat& Value);
+    FMotaEzBatch& Transform(const FString& Key, const FTransform& Value);
+    FMotaEzBatch& LinearColor(const FString& Key, const FLinearColor& Value);
+    FMotaEzBatch& Struct(const FString& Key, const UScriptStruct* StructType, const void* Value);
+    FMotaEzBatch& Blob(const FString& Key, FMotaEzBlobPtr Bytes);
+
+    template <typename T>
+    FMotaEzBatch& Struct(const FString& Key, const T& Value)
+    {
+        return Struct(Key, TBaseStructure<T>::Get(), &Value);
+    }
+
+    const TArray<FMotaEzBatchEntry>& GetEntries() const { return Entries; }
+    operator const TArray<FMotaEzBatchEntry>&() const { return Entries; }
+
+private:
+    TArray<FMotaEzBatchEntry> Entries;
+};
+
 /**
  * Blueprint function library for simplified EzSaveGame usage.
  * Provides convenient wrapper functions that eliminate the need to manually obtain the subsystem.
@@ -96,6 +169,56 @@ public:
     UFUNCTION(BlueprintPure, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject"))
     static FRotator EzGetRotator(const UObject* WorldContextObject, const FString& Key, FRotator DefaultValue = FRotator::ZeroRotator);
 
+    /**
+     * Retrieves a 64-bit integer value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param DefaultValue - Value to return if key doesn't exist
+     * @return The stored integer value or default if not found
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject"))
+    static int64 EzGetInt64(const UObject* WorldContextObject, const FString& Key, int64 DefaultValue = 0);
+
+    /**
+     * Retrieves a double precision value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param DefaultValue - Value to return if key doesn't exist
+     * @return The stored double value or default if not found
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject"))
+    static double EzGetDouble(const UObject* WorldContextObject, const FString& Key, double DefaultValue = 0.0);
+
+    /**
+     * Retrieves a quaternion value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param DefaultValue - Value to return if key doesn't exist
+     * @return The stored quaternion value or default if not found
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="DefaultValue"))
+    static FQuat EzGetQuat(const UObject* WorldContextObject, const FString& Key, const FQuat& DefaultValue);
+
+    /**
+     * Retrieves a transform value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param DefaultValue - Value to return if key doesn't exist
+     * @return The stored transform value or default if not found
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="DefaultValue"))
+    static FTransform EzGetTransform(const UObject* WorldContextObject, const FString& Key, const FTransform& DefaultValue);
+
+    /**
+     * Retrieves a linear color value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param DefaultValue - Value to return if key doesn't exist
+     * @return The stored color value or default if not found
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="DefaultValue"))
+    static FLinearColor EzGetLinearColor(const UObject* WorldContextObject, const FString& Key, const FLinearColor& DefaultValue);
+
     /**
      * Stores an integer value in save data.
      * @param WorldContextObject - World context for subsystem access
@@ -150,6 +273,132 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
     static void EzSetRotator(const UObject* WorldContextObject, const FString& Key, FRotator Value);
 
+    /**
+     * Stores a 64-bit integer value in save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Value - 64-bit integer value to store
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
+    static void EzSetInt64(const UObject* WorldContextObject, const FString& Key, int64 Value);
+
+    /**
+     * Stores a double precision value in save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Value - Double value to store
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
+    static void EzSetDouble(const UObject* WorldContextObject, const FString& Key, double Value);
+
+    /**
+     * Stores a quaternion value in save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Value - Quaternion value to store
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
+    static void EzSetQuat(const UObject* WorldContextObject, const FString& Key, const FQuat& Value);
+
+    /**
+     * Stores a transform value in save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Value - Transform value to store
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
+    static void EzSetTransform(const UObject* WorldContextObject, const FString& Key, const FTransform& Value);
+
+    /**
+     * Stores a linear color value in save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Value - Color value to store
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
+    static void EzSetLinearColor(const UObject* WorldContextObject, const FString& Key, const FLinearColor& Value);
+
+    /**
+     * Retrieves a struct value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param OutValue - Struct to fill; only read if the stored value has the same struct type
+     * @return true if the value was found and read
+     */
+    UFUNCTION(BlueprintCallable, CustomThunk, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject", CustomStructureParam="OutValue"))
+    static bool EzGetStruct(const UObject* WorldContextObject, const FString& Key, int32& OutValue);
+
+    /**
+     * Stores any struct value in save data, as packed records.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Value - Struct value to store
+     */
+    UFUNCTION(BlueprintCallable, CustomThunk, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject", CustomStructureParam="Value"))
+    static void EzSetStruct(const UObject* WorldContextObject, const FString& Key, const int32& Value);
+
+    /** Struct read by type, behind EzGetStruct. */
+    static bool GetStructByType(const UObject* WorldContextObject, const FString& Key, const UScriptStruct* Struct, void* OutValue);
+
+    /** Struct write by type, behind EzSetStruct. */
+    static void SetStructByType(const UObject* WorldContextObject, const FString& Key, const UScriptStruct* Struct, const void* Value);
+
+    DECLARE_FUNCTION(execEzGetStruct)
+    {
+        P_GET_OBJECT(UObject, WorldContextObject);
+        P_GET_PROPERTY(FStrProperty, Key);
+
+        Stack.MostRecentProperty = nullptr;
+        Stack.MostRecentPropertyAddress = nullptr;
+        Stack.StepCompiledIn<FStructProperty>(nullptr);
+        const FStructProperty* ValueProperty = CastField<FStructProperty>(Stack.MostRecentProperty);
+        void* ValuePtr = Stack.MostRecentPropertyAddress;
+        P_FINISH;
+
+        P_NATIVE_BEGIN;
+        *(bool*)RESULT_PARAM = ValueProperty && ValuePtr && GetStructByType(WorldContextObject, Key, ValueProperty->Struct, ValuePtr);
+        P_NATIVE_END;
+    }
+
+    DECLARE_FUNCTION(execEzSetStruct)
+    {
+        P_GET_OBJECT(UObject, WorldContextObject);
+        P_GET_PROPERTY(FStrProperty, Key);
+
+        Stack.MostRecentProperty = nullptr;
+        Stack.MostRecentPropertyAddress = nullptr;
+        Stack.StepCompiledIn<FStructProperty>(nullptr);
+        const FStructProperty* ValueProperty = CastField<FStructProperty>(Stack.MostRecentProperty);
+        const void* ValuePtr = Stack.MostRecentPropertyAddress;
+        P_FINISH;
+
+        P_NATIVE_BEGIN;
+        if (ValueProperty && ValuePtr)
+        {
+            SetStructByType(WorldContextObject, Key, ValueProperty->Struct, ValuePtr);
+        }
+        P_NATIVE_END;
+    }
+
+    /**
+     * Retrieves a copy of the bytes of a Blob value from save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param OutBytes - Receives the bytes
+     * @return true if the key holds a Blob value
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Get", meta=(WorldContext="WorldContextObject"))
+    static bool EzGetBlob(const UObject* WorldContextObject, const FString& Key, TArray<uint8>& OutBytes);
+
+    /**
+     * Stores raw bytes (a thumbnail, a replay chunk...) as a Blob value in save data.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Key - Unique identifier for the value
+     * @param Bytes - Bytes to store
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Set", meta=(WorldContext="WorldContextObject"))
+    static void EzSetBlob(const UObject* WorldContextObject, const FString& Key, const TArray<uint8>& Bytes);
+
     /**
      * Checks if a key exists in the save data.
      * @param WorldContextObject - World context for subsystem access
@@ -167,6 +416,24 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame|Utils", meta=(WorldContext="WorldContextObject"))
     static void RemoveKey(const UObject* WorldContextObject, const FString& Key);
 
+    /**
+     * Gets the stored keys that start with a prefix, e.g. every key of one actor.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Prefix - Case-insensitive key prefix
+     * @return Matching keys in sorted order
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Utils", meta=(WorldContext="WorldContextObject"))
+    static TArray<FString> GetKeysWithPrefix(const UObject* WorldContextObject, const FString& Prefix);
+
+    /**
+     * Removes every key that starts with a prefix, e.g. all keys of a destroyed actor.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Prefix - Case-insensitive key prefix; must not be empty
+     * @return Number of keys removed
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Utils", meta=(WorldContext="WorldContextObject"))
+    static int32 RemoveKeysWithPrefix(const UObject* WorldContextObject, const FString& Prefix);
+
     /**
      * Clears all save data in memory.
      * Use this before adding new data to ensure old data doesn't accumulate.
@@ -209,6 +476,116 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame|Utils")
     static bool DeleteAllSaveData(int32 MaxSlots = 10);
 
+    /**
+     * Writes several values in one pass: one subsystem resolution, one map growth step and one change notification.
+     * Build the entries with FMotaEzBatch in C++, or with the Make Ez * Entry nodes in Blueprint.
+     * @param WorldContextObject - World context for subsystem access
+     * @param Entries - Key/value pairs to store; a later entry for the same key wins
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Batch", meta=(WorldContext="WorldContextObject"))
+    static void EzSetMany(const UObject* WorldContextObject, const TArray<FMotaEzBatchEntry>& Entries);
+
+    /**
+     * Reads several values in one pass with a single subsystem resolution.
+     * Read the results with the Ez Value As * nodes (or FMotaEzValue directly in C++).
+     * @param WorldContextObject - World context for subsystem access
+     * @param Keys - Keys to read
+     * @return One value per key, in the same order; missing keys give a value of type None
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Batch", meta=(WorldContext="WorldContextObject"))
+    static TArray<FMotaEzValue> EzGetMany(const UObject* WorldContextObject, const TArray<FString>& Keys);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzIntEntry(const FString& Key, int32 Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzFloatEntry(const FString& Key, float Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzBoolEntry(const FString& Key, bool Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzStringEntry(const FString& Key, const FString& Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzVectorEntry(const FString& Key, FVector Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzRotatorEntry(const FString& Key, FRotator Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzInt64Entry(const FString& Key, int64 Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzDoubleEntry(const FString& Key, double Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzQuatEntry(const FString& Key, const FQuat& Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzTransformEntry(const FString& Key, const FTransform& Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FMotaEzBatchEntry MakeEzLinearColorEntry(const FString& Key, const FLinearColor& Value);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static int32 EzValueAsInt(const FMotaEzValue& Value, int32 DefaultValue = 0);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static float EzValueAsFloat(const FMotaEzValue& Value, float DefaultValue = 0.0f);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static bool EzValueAsBool(const FMotaEzValue& Value, bool DefaultValue = false);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FString EzValueAsString(const FMotaEzValue& Value, const FString& DefaultValue = TEXT(""));
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FVector EzValueAsVector(const FMotaEzValue& Value, FVector DefaultValue = FVector::ZeroVector);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static FRotator EzValueAsRotator(const FMotaEzValue& Value, FRotator DefaultValue = FRotator::ZeroRotator);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static int64 EzValueAsInt64(const FMotaEzValue& Value, int64 DefaultValue = 0);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch")
+    static double EzValueAsDouble(const FMotaEzValue& Value, double DefaultValue = 0.0);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch", meta=(AutoCreateRefTerm="DefaultValue"))
+    static FQuat EzValueAsQuat(const FMotaEzValue& Value, const FQuat& DefaultValue);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch", meta=(AutoCreateRefTerm="DefaultValue"))
+    static FTransform EzValueAsTransform(const FMotaEzValue& Value, const FTransform& DefaultValue);
+
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Batch", meta=(AutoCreateRefTerm="DefaultValue"))
+    static FLinearColor EzValueAsLinearColor(const FMotaEzValue& Value, const FLinearColor& DefaultValue);
+
+    /**
+     * Resolves the save store once, so later reads and writes skip the world and subsystem lookups.
+     * @param WorldContextObject - World context for subsystem access
+     * @return Handle to keep and reuse; invalid if there is no game instance
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Store", meta=(WorldContext="WorldContextObject"))
+    static FMotaEzSaveStoreHandle ResolveSaveStore(const UObject* WorldContextObject);
+
+    /**
+     * Gets the current save data through a resolved store.
+     * @param Store - Handle from ResolveSaveStore
+     * @return Current save data, or nullptr if the store is no longer valid
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Store")
+    static UMotaEzSaveData* GetStoreSaveData(const FMotaEzSaveStoreHandle& Store);
+
+    /**
+     * Checks whether a resolved store still refers to a live subsystem.
+     * @param Store - Handle from ResolveSaveStore
+     * @return true if the store can be used
+     */
+    UFUNCTION(BlueprintPure, Category="EzSaveGame|Store")
+    static bool IsSaveStoreValid(const FMotaEzSaveStoreHandle& Store);
+
 private:
+    /** Resolves the subsystem, served from a per-world cache that is dropped when the world is cleaned up. */
     static class UMotaEzConfigSubsystem* GetSubsystem(const UObject* WorldContextObject);
 };
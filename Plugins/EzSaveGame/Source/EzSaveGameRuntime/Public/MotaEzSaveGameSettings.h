@@ -5,6 +5,38 @@
 #include "MotaEzFormatSerializer.h"
 #include "MotaEzSaveGameSettings.generated.h"
 
+/** A slot a map reads, and the keys it expects to find in it. */
+USTRUCT(BlueprintType)
+struct FMotaEzPreloadSlot
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    int32 SlotIndex = 0;
+
+    /** Keys read from this slot; missing ones are reported when the prefetch completes. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    TArray<FString> Keys;
+};
+
+/** Slots a map (or an area reached by teleport) needs, prefetched before it starts reading them. */
+USTRUCT(BlueprintType)
+struct FMotaEzPreloadManifest
+{
+    GENERATED_BODY()
+
+    /** Name used by UMotaEzSlotManager::PrefetchManifest, e.g. from a teleport. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    FName Name;
+
+    /** Map whose load triggers the prefetch automatically. Optional. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    TSoftObjectPtr<UWorld> Map;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    TArray<FMotaEzPreloadSlot> Slots;
+};
+
 /**
  * EzSaveGame plugin settings accessible from Project Settings.
  * Configures save file format, paths, encryption, and advanced options.
@@ -53,6 +85,11 @@ public:
               ToolTip="Shows detailed load/save information in the Output Log"))
     bool bVerboseLogging = false;
 
+    UPROPERTY(Config, EditAnywhere, Category="Advanced",
+        meta=(DisplayName="Thread-Safe Save Data",
+              ToolTip="Lets save data getters and setters be called from any thread (AI, async physics, background tasks). Keys are sharded over reader-writer locks, so threads working on different keys rarely wait on each other."))
+    bool bThreadSafeSaveData = false;
+
     UPROPERTY(Config, EditAnywhere, Category="Security",
         meta=(DisplayName="Enable Encryption",
               ToolTip="Encrypts save files in packaged game. Always disabled in editor for easier debugging."))
@@ -64,6 +101,42 @@ public:
               EditCondition="bEnableEncryption"))
     FString EncryptionKey;
 
+    UPROPERTY(Config, EditAnywhere, Category="History",
+        meta=(DisplayName="Enable Slot History",
+              ToolTip="Records a deduplicated version of a slot every time it is saved. Unchanged chunks are stored only once."))
+    bool bEnableSlotHistory = false;
+
+    UPROPERTY(Config, EditAnywhere, Category="History",
+        meta=(DisplayName="Max History Versions",
+              ToolTip="Number of versions kept per slot. Older versions and their unused chunks are deleted automatically. 0 keeps all versions.",
+              ClampMin="0",
+              EditCondition="bEnableSlotHistory"))
+    int32 MaxHistoryVersions = 10;
+
+    UPROPERTY(Config, EditAnywhere, Category="Cache",
+        meta=(DisplayName="Enable Parsed Slot Cache",
+              ToolTip="Keeps recently read or written slots parsed in memory, so loading them again needs no file read and no parsing."))
+    bool bEnableSlotCache = true;
+
+    UPROPERTY(Config, EditAnywhere, Category="Cache",
+        meta=(DisplayName="Slot Cache Budget (KB)",
+              ToolTip="Memory budget of the parsed slot cache. Once exceeded, least recently used slots are compressed (if enabled) and then evicted.",
+              ClampMin="0",
+              EditCondition="bEnableSlotCache"))
+    int32 SlotCacheBudgetKB = 4096;
+
+    UPROPERTY(Config, EditAnywhere, Category="Cache",
+        meta=(DisplayName="Compress Cold Cache Entries",
+              ToolTip="Keeps least recently used cache entries compressed in memory instead of evicting them right away.",
+              EditCondition="bEnableSlotCache"))
+    bool bCompressColdSlotCache = true;
+
+    UPROPERTY(Config, EditAnywhere, Category="Cache",
+        meta=(DisplayName="Preload Manifests",
+              ToolTip="Slots each map or area reads. They are read and parsed in the background when the map starts loading or the manifest is prefetched by name, so reads in BeginPlay are served from memory.",
+              EditCondition="bEnableSlotCache"))
+    TArray<FMotaEzPreloadManifest> PreloadManifests;
+
     /**
      * Gets the full file path for the config file.
      * @return Absolute path to config file
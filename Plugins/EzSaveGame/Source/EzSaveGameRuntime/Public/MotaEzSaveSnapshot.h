@@ -0,0 +1,126 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Class.h"
+#include "MotaEzTypes.h"
+#include <atomic>
+
+/**
+ * Immutable copy of a save data object's contents at one point in time.
+ * Published by the game thread and read without locks from any thread.
+ */
+struct EZSAVEGAMERUNTIME_API FMotaEzSaveSnapshot
+{
+    /** Stored values, as in UMotaEzSaveData::Data. */
+    TMap<FString, FMotaEzValue> Data;
+
+    /** Shared schema defaults reads fall through to. */
+    TSharedPtr<const TMap<FString, FMotaEzValue>> Defaults;
+
+    /** Content fingerprint of the save data when the snapshot was taken. */
+    uint64 Fingerprint = 0;
+
+    /** Increases by one with every publication. */
+    uint64 Version = 0;
+
+    /**
+     * Finds a value, looking at stored values first and then at the defaults layer.
+     * @param Key - Key to look up
+     * @return Value or nullptr if neither layer has the key
+     */
+    const FMotaEzValue* FindValue(const FString& Key) const;
+
+    int32 GetInt(const FString& Key, int32 DefaultValue = 0) const;
+    float GetFloat(const FString& Key, float DefaultValue = 0.f) const;
+    bool GetBool(const FString& Key, bool DefaultValue = false) const;
+    FString GetString(const FString& Key, const FString& DefaultValue = TEXT("")) const;
+    FVector GetVector(const FString& Key, const FVector& DefaultValue = FVector::ZeroVector) const;
+    FRotator GetRotator(const FString& Key, const FRotator& DefaultValue = FRotator::ZeroRotator) const;
+    int64 GetInt64(const FString& Key, int64 DefaultValue = 0) const;
+    double GetDouble(const FString& Key, double DefaultValue = 0.0) const;
+    FQuat GetQuat(const FString& Key, const FQuat& DefaultValue = FQuat::Identity) const;
+    FTransform GetTransform(const FString& Key, const FTransform& DefaultValue = FTransform::Identity) const;
+    FLinearColor GetLinearColor(const FString& Key, const FLinearColor& DefaultValue = FLinearColor::White) const;
+
+    /** Struct reads, as UMotaEzSaveData::GetStructValue / GetStructArrayValue. */
+    bool GetStructValue(const FString& Key, const UScriptStruct* Struct, void* OutValue) const;
+    bool GetStructArrayValue(const FString& Key, const UScriptStruct* Struct, TFunctionRef<void*(int32)> Resize) const;
+
+    template <typename T>
+    bool GetStruct(const FString& Key, T& OutValue) const
+    {
+        return GetStructValue(Key, TBaseStructure<T>::Get(), &OutValue);
+    }
+
+    template <typename T>
+    bool GetStructArray(const FString& Key, TArray<T>& OutValues) const
+    {
+        return GetStructArrayValue(Key, TBaseStructure<T>::Get(), [&OutValues](int32 Num)
+        {
+            OutValues.SetNum(Num);
+            return static_cast<void*>(OutValues.GetData());
+        });
+    }
+
+    /** Blob bytes, shared with the save data they were published from. */
+    FMotaEzBlobPtr GetBlob(const FString& Key) const;
+};
+
+/**
+ * Publication point for the snapshots of one save data object (read-copy-update).
+ * 
+ * The game thread swaps in a new snapshot; readers on any thread pin the current one with an
+ * FMotaEzSnapshotReadScope. Replaced snapshots are freed by epoch-based reclamation once no reader
+ * that could still see them is active. Readers only write to their own thread's epoch slot, so
+ * reading takes no lock and shares no cache line with other readers.
+ * 
+ * Keep the channel alive through its TSharedRef for as long as any thread may read from it.
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzSnapshotChannel
+{
+public:
+    explicit FMotaEzSnapshotChannel(TUniquePtr<FMotaEzSaveSnapshot> InitialSnapshot);
+    ~FMotaEzSnapshotChannel();
+
+    UE_NONCOPYABLE(FMotaEzSnapshotChannel);
+
+    /**
+     * Makes a snapshot current and retires the previous one. Game thread only.
+     * @param Snapshot - New snapshot; its Version is assigned here
+     */
+    void Publish(TUniquePtr<FMotaEzSaveSnapshot> Snapshot);
+
+    /** Frees retired snapshots no active reader can see anymore. Game thread only. */
+    void Reclaim();
+
+    /** @return Version of the current snapshot */
+    uint64 GetVersion() const { return Current.load(std::memory_order_acquire)->Version; }
+
+private:
+    friend class FMotaEzSnapshotReadScope;
+
+    std::atomic<const FMotaEzSaveSnapshot*> Current;
+
+    /** Replaced snapshots with the epoch they were retired in. */
+    TArray<TPair<uint64, const FMotaEzSaveSnapshot*>> Retired;
+};
+
+/**
+ * Pins the current snapshot of a channel for the lifetime of the scope.
+ * The snapshot stays valid and unchanged until the scope ends, even if newer ones are published.
+ * Scopes may nest on the same thread; keep them short, as they delay reclamation.
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzSnapshotReadScope
+{
+public:
+    explicit FMotaEzSnapshotReadScope(const FMotaEzSnapshotChannel& Channel);
+    ~FMotaEzSnapshotReadScope();
+
+    UE_NONCOPYABLE(FMotaEzSnapshotReadScope);
+
+    const FMotaEzSaveSnapshot& Get() const { return *Snapshot; }
+    const FMotaEzSaveSnapshot* operator->() const { return Snapshot; }
+
+private:
+    const FMotaEzSaveSnapshot* Snapshot;
+};
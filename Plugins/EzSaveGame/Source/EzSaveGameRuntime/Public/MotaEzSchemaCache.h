@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MotaEzTypes.h"
+#include "MotaEzFormatSerializer.h"
+#include "MotaEzSchemaCache.generated.h"
+
+/**
+ * Schema in its ready-to-use form: descriptors plus the default value of every field,
+ * already built as FMotaEzValue. Defaults is immutable once built and shared by every
+ * save data object as its defaults layer.
+ */
+struct EZSAVEGAMERUNTIME_API FMotaEzCompiledSchema
+{
+    FMotaEzSaveSchema Schema;
+    TSharedRef<const TMap<FString, FMotaEzValue>> Defaults = MakeShared<const TMap<FString, FMotaEzValue>>();
+
+    /** Builds Defaults from the descriptors in Schema. */
+    void BuildDefaults();
+
+    friend FArchive& operator<<(FArchive& Ar, FMotaEzCompiledSchema& Compiled)
+    {
+        Ar << Compiled.Schema.Fields;
+
+        if (Ar.IsLoading())
+        {
+            TSharedRef<TMap<FString, FMotaEzValue>> Loaded = MakeShared<TMap<FString, FMotaEzValue>>();
+            Ar << *Loaded;
+            Compiled.Defaults = Loaded;
+        }
+        else
+        {
+            Ar << const_cast<TMap<FString, FMotaEzValue>&>(*Compiled.Defaults);
+        }
+        return Ar;
+    }
+};
+
+/**
+ * Binary cache of the compiled schema.
+ * 
+ * The text schema is parsed with the full TOML/JSON/YAML/XML parser only when it changes:
+ * the compiled result is stored next to it (.ezschemac), keyed by an XXH3 hash of the
+ * schema text and its format. At cook time the editor module bakes the cache into
+ * Content/EzSaveGame, so packaged games load it directly and never parse the text schema.
+ */
+UCLASS()
+class EZSAVEGAMERUNTIME_API UMotaEzSchemaCache : public UObject
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Loads a schema, using the binary cache when it matches the schema text.
+     * Falls back to the cook-time baked cache when the text schema does not exist.
+     * Safe to call from worker threads.
+     * @param SchemaPath - Path to the text schema
+     * @param Format - Format of the text schema
+     * @param OutCompiled - Compiled schema (empty if no schema exists)
+     * @param OutError - Error message if loading fails
+     * @return true if a schema was loaded or none exists, false on error
+     */
+    static bool LoadSchema(const FString& SchemaPath, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& OutCompiled, FString& OutError);
+
+    /**
+     * Parses a text schema and writes its compiled cache.
+     * @param SchemaPath - Path to the text schema
+     * @param Format - Format of the text schema
+     * @param CachePath - Destination of the compiled cache
+     * @param OutError - Error message if compiling fails
+     * @return true if the cache was written, false otherwise
+     */
+    static bool CompileSchemaFile(const FString& SchemaPath, EMotaEzConfigFormat Format, const FString& CachePath, FString& OutError);
+
+    /**
+     * Gets the cache path that belongs to a text schema.
+     * @param SchemaPath - Path to the text schema
+     * @return Path of the .ezschemac file next to it
+     */
+    static FString GetCachePath(const FString& SchemaPath);
+
+    /**
+     * Gets the path of the cache baked into the packaged build at cook time.
+     * @return Path inside Content/EzSaveGame
+     */
+    static FString GetBakedCachePath();
+
+private:
+    static bool ReadCache(const FString& CachePath, uint64 ExpectedHash, EMotaEzConfigFormat Format, bool bCheckHash, FMotaEzCompiledSchema& OutCompiled);
+    static bool WriteCache(const FString& CachePath, uint64 SourceHash, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& Compiled);
+    static bool ParseSchemaText(const FString& SchemaText, EMotaEzConfigFormat Format, FMotaEzCompiledSchema& OutCompiled, FString& OutError);
+    static uint64 HashSchemaText(const FString& SchemaText, EMotaEzConfigFormat Format);
+    static void PrecompileValidators(const FMotaEzCompiledSchema& Compiled);
+};
@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MotaEzFormatSerializer.h"
+#include "MotaEzSlotFile.generated.h"
+
+/**
+ * Decoded container header of a slot or config file.
+ * Legacy files written before the container existed report Version 0 and no checksum.
+ */
+struct EZSAVEGAMERUNTIME_API FMotaEzSlotFileHeader
+{
+    uint8 Version = 0;
+    uint8 Flags = 0;
+    EMotaEzConfigFormat Format = EMotaEzConfigFormat::Toml;
+
+    /** Offset of the stored payload from the start of the file. */
+    int64 HeaderSize = 0;
+
+    /** Number of stored payload bytes following the header. */
+    uint64 PayloadLength = 0;
+
+    /** XXH3-64 of the stored (possibly encrypted) payload bytes. */
+    uint64 Checksum = 0;
+
+    bool IsEncrypted() const;
+    bool HasChecksum() const;
+
+    /** True if the payload is raw binary (WriteBytes) rather than text in Format. */
+    bool IsBinary() const;
+};
+
+/**
+ * On-disk container for slot and global config files.
+ * Streams the serialized text through the cipher stage in fixed-size chunks, so encrypted
+ * files are stored as raw bytes (no Base64) and never materialize a second full-size copy.
+ * 
+ * Layout: "EZSV" magic, version, flags, format id, reserved, payload length (uint64),
+ * XXH3-64 checksum of the stored payload (uint64), optional 16-byte nonce, payload.
+ * The header is validated against the file size before any decryption or parsing,
+ * so truncated or corrupted files are rejected early.
+ * Files without the magic are read as plain text, so existing saves keep loading.
+ */
+UCLASS()
+class EZSAVEGAMERUNTIME_API UMotaEzSlotFile : public UObject
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Writes text to disk, encrypting it when UMotaEzEncryption::ShouldEncrypt() is enabled.
+     * The file is written to a temporary file first and moved into place.
+     * @param FilePath - Destination file path
+     * @param Format - Format of the serialized text, recorded in the header
+     * @param Text - Serialized slot or config text
+     * @param OutError - Error message if write fails
+     * @param OutHeader - Optional header of the written file, including its checksum
+     * @return true if the file was written successfully, false otherwise
+     */
+    static bool WriteText(const FString& FilePath, EMotaEzConfigFormat Format, const FString& Text, FString& OutError, FMotaEzSlotFileHeader* OutHeader = nullptr);
+
+    /**
+     * Reads a slot or config file, verifying its checksum and decrypting it if needed.
+     * Chunks are read asynchronously; each chunk is hashed and decrypted while the next one is in flight.
+     * @param FilePath - Source file path
+     * @param OutText - Decoded text
+     * @param OutError - Error message if read fails or the file is corrupted
+     * @param OutHeader - Optional decoded header
+     * @return true if the file was read successfully, false otherwise
+     */
+    static bool ReadText(const FString& FilePath, FString& OutText, FString& OutError, FMotaEzSlotFileHeader* OutHeader = nullptr);
+
+    /**
+     * Writes a binary payload in the same container as WriteText: checksummed, encrypted when enabled,
+     * written to a temporary file and moved into place.
+     * @param FilePath - Destination file path
+     * @param Bytes - Payload to store
+     * @param OutError - Error message if write fails
+     * @param OutHeader - Optional header of the written file, including its checksum
+     * @return true if the file was written successfully, false otherwise
+     */
+    static bool WriteBytes(const FString& FilePath, TConstArrayView<uint8> Bytes, FString& OutError, FMotaEzSlotFileHeader* OutHeader = nullptr);
+
+    /**
+     * Reads a file written by WriteBytes, verifying its checksum and decrypting it if needed.
+     * @param FilePath - Source file path
+     * @param OutBytes - Decoded payload
+     * @param OutError - Error message if read fails, the file is corrupted or it holds text
+     * @param OutHeader - Optional decoded header
+     * @return true if the file was read successfully, false otherwise
+     */
+    static bool ReadBytes(const FString& FilePath, TArray<uint8>& OutBytes, FString& OutError, FMotaEzSlotFileHeader* OutHeader = nullptr);
+
+    /**
+     * Reads and validates only the header: magic, version and payload length against the file size.
+     * Cheap enough to run for every entry of the slot catalog.
+     * @param FilePath - Source file path
+     * @param OutHeader - Decoded header
+     * @param OutError - Error message if the header is missing or inconsistent
+     * @return true if the header is valid (or the file is a legacy plain file), false otherwise
+     */
+    static bool ReadHeader(const FString& FilePath, FMotaEzSlotFileHeader& OutHeader, FString& OutError);
+
+    /**
+     * Copies a file as cheaply as the platform allows.
+     * On Linux this is a copy-on-write reflink (FICLONE) on XFS/btrfs, then an in-kernel
+     * copy_file_range, and finally a streamed copy. Other platforms use the streamed copy.
+     * The streamed path can be forced with EzSave.ForceStreamedCopy 1.
+     * @param DestPath - Destination file path, replaced atomically
+     * @param SourcePath - Source file path
+     * @param OutError - Error message if the copy fails
+     * @return true if the file was copied, false otherwise
+     */
+    static bool CloneFile(const FString& DestPath, const FString& SourcePath, FString& OutError);
+
+    /**
+     * Combines a content fingerprint with the settings that affect the bytes on disk,
+     * so switching format or encryption makes the fingerprint of unchanged data differ.
+     * @param ContentFingerprint - UMotaEzSaveData::GetFingerprint of the data to write
+     * @param Format - Format the data is written in
+     * @return Fingerprint to compare against the one recorded at the last write
+     */
+    static uint64 MakeWriteFingerprint(uint64 ContentFingerprint, EMotaEzConfigFormat Format);
+
+    /** Size of each streamed read/write chunk in bytes. */
+    static constexpr int64 StreamChunkSize = 256 * 1024;
+
+private:
+    static bool WritePayload(const FString& FilePath, EMotaEzConfigFormat Format, uint8 ExtraFlags, TConstArrayView<uint8> Bytes, FString& OutError, FMotaEzSlotFileHeader* OutHeader);
+
+    /** Reads the payload of a file into Buffer (header excluded), verifying and decrypting it in place. */
+    static bool ReadPayload(const FString& FilePath, TArray<uint8>& Buffer, FMotaEzSlotFileHeader& OutHeader, FString& OutError);
+};
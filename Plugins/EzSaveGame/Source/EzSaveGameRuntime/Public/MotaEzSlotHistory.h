@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MotaEzFormatSerializer.h"
+#include "MotaEzSlotHistory.generated.h"
+
+/**
+ * Information about one recorded version of a slot.
+ */
+USTRUCT(BlueprintType)
+struct FMotaEzSlotVersionInfo
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    int32 Version = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    FDateTime Timestamp;
+
+    /** Size of the serialized payload in bytes. */
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    int64 Size = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    int32 NumChunks = 0;
+};
+
+/**
+ * Versioned slot history with content-addressed chunk deduplication.
+ * 
+ * Serialized payloads are split into content-defined chunks (Gear rolling hash, FastCDC-style
+ * normalized chunking, ~8 KB average). Each chunk is stored once under History/Chunks by its
+ * XXH3-128 hash, and each version is a small JSON manifest listing its chunks. A new version
+ * of a mostly unchanged save only writes the chunks that changed. Sectioned slots are recorded
+ * whole, with one chunk list per section block. Binary blocks (Slot0.<Class>.ezobj objects and
+ * Slot0.<Name>.ezblock named blocks) are not part of a version: they are neither recorded nor
+ * touched by a restore.
+ * 
+ * When encryption is enabled, chunks are encrypted with a nonce derived from their content,
+ * so identical chunks still deduplicate.
+ * 
+ * Enable automatic recording from Project Settings > EzSaveGame > History.
+ */
+UCLASS(BlueprintType)
+class EZSAVEGAMERUNTIME_API UMotaEzSlotHistory : public UObject
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Records a new version of an unsectioned slot from its serialized text.
+     * Called automatically by UMotaEzSlotManager::SaveToSlot when history is enabled.
+     * @param SlotIndex - Slot the version belongs to
+     * @param Format - Format of the serialized text
+     * @param Text - Serialized slot contents
+     * @param OutError - Error message if recording fails
+     * @return true if the version was recorded, false otherwise
+     */
+    static bool RecordVersion(int32 SlotIndex, EMotaEzConfigFormat Format, const FString& Text, FString& OutError);
+
+    /**
+     * Records a new version of a slot from the serialized text of each of its blocks.
+     * @param SlotIndex - Slot the version belongs to
+     * @param Format - Format of the serialized text
+     * @param Blocks - Text per section; the empty name is the root block and is required
+     * @param OutError - Error message if recording fails
+     * @return true if the version was recorded, false otherwise
+     */
+    static bool RecordBlocks(int32 SlotIndex, EMotaEzConfigFormat Format, const TMap<FString, FString>& Blocks, FString& OutError);
+
+    /**
+     * Records the current on-disk contents of a slot, its section blocks included, as a new version.
+     * @param SlotIndex - Slot to snapshot
+     * @param OutError - Error message if the snapshot fails
+     * @return true if the snapshot was recorded, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|History")
+    static bool SnapshotSlot(int32 SlotIndex, FString& OutError);
+
+    /**
+     * Lists all recorded versions of a slot, oldest first.
+     * @param SlotIndex - Slot to query
+     * @return Recorded versions
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|History")
+    static TArray<FMotaEzSlotVersionInfo> GetSlotVersions(int32 SlotIndex);
+
+    /**
+     * Rebuilds the slot file and its section blocks from a recorded version. Section blocks the
+     * version did not have are deleted; binary blocks are left as they are. Call LoadFromSlot
+     * afterwards to bring it into memory.
+     * @param SlotIndex - Slot to restore
+     * @param Version - Version number to restore
+     * @param OutError - Error message if restore fails
+     * @return true if the slot file was restored, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|History")
+    static bool RestoreSlotVersion(int32 SlotIndex, int32 Version, FString& OutError);
+
+    /**
+     * Deletes the oldest versions of a slot and any chunks no longer referenced.
+     * @param SlotIndex - Slot to prune
+     * @param KeepVersions - Number of most recent versions to keep
+     * @return Number of versions deleted
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|History")
+    static int32 PruneSlotHistory(int32 SlotIndex, int32 KeepVersions);
+
+    /**
+     * Deletes the whole history of a slot and any chunks no longer referenced.
+     * @param SlotIndex - Slot whose history to delete
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|History")
+    static void DeleteSlotHistory(int32 SlotIndex);
+
+private:
+    static FString GetHistoryDirectory();
+    static FString GetChunkDirectory();
+    static FString GetSlotHistoryDirectory(int32 SlotIndex);
+    static FString GetManifestPath(int32 SlotIndex, int32 Version);
+
+    /** Deletes chunk files not referenced by any manifest of any slot. */
+    static int32 CollectGarbageChunks();
+};
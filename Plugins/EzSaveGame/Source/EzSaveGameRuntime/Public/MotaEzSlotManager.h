@@ -4,6 +4,9 @@
 #include "UObject/Object.h"
 #include "MotaEzSlotManager.generated.h"
 
+class UMotaEzConfigSubsystem;
+class UMotaEzSaveData;
+
 /**
  * Metadata information for a save slot.
  * Contains details about save time, player progress, and custom data.
@@ -34,6 +37,10 @@ struct FMotaEzSlotInfo
     UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
     bool bIsOccupied = false;
 
+    /** True if the slot file exists but its header is truncated or inconsistent. */
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    bool bIsCorrupted = false;
+
     UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
     FString ScreenshotPath;
 
@@ -45,6 +52,15 @@ struct FMotaEzSlotInfo
  * Manager for multiple save slots with metadata support.
  * Provides functionality to save, load, and manage multiple save files with associated metadata.
  * Supports special auto-save slot (index -1) and numbered slots (0-N).
+ * 
+ * Each loaded slot stays resident as its own document in UMotaEzConfigSubsystem. Loading a slot
+ * whose document is resident, unchanged and still matches the file only switches the current save.
+ * Recently read or written slots are also kept parsed in a memory-bounded LRU cache, so reloading
+ * them needs no file read and no parsing.
+ * 
+ * Keys in named sections ("Section/Key") are stored in one block file per section next to the slot
+ * file, which holds the root section. Saving rewrites only the blocks of sections that changed;
+ * LoadSlotSections reads just the sections a caller needs.
  */
 UCLASS(BlueprintType)
 class EZSAVEGAMERUNTIME_API UMotaEzSlotManager : public UObject
@@ -64,7 +80,8 @@ public:
     static bool SaveToSlot(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError);
 
     /**
-     * Loads data from a specific slot.
+     * Loads data from a specific slot and makes its document the current save.
+     * Reads the file only if the slot's document is not resident, has unsaved changes or is out of date.
      * @param WorldContextObject - World context for subsystem access
      * @param SlotIndex - Source slot index to load from
      * @param OutError - Error message if load fails
@@ -73,6 +90,62 @@ public:
     UFUNCTION(BlueprintCallable, Category="EzSaveGame|Slots", meta=(WorldContext="WorldContextObject"))
     static bool LoadFromSlot(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError);
 
+    /**
+     * Saves the resident document of a slot to that slot, whether or not it is the current save.
+     * @param WorldContextObject - World context for subsystem access
+     * @param SlotIndex - Slot whose document to save
+     * @param OutError - Error message if save fails
+     * @return true if save was successful, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Slots", meta=(WorldContext="WorldContextObject"))
+    static bool SaveDocument(const UObject* WorldContextObject, int32 SlotIndex, FString& OutError);
+
+    /**
+     * Loads only some sections of a slot into the slot's document and makes it the current save.
+     * The root section (keys without a section) is always included. Sections of a resident document
+     * that are unchanged and still match their blocks are not read again; other sections stay as they are.
+     * @param WorldContextObject - World context for subsystem access
+     * @param SlotIndex - Source slot index
+     * @param Sections - Names of the sections to load (e.g. "Level.ThirdPerson", "Inventory")
+     * @param OutError - Error message if load fails
+     * @return true if load was successful, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Slots", meta=(WorldContext="WorldContextObject"))
+    static bool LoadSlotSections(const UObject* WorldContextObject, int32 SlotIndex, const TArray<FString>& Sections, FString& OutError);
+
+    /**
+     * Saves only some sections of the current save to a slot; blocks of other sections are not touched.
+     * Sections that did not change since they were last written are skipped.
+     * @param WorldContextObject - World context for subsystem access
+     * @param SlotIndex - Target slot index
+     * @param Sections - Names of the sections to save; an empty name is the root section
+     * @param OutError - Error message if save fails
+     * @return true if save was successful, false otherwise
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Slots", meta=(WorldContext="WorldContextObject"))
+    static bool SaveSlotSections(const UObject* WorldContextObject, int32 SlotIndex, const TArray<FString>& Sections, FString& OutError);
+
+    /**
+     * Writes a named binary block next to a slot (Slot0.<Name>.ezblock), for game systems that keep
+     * their own packed data instead of one key per value. The block is deleted with the slot.
+     * @param SlotIndex - Target slot index
+     * @param BlockName - Name of the block; becomes part of the file name
+     * @param Bytes - Block contents
+     * @param OutError - Error message if the write fails
+     * @return true if the block was written, false otherwise
+     */
+    static bool SaveSlotBlock(int32 SlotIndex, const FString& BlockName, TConstArrayView<uint8> Bytes, FString& OutError);
+
+    /**
+     * Reads a named binary block written by SaveSlotBlock.
+     * @param SlotIndex - Source slot index
+     * @param BlockName - Name of the block
+     * @param OutBytes - Receives the block contents
+     * @param OutError - Error message if the block is missing or corrupted
+     * @return true if the block was read, false otherwise
+     */
+    static bool LoadSlotBlock(int32 SlotIndex, const FString& BlockName, TArray<uint8>& OutBytes, FString& OutError);
+
     /**
      * Deletes a specific slot including metadata and screenshot.
      * @param SlotIndex - Slot index to delete
@@ -92,6 +165,7 @@ public:
 
     /**
      * Retrieves metadata information for a specific slot.
+     * Also validates the slot file header, flagging truncated or inconsistent files as corrupted.
      * @param SlotIndex - Slot index to query
      * @return Slot metadata information
      */
@@ -159,7 +233,8 @@ public:
     static bool QuickLoadFromSlot(const UObject* WorldContextObject, FString& OutError);
 
     /**
-     * Copies all data from one slot to another.
+     * Copies all data from one slot to another: the slot file, its section, object and named blocks and its
+     * metadata. Blocks the destination has but the source lacks are deleted.
      * @param FromSlot - Source slot index
      * @param ToSlot - Destination slot index
      * @return true if copy was successful, false otherwise
@@ -182,6 +257,30 @@ public:
     UFUNCTION(BlueprintPure, Category="EzSaveGame|Slots")
     static int32 FindFirstEmptySlot(int32 MaxSlots = 10);
 
+    /**
+     * Reads and parses slots on worker tasks into the parsed slot cache,
+     * so a later LoadFromSlot or GetDocument for them needs no file read or parsing.
+     * @param SlotIndices - Slots to prefetch; empty, already cached or pending slots are skipped
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Slots")
+    static void PrefetchSlots(const TArray<int32>& SlotIndices);
+
+    /**
+     * Prefetches the slots of a preload manifest from the project settings.
+     * Call it when a transition to the area the manifest describes begins, e.g. on a teleport.
+     * @param ManifestName - Name of the manifest
+     * @return true if the manifest exists
+     */
+    UFUNCTION(BlueprintCallable, Category="EzSaveGame|Slots")
+    static bool PrefetchManifest(FName ManifestName);
+
+    /**
+     * Prefetches every preload manifest registered for a map.
+     * Called by UMotaEzConfigSubsystem when a map starts loading.
+     * @param MapName - Package or short name of the map; PIE prefixes are ignored
+     */
+    static void PrefetchForMap(const FString& MapName);
+
     /**
      * Deletes ALL save data including all slots, metadata, screenshots, config, and schema files.
      * WARNING: This action cannot be undone!
@@ -192,11 +291,44 @@ public:
     static bool DeleteAllSaveData(int32 MaxSlots = 10);
 
 private:
+    friend class UMotaEzSlotHistory;
+    friend class UMotaEzConfigSubsystem;
+    friend class UMotaEzObjectSerializer;
+
+    static void StartSlotPrefetch(int32 SlotIndex, const TArray<FString>& ExpectedKeys);
+
+    static bool SaveDataToSlot(UMotaEzConfigSubsystem* Subsystem, UMotaEzSaveData* SaveData, int32 SlotIndex, FString& OutError);
+
+    /**
+     * Gets the document of a slot, reusing the resident one when it is unchanged and still
+     * matches the file, and reading the file into it otherwise.
+     */
+    static bool LoadSlotDocument(UMotaEzConfigSubsystem* Subsystem, int32 SlotIndex, UMotaEzSaveData*& OutDocument, FString& OutError);
+
     static FString GetSlotConfigPath(int32 SlotIndex);
+
+    /** Path of a section block: Slot0.toml holds the root section, Slot0.<Section>.toml each named one. */
+    static FString GetSlotSectionPath(int32 SlotIndex, const FString& Section);
+
+    /** Path of a named binary block: Slot0.<Name>.ezblock. */
+    static FString GetSlotBlockPath(int32 SlotIndex, const FString& BlockName);
+
+    /** @return Named sections that have a block on disk for a slot */
+    static TArray<FString> GetSlotSectionNames(int32 SlotIndex);
+
+    /**
+     * Writes the section blocks of a save whose contents changed since they were last written.
+     * @param OnlySections - Sections to consider; null for every section of SaveData (and dropping blocks it no longer has)
+     * @param OutWritten - Number of blocks rewritten
+     */
+    static bool WriteSlotSections(UMotaEzSaveData* SaveData, int32 SlotIndex, const TArray<FString>* OnlySections, int32& OutWritten, FString& OutError);
     static FString GetSlotMetadataPath(int32 SlotIndex);
     static bool LoadSlotMetadata(int32 SlotIndex, FMotaEzSlotInfo& OutInfo);
     static bool SaveSlotMetadata(int32 SlotIndex, const FMotaEzSlotInfo& Info);
 
+    /** Forgets the last written fingerprint and cached parse of a slot after its file was replaced externally. */
+    static void InvalidateSlotWriteState(int32 SlotIndex);
+
     static const FString LastUsedSlotKey;
     static const int32 AutoSaveSlotIndex;
 };
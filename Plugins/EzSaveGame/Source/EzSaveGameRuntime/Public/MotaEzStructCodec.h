@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MotaEzTypes.h"
+#include "MotaEzStructCodec.generated.h"
+
+class FJsonObject;
+class FJsonValue;
+
+/**
+ * Converts USTRUCT values to and from the packed records of Struct fields.
+ * 
+ * The first use of a struct compiles its codec from reflection: every member with its offset and a
+ * type handler, nested structs resolved to their own codecs. For records, nested members are
+ * inlined and adjacent fixed-size members merged into one copy, so a struct of plain data is a
+ * single memcpy and an array of them one memcpy for all elements. Strings, names and texts are
+ * stored as UTF-8; no member goes through a text conversion.
+ * 
+ * Records start with the codec's layout hash and element count, and can only be read while the
+ * struct keeps that layout. Text formats write members by name and survive struct changes.
+ */
+UCLASS()
+class EZSAVEGAMERUNTIME_API UMotaEzStructCodec : public UObject
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Packs struct values into records.
+     * @param Struct - Type of the values
+     * @param Values - First of Num values laid out as in a TArray
+     * @param Num - Number of values
+     * @param OutRecords - Receives the records
+     * @return true if the values were packed, false if the arguments are invalid
+     */
+    static bool PackRecords(const UScriptStruct* Struct, const void* Values, int32 Num, TArray<uint8>& OutRecords);
+
+    /**
+     * Unpacks records into struct values.
+     * Members the codec does not serialize keep their current values.
+     * @param Struct - Type of the values
+     * @param Records - Records made by PackRecords
+     * @param GetValues - Called once with the number of records; returns that many initialized values to write
+     * @param OutError - Error message if the records cannot be read
+     * @return true if every record was read, false otherwise
+     */
+    static bool UnpackRecords(const UScriptStruct* Struct, TConstArrayView<uint8> Records, TFunctionRef<void*(int32)> GetValues, FString& OutError);
+
+    /**
+     * Makes a Struct value holding one value or an array of values.
+     * @param Struct - Type of the values
+     * @param Values - First of Num values laid out as in a TArray
+     * @param Num - Number of values; 1 for a scalar
+     * @param bIsArray - Whether the value is an array
+     * @param OutValue - Receives the value
+     * @return true if the value was made, false if the arguments are invalid
+     */
+    static bool MakeValue(const UScriptStruct* Struct, const void* Values, int32 Num, bool bIsArray, FMotaEzValue& OutValue);
+
+    /**
+     * Converts the records of a Struct value to one JSON object per element, members by name.
+     * A value without records (a schema default) converts to one default-constructed element.
+     * @param Value - Struct value
+     * @param OutElements - Receives the elements
+     * @param OutError - Error message if the struct is unknown or the records are invalid
+     * @return true if the value was converted, false otherwise
+     */
+    static bool ToJson(const FMotaEzValue& Value, TArray<TSharedPtr<FJsonValue>>& OutElements, FString& OutError);
+
+    /**
+     * Makes a Struct value from JSON objects with members by name.
+     * Missing members keep their defaults and unknown ones are ignored. Scalars may be given as
+     * strings, for formats that do not type them.
+     * @param StructPath - Path name of the struct
+     * @param bIsArray - Whether the value is an array; scalars take exactly one element
+     * @param Elements - One object per element
+     * @param OutValue - Receives the value
+     * @param OutError - Error message if the struct is unknown
+     * @return true if the value was made, false otherwise
+     */
+    static bool FromJson(const FString& StructPath, bool bIsArray, TConstArrayView<TSharedPtr<FJsonValue>> Elements, FMotaEzValue& OutValue, FString& OutError);
+
+    /**
+     * Converts a Struct value to the nested object the text formats write:
+     * { "$struct": Path, ...members } for scalars, { "$struct": Path, "$items": [ ... ] } for arrays.
+     * @param Value - Struct value
+     * @param OutError - Error message if the value cannot be converted
+     * @return Object, or nullptr on error
+     */
+    static TSharedPtr<FJsonObject> ToJsonObject(const FMotaEzValue& Value, FString& OutError);
+
+    /**
+     * Makes a Struct value from an object written by ToJsonObject.
+     * @param Object - Object with a "$struct" field
+     * @param OutValue - Receives the value
+     * @param OutError - Error message if the object cannot be converted
+     * @return true if the value was made, false otherwise
+     */
+    static bool FromJsonObject(const FJsonObject& Object, FMotaEzValue& OutValue, FString& OutError);
+
+    /** @return true if the object is a Struct value written by ToJsonObject */
+    static bool IsStructObject(const FJsonObject& Object);
+
+    /**
+     * Finds a struct by path name, loading user-defined structs if needed.
+     * @param StructPath - Path name, as stored in Struct values
+     * @return Struct or nullptr if it does not exist
+     */
+    static const UScriptStruct* FindStruct(const FString& StructPath);
+
+    /**
+     * Gets the number of members in a struct's compiled codec, compiling it if needed.
+     * @param Struct - Struct type
+     * @return Number of members that are serialized
+     */
+    static int32 GetMemberCount(const UScriptStruct* Struct);
+
+    /** Field of ToJsonObject objects holding the struct path. */
+    static const TCHAR* StructField;
+
+    /** Field of ToJsonObject objects holding the elements of arrays. */
+    static const TCHAR* ItemsField;
+};
@@ -10,19 +10,36 @@
 UENUM(BlueprintType)
 enum class EMotaEzFieldType : uint8
 {
-    None    UMETA(DisplayName = "None"),
-    Int     UMETA(DisplayName = "Int"),
-    Float   UMETA(DisplayName = "Float"),
-    Bool    UMETA(DisplayName = "Bool"),
-    String  UMETA(DisplayName = "String"),
-    Vector  UMETA(DisplayName = "Vector"),
-    Rotator UMETA(DisplayName = "Rotator")
+    None        UMETA(DisplayName = "None"),
+    Int         UMETA(DisplayName = "Int"),
+    Float       UMETA(DisplayName = "Float"),
+    Bool        UMETA(DisplayName = "Bool"),
+    String      UMETA(DisplayName = "String"),
+    Vector      UMETA(DisplayName = "Vector"),
+    Rotator     UMETA(DisplayName = "Rotator"),
+    Int64       UMETA(DisplayName = "Int64"),
+    Double      UMETA(DisplayName = "Double"),
+    Quat        UMETA(DisplayName = "Quat"),
+    Transform   UMETA(DisplayName = "Transform"),
+    LinearColor UMETA(DisplayName = "Linear Color"),
+    Struct      UMETA(DisplayName = "Struct"),
+    Blob        UMETA(DisplayName = "Blob")
 };
 
+/** Bytes of a Blob value, shared by every copy of the value instead of duplicated. */
+typedef TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> FMotaEzBlobPtr;
+
 /**
  * Generic value container.
  * Can hold either a scalar value or an array of values of a specific type.
  * All values are stored internally as strings for easy serialization across formats.
+ * Numeric and math types use the shortest text that reads back exactly; in binary archives
+ * the fixed-size types (Int64, Double, Quat, Transform, LinearColor) are packed as raw
+ * little-endian numbers instead.
+ * Struct values hold the struct's path name in ScalarValue and their members as packed records
+ * in StructData (see UMotaEzStructCodec).
+ * Blob values hold opaque bytes in BlobData; copies of the value share the same bytes, and
+ * binary archives write them inline while text formats write them as Base64.
  */
 USTRUCT(BlueprintType)
 struct FMotaEzValue
@@ -41,7 +58,55 @@ struct FMotaEzValue
     UPROPERTY()
     TArray<FString> ArrayValues;
 
+    /** Packed records of Struct values; empty reads as default-constructed (schema defaults). */
+    UPROPERTY()
+    TArray<uint8> StructData;
+
+    /** Bytes of Blob values; immutable once stored, null for an empty blob. */
+    FMotaEzBlobPtr BlobData;
+
     bool IsArray() const { return bIsArray; }
+
+    friend EZSAVEGAMERUNTIME_API FArchive& operator<<(FArchive& Ar, FMotaEzValue& Value);
+};
+
+/**
+ * One key/value pair of a batched write or read (EzSetMany / EzGetMany).
+ */
+USTRUCT(BlueprintType)
+struct FMotaEzBatchEntry
+{
+    GENERATED_BODY();
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    FString Key;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EzSaveGame")
+    FMotaEzValue Value;
+};
+
+/** How a key differs between two undo checkpoints. */
+UENUM(BlueprintType)
+enum class EMotaEzKeyChangeType : uint8
+{
+    Added       UMETA(DisplayName = "Added"),
+    Removed     UMETA(DisplayName = "Removed"),
+    Modified    UMETA(DisplayName = "Modified")
+};
+
+/**
+ * One key that differs between two undo checkpoints (UMotaEzSaveData::DiffCheckpoints).
+ */
+USTRUCT(BlueprintType)
+struct FMotaEzKeyChange
+{
+    GENERATED_BODY();
+
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    FString Key;
+
+    UPROPERTY(BlueprintReadOnly, Category="EzSaveGame")
+    EMotaEzKeyChangeType Change = EMotaEzKeyChangeType::Modified;
 };
 
 /**
@@ -82,6 +147,21 @@ struct FMotaEzFieldDescriptor
 
     UPROPERTY()
     FString ValidationErrorMessage;
+
+    friend FArchive& operator<<(FArchive& Ar, FMotaEzFieldDescriptor& Desc)
+    {
+        Ar << Desc.Name;
+        Ar << Desc.Type;
+        Ar << Desc.bIsArray;
+        Ar << Desc.DefaultValue;
+        Ar << Desc.DefaultArray;
+        Ar << Desc.bEnableValidation;
+        Ar << Desc.MinValue;
+        Ar << Desc.MaxValue;
+        Ar << Desc.RegexPattern;
+        Ar << Desc.ValidationErrorMessage;
+        return Ar;
+    }
 };
 
 /**
@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "MotaEzPersistentMap.h"
+
+/**
+ * Bounded undo/redo history of a save data object's stored values.
+ *
+ * Each checkpoint holds a persistent map of the contents. Consecutive checkpoints share every
+ * entry that did not change between them, so a checkpoint costs time and memory proportional
+ * to the keys written since the previous one. Checkpoints live in a ring; once it is full,
+ * adding one drops the oldest.
+ *
+ * Owned and driven by UMotaEzSaveData (see UMotaEzSaveData::EnableUndoHistory); only the
+ * change marking is thread-safe.
+ */
+class EZSAVEGAMERUNTIME_API FMotaEzUndoHistory
+{
+public:
+    struct FCheckpoint
+    {
+        int32 Id = INDEX_NONE;
+        FString Label;
+        FMotaEzPersistentMap State;
+    };
+
+    /**
+     * @param InCapacity - Maximum number of checkpoints kept (at least 2)
+     * @param InitialState - Contents recorded as the first checkpoint
+     */
+    FMotaEzUndoHistory(int32 InCapacity, FMotaEzPersistentMap&& InitialState);
+
+    UE_NONCOPYABLE(FMotaEzUndoHistory);
+
+    /** Records that a key changed since the current checkpoint. Thread-safe. */
+    void MarkChanged(const FString& Key);
+
+    /** Records that the contents were replaced wholesale, so the next checkpoint compares every key. Thread-safe. */
+    void MarkAllChanged();
+
+    /** @return true if anything changed since the current checkpoint. Thread-safe. */
+    bool HasPendingChanges() const;
+
+    /**
+     * Takes the changes recorded since the current checkpoint.
+     * @param OutKeys - Receives the changed keys
+     * @return true if every key has to be compared instead
+     */
+    bool TakePendingChanges(TSet<FString>& OutKeys);
+
+    /** Forgets the changes recorded since the current checkpoint. */
+    void DiscardPendingChanges();
+
+    /** @return Number of checkpoints kept */
+    int32 Num() const { return Count; }
+
+    /** @return Position of the current checkpoint, 0 being the oldest kept */
+    int32 GetCursor() const { return Cursor; }
+
+    /** @return Checkpoint at a position, 0 being the oldest kept */
+    const FCheckpoint& Get(int32 Index) const;
+
+    const FCheckpoint& GetCurrent() const { return Get(Cursor); }
+
+    /** @return Position of the checkpoint with the id, or INDEX_NONE if it was dropped or never existed */
+    int32 IndexOfId(int32 Id) const;
+
+    /**
+     * Adds a checkpoint after the current one and makes it current. The checkpoints after the
+     * current one (the redo steps) are dropped, and so is the oldest one if the ring is full.
+     * @param Label - Free text describing the checkpoint
+     * @param State - Contents to record
+     * @return Id of the new checkpoint
+     */
+    int32 Push(const FString& Label, FMotaEzPersistentMap&& State);
+
+    /** Makes the checkpoint at a position the current one. */
+    void SetCursor(int32 Index);
+
+private:
+    FCheckpoint& GetMutable(int32 Index) { return Ring[(Head + Index) % Ring.Num()]; }
+
+    /** Fixed-size ring; Count checkpoints starting at Head, oldest first. */
+    TArray<FCheckpoint> Ring;
+    int32 Head = 0;
+    int32 Count = 0;
+    int32 Cursor = 0;
+    int32 NextId = 0;
+
+    /** Keys changed since the current checkpoint; written by any thread in thread-safe mode. */
+    TSet<FString> PendingKeys;
+    bool bPendingAll = false;
+    mutable FCriticalSection PendingLock;
+};
@@ -74,6 +74,13 @@ public:
      */
     static bool ValidateStringPattern(const FString& Value, const FString& Pattern, FString& OutError);
 
+    /**
+     * Compiles a regex pattern ahead of time so ValidateStringPattern reuses it.
+     * Thread-safe; patterns stay compiled for the lifetime of the process.
+     * @param Pattern - Regex pattern to compile
+     */
+    static void PrecompilePattern(const FString& Pattern);
+
     /**
      * Validates an array by checking each element.
      * @param ArrayValues - Array of string values to validate
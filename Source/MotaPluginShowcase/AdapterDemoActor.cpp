@@ -203,12 +203,13 @@ FString AAdapterDemoActor::GetFormatName(EMotaEzConfigFormat Format)
 
 void AAdapterDemoActor::CreateTestData()
 {
-	// Datos de prueba para la demostración
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("TestValue"), 12345);
-	UMotaEzSaveGameLibrary::EzSetString(this, TEXT("TestString"), TEXT("Adapter Pattern Demo"));
-	UMotaEzSaveGameLibrary::EzSetFloat(this, TEXT("TestFloat"), 99.99f);
-	UMotaEzSaveGameLibrary::EzSetBool(this, TEXT("TestBool"), true);
-	UMotaEzSaveGameLibrary::EzSetVector(this, TEXT("TestVector"), FVector(100, 200, 300));
+	// Datos de prueba para la demostración (escritos en un solo lote)
+	UMotaEzSaveGameLibrary::EzSetMany(this, FMotaEzBatch(5)
+		.Int(TEXT("TestValue"), 12345)
+		.String(TEXT("TestString"), TEXT("Adapter Pattern Demo"))
+		.Float(TEXT("TestFloat"), 99.99f)
+		.Bool(TEXT("TestBool"), true)
+		.Vector(TEXT("TestVector"), FVector(100, 200, 300)));
 	
 	UE_LOG(LogTemp, Log, TEXT("📝 Datos de prueba creados para Adapter Demo"));
 }
@@ -121,12 +121,13 @@ void AFacadeDemoActor::DemoCompleteWorkflow()
 {
 	UE_LOG(LogTemp, Display, TEXT("=== DEMOSTRACIÓN COMPLETA DEL PATRÓN FACADE ===\n"));
 	
-	// Guardar varios valores usando Facade (simple y limpio)
-	UMotaEzSaveGameLibrary::EzSetString(this, TEXT("PlayerName"), TEXT("Hero"));
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("PlayerScore"), 1000);
-	UMotaEzSaveGameLibrary::EzSetFloat(this, TEXT("PlayerHealth"), 85.5f);
-	UMotaEzSaveGameLibrary::EzSetBool(this, TEXT("HasSword"), true);
-	UMotaEzSaveGameLibrary::EzSetVector(this, TEXT("SpawnPoint"), FVector(0, 0, 100));
+	// Guardar varios valores usando Facade (simple y limpio): una sola llamada para todo el lote
+	UMotaEzSaveGameLibrary::EzSetMany(this, FMotaEzBatch(5)
+		.String(TEXT("PlayerName"), TEXT("Hero"))
+		.Int(TEXT("PlayerScore"), 1000)
+		.Float(TEXT("PlayerHealth"), 85.5f)
+		.Bool(TEXT("HasSword"), true)
+		.Vector(TEXT("SpawnPoint"), FVector(0, 0, 100)));
 	
 	// QuickSave (1 línea!)
 	bool bSuccess = UMotaEzSaveGameLibrary::QuickSave(this);
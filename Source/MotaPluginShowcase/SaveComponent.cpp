@@ -1,4 +1,5 @@
 ﻿#include "SaveComponent.h"
+#include "SaveComponentRegistry.h"
 #include "MotaEzSlotManager.h"
 #include "MotaEzSaveGameLibrary.h"
 #include "GameFramework/Character.h"
@@ -10,6 +11,37 @@ USaveComponent::USaveComponent()
     PrimaryComponentTick.bCanEverTick = false;
 }
 
+void USaveComponent::OnRegister()
+{
+    Super::OnRegister();
+
+    if (UWorld* World = GetWorld())
+    {
+        if (USaveComponentRegistry* Registry = World->GetSubsystem<USaveComponentRegistry>())
+        {
+            Registry->Register(this);
+        }
+    }
+}
+
+void USaveComponent::OnUnregister()
+{
+    if (UWorld* World = GetWorld())
+    {
+        if (USaveComponentRegistry* Registry = World->GetSubsystem<USaveComponentRegistry>())
+        {
+            Registry->Unregister(this);
+        }
+    }
+
+    Super::OnUnregister();
+}
+
+FString USaveComponent::GetActualId() const
+{
+    return !SaveId.IsEmpty() ? SaveId : (GetOwner() ? GetOwner()->GetName() : GetName());
+}
+
 static void ShowOnScreen(UWorld* World, const FString& Msg, const FColor& Color = FColor::Green, float Time = 4.0f)
 {
     if (World && GEngine)
@@ -23,7 +55,7 @@ void USaveComponent::SaveToSlot(const FString& SlotName)
     if (!GetOwner()) return;
 
     // Determinar el ID real que vamos a usar
-    const FString ActualId = !SaveId.IsEmpty() ? SaveId : GetOwner()->GetName();
+    const FString ActualId = GetActualId();
     
     ShowOnScreen(GetWorld(), FString::Printf(TEXT("[Save] Saving '%s' to '%s'"), *ActualId, *SlotName), FColor::Cyan);
 
@@ -73,7 +105,7 @@ void USaveComponent::LoadFromSlot(const FString& SlotName)
     if (!GetOwner()) return;
 
     // Determinar el ID real
-    const FString ActualId = !SaveId.IsEmpty() ? SaveId : GetOwner()->GetName();
+    const FString ActualId = GetActualId();
     
     ShowOnScreen(GetWorld(), FString::Printf(TEXT("[Load] Loading '%s' from '%s'"), *ActualId, *SlotName), FColor::Cyan);
 
@@ -148,3 +180,25 @@ void USaveComponent::QuickLoad()
 {
     LoadFromSlot(QuickSlotName);
 }
+
+int32 USaveComponent::ClearSavedState()
+{
+    if (!GetOwner()) return 0;
+
+    const FString ActualId = GetActualId();
+
+    // Solo las keys exactas de este objeto: un prefijo "<Id>_" también borraría las de "Door_2" al limpiar "Door"
+    int32 Removed = 0;
+    for (const FString& Key : { ActualId + TEXT("_Pos"), ActualId + TEXT("_Rot") })
+    {
+        if (UMotaEzSaveGameLibrary::HasKey(GetOwner(), Key))
+        {
+            UMotaEzSaveGameLibrary::RemoveKey(GetOwner(), Key);
+            ++Removed;
+        }
+    }
+
+    ShowOnScreen(GetWorld(), FString::Printf(TEXT("[Save] Cleared %d keys of '%s'"), Removed, *ActualId), FColor::Orange);
+    UE_LOG(LogTemp, Display, TEXT("[SaveComponent] Removed %d keys of %s"), Removed, *ActualId);
+    return Removed;
+}
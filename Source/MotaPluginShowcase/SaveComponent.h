@@ -24,10 +24,27 @@ public:
     UFUNCTION(BlueprintCallable, Category="Save")
     void QuickLoad();
 
+    // Borra de CurrentSave las keys de este objeto (<SaveId>_Pos y <SaveId>_Rot), p. ej. al destruirlo
+    UFUNCTION(BlueprintCallable, Category="Save")
+    int32 ClearSavedState();
+
     // Identificador opcional para el objeto. Si está vacío se usará el nombre del actor propietario.
+    // Para el guardado en bloque (USaveComponentRegistry) se lee al registrarse el componente.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Save")
     FString SaveId;
 
+    // SaveId, o el nombre del actor propietario si está vacío
+    FString GetActualId() const;
+
 protected:
+    virtual void OnRegister() override;
+    virtual void OnUnregister() override;
+
     FString QuickSlotName = TEXT("QuickSlot");
+
+private:
+    friend class USaveComponentRegistry;
+
+    // Posición en USaveComponentRegistry (INDEX_NONE si no está registrado)
+    int32 RegistryIndex = INDEX_NONE;
 };
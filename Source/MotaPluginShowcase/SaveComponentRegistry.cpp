@@ -0,0 +1,253 @@
+﻿#include "SaveComponentRegistry.h"
+#include "SaveComponent.h"
+#include "MotaEzSlotManager.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/PlatformTime.h"
+#include "Hash/xxhash.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "El bloque de transformaciones se copia tal cual de memoria");
+
+const TCHAR* USaveComponentRegistry::BlockName = TEXT("Transforms");
+
+namespace
+{
+    constexpr uint32 TransformsMagic = 0x54575A45; // "EZWT"
+    constexpr uint32 TransformsVersion = 1;
+
+    // Cabecera del bloque; los arrays van justo detrás, sin separadores
+    struct FTransformsHeader
+    {
+        uint32 Magic = TransformsMagic;
+        uint32 Version = TransformsVersion;
+        uint32 Count = 0;
+        uint32 Reserved = 0;
+    };
+
+    uint64 HashSaveId(const FString& Id)
+    {
+        // Hash estable entre ejecuciones (no depende de FName ni de punteros)
+        return FXxHash64::HashBuffer(*Id, Id.Len() * sizeof(TCHAR)).Hash;
+    }
+}
+
+void FSaveComponentTransforms::Reset(int32 NewSize)
+{
+    Ids.SetNumUninitialized(NewSize);
+    Positions.SetNumUninitialized(NewSize);
+    Rotations.SetNumUninitialized(NewSize);
+}
+
+void FSaveComponentTransforms::Serialize(TArray<uint8>& OutBytes) const
+{
+    FTransformsHeader Header;
+    Header.Count = Ids.Num();
+
+    const int64 IdsSize = Ids.Num() * sizeof(uint64);
+    const int64 PositionsSize = Positions.Num() * sizeof(FVector);
+    const int64 RotationsSize = Rotations.Num() * sizeof(FQuat4f);
+
+    // Un solo buffer y tres memcpy, sin pasar por keys ni texto
+    OutBytes.SetNumUninitialized(sizeof(Header) + IdsSize + PositionsSize + RotationsSize);
+    uint8* Out = OutBytes.GetData();
+    FMemory::Memcpy(Out, &Header, sizeof(Header));
+    Out += sizeof(Header);
+    FMemory::Memcpy(Out, Ids.GetData(), IdsSize);
+    Out += IdsSize;
+    FMemory::Memcpy(Out, Positions.GetData(), PositionsSize);
+    Out += PositionsSize;
+    FMemory::Memcpy(Out, Rotations.GetData(), RotationsSize);
+}
+
+bool FSaveComponentTransforms::Deserialize(TConstArrayView<uint8> Bytes)
+{
+    FTransformsHeader Header;
+    if (Bytes.Num() < (int64)sizeof(Header))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+
+    const int64 Count = Header.Count;
+    const int64 ExpectedSize = sizeof(Header) + Count * (sizeof(uint64) + sizeof(FVector) + sizeof(FQuat4f));
+    if (Header.Magic != TransformsMagic || Header.Version != TransformsVersion || Bytes.Num() != ExpectedSize)
+    {
+        return false;
+    }
+
+    Reset(Count);
+    const uint8* In = Bytes.GetData() + sizeof(Header);
+    FMemory::Memcpy(Ids.GetData(), In, Count * sizeof(uint64));
+    In += Count * sizeof(uint64);
+    FMemory::Memcpy(Positions.GetData(), In, Count * sizeof(FVector));
+    In += Count * sizeof(FVector);
+    FMemory::Memcpy(Rotations.GetData(), In, Count * sizeof(FQuat4f));
+    return true;
+}
+
+void USaveComponentRegistry::Register(USaveComponent* Component)
+{
+    if (!Component || Component->RegistryIndex != INDEX_NONE)
+    {
+        return;
+    }
+
+    // El ID se calcula una vez aquí, no en cada guardado
+    const uint64 Id = HashSaveId(Component->GetActualId());
+    if (IndexById.Contains(Id))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[SaveComponentRegistry] Duplicate SaveId '%s'; only one of them will be restored"), *Component->GetActualId());
+    }
+
+    Component->RegistryIndex = Components.Add(Component);
+    Ids.Add(Id);
+    IndexById.Add(Id, Component->RegistryIndex);
+}
+
+void USaveComponentRegistry::Unregister(USaveComponent* Component)
+{
+    if (!Component || !Components.IsValidIndex(Component->RegistryIndex) || Components[Component->RegistryIndex] != Component)
+    {
+        return;
+    }
+
+    const int32 Index = Component->RegistryIndex;
+    if (const int32* Existing = IndexById.Find(Ids[Index]); Existing && *Existing == Index)
+    {
+        IndexById.Remove(Ids[Index]);
+    }
+
+    // Swap-remove: el último componente ocupa el hueco y se actualiza su índice
+    Components.RemoveAtSwap(Index, EAllowShrinking::No);
+    Ids.RemoveAtSwap(Index, EAllowShrinking::No);
+    if (Components.IsValidIndex(Index))
+    {
+        Components[Index]->RegistryIndex = Index;
+        if (int32* Moved = IndexById.Find(Ids[Index]); Moved && *Moved == Components.Num())
+        {
+            *Moved = Index;
+        }
+    }
+
+    Component->RegistryIndex = INDEX_NONE;
+}
+
+void USaveComponentRegistry::CaptureTransforms(FSaveComponentTransforms& OutTransforms) const
+{
+    OutTransforms.Reset(Components.Num());
+
+    int32 Count = 0;
+    for (int32 Index = 0; Index < Components.Num(); ++Index)
+    {
+        const AActor* Owner = Components[Index]->GetOwner();
+        const USceneComponent* Root = Owner ? Owner->GetRootComponent() : nullptr;
+        if (!Root)
+        {
+            continue;
+        }
+
+        // Se lee directamente la transformación del root, sin pasar por FRotator
+        const FTransform& Transform = Root->GetComponentTransform();
+        OutTransforms.Ids[Count] = Ids[Index];
+        OutTransforms.Positions[Count] = Transform.GetLocation();
+        OutTransforms.Rotations[Count] = FQuat4f(Transform.GetRotation());
+        ++Count;
+    }
+
+    OutTransforms.Ids.SetNum(Count, EAllowShrinking::No);
+    OutTransforms.Positions.SetNum(Count, EAllowShrinking::No);
+    OutTransforms.Rotations.SetNum(Count, EAllowShrinking::No);
+}
+
+int32 USaveComponentRegistry::ApplyTransforms(const FSaveComponentTransforms& Transforms)
+{
+    int32 Moved = 0;
+    for (int32 Index = 0; Index < Transforms.Num(); ++Index)
+    {
+        const int32* Found = IndexById.Find(Transforms.Ids[Index]);
+        AActor* Owner = Found ? Components[*Found]->GetOwner() : nullptr;
+        USceneComponent* Root = Owner ? Owner->GetRootComponent() : nullptr;
+        if (!Root)
+        {
+            continue;
+        }
+
+        const FVector& Loc = Transforms.Positions[Index];
+        const FQuat Rot = FQuat(Transforms.Rotations[Index]);
+
+        // Los actores que no se han movido no se tocan (ni overlaps ni física)
+        const FTransform& Current = Root->GetComponentTransform();
+        if (Current.GetLocation().Equals(Loc) && Current.GetRotation().Equals(Rot))
+        {
+            continue;
+        }
+
+        if (ACharacter* Char = Cast<ACharacter>(Owner))
+        {
+            // Igual que USaveComponent::LoadFromSlot: parar el movimiento y girar también el controller
+            if (UCharacterMovementComponent* MoveComp = Char->GetCharacterMovement())
+            {
+                MoveComp->StopMovementImmediately();
+            }
+            Char->TeleportTo(Loc, Rot.Rotator(), false, true);
+            if (AController* Controller = Char->GetController())
+            {
+                Controller->SetControlRotation(Rot.Rotator());
+            }
+        }
+        else
+        {
+            Root->SetWorldLocationAndRotation(Loc, Rot, false, nullptr, ETeleportType::TeleportPhysics);
+        }
+        ++Moved;
+    }
+    return Moved;
+}
+
+bool USaveComponentRegistry::SaveAllToSlot(int32 SlotIndex)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    FSaveComponentTransforms Transforms;
+    CaptureTransforms(Transforms);
+
+    TArray<uint8> Bytes;
+    Transforms.Serialize(Bytes);
+    const double CaptureTime = FPlatformTime::Seconds();
+
+    FString Error;
+    if (!UMotaEzSlotManager::SaveSlotBlock(SlotIndex, BlockName, Bytes, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[SaveComponentRegistry] Save failed: %s"), *Error);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("[SaveComponentRegistry] Saved %d actors to slot %d (%d bytes, capture %.3f ms, total %.3f ms)"),
+        Transforms.Num(), SlotIndex, Bytes.Num(), (CaptureTime - StartTime) * 1000.0, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return true;
+}
+
+int32 USaveComponentRegistry::LoadAllFromSlot(int32 SlotIndex)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<uint8> Bytes;
+    FString Error;
+    if (!UMotaEzSlotManager::LoadSlotBlock(SlotIndex, BlockName, Bytes, Error))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[SaveComponentRegistry] Load failed: %s"), *Error);
+        return 0;
+    }
+
+    FSaveComponentTransforms Transforms;
+    if (!Transforms.Deserialize(Bytes))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[SaveComponentRegistry] Slot %d has an invalid transforms block"), SlotIndex);
+        return 0;
+    }
+
+    const int32 Moved = ApplyTransforms(Transforms);
+    UE_LOG(LogTemp, Display, TEXT("[SaveComponentRegistry] Restored %d of %d actors from slot %d (%.3f ms)"),
+        Moved, Transforms.Num(), SlotIndex, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return Moved;
+}
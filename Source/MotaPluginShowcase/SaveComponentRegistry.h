@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SaveComponentRegistry.generated.h"
+
+class USaveComponent;
+
+/**
+ * Transformaciones de todos los USaveComponent en formato SoA (un array por campo).
+ * Se serializa como un único bloque binario: cabecera + Ids + Positions + Rotations copiados en bloque.
+ */
+struct MOTAPLUGINSHOWCASE_API FSaveComponentTransforms
+{
+    TArray<uint64> Ids;
+    TArray<FVector> Positions;
+    TArray<FQuat4f> Rotations;
+
+    int32 Num() const { return Ids.Num(); }
+
+    void Reset(int32 NewSize = 0);
+    void Serialize(TArray<uint8>& OutBytes) const;
+    bool Deserialize(TConstArrayView<uint8> Bytes);
+};
+
+/**
+ * Registro por mundo de los USaveComponent.
+ * Guarda y restaura las transformaciones de todos los actores registrados de una vez,
+ * en lugar de dos keys de texto y una escritura de slot por actor.
+ */
+UCLASS()
+class MOTAPLUGINSHOWCASE_API USaveComponentRegistry : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Los componentes se registran solos en OnRegister/OnUnregister
+    void Register(USaveComponent* Component);
+    void Unregister(USaveComponent* Component);
+
+    // Captura todas las transformaciones en una pasada
+    void CaptureTransforms(FSaveComponentTransforms& OutTransforms) const;
+
+    // Aplica las transformaciones por ID; devuelve cuántos actores se han movido
+    int32 ApplyTransforms(const FSaveComponentTransforms& Transforms);
+
+    // Guarda las transformaciones de todos los actores registrados como bloque del slot
+    UFUNCTION(BlueprintCallable, Category="Save")
+    bool SaveAllToSlot(int32 SlotIndex);
+
+    // Restaura en bloque las transformaciones guardadas con SaveAllToSlot
+    UFUNCTION(BlueprintCallable, Category="Save")
+    int32 LoadAllFromSlot(int32 SlotIndex);
+
+    UFUNCTION(BlueprintPure, Category="Save")
+    int32 GetNumRegistered() const { return Components.Num(); }
+
+    // Nombre del bloque dentro del slot (Slot0.Transforms.ezblock)
+    static const TCHAR* BlockName;
+
+private:
+    // Arrays paralelos: Components[i] tiene el ID Ids[i]
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<USaveComponent>> Components;
+
+    TArray<uint64> Ids;
+    TMap<uint64, int32> IndexById;
+};
@@ -1,15 +1,11 @@
 ﻿// SingletonDemoActor.cpp - Implementación
 #include "SingletonDemoActor.h"
-#include "MotaEzSaveGameLibrary.h"
 #include "MotaEzSlotManager.h"
+#include "MotaEzSaveData.h"
+#include "StatsManager.h"
 #include "Components/TextRenderComponent.h"
 #include "Components/BoxComponent.h"
 #include "GameFramework/Character.h"
-#include "StatsManager.h"
-#include "Kismet/GameplayStatics.h"
-
-// SLOT ASIGNADO PARA NIVEL 1 (SINGLETON)
-static const int32 SINGLETON_SLOT_INDEX = 10;
 
 ASingletonDemoActor::ASingletonDemoActor()
 {
@@ -45,9 +41,8 @@ void ASingletonDemoActor::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	// Cargar datos desde Slot 10 (Nivel Singleton)
-	FString Error;
-	UMotaEzSlotManager::LoadFromSlot(GetWorld(), SINGLETON_SLOT_INDEX, Error);
+	// El contador vive en el documento de estadísticas (Slot 99), que AStatsManager ya mantiene residente:
+	// no hace falta cargar ningún slot propio ni cambiar el documento actual
 	
 	// Actualizar display inicial
 	UpdateDisplayText();
@@ -59,43 +54,39 @@ void ASingletonDemoActor::IncrementSharedCounter()
 	// Todos los actores acceden a la MISMA instancia del subsistema
 	// El contador es compartido globalmente
 	
+	// El contador vive en el documento de estadísticas (Slot 99), el mismo que muestra el panel:
+	// al escribirlo, la suscripción de AStatsManager actualiza "Contador global"
+	UMotaEzSaveData* Stats = AStatsManager::FindStatsDocument(this);
+	if (!Stats)
+	{
+		return;
+	}
+	
 	// Obtener valor actual desde el subsistema único (Singleton)
-	int32 CurrentValue = UMotaEzSaveGameLibrary::EzGetInt(this, TEXT("GlobalCounter"), 0);
+	int32 CurrentValue = Stats->GetInt(TEXT("GlobalCounter"), 0);
 	
 	// Incrementar
 	CurrentValue++;
 	
 	// Guardar de vuelta en el subsistema único
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("GlobalCounter"), CurrentValue);
+	Stats->SetInt(TEXT("GlobalCounter"), CurrentValue);
 	
-	// Guardar en Slot 10 (Nivel Singleton)
+	// Guardar el documento de estadísticas (Slot 99)
 	FString Error;
-	UMotaEzSlotManager::SaveToSlot(GetWorld(), SINGLETON_SLOT_INDEX, Error);
+	UMotaEzSlotManager::SaveDocument(GetWorld(), AStatsManager::StatsSlotIndex, Error);
 	
 	// Log para depuración
 	UE_LOG(LogTemp, Log, TEXT("%s incrementó GlobalCounter a: %d"), *ActorID, CurrentValue);
 	
 	// Actualizar display
 	UpdateDisplayText();
-	
-	// Buscar StatsManager para actualizar su caché
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AStatsManager::StaticClass(), FoundActors);
-	
-	if (FoundActors.Num() > 0)
-	{
-		AStatsManager* StatsManager = Cast<AStatsManager>(FoundActors[0]);
-		if (StatsManager)
-		{
-			StatsManager->RefreshStatsFromSaveSystem();
-		}
-	}
 }
 
 int32 ASingletonDemoActor::GetSharedCounter() const
 {
 	// Acceso al valor compartido desde el Singleton
-	return UMotaEzSaveGameLibrary::EzGetInt(this, TEXT("GlobalCounter"), 0);
+	const UMotaEzSaveData* Stats = AStatsManager::FindStatsDocument(this);
+	return Stats ? Stats->GetInt(TEXT("GlobalCounter"), 0) : 0;
 }
 
 void ASingletonDemoActor::UpdateDisplayText()
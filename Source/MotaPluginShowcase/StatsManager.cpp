@@ -1,11 +1,13 @@
 ﻿// StatsManager.cpp - Implementación del gestor de estadísticas
 #include "StatsManager.h"
-#include "MotaEzSaveGameLibrary.h"
 #include "MotaEzSlotManager.h"
+#include "MotaEzConfigSubsystem.h"
+#include "MotaEzSaveData.h"
 #include "MotaEzSaveGameSettings.h"
 #include "Components/TextRenderComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
 #include "Kismet/GameplayStatics.h"
-#include "TimerManager.h"
 
 AStatsManager::AStatsManager()
 {
@@ -30,22 +32,39 @@ void AStatsManager::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	// Cargar estadísticas desde Slot 99 (SlotMain - estadísticas globales)
-	FString Error;
-	UMotaEzSlotManager::LoadFromSlot(GetWorld(), 99, Error);
+	// Las estadísticas viven en su propio documento (Slot 99), residente junto al slot del nivel:
+	// no se sustituye el guardado activo ni se recarga de disco al cambiar de nivel
+	UMotaEzSaveData* Stats = GetStatsDocument();
 	
 	// Cargar PlayTime SOLO al inicio (luego se incrementa en Tick)
-	CachedPlayTime = UMotaEzSaveGameLibrary::EzGetInt(this, TEXT("TotalPlayTime"), 0);
+	CachedPlayTime = Stats ? Stats->GetInt(TEXT("TotalPlayTime"), 0) : 0;
 	
-	// Cargar estadísticas desde el sistema
-	RefreshStatsFromSaveSystem();
+	if (Stats)
+	{
+		CachedGlobalCounter = Stats->GetInt(TEXT("GlobalCounter"), 0);
+		CachedTeleportCount = Stats->GetInt(TEXT("TeleportCount"), 0);
+		
+		// En lugar de releer cada segundo, el documento nos avisa cuando cambian estas keys
+		StatsSubscription = Stats->SubscribeKeys({ TEXT("GlobalCounter"), TEXT("TeleportCount") },
+			FMotaEzKeysChangedDelegate::CreateUObject(this, &AStatsManager::HandleStatsChanged));
+	}
 	
-	// Timer para actualizar display cada 1 segundo
-	GetWorldTimerManager().SetTimer(UpdateTimerHandle, this, &AStatsManager::RefreshStatsFromSaveSystem, 1.0f, true);
+	UpdateStatsDisplay();
 	
 	UE_LOG(LogTemp, Log, TEXT("Stats Manager iniciado - PlayTime inicial: %d segundos"), CachedPlayTime);
 }
 
+void AStatsManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMotaEzSaveData* Stats = GetStatsDocument())
+	{
+		Stats->Unsubscribe(StatsSubscription);
+	}
+	StatsSubscription.Reset();
+	
+	Super::EndPlay(EndPlayReason);
+}
+
 void AStatsManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -59,6 +78,9 @@ void AStatsManager::Tick(float DeltaTime)
 	{
 		CachedPlayTime += 1;
 		AccumulatedTime -= 1.0f; // Mantener el resto para precisión
+		
+		// El tiempo de juego es lo único que cambia cada segundo
+		UpdateStatsDisplay();
 	}
 	
 	// Guardar cada minuto (cada 60 segundos)
@@ -80,7 +102,10 @@ void AStatsManager::IncrementGlobalCounter()
 	// Demostración del patrón SINGLETON
 	// Acceso directo al subsistema global
 	CachedGlobalCounter++;
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("GlobalCounter"), CachedGlobalCounter);
+	if (UMotaEzSaveData* Stats = GetStatsDocument())
+	{
+		Stats->SetInt(TEXT("GlobalCounter"), CachedGlobalCounter);
+	}
 	
 	UE_LOG(LogTemp, Log, TEXT("GlobalCounter incrementado a: %d"), CachedGlobalCounter);
 }
@@ -93,7 +118,10 @@ int32 AStatsManager::GetGlobalCounter() const
 void AStatsManager::IncrementTeleportCount()
 {
 	CachedTeleportCount++;
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("TeleportCount"), CachedTeleportCount);
+	if (UMotaEzSaveData* Stats = GetStatsDocument())
+	{
+		Stats->SetInt(TEXT("TeleportCount"), CachedTeleportCount);
+	}
 }
 
 int32 AStatsManager::GetTotalPlayTime() const
@@ -108,11 +136,23 @@ int32 AStatsManager::GetTotalSavedDataCount() const
 	return 15; // Número aproximado de datos guardados en SaveData
 }
 
-void AStatsManager::RefreshStatsFromSaveSystem()
+void AStatsManager::HandleStatsChanged(const TArray<FString>& ChangedKeys)
 {
-	// Cargar todos los valores desde EzSaveGame (excepto PlayTime que se maneja en Tick)
-	CachedGlobalCounter = UMotaEzSaveGameLibrary::EzGetInt(this, TEXT("GlobalCounter"), 0);
-	CachedTeleportCount = UMotaEzSaveGameLibrary::EzGetInt(this, TEXT("TeleportCount"), 0);
+	// Releer solo las keys que han cambiado (PlayTime se maneja en Tick)
+	if (const UMotaEzSaveData* Stats = GetStatsDocument())
+	{
+		for (const FString& Key : ChangedKeys)
+		{
+			if (Key == TEXT("GlobalCounter"))
+			{
+				CachedGlobalCounter = Stats->GetInt(Key, 0);
+			}
+			else if (Key == TEXT("TeleportCount"))
+			{
+				CachedTeleportCount = Stats->GetInt(Key, 0);
+			}
+		}
+	}
 	
 	// Actualizar display
 	UpdateStatsDisplay();
@@ -143,14 +183,20 @@ void AStatsManager::UpdateStatsDisplay()
 
 void AStatsManager::SaveAllStats()
 {
-	// Guardar todas las estadísticas actuales en el subsistema
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("GlobalCounter"), CachedGlobalCounter);
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("TotalPlayTime"), CachedPlayTime); // Guardado como int (segundos)
-	UMotaEzSaveGameLibrary::EzSetInt(this, TEXT("TeleportCount"), CachedTeleportCount);
+	// Guardar todas las estadísticas actuales en su documento
+	UMotaEzSaveData* Stats = GetStatsDocument();
+	if (!Stats)
+	{
+		return;
+	}
 	
-	// Guardar en Slot 99 (SlotMain - estadísticas globales)
+	// GlobalCounter no se reescribe: otros actores (ASingletonDemoActor) lo incrementan directamente en el documento
+	Stats->SetInt(TEXT("TotalPlayTime"), CachedPlayTime); // Guardado como int (segundos)
+	Stats->SetInt(TEXT("TeleportCount"), CachedTeleportCount);
+	
+	// Guardar en Slot 99 (SlotMain - estadísticas globales) sin tocar el guardado activo
 	FString Error;
-	bool bSuccess = UMotaEzSlotManager::SaveToSlot(GetWorld(), 99, Error);
+	bool bSuccess = UMotaEzSlotManager::SaveDocument(GetWorld(), StatsSlotIndex, Error);
 	
 	if (bSuccess)
 	{
@@ -163,6 +209,19 @@ void AStatsManager::SaveAllStats()
 	}
 }
 
+UMotaEzSaveData* AStatsManager::GetStatsDocument() const
+{
+	return FindStatsDocument(this);
+}
+
+UMotaEzSaveData* AStatsManager::FindStatsDocument(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	UMotaEzConfigSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UMotaEzConfigSubsystem>() : nullptr;
+	return Subsystem ? Subsystem->GetDocument(StatsSlotIndex) : nullptr;
+}
+
 FString AStatsManager::GetActiveFormat() const
 {
 	const UMotaEzSaveGameSettings* Settings = GetDefault<UMotaEzSaveGameSettings>();
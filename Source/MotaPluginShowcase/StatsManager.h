@@ -19,6 +19,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	virtual void Tick(float DeltaTime) override;
@@ -45,10 +46,6 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Stats|Singleton")
 	int32 GetTotalSavedDataCount() const;
 	
-	/** Actualiza todas las estadísticas desde el sistema de guardado */
-	UFUNCTION(BlueprintCallable, Category = "Stats|Singleton")
-	void RefreshStatsFromSaveSystem();
-	
 	/** Guarda todas las estadísticas actuales */
 	UFUNCTION(BlueprintCallable, Category = "Stats|Singleton")
 	void SaveAllStats();
@@ -75,6 +72,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Stats|Display")
 	int32 GetTeleportCount() const { return CachedTeleportCount; }
 	
+	// === DOCUMENTO DE ESTADÍSTICAS ===
+	
+	/** Slot 99 (SlotMain) - estadísticas globales */
+	static constexpr int32 StatsSlotIndex = 99;
+	
+	/** Documento residente del Slot 99, compartido por todos los actores que escriben estadísticas */
+	static class UMotaEzSaveData* FindStatsDocument(const UObject* WorldContextObject);
+	
 	// === COMPONENTES ===
 	
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
@@ -93,8 +98,14 @@ private:
 	UPROPERTY()
 	FDateTime LastSaveTime;
 	
-	// Timer para actualizar el panel automáticamente
-	FTimerHandle UpdateTimerHandle;
+	// Suscripción a cambios de GlobalCounter y TeleportCount (sustituye al timer de refresco)
+	FDelegateHandle StatsSubscription;
+	
+	/** Documento residente del Slot 99 (no depende del slot activo del nivel) */
+	class UMotaEzSaveData* GetStatsDocument() const;
+	
+	/** Recibe, una vez por frame, las keys de estadísticas que han cambiado */
+	void HandleStatsChanged(const TArray<FString>& ChangedKeys);
 	
 	void UpdateStatsDisplay();
 };
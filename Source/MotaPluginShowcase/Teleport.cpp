@@ -4,6 +4,7 @@
 #include "Teleport.h"
 #include "GameFramework/Character.h"
 #include "MotaEzSaveGameLibrary.h"
+#include "MotaEzSlotManager.h"
 #include "StatsManager.h"
 #include "Kismet/GameplayStatics.h"
 
@@ -55,6 +56,12 @@ void ATeleport::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* Othe
 	
 	if (Character)
 	{
+		// Empezar a leer en segundo plano los slots que se usan en el destino
+		if (!PreloadManifest.IsNone())
+		{
+			UMotaEzSlotManager::PrefetchManifest(PreloadManifest);
+		}
+
 		// Teletransportar al personaje a la ubicación de destino
 		Character->SetActorLocation(TeleportDestination, false, nullptr, ETeleportType::TeleportPhysics);
 		
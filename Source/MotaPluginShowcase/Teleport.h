@@ -32,6 +32,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Teleport")
 	FVector TeleportDestination;
 
+	// Manifiesto de precarga (Project Settings > EzSaveGame) cuyos slots se leen al entrar en el trigger
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Teleport")
+	FName PreloadManifest;
+
 	// Función que se llama cuando algo entra en el trigger
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, 